@@ -0,0 +1,111 @@
+/*
+ * Benchmark comparing the play-out latency of the jitter-buffers while packages are received concurrently.
+ *
+ * A receiver-thread writes packages into the buffer as fast as the buffer accepts them,
+ * while the play-out thread reads the packages and measures the time spent in every call to readPackage.
+ * The play-out thread only reads, if a package is available, since reading faster than packages arrive
+ * would make the buffer drop all following packages as late losses.
+ * For the audio-thread, not the average but the worst-case time is the interesting value.
+ *
+ * Usage: BenchmarkJitterBuffers [number of packages to read]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rtp/RTPBuffer.h"
+#include "rtp/RTPBufferLockFree.h"
+
+using namespace ohmcomm::rtp;
+
+static const uint16_t maxCapacity = 128;
+static const uint16_t maxDelay = 200;
+static const uint16_t minBufferPackages = 1;
+static const unsigned int payloadSize = 160;
+
+//the index is calculated in 64 bit, since the number of reads times the percentile exceeds 32 bit
+static long getPercentile(const std::vector<long>& sortedDurations, const uint64_t perTenThousand)
+{
+    return sortedDurations[std::min((uint64_t)sortedDurations.size() - 1, sortedDurations.size() * perTenThousand / 10000)];
+}
+
+static void runBenchmark(const std::string& name, RTPBufferHandler& buffer, const unsigned int numReads)
+{
+    std::atomic<bool> running(true);
+    std::thread receiver([&buffer, &running]()
+    {
+        RTPPackageHandler package(payloadSize);
+        const std::vector<char> payload(payloadSize, 42);
+        package.createNewRTPPackage(payload.data(), payloadSize);
+        while(running.load(std::memory_order_relaxed))
+        {
+            if(buffer.addPackage(package, payloadSize) == RTPBufferStatus::RTP_BUFFER_INPUT_OVERFLOW)
+            {
+                //retry the same package later
+                std::this_thread::yield();
+                continue;
+            }
+            package.createNewRTPPackage(payload.data(), payloadSize);
+        }
+    });
+
+    RTPPackageHandler package(payloadSize);
+    std::vector<long> durations(numReads);
+    unsigned int numUnderflows = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for(unsigned int i = 0; i < numReads; ++i)
+    {
+        while(buffer.getSize() == 0)
+        {
+            std::this_thread::yield();
+        }
+        const auto before = std::chrono::steady_clock::now();
+        if(buffer.readPackage(package) == RTPBufferStatus::RTP_BUFFER_OUTPUT_UNDERFLOW)
+        {
+            ++numUnderflows;
+        }
+        durations[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - before).count();
+    }
+    const auto totalDuration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    running.store(false);
+    receiver.join();
+
+    std::sort(durations.begin(), durations.end());
+    long sum = 0;
+    for(const long duration : durations)
+    {
+        sum += duration;
+    }
+    std::cout << name << ":" << std::endl;
+    std::cout << "\tPackages read: " << numReads << " in " << totalDuration << " ms (" << numUnderflows << " underflows)" << std::endl;
+    std::cout << "\tread-latency mean: " << (sum / numReads) << " ns" << std::endl;
+    std::cout << "\tread-latency median: " << durations[numReads / 2] << " ns" << std::endl;
+    std::cout << "\tread-latency 99th percentile: " << getPercentile(durations, 9900) << " ns" << std::endl;
+    std::cout << "\tread-latency 99.99th percentile: " << getPercentile(durations, 9999) << " ns" << std::endl;
+    std::cout << "\tread-latency maximum: " << durations.back() << " ns" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    const unsigned int numReads = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    if(numReads == 0)
+    {
+        std::cerr << "Number of packages to read must be positive!" << std::endl;
+        return 1;
+    }
+    {
+        RTPBuffer buffer(1, maxCapacity, maxDelay, minBufferPackages);
+        runBenchmark("RTPBuffer", buffer, numReads);
+    }
+    {
+        RTPBufferLockFree buffer(1, maxCapacity, maxDelay, minBufferPackages, payloadSize);
+        runBenchmark("RTPBufferLockFree", buffer, numReads);
+    }
+    return 0;
+}
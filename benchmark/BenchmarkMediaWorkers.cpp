@@ -0,0 +1,216 @@
+/*
+ * Benchmark measuring the number of calls a MediaWorkerPool serves per core.
+ *
+ * Every call is simulated by a client-socket sending a G.711 RTP-package (20 ms of audio) every 20 ms to the shared port.
+ * The worker owning the call receives the packages into the jitter-buffer of the call. Every 20 ms, the worker reads a package
+ * of all of its calls from their jitter-buffers, transcodes it (decodes and encodes G.711) and sends it back to the client,
+ * like a media-server relaying the audio.
+ *
+ * The CPU-time of the workers is measured in their threads, the calls per core are the number of calls divided by the
+ * number of cores the workers fully used. The clients run in the same process, but their CPU-time is not counted.
+ *
+ * The results are written to std::wcout, since the logger already writes wide characters to the standard output.
+ *
+ * Usage: BenchmarkMediaWorkers [number of workers] [number of calls] [duration in seconds]
+ */
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#include <time.h>
+#endif
+
+#include "codecs/g711common.h"
+#include "network/UDPWrapper.h"
+#include "rtp/JitterBuffers.h"
+#include "rtp/MediaWorkerPool.h"
+#include "rtp/RTPPackageHandler.h"
+
+using namespace ohmcomm;
+using namespace ohmcomm::rtp;
+
+static const unsigned short serverPort = 30000;
+//the clients use consecutive ports, so the calls are distributed evenly among the workers
+static const unsigned short firstClientPort = 30002;
+static const unsigned int samplesPerPackage = 160;
+static const std::chrono::milliseconds packageInterval{20};
+
+struct Call
+{
+    std::shared_ptr<SharedMediaSocket::Session> session;
+    std::unique_ptr<JitterBuffers> buffers;
+    std::unique_ptr<RTPPackageHandler> inputPackage;
+    std::unique_ptr<RTPPackageHandler> outputPackage;
+    std::unique_ptr<Participant> server;
+    uint32_t remoteSSRC;
+    unsigned int packagesRelayed;
+};
+
+//the CPU-time used by the current thread
+static std::chrono::nanoseconds getThreadCPUTime()
+{
+#ifdef __linux__
+    timespec time;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return std::chrono::seconds(time.tv_sec) + std::chrono::nanoseconds(time.tv_nsec);
+#else
+    return std::chrono::nanoseconds(0);
+#endif
+}
+
+//measures the CPU-time of the worker, in its thread
+static std::chrono::nanoseconds getWorkerCPUTime(MediaWorkerPool& pool, const unsigned int worker)
+{
+    std::promise<std::chrono::nanoseconds> cpuTime;
+    pool.getEventLoop(worker).addTimer(std::chrono::milliseconds(0), [&cpuTime]() { cpuTime.set_value(getThreadCPUTime()); }, false);
+    return cpuTime.get_future().get();
+}
+
+static void relayPackage(Call& call)
+{
+    RTPBufferHandler* buffer = call.buffers->findBuffer(call.remoteSSRC);
+    if(buffer == nullptr || buffer->readPackage(*call.inputPackage) != RTPBufferStatus::RTP_BUFFER_ALL_OKAY)
+    {
+        return;
+    }
+    const uint8_t* input = (const uint8_t*) call.inputPackage->getRTPPackageData();
+    uint8_t output[samplesPerPackage];
+    for(unsigned int i = 0; i < samplesPerPackage; ++i)
+    {
+        output[i] = s16_to_ulaw(ulaw_to_s16(input[i]));
+    }
+    const void* package = call.outputPackage->createNewRTPPackage(output, samplesPerPackage);
+    call.session->sendData(package, call.outputPackage->getRTPHeaderSize() + samplesPerPackage);
+    ++call.packagesRelayed;
+}
+
+int main(int argc, char** argv)
+{
+    const unsigned int numWorkers = argc > 1 ? std::stoul(argv[1]) : MediaWorkerPool::getDefaultNumberOfWorkers();
+    const unsigned int numCalls = argc > 2 ? std::stoul(argv[2]) : 100 * numWorkers;
+    const unsigned int duration = argc > 3 ? std::stoul(argv[3]) : 10;
+    if(numWorkers == 0 || numCalls == 0 || duration == 0 || numCalls > UINT16_MAX - firstClientPort)
+    {
+        std::wcerr << "Invalid number of workers, calls or duration!" << std::endl;
+        return 1;
+    }
+#ifdef __linux__
+    //every call needs a client-socket
+    rlimit fileLimit;
+    if(getrlimit(RLIMIT_NOFILE, &fileLimit) == 0 && fileLimit.rlim_cur < fileLimit.rlim_max)
+    {
+        fileLimit.rlim_cur = fileLimit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &fileLimit);
+    }
+#endif
+
+    MediaWorkerPool pool(serverPort, numWorkers);
+    std::vector<std::vector<Call>> calls(pool.getNumberOfWorkers());
+    std::vector<std::unique_ptr<network::UDPWrapper>> clients;
+    std::vector<std::unique_ptr<RTPPackageHandler>> clientPackages;
+    std::vector<std::unique_ptr<Participant>> clientParticipants;
+    for(unsigned int i = 0; i < numCalls; ++i)
+    {
+        const unsigned short clientPort = firstClientPort + i;
+        const uint32_t clientSSRC = 0x10000 + i;
+        clients.emplace_back(new network::UDPWrapper(NetworkConfiguration{clientPort, "127.0.0.1", serverPort}));
+        clientParticipants.emplace_back(new Participant(clientSSRC, true));
+        clientPackages.emplace_back(new RTPPackageHandler(samplesPerPackage, *clientParticipants.back()));
+
+        Call call;
+        call.session = pool.openSession("127.0.0.1", clientPort);
+        call.buffers.reset(new JitterBuffers(16, 200, 1, JitterBufferType::RTP_BUFFER, samplesPerPackage, 1));
+        call.inputPackage.reset(new RTPPackageHandler(samplesPerPackage));
+        call.server.reset(new Participant(0x20000 + i, true));
+        call.outputPackage.reset(new RTPPackageHandler(samplesPerPackage, *call.server));
+        call.remoteSSRC = clientSSRC;
+        call.packagesRelayed = 0;
+        call.session->startReceiving(*call.buffers, nullptr);
+        calls[pool.getWorkerIndex(clientPort)].push_back(std::move(call));
+    }
+
+    //the play-out of the calls runs in the thread of their worker
+    std::vector<network::EventLoop::TimerID> playoutTimers;
+    for(unsigned int worker = 0; worker < pool.getNumberOfWorkers(); ++worker)
+    {
+        std::vector<Call>& workerCalls = calls[worker];
+        playoutTimers.push_back(pool.getEventLoop(worker).addTimer(packageInterval, [&workerCalls]()
+        {
+            for(Call& call : workerCalls)
+            {
+                relayPackage(call);
+            }
+        }));
+    }
+
+    std::atomic<bool> running(true);
+    std::atomic<unsigned long> packagesSent(0);
+    std::thread clientThread([&]()
+    {
+        const std::vector<uint8_t> payload(samplesPerPackage, 0xFF);
+        auto nextSend = std::chrono::steady_clock::now();
+        while(running)
+        {
+            for(unsigned int i = 0; i < numCalls; ++i)
+            {
+                const void* package = clientPackages[i]->createNewRTPPackage(payload.data(), samplesPerPackage);
+                clients[i]->sendData(package, clientPackages[i]->getRTPHeaderSize() + samplesPerPackage);
+            }
+            packagesSent += numCalls;
+            nextSend += packageInterval;
+            std::this_thread::sleep_until(nextSend);
+        }
+    });
+
+    //skip the start-up, until all calls are buffering
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    std::vector<std::chrono::nanoseconds> startTimes;
+    for(unsigned int worker = 0; worker < pool.getNumberOfWorkers(); ++worker)
+    {
+        startTimes.push_back(getWorkerCPUTime(pool, worker));
+    }
+    const auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::seconds(duration));
+    std::chrono::nanoseconds totalCPUTime(0);
+    std::wcout << "Workers: " << pool.getNumberOfWorkers() << ", calls: " << numCalls << std::endl;
+    for(unsigned int worker = 0; worker < pool.getNumberOfWorkers(); ++worker)
+    {
+        const std::chrono::nanoseconds cpuTime = getWorkerCPUTime(pool, worker) - startTimes[worker];
+        totalCPUTime += cpuTime;
+        std::wcout << "\tWorker " << worker << ": " << calls[worker].size() << " calls, "
+                << std::chrono::duration_cast<std::chrono::milliseconds>(cpuTime).count() << " ms CPU-time" << std::endl;
+    }
+    const double elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    running = false;
+    clientThread.join();
+    for(unsigned int worker = 0; worker < pool.getNumberOfWorkers(); ++worker)
+    {
+        pool.getEventLoop(worker).cancelTimer(playoutTimers[worker]);
+    }
+    unsigned long relayed = 0;
+    unsigned int silentCalls = 0;
+    for(const std::vector<Call>& workerCalls : calls)
+    {
+        for(const Call& call : workerCalls)
+        {
+            relayed += call.packagesRelayed;
+            silentCalls += call.packagesRelayed == 0 ? 1 : 0;
+        }
+    }
+
+    const double coresUsed = std::chrono::duration<double>(totalCPUTime).count() / elapsedSeconds;
+    std::wcout << "\tPackages sent by clients: " << packagesSent << ", relayed by workers: " << relayed << std::endl;
+    std::wcout << "\tCalls without any package relayed: " << silentCalls << std::endl;
+    std::wcout << "\tCores used by workers: " << coresUsed << std::endl;
+    std::wcout << "\tCalls per core: " << (coresUsed > 0 ? numCalls / coresUsed : 0) << std::endl;
+    return 0;
+}
@@ -0,0 +1,321 @@
+/*
+ * Offline simulator comparing the jitter-buffers on package-arrival traces.
+ *
+ * The buffers are run on a virtual clock (see BufferClock), so a trace of several minutes is simulated within a fraction of a second
+ * and the results are independent of the load of the machine. The packages of the trace are added at their time of arrival,
+ * the play-out reads one package every packet-interval, like the audio-callback does.
+ *
+ * The trace is either read from a file or generated synthetically with the given network-conditions:
+ * - jitter: exponentially distributed additional network-delay
+ * - reordering: some packages are delayed by one to three additional packet-intervals
+ * - burst loss: packages are lost in bursts (Gilbert-model) with the given average loss rate and burst length
+ * - clock skew: the sender's clock runs faster (positive) or slower (negative) than ours
+ *
+ * For every buffer, the added latency (time from reception to play-out), the late-loss rate (received packages never played),
+ * the concealment ratio (play-outs without a new package) and the processing time per call is reported.
+ *
+ * Usage: JitterBufferSimulator [option=value]...
+ *  buffer=all|rtp|lockfree|alternative     The buffer to simulate (default: all)
+ *  trace=<file>                            Recorded trace, each line "<send time> <arrival time>" in ms, in sending order.
+ *                                          A negative arrival time marks the package as lost.
+ *  duration=<s>                            The length of the synthetic trace (default: 60)
+ *  packet=<ms>                             The packet-interval (default: 20)
+ *  delay=<ms>                              The minimum network-delay (default: 20)
+ *  jitter=<ms>                             The mean of the additional network-delay (default: 10)
+ *  reorder=<percent>                       The ratio of reordered packages (default: 0)
+ *  loss=<percent>                          The ratio of lost packages (default: 0)
+ *  burst=<packages>                        The mean length of a loss-burst (default: 1)
+ *  skew=<ppm>                              The drift of the sender's clock (default: 0)
+ *  seed=<number>                           The seed for the synthetic trace (default: 42)
+ *  capacity=<packages>                     The jitter-buffer capacity (default: 128)
+ *  maxdelay=<ms>                           The maximum delay of buffered packages (default: 200)
+ *  minpackages=<packages>                  The initial number of packages to buffer (default: 1)
+ *  quantile=<percent>                      Adapt the playout delay to the given quantile of package delays (default: late-loss thresholds)
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "rtp/BufferClock.h"
+#include "rtp/RTPBuffer.h"
+#include "rtp/RTPBufferAlternative.h"
+#include "rtp/RTPBufferLockFree.h"
+
+using namespace ohmcomm::rtp;
+
+static const unsigned int payloadSize = 160;
+static const uint32_t initialTimestamp = 4711;
+
+/*!
+ * A single package of the trace, all times in ms
+ */
+struct TraceEntry
+{
+    double sendTime;
+    double arrivalTime;
+    bool lost;
+};
+
+/*!
+ * The results of a single simulation
+ */
+struct SimulationResult
+{
+    unsigned long numReceived = 0;
+    unsigned long numPlayed = 0;
+    unsigned long numReads = 0;
+    unsigned long numConcealed = 0;
+    unsigned long numOverflows = 0;
+    std::vector<double> latencies;
+    std::vector<long> addDurations;
+    std::vector<long> readDurations;
+};
+
+static std::chrono::steady_clock::time_point virtualNow;
+
+static std::chrono::steady_clock::time_point getVirtualTime()
+{
+    return virtualNow;
+}
+
+static void setVirtualTime(const double milliseconds)
+{
+    //start with an offset, so no time lies before the epoch of the clock
+    virtualNow = std::chrono::steady_clock::time_point(std::chrono::hours(1)) +
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double, std::milli>(milliseconds));
+}
+
+static std::vector<TraceEntry> readTrace(const std::string& fileName)
+{
+    std::vector<TraceEntry> trace;
+    std::ifstream file(fileName);
+    double sendTime, arrivalTime;
+    while(file >> sendTime >> arrivalTime)
+    {
+        trace.push_back(TraceEntry{sendTime, arrivalTime, arrivalTime < 0});
+    }
+    return trace;
+}
+
+static std::vector<TraceEntry> generateTrace(const std::map<std::string, double>& options)
+{
+    const double packetInterval = options.at("packet");
+    const unsigned long numPackages = options.at("duration") * 1000 / packetInterval;
+    const double lossRatio = options.at("loss") / 100;
+    //Gilbert-model: probability to leave (r) and to enter (p) the loss-state, resulting in the given loss rate and mean burst-length
+    const double leaveLossProbability = 1 / std::max(1.0, options.at("burst"));
+    const double enterLossProbability = lossRatio < 1 ? lossRatio * leaveLossProbability / (1 - lossRatio) : 1;
+
+    std::mt19937 generator(options.at("seed"));
+    std::uniform_real_distribution<double> uniform(0, 1);
+    std::exponential_distribution<double> jitter(options.at("jitter") > 0 ? 1 / options.at("jitter") : 1e9);
+    std::uniform_int_distribution<int> reorderIntervals(1, 3);
+
+    std::vector<TraceEntry> trace(numPackages);
+    bool inLossState = false;
+    for(unsigned long i = 0; i < numPackages; ++i)
+    {
+        //the sending times in our time, a faster sender sends its packages in shorter intervals
+        trace[i].sendTime = i * packetInterval * (1 - options.at("skew") / 1000000);
+        trace[i].arrivalTime = trace[i].sendTime + options.at("delay") + jitter(generator);
+        if(uniform(generator) < options.at("reorder") / 100)
+        {
+            trace[i].arrivalTime += reorderIntervals(generator) * packetInterval;
+        }
+        inLossState = uniform(generator) < (inLossState ? 1 - leaveLossProbability : enterLossProbability);
+        trace[i].lost = inLossState;
+    }
+    return trace;
+}
+
+static std::unique_ptr<RTPBufferHandler> createBuffer(const std::string& type, const std::map<std::string, double>& options)
+{
+    const uint16_t capacity = options.at("capacity");
+    const uint16_t maxDelay = options.at("maxdelay");
+    const uint16_t minPackages = options.at("minpackages");
+    PlayoutAdaptionSettings settings;
+    if(options.at("quantile") > 0)
+    {
+        settings = PlayoutAdaptionSettings(PlayoutAdaptionMode::DELAY_QUANTILE, options.at("quantile") / 100);
+    }
+    if(type == "lockfree")
+    {
+        return std::unique_ptr<RTPBufferHandler>(new RTPBufferLockFree(1, capacity, maxDelay, minPackages, payloadSize, settings));
+    }
+    if(type == "alternative")
+    {
+        return std::unique_ptr<RTPBufferHandler>(new RTPBufferAlternative(capacity, maxDelay, minPackages));
+    }
+    return std::unique_ptr<RTPBufferHandler>(new RTPBuffer(1, capacity, maxDelay, minPackages, payloadSize, settings));
+}
+
+static SimulationResult simulate(RTPBufferHandler& buffer, const std::vector<TraceEntry>& trace, const double packetInterval, const double drainTime)
+{
+    SimulationResult result;
+    std::vector<uint32_t> arrivalOrder;
+    for(uint32_t i = 0; i < trace.size(); ++i)
+    {
+        if(!trace[i].lost)
+        {
+            arrivalOrder.push_back(i);
+        }
+    }
+    std::stable_sort(arrivalOrder.begin(), arrivalOrder.end(), [&trace](const uint32_t a, const uint32_t b)
+    {
+        return trace[a].arrivalTime < trace[b].arrivalTime;
+    });
+    result.numReceived = arrivalOrder.size();
+    if(arrivalOrder.empty())
+    {
+        return result;
+    }
+
+    RTPPackageHandler package(payloadSize);
+    std::vector<char> payload(payloadSize, 0);
+    //the play-out starts with the first package received
+    const double playoutStart = trace[arrivalOrder.front()].arrivalTime;
+    const double lastArrival = trace[arrivalOrder.back()].arrivalTime;
+    std::size_t nextArrival = 0;
+    unsigned long numTicks = 0;
+    int64_t lastPlayedIndex = -1;
+    while(true)
+    {
+        const double nextTick = playoutStart + numTicks * packetInterval;
+        if(nextArrival < arrivalOrder.size() && trace[arrivalOrder[nextArrival]].arrivalTime <= nextTick)
+        {
+            //receive the package
+            const uint32_t index = arrivalOrder[nextArrival++];
+            setVirtualTime(trace[index].arrivalTime);
+            memcpy(payload.data(), &index, sizeof(index));
+            package.createNewRTPPackage(payload.data(), payloadSize);
+            RTPHeader* header = reinterpret_cast<RTPHeader*>(package.getWriteBuffer(0));
+            header->setSequenceNumber(index % UINT16_MAX);
+            header->setTimestamp(initialTimestamp + (uint32_t)(index * packetInterval));
+            const auto before = std::chrono::steady_clock::now();
+            if(buffer.addPackage(package, payloadSize) == RTPBufferStatus::RTP_BUFFER_INPUT_OVERFLOW)
+            {
+                ++result.numOverflows;
+            }
+            result.addDurations.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - before).count());
+            continue;
+        }
+        if(nextTick > lastArrival && (buffer.getSize() == 0 || nextTick > lastArrival + drainTime))
+        {
+            //all packages received and played (or never will be)
+            break;
+        }
+        //play out the next package
+        setVirtualTime(nextTick);
+        ++numTicks;
+        const auto before = std::chrono::steady_clock::now();
+        const RTPBufferStatus status = buffer.readPackage(package);
+        result.readDurations.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - before).count());
+        ++result.numReads;
+        uint32_t index;
+        memcpy(&index, package.getRTPPackageData(), sizeof(index));
+        if(status != RTPBufferStatus::RTP_BUFFER_ALL_OKAY || (int64_t)index <= lastPlayedIndex || index >= trace.size() || trace[index].arrivalTime > nextTick)
+        {
+            //silence, a repeated package or any other concealment (or garbage, not written by a received package)
+            ++result.numConcealed;
+            continue;
+        }
+        lastPlayedIndex = index;
+        ++result.numPlayed;
+        result.latencies.push_back(nextTick - trace[index].arrivalTime);
+    }
+    return result;
+}
+
+template<typename T>
+static T percentile(std::vector<T>& values, const double percent)
+{
+    if(values.empty())
+    {
+        return T();
+    }
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, (std::size_t)(values.size() * percent / 100))];
+}
+
+template<typename T>
+static double mean(const std::vector<T>& values)
+{
+    double sum = 0;
+    for(const T value : values)
+    {
+        sum += value;
+    }
+    return values.empty() ? 0 : sum / values.size();
+}
+
+static void printResult(const std::string& name, SimulationResult& result)
+{
+    std::cout << name << ":" << std::endl;
+    std::cout << "\tPackages received: " << result.numReceived << ", played: " << result.numPlayed << " (" << result.numOverflows << " overflows)" << std::endl;
+    std::cout << "\tlate-loss rate: " << (result.numReceived == 0 ? 0 : 100.0 * (result.numReceived - result.numPlayed) / result.numReceived) << " %" << std::endl;
+    std::cout << "\tconcealment ratio: " << (result.numReads == 0 ? 0 : 100.0 * result.numConcealed / result.numReads) << " %" << std::endl;
+    std::cout << "\tadded latency mean: " << mean(result.latencies) << " ms" << std::endl;
+    std::cout << "\tadded latency 95th percentile: " << percentile(result.latencies, 95) << " ms" << std::endl;
+    std::cout << "\tadded latency maximum: " << percentile(result.latencies, 100) << " ms" << std::endl;
+    std::cout << "\taddPackage mean: " << mean(result.addDurations) << " ns, 99th percentile: " << percentile(result.addDurations, 99) << " ns" << std::endl;
+    std::cout << "\treadPackage mean: " << mean(result.readDurations) << " ns, 99th percentile: " << percentile(result.readDurations, 99) << " ns" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    std::map<std::string, double> options = {
+        {"duration", 60}, {"packet", 20}, {"delay", 20}, {"jitter", 10}, {"reorder", 0}, {"loss", 0}, {"burst", 1}, {"skew", 0}, {"seed", 42},
+        {"capacity", 128}, {"maxdelay", 200}, {"minpackages", 1}, {"quantile", 0}
+    };
+    std::string bufferType = "all";
+    std::string traceFile;
+    for(int i = 1; i < argc; ++i)
+    {
+        const std::string arg(argv[i]);
+        const std::size_t separator = arg.find('=');
+        const std::string key = arg.substr(0, separator);
+        const std::string value = separator == std::string::npos ? "" : arg.substr(separator + 1);
+        if(key == "buffer")
+            bufferType = value;
+        else if(key == "trace")
+            traceFile = value;
+        else if(options.find(key) != options.end() && !value.empty())
+            options[key] = std::stod(value);
+        else
+        {
+            std::cerr << "Invalid option: " << arg << std::endl;
+            return 1;
+        }
+    }
+    if(options["packet"] <= 0 || options["capacity"] < 1)
+    {
+        std::cerr << "Packet-interval and capacity must be positive!" << std::endl;
+        return 1;
+    }
+
+    const std::vector<TraceEntry> trace = traceFile.empty() ? generateTrace(options) : readTrace(traceFile);
+    if(trace.empty())
+    {
+        std::cerr << "Trace is empty!" << std::endl;
+        return 1;
+    }
+    std::cout << "Simulating " << trace.size() << " packages (" << (trace.size() * options["packet"] / 1000) << " s)" << std::endl;
+
+    BufferClock::setTimeSource(&getVirtualTime);
+    const std::vector<std::string> types = bufferType == "all" ? std::vector<std::string>{"rtp", "lockfree", "alternative"} : std::vector<std::string>{bufferType};
+    for(const std::string& type : types)
+    {
+        std::unique_ptr<RTPBufferHandler> buffer = createBuffer(type, options);
+        SimulationResult result = simulate(*buffer, trace, options["packet"], options["capacity"] * options["packet"]);
+        printResult(type, result);
+    }
+    BufferClock::setTimeSource(nullptr);
+    return 0;
+}
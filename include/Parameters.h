@@ -158,6 +158,17 @@ namespace ohmcomm
         static const Parameter* PROFILE_PROCESSORS;
         static const Parameter* ENABLE_DTX;
         static const Parameter* ENABLE_FEC;
+        static const Parameter* LOCK_FREE_BUFFER;
+        static const Parameter* PLAYOUT_QUANTILE;
+        static const Parameter* JITTER_BUFFER_CAPACITY;
+        static const Parameter* JITTER_BUFFER_MAX_DELAY;
+        static const Parameter* JITTER_BUFFER_MIN_PACKAGES;
+        static const Parameter* RTCP_MUX;
+        static const Parameter* SOCKET_RECEIVE_BUFFER;
+        static const Parameter* SOCKET_SEND_BUFFER;
+        static const Parameter* DSCP;
+        static const Parameter* SOCKET_PRIORITY;
+        static const Parameter* BUSY_POLL;
 
         static const Parameter* USER_LOCAL_DEVICE;
         static const Parameter* USER_EMAIL;
@@ -8,7 +8,10 @@
 #ifndef STATISTICS_H
 #define	STATISTICS_H
 
+#include <array>
+#include <atomic>
 #include <iostream>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -44,10 +47,18 @@ namespace ohmcomm
         static constexpr int RTCP_PACKAGES_RECEIVED{17};
         static constexpr int RTCP_BYTES_SENT{18};
         static constexpr int RTCP_BYTES_RECEIVED{19};
+        static constexpr int RTP_BUFFER_FRAMES_DROPPED{20};
+        static constexpr int RTP_BUFFER_FRAMES_INSERTED{21};
+        static constexpr int RTP_SEND_QUEUE_MAXIMUM_DEPTH{22};
+        static constexpr int RTP_SEND_QUEUE_DROPPED{23};
+        static constexpr int SOCKET_RECEIVE_DROPPED{24};
 
         /*!
          * Increments the given counter by the value provided
          *
+         * The increments are counted per thread and summed up on reading the counter, so the threads (e.g. the workers of a MediaWorkerPool)
+         * don't contend for the same counters
+         *
          * \param counterIndex The key of the counter to increment
          *
          * \param byValue The value to increment by, defaults to 1
@@ -72,6 +83,13 @@ namespace ohmcomm
          */
         static void maxCounter(int counterIndex, long newValue);
 
+        /*!
+         * \param counterIndex The key to the counter
+         *
+         * \return the current value of the given counter
+         */
+        static long readCounter(int counterIndex);
+
         /*!
          * Prints some general statistical information
          * 
@@ -105,15 +123,46 @@ namespace ohmcomm
         
         /*!
          * Resets all counters and removes all registered profilers
+         *
+         * NOTE: Increments made concurrently by other threads may get lost
          */
         static void resetStatistics();
 
     private:
 
-        static long counters[20];
+        //the number of counters, must be larger than the highest counter-index
+        static constexpr int NUM_COUNTERS{25};
+
+        /*!
+         * The counters incremented by a single thread. The shard of an exiting thread is added to the global counters
+         */
+        struct alignas(64) CounterShard
+        {
+            //only written by the owning thread, atomic to be read by the other threads
+            std::atomic<long> counters[NUM_COUNTERS];
+
+            CounterShard();
+            ~CounterShard();
+        };
+
+        //the counters set directly and the increments of the exited threads
+        static std::atomic<long> counters[NUM_COUNTERS];
+        //guards the list of shards, but not their counters
+        static std::mutex shardsMutex;
+        static std::vector<CounterShard*> shards;
 
         static std::vector<ProfilingAudioProcessor*> audioProcessorStatistics;
 
+        /*!
+         * \return the counter-shard of the calling thread
+         */
+        static CounterShard& getLocalShard();
+
+        /*!
+         * \return the current values of all counters, summed up over all threads
+         */
+        static std::array<long, NUM_COUNTERS> readCounters();
+
         /*!
          * Internal helper-method to print audio-processor profiling results to given output-stream
          */
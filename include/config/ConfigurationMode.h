@@ -64,10 +64,17 @@ namespace ohmcomm
         const NetworkConfiguration getNetworkConfiguration() const;
 
         /*!
+         * If RTP and RTCP are multiplexed on a single port (RFC 5761), the local port equals the local port for RTP
+         *
          * \return the configured NetworkConfiguration for the RTCP-port
          */
         virtual const NetworkConfiguration getRTCPNetworkConfiguration() const;
 
+        /*!
+         * \return the configured options for the RTP-socket, the default values for all options not configured
+         */
+        const SocketOptions getSocketOptions() const;
+
         /*!
          * \return a pair containing (first) all configured processor-names and (second) a flag whether to profile the processors
          */
@@ -8,6 +8,8 @@
 #ifndef INTERACTIVECONFIGURATION_H
 #define	INTERACTIVECONFIGURATION_H
 
+#include <map>
+
 #include "ConfigurationMode.h"
 #include "UserInput.h"
 #include "audio/AudioHandler.h"
@@ -17,6 +19,9 @@ namespace ohmcomm
 
     /*!
      * Configuration utilizing UserInput to ask the user for settings
+     *
+     * The answers to custom configuration-values are remembered, so the user is asked only once for every key
+     * (e.g. when several processors or several instances of the same processor query the same value)
      */
     class InteractiveConfiguration : public ConfigurationMode
     {
@@ -33,6 +38,10 @@ namespace ohmcomm
         bool isCustomConfigurationSet(const std::string key, const std::string message) const override;
 
     private:
+        //the answers given for the custom configuration-keys
+        mutable std::map<std::string, std::string> customConfig;
+        //the answers given for whether custom configuration-keys are set
+        mutable std::map<std::string, bool> customConfigSet;
 
         void interactivelyConfigureAudioDevices(std::unique_ptr<AudioHandler>&& handler);
         void interactivelyConfigureNetwork();
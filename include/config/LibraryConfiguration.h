@@ -47,6 +47,13 @@ namespace ohmcomm
          */
         void configureNetwork(const NetworkConfiguration& networkConfig);
 
+        /*!
+         * (Optional) Configures the options of the RTP-socket for the LIBRARY configuration-mode
+         *
+         * \param socketOptions The socket-options to use, all options with their default values are not set
+         */
+        void configureSocketOptions(const SocketOptions& socketOptions);
+
         /*!
          * Configures the audio-processors for the LIBRARY configuration-mode
          *
@@ -30,6 +30,31 @@ namespace ohmcomm
         //Remote port
         unsigned short remotePort;
     };
+
+    /*!
+     * Options for the buffers and the quality of service of a socket, the default values keep the settings of the system
+     */
+    struct SocketOptions
+    {
+        //the DSCP "Expedited Forwarding" (RFC 3246), recommended for real-time audio (RFC 4594)
+        static const int DSCP_EXPEDITED_FORWARDING = 46;
+
+        //the size (in bytes) of the kernel receive-buffer, 0 for the system default
+        int receiveBufferSize = 0;
+        //the size (in bytes) of the kernel send-buffer, 0 for the system default
+        int sendBufferSize = 0;
+        //the differentiated services code point to mark the packages sent with (IP_TOS/IPV6_TCLASS), -1 to not mark them
+        int dscp = -1;
+        //the priority of the packages sent in the local queues (SO_PRIORITY, Linux only), -1 for the system default
+        int priority = -1;
+        //the time (in microseconds) to busy-poll the device for packages before blocking (SO_BUSY_POLL, Linux only), 0 to not poll
+        int busyPollMicroseconds = 0;
+
+        inline bool isDefault() const
+        {
+            return receiveBufferSize == 0 && sendBufferSize == 0 && dscp < 0 && priority < 0 && busyPollMicroseconds == 0;
+        }
+    };
     
     //Container for modes of playback
     enum PlaybackMode : unsigned char
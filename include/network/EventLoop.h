@@ -0,0 +1,152 @@
+/*
+ * File:   EventLoop.h
+ */
+
+#ifndef EVENTLOOP_H
+#define	EVENTLOOP_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace ohmcomm
+{
+    namespace network
+    {
+
+        /*!
+         * Event-loop multiplexing the sockets and timers of several sessions (e.g. RTP, RTCP and SIP) onto a single thread.
+         *
+         * The sockets are watched with epoll, the loop is woken up via an eventfd, so it can be shut down immediately
+         * instead of waiting for a receive-timeout. Timers are handled by the timeout of the wait.
+         *
+         * All callbacks of a loop are executed in its thread (one at a time), so they must not block.
+         * After removeSocket() or cancelTimer() returns, the callback is not executed anymore.
+         * Since this waits for the callback currently executed, a callback must never add or remove the sockets and timers of another loop,
+         * which may in turn wait for this loop. Thus, all sockets and timers of a session are added to the same loop.
+         *
+         * The loops returned by getSharedLoop() form a small fixed pool shared by all sessions.
+         *
+         * NOTE: Only supported on Linux, see isSupported(). Otherwise, the components keep running their own threads
+         */
+        class EventLoop
+        {
+        public:
+            typedef std::function<void()> Callback;
+            typedef uint64_t TimerID;
+
+            //the number of loops (and threads) in the shared pool
+            static constexpr unsigned int SHARED_LOOPS{2};
+
+            EventLoop();
+            ~EventLoop();
+
+            /*!
+             * \return whether event-loops are supported on this platform
+             */
+            static bool isSupported();
+
+            /*!
+             * Returns one of the shared event-loops, which are assigned round-robin and started on first use
+             *
+             * \return a running event-loop
+             */
+            static EventLoop& getSharedLoop();
+
+            /*!
+             * Starts the thread running the loop
+             */
+            void startUp();
+
+            /*!
+             * Stops the loop and waits for its thread to finish
+             */
+            void shutdown();
+
+            /*!
+             * \return whether the loop is running
+             */
+            bool isRunning() const;
+
+            /*!
+             * Adds the socket to the watched sockets. The socket is set to non-blocking mode.
+             *
+             * \param socket The socket-descriptor
+             * \param onReadable The callback executed every time data can be read from the socket
+             *
+             * \return whether the socket was added
+             */
+            bool addSocket(const int socket, const Callback& onReadable);
+
+            /*!
+             * Stops watching the socket. This method must be called before the socket is closed
+             */
+            void removeSocket(const int socket);
+
+            /*!
+             * Adds a new timer
+             *
+             * \param interval The time until the (first) expiration
+             * \param onExpired The callback executed on expiration
+             * \param repeat Whether the timer is re-armed with the same interval after it expired
+             *
+             * \return the ID of the new timer, to be used to cancel it
+             */
+            TimerID addTimer(const std::chrono::milliseconds interval, const Callback& onExpired, const bool repeat = true);
+
+            /*!
+             * Cancels the timer, if it has not already expired
+             */
+            void cancelTimer(const TimerID timer);
+
+        private:
+            //the maximum number of events handled per wait
+            static constexpr int MAX_EVENTS{32};
+
+            struct Timer
+            {
+                std::chrono::steady_clock::time_point expiration;
+                std::chrono::milliseconds interval;
+                bool repeat;
+                Callback callback;
+            };
+
+            int pollDescriptor;
+            int wakeupDescriptor;
+            std::thread loopThread;
+            std::atomic<bool> loopRunning;
+            //guards the sockets and timers and is held while executing callbacks.
+            //Recursive, so callbacks can remove themselves
+            std::recursive_mutex dispatchMutex;
+            std::map<int, Callback> sockets;
+            std::map<TimerID, Timer> timers;
+            TimerID nextTimerID;
+
+            /*!
+             * Method called in the parallel thread, waiting for and dispatching events
+             */
+            void runLoop();
+
+            /*!
+             * Interrupts the current wait, e.g. to re-calculate the timeout
+             */
+            void wakeUp();
+
+            /*!
+             * \return the time (in milliseconds) to wait until the next timer expires, -1 to wait infinitely
+             */
+            int getWaitTimeout();
+
+            /*!
+             * Executes the callbacks of all expired timers
+             */
+            void handleTimers();
+        };
+    }
+}
+#endif	/* EVENTLOOP_H */
+
@@ -0,0 +1,123 @@
+/*
+ * File:   IOUringUDPWrapper.h
+ */
+#ifdef IO_URING_HEADER  //Only compile, if io_uring is enabled
+#ifndef IOURINGUDPWRAPPER_H
+#define	IOURINGUDPWRAPPER_H
+
+#include <mutex>
+#include <vector>
+
+#include IO_URING_HEADER
+#include "UDPWrapper.h"
+
+namespace ohmcomm
+{
+    namespace network
+    {
+
+        /*!
+         * UDPWrapper receiving the packages via io_uring instead of a system-call per batch (see https://kernel.dk/io_uring.pdf).
+         *
+         * A single multishot receive-request is kept armed on the socket, the kernel writes every package into one of the buffers
+         * registered with the ring (provided buffer-ring) and posts a completion. The completions are read from memory shared with the kernel,
+         * so as long as packages arrive, receiveData() takes them without any system-call. Only if no completion is available,
+         * a single io_uring_enter() waits for the next completion. The receive-request only needs to be submitted again,
+         * if the kernel ran out of buffers.
+         *
+         * The descriptor returned by getSocketDescriptor() is the descriptor of the ring, which is readable while completions are available,
+         * so the wrapper can be watched by an EventLoop like a socket.
+         *
+         * Packages are sent via the socket, since a single UDP-package is sent synchronously anyway.
+         *
+         * If the ring can't be set up (e.g. the kernel is older than 6.0 or io_uring is disabled), the wrapper falls back to the socket,
+         * like the UDPWrapper.
+         */
+        class IOUringUDPWrapper : public UDPWrapper
+        {
+        public:
+            //the number of buffers registered with the ring, the maximum number of packages received and not yet read
+            static constexpr unsigned int NUM_BUFFERS{128};
+            //the maximum size of a single package received
+            static constexpr unsigned int MAX_PACKAGE_SIZE{8192};
+
+            IOUringUDPWrapper(const NetworkConfiguration& networkConfig);
+            ~IOUringUDPWrapper();
+
+            Package receiveData(void *buffer, unsigned int bufferSize = 0) override;
+            unsigned int receiveData(void* const* buffers, const unsigned int bufferSize, Package* packages, const unsigned int numBuffers) override;
+
+            void closeNetwork() override;
+
+            /*!
+             * \return the descriptor of the ring or of the socket, if io_uring is not used
+             */
+            int getSocketDescriptor() const override;
+
+            /*!
+             * \return whether the packages are received via io_uring
+             */
+            bool isRingActive() const;
+
+        private:
+            //the user-data of the receive-request, to tell its completions apart from others (e.g. of cancel-requests)
+            static constexpr uint64_t RECEIVE_REQUEST{1};
+            //the ID of the group of provided buffers
+            static constexpr uint16_t BUFFER_GROUP{0};
+            //the space reserved in every buffer for the header, the sender-address and the ancillary data in front of the package
+            static constexpr unsigned int BUFFER_HEADER_SIZE{sizeof(io_uring_recvmsg_out) + sizeof(sockaddr_in6) + CONTROL_BUFFER_SIZE};
+
+            int ringDescriptor;
+            //the memory shared with the kernel
+            void* submissionRing;
+            size_t submissionRingSize;
+            void* completionRing;
+            size_t completionRingSize;
+            io_uring_sqe* submissionEntries;
+            io_uring_params parameters;
+            io_uring_buf_ring* bufferRing;
+            std::vector<char> buffers;
+            //the message-header the kernel copies the lengths of the sender-address and the ancillary data from, for every package
+            msghdr receiveMessage;
+            //only accessed by the receiving thread
+            bool isReceiveArmed;
+            //guards the submission-queue, which is filled by the receiving thread and by closeNetwork()
+            std::mutex submissionMutex;
+
+            bool setUpRing();
+            void tearDownRing();
+
+            /*!
+             * Adds the request to the submission-queue and submits it, the submission-mutex must be locked
+             *
+             * \return whether the request was submitted
+             */
+            bool submit(const io_uring_sqe& entry);
+
+            /*!
+             * Submits the multishot receive-request, the submission-mutex must be locked
+             */
+            bool armReceive();
+
+            /*!
+             * Waits up to the given timeout for the next completion
+             *
+             * \return the result of io_uring_enter(), the negative error-code on failure
+             */
+            int waitForCompletion(const std::chrono::milliseconds timeout);
+
+            /*!
+             * Returns the buffer with the given ID to the kernel
+             */
+            void recycleBuffer(const uint16_t bufferID);
+
+            /*!
+             * \return the start of the buffer with the given ID
+             */
+            char* getBuffer(const uint16_t bufferID);
+        };
+    }
+}
+
+#endif	/* IOURINGUDPWRAPPER_H */
+#endif
@@ -8,6 +8,7 @@
 #ifndef MULTICASTNETWORKWRAPPER_H
 #define	MULTICASTNETWORKWRAPPER_H
 
+#include <mutex>
 #include <string>
 #include <vector>
 #include <utility>
@@ -15,6 +16,10 @@
 #include "configuration.h"
 #include "UDPWrapper.h"
 
+#ifdef __linux__
+#include <sys/uio.h>    //iovec
+#endif
+
 namespace ohmcomm
 {
 
@@ -23,10 +28,47 @@ namespace ohmcomm
 
         /*!
          * UDP-based network-wrapper sending packages to multiple destinations
+         *
+         * On Linux, a package is sent to all destinations with a single sendmmsg() call.
+         * The message-headers for the destinations are only rebuilt when the list of destinations changes.
+         *
+         * If the initial destination is an IP multicast-group, the group can be joined (see joinGroup()).
+         * Then a single package sent to the group reaches all members, instead of replicating it for every destination.
          */
         class MulticastNetworkWrapper : public UDPWrapper
         {
         public:
+
+            /*!
+             * Statistics about the packages sent to a single destination
+             */
+            struct DestinationStatistics
+            {
+                SocketAddress address;
+                //the number of packages successfully sent
+                unsigned long packagesSent;
+                //the number of bytes successfully sent
+                unsigned long bytesSent;
+                //the number of packages failed to send
+                unsigned long errors;
+            };
+
+            /*!
+             * Settings for joining an IP multicast-group
+             */
+            struct GroupConfiguration
+            {
+                //the TTL (IPv4) or hop-limit (IPv6) of the packages sent, 1 keeps them within the local network
+                unsigned char timeToLive;
+                //whether packages sent to the group are also delivered to the members on the local host
+                bool loopback;
+                //the index of the network-interface to join the group on and send from, 0 for the default interface
+                unsigned int interfaceIndex;
+            };
+
+            //by default, stay within the local network and allow several members on the same host
+            static constexpr GroupConfiguration DEFAULT_GROUP_CONFIGURATION{1, true, 0};
+
             MulticastNetworkWrapper(const NetworkConfiguration& initialDestination);
 
             virtual ~MulticastNetworkWrapper()
@@ -35,6 +77,9 @@ namespace ohmcomm
             }
 
             int sendData(const void* buffer, const unsigned int bufferSize) override;
+            int sendData(const BufferSegment* segments, const unsigned int numSegments) override;
+
+            void closeNetwork() override;
 
             /*!
              * Adds a new remote address as destination sending packages
@@ -58,9 +103,58 @@ namespace ohmcomm
              */
             bool removeDestination(const std::string& destinationAddress, const unsigned short destinationPort = DEFAULT_NETWORK_PORT);
 
+            /*!
+             * Joins the multicast-group specified as initial destination, so packages sent to the group are received by this socket.
+             *
+             * NOTE: To receive the packages of the other members, the local port must equal the port of the group
+             *
+             * \param groupConfig The settings for the group-membership and the packages sent
+             *
+             * \return whether the group was joined, false if the initial destination is no multicast-address or on any error
+             */
+            bool joinGroup(const GroupConfiguration& groupConfig = DEFAULT_GROUP_CONFIGURATION);
+
+            /*!
+             * Leaves the multicast-group, if it was joined
+             */
+            void leaveGroup();
+
+            /*!
+             * \return whether this wrapper is currently member of a multicast-group
+             */
+            bool isGroupJoined() const;
+
+            /*!
+             * \return a copy of the statistics for all current destinations, in the order they were added
+             */
+            std::vector<DestinationStatistics> getDestinationStatistics() const;
+
         private:
-            //a list of destination-addresses
-            std::vector<SocketAddress> destinations;
+            //a list of destination-addresses with their statistics
+            std::vector<DestinationStatistics> destinations;
+            //the multicast-group joined, only valid if groupJoined is set
+            SocketAddress groupAddress;
+            unsigned int groupInterface;
+            bool groupJoined;
+            //guards the destinations and shared message-headers, since RTP and (multiplexed) RTCP are sent from different threads
+            //and the destinations may be changed while sending
+            mutable std::mutex sendMutex;
+#ifdef __linux__
+            //the message-headers passed to sendmmsg(), one per destination
+            std::vector<mmsghdr> messages;
+            //the segments of the package, shared by all messages
+            iovec packageBuffers[MAX_BUFFER_SEGMENTS];
+
+            /*!
+             * Rebuilds the message-headers from the list of destinations, the send-mutex must be locked
+             */
+            void updateMessages();
+#endif
+
+            /*!
+             * \return the position of the given address in the list of destinations or destinations.end(), the send-mutex must be locked
+             */
+            std::vector<DestinationStatistics>::iterator findDestination(const SocketAddress& address);
         };
     }
 }
@@ -0,0 +1,244 @@
+/*
+ * File:   NetworkEmulator.h
+ */
+
+#ifndef NETWORKEMULATOR_H
+#define	NETWORKEMULATOR_H
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "NetworkWrapper.h"
+#include "configuration.h"
+
+namespace ohmcomm
+{
+    namespace network
+    {
+
+        /*!
+         * The distribution of the additional delay (jitter) of the packages
+         */
+        enum class DelayDistribution
+        {
+            //every package is delayed by the jitter
+            CONSTANT,
+            //uniformly distributed between zero and twice the jitter
+            UNIFORM,
+            //normally distributed with the jitter as mean and standard deviation, truncated at zero
+            NORMAL,
+            //exponentially distributed with the jitter as mean
+            EXPONENTIAL,
+            //pareto-distributed (shape 1.5) with the jitter as mean, a heavy tail of very late packages
+            PARETO
+        };
+
+        /*!
+         * The impairments applied by the NetworkEmulator to all packages sent by an endpoint
+         */
+        struct NetworkImpairments
+        {
+            //the minimum delay of every package
+            std::chrono::microseconds delay{0};
+            //the mean additional delay, see the distribution
+            std::chrono::microseconds jitter{0};
+            DelayDistribution distribution = DelayDistribution::CONSTANT;
+            //the probability of a package to be sent without the (additional) delay, overtaking the previous packages
+            double reorderProbability = 0;
+            //the Gilbert-Elliott loss-model: the probability to change into the bad state after a package and back into the good state
+            double goodToBadProbability = 0;
+            double badToGoodProbability = 1;
+            //the probability of a package to be lost in the good and in the bad state
+            double lossInGood = 0;
+            double lossInBad = 1;
+            //the probability of a package to be delivered twice, each copy with its own delay
+            double duplicateProbability = 0;
+            //the bandwidth in bits per second, 0 for no limit. Packages exceeding the bandwidth are queued
+            uint64_t bandwidth = 0;
+
+            /*!
+             * Sets up the Gilbert-Elliott model to lose packages in bursts, every package of a burst is lost
+             *
+             * \param lossRate The average ratio of lost packages
+             * \param burstLength The average number of packages lost in a row
+             */
+            void setBurstLoss(const double lossRate, const double burstLength);
+        };
+
+        /*!
+         * An in-memory network of emulated endpoints, for deterministic tests and benchmarks without real sockets.
+         *
+         * Every endpoint is a NetworkWrapper identified by its local address, the packages sent are delivered to the endpoint
+         * with the remote address of the sender after the delay and loss determined by the impairments of the sender.
+         * Packages to unknown addresses are dropped, like UDP does.
+         *
+         * The network runs either on the real (steady) clock or on a virtual clock, which is only advanced by calls to advanceTime(),
+         * so any number of packages can be sent and received faster than real-time. The reception-time of the packages received
+         * is the time of the clock of the network, so the jitter-buffers see the emulated delays (see rtp::BufferClock to run the buffers on the virtual clock).
+         *
+         * All random decisions are made by a generator per endpoint seeded from the seed of the network, so runs with the same seed
+         * and the same sequence of packages are reproducible.
+         */
+        class NetworkEmulator : public std::enable_shared_from_this<NetworkEmulator>
+        {
+        public:
+            //the default time to block in receiveData() waiting for a package
+            static constexpr std::chrono::milliseconds DEFAULT_RECEIVE_TIMEOUT{1000};
+
+            /*!
+             * A single endpoint of the emulated network
+             */
+            class Endpoint : public NetworkWrapper
+            {
+            public:
+                ~Endpoint();
+
+                int sendData(const void* buffer, const unsigned int bufferSize) override;
+                int sendData(const BufferSegment* segments, const unsigned int numSegments) override;
+                Package receiveData(void* buffer, unsigned int bufferSize) override;
+
+                /*!
+                 * Receives all packages already delivered, waits for the first package up to the receive-timeout of the network
+                 */
+                unsigned int receiveData(void* const* buffers, const unsigned int bufferSize, Package* packages, const unsigned int numBuffers) override;
+                std::wstring getLastError() const override;
+
+                /*!
+                 * Removes the endpoint from the network, all packages queued for it are dropped
+                 */
+                void closeNetwork() override;
+
+                /*!
+                 * Sets the impairments for all packages sent afterwards by this endpoint
+                 */
+                void setImpairments(const NetworkImpairments& impairments);
+
+                /*!
+                 * \return the local address of this endpoint
+                 */
+                const SocketAddress& getLocalAddress() const;
+
+                /*!
+                 * \return the number of packages queued for this endpoint, which are not yet received
+                 */
+                unsigned int getNumberOfQueuedPackages() const;
+
+            private:
+                //a package on its way to this endpoint
+                struct QueuedPackage
+                {
+                    std::chrono::steady_clock::time_point deliveryTime;
+                    //the order of sending, to keep the order of packages delivered at the same time
+                    uint64_t sequence;
+                    SocketAddress sender;
+                    std::vector<char> data;
+
+                    inline bool operator>(const QueuedPackage& other) const
+                    {
+                        return deliveryTime > other.deliveryTime || (deliveryTime == other.deliveryTime && sequence > other.sequence);
+                    }
+                };
+
+                const std::shared_ptr<NetworkEmulator> network;
+                const SocketAddress localAddress;
+                const SocketAddress remoteAddress;
+                //all members below are guarded by the mutex of the network
+                NetworkImpairments impairments;
+                std::mt19937 random;
+                bool isInBadState;
+                //the time the last package sent leaves the (bandwidth-limited) link
+                std::chrono::steady_clock::time_point linkBusyUntil;
+                std::priority_queue<QueuedPackage, std::vector<QueuedPackage>, std::greater<QueuedPackage>> queue;
+                bool isOpen;
+
+                Endpoint(const std::shared_ptr<NetworkEmulator> network, const SocketAddress& localAddress, const SocketAddress& remoteAddress,
+                         const NetworkImpairments& impairments, const uint32_t seed);
+
+                /*!
+                 * Determines whether the next package is lost, according to the Gilbert-Elliott model
+                 */
+                bool isPackageLost();
+
+                /*!
+                 * \return the delay of the next package
+                 */
+                std::chrono::microseconds getPackageDelay();
+
+                friend class NetworkEmulator;
+            };
+
+            /*!
+             * Creates a new network without any endpoints
+             *
+             * \param virtualTime Whether to run on a virtual clock (see advanceTime()) instead of the steady clock
+             * \param seed The seed for the random decisions of all endpoints
+             * \param receiveTimeout The maximum (real) time to block in receiveData(), zero to never block
+             */
+            static std::shared_ptr<NetworkEmulator> create(const bool virtualTime = false, const uint32_t seed = 42,
+                                                           const std::chrono::milliseconds receiveTimeout = DEFAULT_RECEIVE_TIMEOUT);
+
+            /*!
+             * Adds a new endpoint to the network
+             *
+             * \param networkConfig The local port and the remote address and port of the endpoint
+             * \param impairments The impairments for the packages sent by the endpoint
+             * \param localIPAddress The local address of the endpoint, must be of the same address-family as the remote
+             *
+             * \return the new endpoint
+             */
+            std::shared_ptr<Endpoint> createEndpoint(const NetworkConfiguration& networkConfig, const NetworkImpairments& impairments = NetworkImpairments{},
+                                                     const std::string& localIPAddress = "127.0.0.1");
+
+            /*!
+             * \return the current time of the clock of the network
+             */
+            std::chrono::steady_clock::time_point now() const;
+
+            /*!
+             * Advances the virtual clock and wakes up all endpoints waiting for packages delivered in the meantime.
+             *
+             * NOTE: Has no effect on a network running on the real clock
+             */
+            void advanceTime(const std::chrono::microseconds duration);
+
+            /*!
+             * \return whether the network runs on a virtual clock
+             */
+            bool isVirtualTime() const;
+
+        private:
+            const bool virtualTime;
+            const uint32_t seed;
+            const std::chrono::milliseconds receiveTimeout;
+            //guards all endpoints and the virtual clock
+            mutable std::mutex networkMutex;
+            //notified on every package sent, on advancing the virtual clock and on closing an endpoint
+            std::condition_variable packagesChanged;
+            std::chrono::steady_clock::time_point virtualNow;
+            std::vector<Endpoint*> endpoints;
+            uint64_t nextSequence;
+
+            NetworkEmulator(const bool virtualTime, const uint32_t seed, const std::chrono::milliseconds receiveTimeout);
+
+            /*!
+             * \return the current time, the network-mutex must be locked
+             */
+            std::chrono::steady_clock::time_point getTime() const;
+
+            /*!
+             * Queues the package sent by the given endpoint at the receiving endpoint, the network-mutex must be locked
+             */
+            void deliverPackage(Endpoint& sender, const NetworkWrapper::BufferSegment* segments, const unsigned int numSegments);
+
+            void removeEndpoint(Endpoint* endpoint);
+        };
+    }
+}
+
+#endif	/* NETWORKEMULATOR_H */
+
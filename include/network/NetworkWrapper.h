@@ -1,11 +1,15 @@
 #ifndef NETWORKWRAPPER_H
 #define	NETWORKWRAPPER_H
 
+#include <chrono>
 #include <iostream>
+#include <stdint.h>
 #include <string>
 #include <string.h> //for strerror
+#include <vector>
 
 #include "SocketAddress.h"
+#include "configuration.h"
 
 namespace ohmcomm
 {
@@ -31,6 +35,8 @@ namespace ohmcomm
                 SocketAddress address;
                 //error-code or package-size
                 int status;
+                //the time the package was received, as reported by the kernel if supported
+                std::chrono::steady_clock::time_point receptionTime;
 
                 /*!
                  * \return whether the call to receiveData() has timed out
@@ -51,6 +57,20 @@ namespace ohmcomm
                 }
             };
 
+            /*!
+             * A single part of a package to be sent, e.g. the header or the payload
+             */
+            struct BufferSegment
+            {
+                const void* data;
+                unsigned int size;
+            };
+
+            //the maximum number of segments the implementations send without joining them
+            static constexpr unsigned int MAX_BUFFER_SEGMENTS{4};
+            //the maximum number of packages received with a single call
+            static constexpr unsigned int MAX_RECEIVE_BATCH{16};
+
             virtual ~NetworkWrapper()
             {
                 //needs a virtual destructor to be overridden correctly
@@ -65,6 +85,20 @@ namespace ohmcomm
              */
             virtual int sendData(const void *buffer, const unsigned int bufferSize) = 0;
 
+            /*!
+             * Sends the given segments as a single package (scatter-gather), so the caller does not need to join them.
+             *
+             * The default implementation copies the segments into a single buffer, implementations supporting
+             * scatter-gather I/O (e.g. sendmsg()) should override this method.
+             *
+             * \param segments The parts of the package, in order
+             *
+             * \param numSegments The number of segments
+             *
+             * \return the number of bytes sent
+             */
+            virtual int sendData(const BufferSegment* segments, const unsigned int numSegments);
+
             /*!
              * In case of an error, this method returns INVALID_SOCKET. In case of a blocking-timeout, this method returns RECEIVE_TIMEOUT
              * 
@@ -76,6 +110,24 @@ namespace ohmcomm
              */
             virtual Package receiveData(void *buffer, unsigned int bufferSize) = 0;
 
+            /*!
+             * Receives several packages at once, blocks until at least one package is received (or the receive timed out).
+             *
+             * The default implementation receives a single package, implementations supporting batched I/O (e.g. recvmmsg())
+             * should override this method.
+             *
+             * \param buffers The buffers to receive into, one per package
+             *
+             * \param bufferSize The maximum number of bytes to receive into every buffer
+             *
+             * \param packages Information about the received packages, one per buffer
+             *
+             * \param numBuffers The number of buffers (and packages), at most MAX_RECEIVE_BATCH packages are received
+             *
+             * \return the number of packages received. If the call timed out or failed, 1 is returned and the first package holds the status
+             */
+            virtual unsigned int receiveData(void* const* buffers, const unsigned int bufferSize, Package* packages, const unsigned int numBuffers);
+
             /*!
              * Returns the last error code and a human-readable description
              */
@@ -86,6 +138,38 @@ namespace ohmcomm
              */
             virtual void closeNetwork() = 0;
 
+            /*!
+             * The socket can be watched by an EventLoop instead of blocking in receiveData().
+             *
+             * \return the descriptor of the underlying socket, INVALID_SOCKET if there is no socket (or it is closed)
+             */
+            virtual int getSocketDescriptor() const
+            {
+                return INVALID_SOCKET;
+            }
+
+            /*!
+             * Applies the options for the buffers and the quality of service to the underlying socket.
+             *
+             * The default implementation has no socket to apply the options to
+             *
+             * \return whether all options were applied
+             */
+            virtual bool setSocketOptions(const SocketOptions& options)
+            {
+                return options.isDefault();
+            }
+
+            /*!
+             * The kernel drops packages received while the receive-buffer of the socket is full.
+             *
+             * \return the total number of packages dropped so far, as far as already reported by the kernel, 0 if not supported
+             */
+            virtual uint32_t getNumberOfDroppedPackages() const
+            {
+                return 0;
+            }
+
         protected:
 
             // Defines OS-independant flag to close socket
@@ -101,6 +185,10 @@ namespace ohmcomm
              * \return whether the recv()-method has returned because of a timeout
              */
             bool hasTimedOut() const;
+
+        private:
+            //the buffer to join the segments into, only used by the default scatter-gather implementation
+            std::vector<char> gatherBuffer;
         };
     }
 }
@@ -50,6 +50,26 @@ namespace ohmcomm
              * Returns the IP-address and the port as several variables
              */
             std::pair<std::string, uint16_t> toAddressAndPort() const;
+
+            /*!
+             * \return the IP-address and port in a human-readable format, e.g. "127.0.0.1:12345" or "[::1]:12345"
+             */
+            std::string toString() const;
+
+            /*!
+             * \return whether this is an IPv4 (224.0.0.0/4) or IPv6 (ff00::/8) multicast-address
+             */
+            bool isMulticastAddress() const;
+
+            /*!
+             * \return whether both addresses have the same IP-version, IP-address and port
+             */
+            bool operator==(const SocketAddress& other) const;
+
+            inline bool operator!=(const SocketAddress& other) const
+            {
+                return !(*this == other);
+            }
             
             /*!
              * Creates a new SocketAddress from the given host-address and port
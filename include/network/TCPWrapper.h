@@ -7,6 +7,10 @@
 
 #ifndef TCPWRAPPER_H
 #define	TCPWRAPPER_H
+
+#include <atomic>
+#include <mutex>
+
 #include "configuration.h"
 #include "NetworkWrapper.h"
 
@@ -16,10 +20,22 @@ namespace ohmcomm
     {
         /*!
          * NetworkWrapper implementation using the TCP protocol
+         *
+         * Every package is framed with its length (RFC 4571), so the packages can be separated again on the receiving side.
+         * The received data is reassembled in a preallocated buffer, all complete packages received with a single call are returned as a batch.
+         *
+         * Packages are sent without delay (TCP_NODELAY) and without blocking: if the connection is congested, the remainder of a package
+         * partially sent is sent together with the next package. A package which would be queued behind such a remainder is dropped,
+         * since audio arriving late is useless and would only increase the latency of all following packages.
          */
         class TCPWrapper : public NetworkWrapper
         {
         public:
+            //the size of the length-field in front of every package (RFC 4571)
+            static constexpr unsigned int FRAME_HEADER_SIZE{2};
+            //the maximum size of a package, limited by the length-field
+            static constexpr unsigned int MAX_PACKAGE_SIZE{UINT16_MAX};
+
             TCPWrapper(unsigned short localPort, const std::string remoteIPAddress, unsigned short remotePort);
 
             TCPWrapper(const NetworkConfiguration& networkConfig);
@@ -27,14 +43,41 @@ namespace ohmcomm
             ~TCPWrapper();
 
             int sendData(const void *buffer, const unsigned int bufferSize = 0) override;
+
+            /*!
+             * Sends the segments as a single package, never blocks.
+             *
+             * \return the size of the package, 0 if the package was dropped since the connection is congested
+             */
+            int sendData(const BufferSegment* segments, const unsigned int numSegments) override;
             Package receiveData(void *buffer, unsigned int bufferSize = 0) override;
+            unsigned int receiveData(void* const* buffers, const unsigned int bufferSize, Package* packages, const unsigned int numBuffers) override;
 
             virtual void closeNetwork() override;
+
+            int getSocketDescriptor() const override;
+
+            /*!
+             * \return the number of packages not sent, since the connection was congested
+             */
+            uint32_t getNumberOfDroppedSends() const;
         private:
 
             int Socket;
             SocketAddress localAddress;
             SocketAddress remoteAddress;
+            //the data received, but not yet returned: the complete packages and the beginning of the next package
+            std::vector<char> receiveBuffer;
+            unsigned int receiveStart;
+            unsigned int receiveEnd;
+            //guards the remainder of the package partially sent, since RTP and RTCP are sent from different threads
+            std::mutex sendMutex;
+            //the remainder of the package partially sent, must be sent before any other package to keep the framing intact
+            std::vector<char> pendingBuffer;
+            unsigned int pendingStart;
+            unsigned int pendingEnd;
+            std::atomic<uint32_t> droppedSends;
+            bool isCongested;
 
             void startWinsock();
 
@@ -48,6 +91,13 @@ namespace ohmcomm
              * \returns the size of the socket-address depending on the IP-version used
              */
             int getSocketAddressLength();
+
+            /*!
+             * Takes the complete packages from the receive-buffer
+             *
+             * \return the number of packages taken
+             */
+            unsigned int readPackages(void* const* buffers, const unsigned int bufferSize, Package* packages, const unsigned int numBuffers);
         };
     }
 }
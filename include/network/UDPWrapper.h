@@ -1,6 +1,8 @@
 #ifndef UDPWRAPPER_H
 #define	UDPWRAPPER_H
 
+#include <atomic>
+
 #include "configuration.h"
 #include "NetworkWrapper.h"
 
@@ -19,16 +21,46 @@ namespace ohmcomm
 
             UDPWrapper(const NetworkConfiguration& networkConfig);
 
+            /*!
+             * \param reusePort Whether several sockets may bind the same local port (SO_REUSEPORT), the received packages are distributed among them
+             */
+            UDPWrapper(const NetworkConfiguration& networkConfig, const bool reusePort);
+
             ~UDPWrapper();
 
             int sendData(const void *buffer, const unsigned int bufferSize = 0) override;
+            int sendData(const BufferSegment* segments, const unsigned int numSegments) override;
             Package receiveData(void *buffer, unsigned int bufferSize = 0) override;
+            unsigned int receiveData(void* const* buffers, const unsigned int bufferSize, Package* packages, const unsigned int numBuffers) override;
 
             virtual void closeNetwork() override;
+
+            int getSocketDescriptor() const override;
+
+            /*!
+             * Sets the options on the socket, a buffer-size exceeding the system-limit (e.g. net.core.rmem_max) is capped by the kernel,
+             * unless the process is privileged to exceed it
+             */
+            bool setSocketOptions(const SocketOptions& options) override;
+
+            uint32_t getNumberOfDroppedPackages() const override;
+
+            /*!
+             * Sends the segments as a single package to the given destination instead of the configured remote address,
+             * e.g. if the socket is shared by several sessions
+             *
+             * \param destination The address to send to, must have the IP-version of the socket
+             *
+             * \return the number of bytes sent
+             */
+            int sendDataTo(const SocketAddress& destination, const BufferSegment* segments, const unsigned int numSegments);
         protected:
             int Socket;
             SocketAddress localAddress;
             SocketAddress remoteAddress;
+            bool reusePort;
+            //the counter of dropped packages last reported by the kernel (SO_RXQ_OVFL)
+            std::atomic<uint32_t> droppedPackages;
 
             void startWinsock();
 
@@ -42,6 +74,28 @@ namespace ohmcomm
              * \returns the size of the socket-address depending on the IP-version used
              */
             int getSocketAddressLength();
+
+#ifdef __linux__
+            //the size of the ancillary data received with every package: the kernel-timestamp and the counter of dropped packages
+            static constexpr unsigned int CONTROL_BUFFER_SIZE{CMSG_SPACE(sizeof(timespec)) + CMSG_SPACE(sizeof(uint32_t))};
+
+            /*!
+             * Reads the counter of dropped packages from the ancillary data of the message, if the kernel reported it
+             */
+            void readDroppedPackages(msghdr& message);
+
+            /*!
+             * Converts the kernel-timestamp (wall-clock) of the message into the steady clock, falls back to now, if the message has no timestamp
+             */
+            static std::chrono::steady_clock::time_point getReceptionTime(msghdr& message, const std::chrono::system_clock::time_point systemNow,
+                                                                          const std::chrono::steady_clock::time_point steadyNow);
+#endif
+
+        private:
+            /*!
+             * Sets a single socket-option of type int, logs a warning on failure
+             */
+            bool setSocketOption(const int level, const int option, const int value, const char* description);
         };
     }
 }
@@ -0,0 +1,88 @@
+/*
+ * File:   AudioMixer.h
+ */
+
+#ifndef AUDIOMIXER_H
+#define	AUDIOMIXER_H
+
+#include <cstdint>
+#include <vector>
+
+namespace ohmcomm
+{
+
+    /*!
+     * Mixes the decoded audio-data of several streams (e.g. the participants of a conference) into a single buffer.
+     *
+     * The samples of every stream are summed up in a wider accumulator, which is saturated into the output-format once per mix,
+     * so the cost of the mix grows linearly with the number of streams and the result does not depend on the order of the streams.
+     * On x86, the summing and saturation use SSE2.
+     *
+     * All memory is allocated on configuration, so mixing does not allocate anything in the audio-thread
+     */
+    class AudioMixer
+    {
+    public:
+        AudioMixer();
+
+        /*!
+         * Prepares the mixer for the given audio-format
+         *
+         * \param audioFormatFlag The audio-format, one of the AUDIO_FORMAT_XXX flags from AudioConfiguration
+         * \param maxBufferSize The maximum size of a single buffer, in bytes
+         *
+         * \return whether the audio-format is supported
+         */
+        bool configure(const unsigned int audioFormatFlag, const unsigned int maxBufferSize);
+
+        /*!
+         * \return whether the mixer was successfully configured
+         */
+        bool isConfigured() const;
+
+        /*!
+         * Starts a new mix, discarding all streams added so far
+         */
+        void startMix();
+
+        /*!
+         * Adds the audio-data of a single stream to the current mix
+         *
+         * \param buffer The decoded audio-data
+         * \param bufferSize The number of valid bytes in the buffer
+         */
+        void addStream(const void* buffer, const unsigned int bufferSize);
+
+        /*!
+         * \return the number of streams added to the current mix
+         */
+        unsigned int getNumberOfStreams() const;
+
+        /*!
+         * Writes the saturated sum of all streams added into the output-buffer.
+         *
+         * \param outputBuffer The buffer to write into
+         * \param maxBufferSize The size of the output-buffer, in bytes
+         *
+         * \return the number of bytes written
+         */
+        unsigned int writeMix(void* outputBuffer, const unsigned int maxBufferSize) const;
+
+    private:
+        unsigned int audioFormatFlag;
+        unsigned int sampleSize;
+        //the accumulated samples, only the one matching the audio-format is used
+        std::vector<int32_t> integerMix;
+        std::vector<float> floatMix;
+        //the number of valid samples in the current mix
+        unsigned int numSamples;
+        unsigned int numStreams;
+
+        void addSamples(const int16_t* samples, const unsigned int count);
+        void addSamples(const float* samples, const unsigned int count);
+        void writeSamples(int16_t* samples, const unsigned int count) const;
+        void writeSamples(float* samples, const unsigned int count) const;
+    };
+}
+#endif	/* AUDIOMIXER_H */
+
@@ -40,6 +40,39 @@ namespace ohmcomm
          * A silence-package has all samples set to a volume of zero
          */
         bool isSilentPackage;
+
+        //! The maximum size of the comfort-noise parameters: the noise-level and up to 10 reflection-coefficients
+        static constexpr unsigned int MAX_COMFORT_NOISE_SIZE{11};
+
+        /*!
+         * The parameters of the background-noise of a silent package, encoded as comfort-noise payload (see RFC 3389).
+         *
+         * On input, this is set by the comfort-noise generator, on output by the RTP-processor when receiving a comfort-noise package
+         */
+        uint8_t comfortNoise[MAX_COMFORT_NOISE_SIZE];
+
+        /*!
+         * The number of valid bytes in comfortNoise, zero if no comfort-noise is available
+         */
+        uint8_t comfortNoiseSize;
+
+        /*!
+         * On output, the number of streams (e.g. remote participants) the last processor in the chain provides audio-data for.
+         *
+         * If this is set to more than one stream, the ProcessorManager reads every stream separately (see streamIndex),
+         * decodes each with its own instance of the codec and mixes them
+         */
+        unsigned int numStreams;
+
+        /*!
+         * On output, the index of the stream to read, set by the ProcessorManager
+         */
+        unsigned int streamIndex;
+
+        /*!
+         * On output, the unique ID (e.g. the SSRC) of the stream read, used to keep the same codec-instance for every stream
+         */
+        uint32_t streamId;
     };
 
     /*!
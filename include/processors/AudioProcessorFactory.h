@@ -29,6 +29,8 @@ namespace ohmcomm
         static const std::string ILBC_CODEC;
         static const std::string GSM_CODEC;
         static const std::string AMR_CODEC;
+        static const std::string LOSS_CONCEALMENT;
+        static const std::string COMFORT_NOISE;
 
         /*!
          * Returns the AudioProcessor for the given name
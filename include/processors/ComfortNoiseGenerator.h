@@ -0,0 +1,114 @@
+/*
+ * File:   ComfortNoiseGenerator.h
+ */
+
+#ifndef COMFORTNOISEGENERATOR_H
+#define	COMFORTNOISEGENERATOR_H
+
+#include "processors/AudioProcessor.h"
+
+namespace ohmcomm
+{
+
+    /*!
+     * Audio-processor describing and re-synthesizing the background-noise of silent packages, as specified in RFC 3389.
+     *
+     * On input, the noise-level and spectral envelope (as reflection-coefficients of a linear predictor) of every package
+     * marked as silent are written into the StreamData, so the RTP-processor can send them as comfort-noise package while DTX is active.
+     *
+     * On output, for every received (or continued) comfort-noise package, white noise is shaped with the received spectral envelope
+     * and scaled to the received noise-level, so the listener is not irritated by absolute silence.
+     *
+     * NOTE: The silence-detection must be performed by another processor (e.g. Gain Control) added in front of this one.
+     * This processor must be added in front of the codec to operate on the decoded audio-data.
+     */
+    class ComfortNoiseGenerator : public AudioProcessor
+    {
+    public:
+        ComfortNoiseGenerator(const std::string& name);
+
+        unsigned int getSupportedAudioFormats() const override;
+        unsigned int getSupportedSampleRates() const override;
+        const std::vector<int> getSupportedBufferSizes(unsigned int sampleRate) const override;
+        PayloadType getSupportedPlayloadType() const override;
+
+        void configure(const AudioConfiguration& audioConfig, const std::shared_ptr<ConfigurationMode> configMode, const uint16_t bufferSize, const ProcessorCapabilities& chainCapabilities) override;
+        bool cleanUp() override;
+
+        unsigned int processInputData(void *inputBuffer, const unsigned int inputBufferByteSize, StreamData *userData) override;
+        unsigned int processOutputData(void *outputBuffer, const unsigned int outputBufferByteSize, StreamData *userData) override;
+
+        /*!
+         * Encodes the noise-level and reflection-coefficients into the comfort-noise payload, as specified in RFC 3389
+         *
+         * \param level The noise-level in -dBov
+         * \param reflectionCoefficients The reflection-coefficients, each within (-1, 1)
+         * \param order The number of reflection-coefficients
+         * \param payload The buffer to write into, must hold at least order + 1 bytes
+         *
+         * \return the size of the payload, in bytes
+         */
+        static unsigned int encodeParameters(const double level, const double* reflectionCoefficients, const unsigned int order, uint8_t* payload);
+
+        /*!
+         * Decodes the comfort-noise payload into the noise-level and the reflection-coefficients
+         *
+         * \return the number of reflection-coefficients (the model order)
+         */
+        static unsigned int decodeParameters(const uint8_t* payload, const unsigned int payloadSize, double& level, double* reflectionCoefficients);
+
+    private:
+        typedef void (ComfortNoiseGenerator::*Analyzer)(const void* buffer, const unsigned int bufferSize, StreamData* userData);
+        typedef unsigned int (ComfortNoiseGenerator::*Synthesizer)(void* buffer, const unsigned int numFrames, const unsigned int maxBufferSize);
+        //the order of the linear predictor modelling the noise-spectrum
+        static constexpr unsigned int MODEL_ORDER{StreamData::MAX_COMFORT_NOISE_SIZE - 1};
+        //the noise-level of a package without any signal, in -dBov
+        static constexpr uint8_t MIN_NOISE_LEVEL{127};
+
+        unsigned char numInputChannels;
+        unsigned char numOutputChannels;
+        Analyzer analyzer;
+        Synthesizer synthesizer;
+        //the sample-value of 0 dBov
+        double fullScale;
+
+        //the parameters currently synthesized
+        uint8_t currentParameters[StreamData::MAX_COMFORT_NOISE_SIZE];
+        uint8_t currentParametersSize;
+        //the direct-form coefficients of the synthesis-filter
+        double predictorCoefficients[MODEL_ORDER];
+        unsigned int predictorOrder;
+        //the standard-deviation of the excitation-noise
+        double excitationGain;
+        //the last output samples, the filter-state
+        double filterState[MODEL_ORDER];
+        //the state of the noise-generator
+        uint32_t randomState;
+
+        template<typename AudioFormat>
+        void analyze(const void* buffer, const unsigned int bufferSize, StreamData* userData);
+
+        /*!
+         * Writes the given number of frames of comfort-noise into the buffer, limited by the maximum buffer-size
+         *
+         * \return the number of bytes written
+         */
+        template<typename AudioFormat>
+        unsigned int synthesize(void* buffer, const unsigned int numFrames, const unsigned int maxBufferSize);
+
+        template<typename AudioFormat>
+        static AudioFormat clipSample(const double value);
+
+        /*!
+         * Updates the synthesis-filter, if the parameters changed
+         */
+        void updateParameters(const uint8_t* payload, const unsigned int payloadSize);
+
+        /*!
+         * \return the next white-noise sample, uniformly distributed within [-1, 1]
+         */
+        double nextRandom();
+    };
+}
+#endif	/* COMFORTNOISEGENERATOR_H */
+
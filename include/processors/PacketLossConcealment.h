@@ -0,0 +1,123 @@
+/*
+ * File:   PacketLossConcealment.h
+ */
+
+#ifndef PACKETLOSSCONCEALMENT_H
+#define	PACKETLOSSCONCEALMENT_H
+
+#include <vector>
+
+#include "processors/AudioProcessor.h"
+
+namespace ohmcomm
+{
+
+    /*!
+     * Audio-processor concealing lost packages in the decoded PCM-stream.
+     *
+     * For every package the jitter-buffer could not provide (the package is marked as silent-package),
+     * the last pitch-period of the previous audio is repeated. Over consecutive losses, the repeated signal is faded out
+     * (full volume for the first 10 ms, silence after 60 ms, see ITU-T G.711 Appendix I) and the first real package after
+     * the loss is cross-faded with the continued extrapolation to avoid clicks.
+     *
+     * The pitch-period is only estimated once per loss (on a signal decimated to 8 kHz), so the additional cost
+     * for every other package is a single copy into the history-buffer.
+     *
+     * NOTE: Since the output-processors are run in reverse order, this processor must be added in front of the codec
+     * to operate on the decoded audio-data
+     */
+    class PacketLossConcealment : public AudioProcessor
+    {
+    public:
+        PacketLossConcealment(const std::string& name);
+
+        unsigned int getSupportedAudioFormats() const override;
+        unsigned int getSupportedSampleRates() const override;
+        const std::vector<int> getSupportedBufferSizes(unsigned int sampleRate) const override;
+        PayloadType getSupportedPlayloadType() const override;
+
+        void configure(const AudioConfiguration& audioConfig, const std::shared_ptr<ConfigurationMode> configMode, const uint16_t bufferSize, const ProcessorCapabilities& chainCapabilities) override;
+        bool cleanUp() override;
+
+        unsigned int processInputData(void *inputBuffer, const unsigned int inputBufferByteSize, StreamData *userData) override;
+        unsigned int processOutputData(void *outputBuffer, const unsigned int outputBufferByteSize, StreamData *userData) override;
+
+    private:
+        typedef void (PacketLossConcealment::*SampleProcessor)(void* buffer, const unsigned int bufferSize, StreamData* userData);
+        //the lowest and highest pitch-frequencies (in Hz) to detect
+        static constexpr unsigned int MIN_PITCH{66};
+        static constexpr unsigned int MAX_PITCH{400};
+        //the sample-rate the pitch is coarsely searched with
+        static constexpr unsigned int PITCH_SEARCH_RATE{8000};
+        //the time (in ms) after which the concealed audio starts to fade out and is completely silenced
+        static constexpr unsigned int FADE_START{10};
+        static constexpr unsigned int FADE_END{60};
+
+        unsigned int numChannels;
+        SampleProcessor processor;
+        //the range of the pitch-period, in frames
+        unsigned int minPeriod;
+        unsigned int maxPeriod;
+        //the step of the coarse pitch-search, in frames
+        unsigned int decimation;
+        //the number of frames from the start of the loss at which the fading starts/ends
+        unsigned int fadeStartFrames;
+        unsigned int fadeEndFrames;
+
+        /*!
+         * The last frames played out (interleaved), the newest frame is the last one
+         */
+        std::vector<float> history;
+        //the number of frames in the history, the number of valid frames
+        unsigned int historyFrames;
+        unsigned int historyFill;
+        /*!
+         * Down-mixed (mono) copy of the history, used for the pitch-search
+         */
+        std::vector<float> pitchSearchBuffer;
+        /*!
+         * The last pitch-period of the history (interleaved) to repeat, its end is smoothed to wrap around without clicks
+         */
+        std::vector<float> pitchBuffer;
+        unsigned int pitchPeriod;
+        unsigned int pitchPosition;
+        /*!
+         * The number of frames concealed since the start of the current loss, zero if the last package was not lost
+         */
+        unsigned int concealedFrames;
+        /*!
+         * The extrapolated frames to cross-fade the first package after a loss with
+         */
+        std::vector<float> crossFadeBuffer;
+
+        template<typename AudioFormat>
+        void process(void* buffer, const unsigned int bufferSize, StreamData* userData);
+
+        template<typename AudioFormat>
+        static AudioFormat toSample(const float value);
+
+        /*!
+         * Estimates the pitch-period of the history and fills the pitch-buffer
+         */
+        void startConcealment();
+
+        /*!
+         * Writes the given number of frames continuing the pitch-buffer, faded out according to the duration of the loss
+         */
+        template<typename AudioFormat>
+        void extrapolate(AudioFormat* output, const unsigned int numFrames);
+
+        /*!
+         * Appends the frames to the history, dropping the oldest frames
+         */
+        template<typename AudioFormat>
+        void appendHistory(const AudioFormat* samples, const unsigned int numFrames);
+
+        /*!
+         * \return the normalized cross-correlation of the last length samples of the signal with the samples lag earlier
+         */
+        static float correlate(const float* signal, const unsigned int signalLength, const unsigned int length, const unsigned int lag, const unsigned int step);
+    };
+}
+#endif	/* PACKETLOSSCONCEALMENT_H */
+
@@ -14,6 +14,7 @@
 
 #include "configuration.h"
 #include "audio/AudioDevice.h"
+#include "processors/AudioMixer.h"
 #include "processors/AudioProcessor.h"
 #include "Statistics.h"
 
@@ -22,10 +23,21 @@ namespace ohmcomm
 
     /*!
      * Class for storing and managing the active audio-processors
+     *
+     * If the last processor in the chain (e.g. the RTP-processor) provides several streams on output (see StreamData#numStreams),
+     * every stream is decoded separately by its own instances of the codec (and all processors between the codec and the last processor)
+     * and the decoded streams are mixed, before the remaining processors are run on the mixed audio-data.
+     * Streams currently not providing any audio-data (e.g. due to a lost package or a buffer-underflow) are still decoded for up to
+     * MAX_CONCEALED_CYCLES, so the codec of the stream can conceal the loss. Streams silent for longer are skipped.
      */
     class ProcessorManager
     {
     public:
+        //! The maximum number of streams to decode with separate codec-instances
+        static constexpr unsigned int MAX_MIXED_STREAMS{16};
+        //! The number of output-cycles a stream without audio-data is still decoded and mixed, to conceal lost packages
+        static constexpr unsigned int MAX_CONCEALED_CYCLES{5};
+
         ProcessorManager();
 
         /*!
@@ -123,7 +135,32 @@ namespace ohmcomm
         const ProcessorCapabilities getCombinedCapabilities();
 
     private:
+
+        /*!
+         * The processors decoding a single stream
+         */
+        struct StreamDecoder
+        {
+            //the processors in the order of the processor-chain, either the processors of the chain or separate instances
+            std::vector<AudioProcessor*> processors;
+            //the ID of the stream currently decoded
+            uint32_t streamId;
+            //the output-cycle this decoder was last used in, to reassign the least recently used decoder to new streams
+            uint64_t lastUsed;
+            //the output-cycle the stream last provided audio-data in
+            uint64_t lastActive;
+        };
+
         std::vector<std::unique_ptr<AudioProcessor>> audioProcessors;
+        //the number of processors before the last one (in output-order) to run separately for every stream
+        unsigned int numStreamProcessors;
+        //the additional processor-instances to decode streams with
+        std::vector<std::unique_ptr<AudioProcessor>> streamProcessors;
+        std::vector<StreamDecoder> streamDecoders;
+        AudioMixer mixer;
+        //the buffer to read and decode the additional streams into
+        std::vector<char> streamBuffer;
+        uint64_t outputCycle;
         //selected best sample-rate to be used by all audio-processors
         //in normal case (no resampling required), this is the same as the audio-configuration's sample-rate
         unsigned int processorsSampleRate;
@@ -133,6 +170,41 @@ namespace ohmcomm
          */
         unsigned int findOptimalBufferSize(unsigned int defaultBufferSize, unsigned int sampleRate);
 
+        /*!
+         * Creates the processor-instances to decode every stream separately with
+         */
+        void configureStreamDecoders(const AudioConfiguration& audioConfiguration, const std::shared_ptr<ConfigurationMode> configMode, const uint16_t bufferSize,
+                                     const ProcessorCapabilities& chainCapabilities);
+
+        /*!
+         * Removes all processor-instances for decoding streams, e.g. since the processor-chain changed
+         */
+        void clearStreamDecoders();
+
+        /*!
+         * Runs the decoder of the stream set in the stream-data on the buffer
+         *
+         * \return the new number of valid bytes in the buffer
+         */
+        unsigned int decodeStream(void* buffer, unsigned int bufferSize, StreamData* streamData);
+
+        /*!
+         * \return the decoder assigned to the given stream or nullptr
+         */
+        StreamDecoder* findDecoder(const uint32_t streamId);
+
+        /*!
+         * \return whether the given stream provided audio-data within the last MAX_CONCEALED_CYCLES, so a missing package is concealed
+         */
+        bool isConcealingStream(const uint32_t streamId);
+
+        /*!
+         * Reads, decodes and mixes all streams provided by the last processor, the first stream is already read into the output-buffer
+         *
+         * \return the number of valid bytes in the output-buffer
+         */
+        unsigned int mixStreams(void* outputBuffer, unsigned int bufferSize, StreamData* streamData);
+
         /*!
          * Automatically selects the best audio format out of the supported formats
          */
@@ -0,0 +1,48 @@
+/*
+ * File:   BufferClock.h
+ */
+
+#ifndef BUFFERCLOCK_H
+#define	BUFFERCLOCK_H
+
+#include <chrono>
+
+namespace ohmcomm
+{
+    namespace rtp
+    {
+
+        /*!
+         * The clock used by the jitter-buffers to timestamp the reception of packages and to expire delayed packages.
+         *
+         * By default, this is the steady clock. For simulations, the time source can be replaced by a virtual clock,
+         * so the buffers can be run with recorded or synthetic traces faster than real-time (see benchmark/JitterBufferSimulator.cpp).
+         */
+        class BufferClock
+        {
+        public:
+            typedef std::chrono::steady_clock::time_point (*TimeSource)();
+
+            /*!
+             * \return the current time of the configured time source
+             */
+            static inline std::chrono::steady_clock::time_point now()
+            {
+                return timeSource();
+            }
+
+            /*!
+             * Replaces the time source for all jitter-buffers.
+             *
+             * NOTE: This method must not be called while any jitter-buffer is in use
+             *
+             * \param source The new time source, nullptr resets to the steady clock
+             */
+            static void setTimeSource(TimeSource source);
+
+        private:
+            static TimeSource timeSource;
+        };
+    }
+}
+#endif	/* BUFFERCLOCK_H */
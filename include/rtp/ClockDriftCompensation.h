@@ -0,0 +1,162 @@
+/*
+ * File:   ClockDriftCompensation.h
+ */
+
+#ifndef CLOCKDRIFTCOMPENSATION_H
+#define	CLOCKDRIFTCOMPENSATION_H
+
+#include <cstdint>
+
+#include "Statistics.h"
+
+namespace ohmcomm
+{
+    namespace rtp
+    {
+
+        /*!
+         * The correction to apply to the play-out to compensate the clock-drift
+         */
+        enum class DriftCorrection
+        {
+            //! Play the next package as usual
+            NONE,
+            //! Skip a single package, the remote clock is faster than ours
+            DROP_FRAME,
+            //! Play an additional package (without consuming the next one), the remote clock is slower than ours
+            INSERT_FRAME
+        };
+
+        /*!
+         * Mixin for jitter-buffers to compensate the drift between the clock of the remote (producing the packages)
+         * and the local audio-clock (consuming them).
+         *
+         * If the remote sound card runs faster than ours, the buffer slowly fills up, if it runs slower, the buffer drains.
+         * Since the RTP timestamps of OHMComm are derived from the system-clock of the sender and not from its audio-clock,
+         * the drift is estimated from the trend of the buffer-level on play-out instead:
+         * The average buffer-level of successive windows of play-outs is compared, so constant offsets (e.g. caused by jitter) cancel out.
+         * The estimated drift is accumulated and a single frame is dropped or inserted, whenever it sums up to a whole package.
+         */
+        class ClockDriftCompensation
+        {
+        protected:
+
+            /*!
+             * \param enabled whether to apply any corrections at all
+             */
+            ClockDriftCompensation(const bool enabled = true) : enabled(enabled)
+            {
+                resetDriftCompensation();
+            }
+
+            virtual ~ClockDriftCompensation()
+            {
+            }
+
+            /*!
+             * Call this method on every play-out of a package
+             *
+             * \param bufferExcess The number of packages buffered more than the current playout delay requires
+             *
+             * \return the correction to apply for this play-out. If it is applied, it must be confirmed via #driftCorrectionApplied,
+             * otherwise it is returned again on the next play-out
+             */
+            inline DriftCorrection updateDriftCompensation(const int bufferExcess)
+            {
+                if(!enabled)
+                {
+                    return DriftCorrection::NONE;
+                }
+                //use the level the buffer would have without any previous corrections
+                windowSum += bufferExcess + correctionOffset;
+                ++windowReads;
+                if(windowReads == WINDOW_SIZE)
+                {
+                    const double windowMean = windowSum / (double)WINDOW_SIZE;
+                    if(hasPreviousWindow)
+                    {
+                        //the change of the buffer-level per play-out
+                        const double windowDrift = (windowMean - previousWindowMean) / WINDOW_SIZE;
+                        driftRate = hasDriftRate ? (1 - DRIFT_SMOOTHING) * driftRate + DRIFT_SMOOTHING * windowDrift : windowDrift;
+                        hasDriftRate = true;
+                    }
+                    previousWindowMean = windowMean;
+                    hasPreviousWindow = true;
+                    windowSum = 0;
+                    windowReads = 0;
+                }
+                accumulatedDrift += driftRate;
+                if(accumulatedDrift >= 1.0)
+                {
+                    return DriftCorrection::DROP_FRAME;
+                }
+                if(accumulatedDrift <= -1.0)
+                {
+                    return DriftCorrection::INSERT_FRAME;
+                }
+                return DriftCorrection::NONE;
+            }
+
+            /*!
+             * Confirms the given correction to have been applied to the play-out
+             */
+            inline void driftCorrectionApplied(const DriftCorrection correction)
+            {
+                if(correction == DriftCorrection::DROP_FRAME)
+                {
+                    accumulatedDrift -= 1.0;
+                    ++correctionOffset;
+                    Statistics::incrementCounter(Statistics::RTP_BUFFER_FRAMES_DROPPED);
+                }
+                else if(correction == DriftCorrection::INSERT_FRAME)
+                {
+                    accumulatedDrift += 1.0;
+                    --correctionOffset;
+                    Statistics::incrementCounter(Statistics::RTP_BUFFER_FRAMES_INSERTED);
+                }
+            }
+
+            /*!
+             * \return the estimated drift of the remote clock relative to the local audio-clock, in parts per million
+             */
+            inline double getEstimatedDrift() const
+            {
+                return driftRate * 1000000;
+            }
+
+            /*!
+             * Discards the estimated drift, e.g. when the buffer is reused for another stream
+             */
+            inline void resetDriftCompensation()
+            {
+                windowSum = 0;
+                windowReads = 0;
+                previousWindowMean = 0;
+                hasPreviousWindow = false;
+                driftRate = 0;
+                hasDriftRate = false;
+                accumulatedDrift = 0;
+                correctionOffset = 0;
+            }
+
+        private:
+            //the number of play-outs to average the buffer-level over
+            static constexpr unsigned int WINDOW_SIZE{500};
+            //the weight of the drift of the latest window
+            constexpr static double DRIFT_SMOOTHING = 0.3;
+            const bool enabled;
+            long windowSum;
+            unsigned int windowReads;
+            double previousWindowMean;
+            bool hasPreviousWindow;
+            //the estimated change of the buffer-level per play-out
+            double driftRate;
+            bool hasDriftRate;
+            //the drift accumulated since the last correction, in packages
+            double accumulatedDrift;
+            //the number of frames dropped minus the number of frames inserted
+            int correctionOffset;
+        };
+    }
+}
+#endif	/* CLOCKDRIFTCOMPENSATION_H */
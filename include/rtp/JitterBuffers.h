@@ -8,51 +8,166 @@
 #ifndef JITTERBUFFERS_H
 #define	JITTERBUFFERS_H
 
-#include <map>
+#include <atomic>
+#include <chrono>
 #include <mutex>
 #include <memory>
 
 #include "RTPBufferHandler.h"
+#include "PlayoutPointAdaption.h"
 
 namespace ohmcomm
 {
     namespace rtp
     {
+        /*!
+         * The implementations of jitter-buffers available
+         */
+        enum class JitterBufferType
+        {
+            //! The RTPBuffer, synchronized via a mutex
+            RTP_BUFFER,
+            //! The RTPBufferLockFree, for a single receiving thread and a single play-out thread
+            LOCK_FREE
+        };
+
         /*!
          * Container for storing and managing all RTP jitter-buffers in use
+         *
+         * All buffers are allocated on construction and assigned to the SSRCs on demand.
+         * Looking up the buffer for a SSRC does not lock and does not allocate any memory,
+         * only assigning a buffer to a new SSRC and releasing it again are synchronized.
+         *
+         * Buffers of SSRCs, which did not receive any package for IDLE_TIMEOUT, are released automatically (see #removeIdleBuffers()).
+         * A released buffer is only reused after RELEASE_GRACE_PERIOD, so threads still accessing the buffer are not disturbed.
          */
         class JitterBuffers
         {
         public:
+            //! The default maximum number of streams buffered at the same time
+            static constexpr uint16_t DEFAULT_MAX_STREAMS{16};
+            //! The time without any received package, after which a buffer is released
+            static constexpr std::chrono::seconds IDLE_TIMEOUT{30};
+            //! The time after releasing a buffer until it is reused for another SSRC
+            static constexpr std::chrono::seconds RELEASE_GRACE_PERIOD{1};
+
             /*!
              * \param maxCapacity The maximum number of packages to buffer in a single jitter-buffer
              * \param maxDelay The maximum delay in milliseconds before dropping packages
              * \param minBufferPackages The minimum of packages to buffer before returning valid audio-data
+             * \param bufferType The type of jitter-buffer to create for every SSRC
+             * \param maxPayloadSize The maximum size of a single payload, used to preallocate the buffers
+             * \param maxStreams The maximum number of SSRCs to buffer packages for at the same time
+             * \param adaptionSettings The algorithm to adapt the playout delay of the buffers with
              */
-            JitterBuffers(const uint16_t maxCapacity, const uint16_t maxDelay, const uint16_t minBufferPackage = 1);
+            JitterBuffers(const uint16_t maxCapacity, const uint16_t maxDelay, const uint16_t minBufferPackage = 1,
+                          const JitterBufferType bufferType = JitterBufferType::RTP_BUFFER, const unsigned int maxPayloadSize = RTPBufferHandler::DEFAULT_MAX_PAYLOAD_SIZE,
+                          const uint16_t maxStreams = DEFAULT_MAX_STREAMS, const PlayoutAdaptionSettings& adaptionSettings = PlayoutAdaptionSettings());
 
             /*!
+             * Retrieves the buffer for the given SSRC and assigns a new one, if there is none yet.
+             * This also marks the SSRC as active.
+             *
              * \param ssrc The SSRC to retrieve (and create) the buffer for
              * 
-             * \return the jitter-buffer for the given SSRC
+             * \return the jitter-buffer for the given SSRC or nullptr, if all buffers are in use
              */
-            const std::unique_ptr<RTPBufferHandler>& getBuffer(const uint32_t ssrc);
+            RTPBufferHandler* getBuffer(const uint32_t ssrc);
 
             /*!
-             * Destroys the RTP-buffer for the given SSRC freeing its resources
+             * \param ssrc The SSRC to retrieve the buffer for
+             *
+             * \return the jitter-buffer for the given SSRC or nullptr, if no buffer is assigned to this SSRC
+             */
+            RTPBufferHandler* findBuffer(const uint32_t ssrc) const;
+
+            /*!
+             * Lists the SSRCs currently assigned a buffer. This method does not lock and does not allocate any memory.
+             *
+             * \param ssrcs The array to write the SSRCs into
+             * \param maxSSRCs The maximum number of SSRCs to write
+             *
+             * \return the number of SSRCs written
+             */
+            unsigned int getActiveSSRCs(uint32_t* ssrcs, const unsigned int maxSSRCs) const;
+
+            /*!
+             * Releases the RTP-buffer for the given SSRC, so it can be reused for another SSRC
              */
             void removeBuffer(const uint32_t ssrc);
 
             /*!
-             * Deletes all buffers
+             * Releases the buffers of all SSRCs, which have not received any package within the IDLE_TIMEOUT.
+             *
+             * This method checks the buffers at most once per second, so it can be called on every package reception
+             */
+            void removeIdleBuffers();
+
+            /*!
+             * Releases all buffers
              */
             void cleanup();
         private:
-            const uint16_t maximumCapacity;
-            const uint16_t maximumDelay;
-            const uint16_t minBufferPackages;
+            //marks an unused entry in the directory
+            static constexpr uint64_t ENTRY_EMPTY{0};
+            //marks a removed entry in the directory, lookups need to continue probing
+            static constexpr uint64_t ENTRY_REMOVED{UINT64_MAX};
+
+            /*!
+             * A pool-entry, holding a preallocated buffer
+             */
+            struct PoolEntry
+            {
+                std::unique_ptr<RTPBufferHandler> buffer;
+                //the time of the last package received, as steady_clock ticks
+                std::atomic<std::chrono::steady_clock::rep> lastActivity;
+                //the time this entry was released, as steady_clock ticks
+                std::chrono::steady_clock::time_point releaseTime;
+                //the SSRC this buffer is assigned to, only valid if inUse is set
+                uint32_t ssrc;
+                bool inUse;
+
+                PoolEntry() : buffer(), lastActivity(0), releaseTime(), ssrc(0), inUse(false)
+                {
+
+                }
+            };
+
+            const uint16_t maxStreams;
+            //the size of the directory, a power of two
+            const uint32_t directorySize;
+            //guards assigning and releasing buffers (not the look-ups)
             std::mutex mutex;
-            std::map<uint32_t, std::unique_ptr<RTPBufferHandler>> buffers;
+            std::unique_ptr<PoolEntry[]> pool;
+            //open-addressing hash-table mapping the SSRCs to the pool-entries, each entry is encoded as (pool-index + 1) << 32 | SSRC
+            std::unique_ptr<std::atomic<uint64_t>[]> directory;
+            //the time of the last check for idle buffers, as steady_clock ticks
+            std::atomic<std::chrono::steady_clock::rep> lastIdleCheck;
+
+            /*!
+             * \param ssrc The SSRC to look up
+             * \param value Is set to the directory-entry found, since the entry at the position may change concurrently
+             *
+             * \return the position in the directory for the given SSRC or directorySize, if the SSRC is not in the directory
+             */
+            uint32_t findDirectoryPosition(const uint32_t ssrc, uint64_t& value) const;
+
+            static inline uint16_t getPoolIndex(const uint64_t directoryValue)
+            {
+                return (directoryValue >> 32) - 1;
+            }
+
+            /*!
+             * Releases the pool-entry at the given directory-position and empties the removed entries no more needed for probing,
+             * the mutex must be locked
+             */
+            void releaseEntry(const uint32_t position, const std::chrono::steady_clock::time_point now);
+
+            static inline uint32_t getStartPosition(const uint32_t ssrc, const uint32_t directorySize)
+            {
+                //multiplicative hashing, to spread sequential SSRCs
+                return (ssrc * UINT32_C(2654435761)) & (directorySize - 1);
+            }
         };
     }
 }
@@ -8,7 +8,10 @@
 #ifndef LOSSCONCEALMENT_H
 #define	LOSSCONCEALMENT_H
 
+#include <algorithm>
+
 #include "RTPPackageHandler.h"
+#include "processors/AudioProcessor.h"
 
 namespace ohmcomm
 {
@@ -19,7 +22,8 @@ namespace ohmcomm
          * Mixin for jitter buffers to improve the loss concealment techniques
          * 
          * For the first N lost packages, the last successfully received package is repeated. 
-         * After the threshold is reached (more successive packages are lost) the losses are concealed, currently by playing silence
+         * After the threshold is reached (more successive packages are lost) the losses are concealed by playing silence
+         * or - if the remote is in a silence period - by continuing the last comfort-noise package (see RFC 3389)
          */
         class LossConcealment
         {
@@ -29,7 +33,7 @@ namespace ohmcomm
              * \param maxPackageRepetitions the maximum times a single package is repeated to conceal subsequent lost packages
              */
             LossConcealment(const uint16_t maxPackageRepetitions = DEFAULT_PACKAGE_REPETITIONS) : maxPackageRepetitions(maxPackageRepetitions),
-            numRepeatedPackages(0), lastReceivedSequenceNumber(0)
+            numRepeatedPackages(0), lastReceivedSequenceNumber(0), comfortNoise(), comfortNoiseSize(0)
             {
 
             }
@@ -64,6 +68,37 @@ namespace ohmcomm
                 createConcealmentPackage(package);
             }
 
+            /*!
+             * Forgets about the previously concealed losses, e.g. when the buffer is reused for another stream
+             */
+            inline void resetConcealment()
+            {
+                numRepeatedPackages = 0;
+                lastReceivedSequenceNumber = 0;
+                comfortNoiseSize = 0;
+            }
+
+            /*!
+             * Remembers the parameters of a played comfort-noise package, to conceal the subsequent (not sent) packages with.
+             * Any other package ends the silence period of the remote.
+             *
+             * \param header The header of the package played
+             * \param payload The payload of the package
+             * \param payloadSize The size of the payload in bytes
+             */
+            inline void updateComfortNoise(const RTPHeader& header, const void* payload, const unsigned int payloadSize)
+            {
+                if(header.getPayloadType() == PayloadType::CN)
+                {
+                    comfortNoiseSize = std::min(payloadSize, StreamData::MAX_COMFORT_NOISE_SIZE);
+                    memcpy(comfortNoise, payload, comfortNoiseSize);
+                }
+                else
+                {
+                    comfortNoiseSize = 0;
+                }
+            }
+
             /*!
              * Copies the last received package, if it is still in the buffer
              * 
@@ -79,8 +114,15 @@ namespace ohmcomm
              */
             inline void createConcealmentPackage(RTPPackageHandler &package)
             {
-                //TODO switch to comfort noise
-                package.createSilencePackage();
+                if(comfortNoiseSize > 0)
+                {
+                    //the remote is in a silence period, continue the comfort noise
+                    package.createComfortNoisePackage(comfortNoise, comfortNoiseSize);
+                }
+                else
+                {
+                    package.createSilencePackage();
+                }
             }
 
         private:
@@ -88,6 +130,8 @@ namespace ohmcomm
             const uint16_t maxPackageRepetitions;
             uint16_t numRepeatedPackages;
             uint16_t lastReceivedSequenceNumber;
+            uint8_t comfortNoise[StreamData::MAX_COMFORT_NOISE_SIZE];
+            uint8_t comfortNoiseSize;
         };
     }
 }
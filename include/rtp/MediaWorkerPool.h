@@ -0,0 +1,116 @@
+/*
+ * File:   MediaWorkerPool.h
+ */
+
+#ifndef MEDIAWORKERPOOL_H
+#define	MEDIAWORKERPOOL_H
+
+#include <memory>
+#include <vector>
+
+#include "network/EventLoop.h"
+#include "SharedMediaSocket.h"
+
+namespace ohmcomm
+{
+    namespace rtp
+    {
+
+        /*!
+         * Pool of worker-threads serving the sessions of a multi-call server on a single local port.
+         *
+         * Every worker runs its own EventLoop and owns a SharedMediaSocket, all bound to the same port with SO_REUSEPORT.
+         * A session is owned by the worker determined by the port of its remote, a socket-filter attached to the sockets makes the kernel
+         * deliver the packages of a remote directly to its worker. So the receiving and jitter-buffering of the sessions (and any other
+         * work scheduled on the event-loop of the worker) scale with the number of workers without sharing any session-state between them.
+         *
+         * NOTE: The steering of the packages is only supported on Linux, otherwise a single worker is used
+         */
+        class MediaWorkerPool
+        {
+        public:
+            /*!
+             * Creates and starts the workers
+             *
+             * \param localPort The local port shared by all workers
+             * \param numWorkers The number of workers, defaults to the number of cores
+             * \param isIPv6 Whether the sockets are used for IPv6 (or IPv4) remotes
+             * \param maxPayloadSize The maximum size (in bytes) of the payload of a single package
+             */
+            MediaWorkerPool(const unsigned short localPort, const unsigned int numWorkers = getDefaultNumberOfWorkers(), const bool isIPv6 = false,
+                            const unsigned int maxPayloadSize = RTPBufferHandler::DEFAULT_MAX_PAYLOAD_SIZE);
+            ~MediaWorkerPool();
+
+            /*!
+             * \return the number of cores available, at least one
+             */
+            static unsigned int getDefaultNumberOfWorkers();
+
+            /*!
+             * \return the number of workers running
+             */
+            unsigned int getNumberOfWorkers() const;
+
+            /*!
+             * \param remotePort The port of the remote
+             *
+             * \return the index of the worker receiving the packages sent from the given remote port
+             */
+            unsigned int getWorkerIndex(const unsigned short remotePort) const;
+
+            /*!
+             * Adds a new session to the worker owning the remote
+             *
+             * \param remoteIPAddress The IP-address of the remote
+             * \param remotePort The port of the remote
+             *
+             * \return the new session
+             */
+            std::shared_ptr<SharedMediaSocket::Session> openSession(const std::string& remoteIPAddress, const unsigned short remotePort);
+
+            /*!
+             * \return the socket of the given worker, e.g. to create a ProcessorRTP for a session owned by this worker
+             */
+            std::shared_ptr<SharedMediaSocket> getSocket(const unsigned int workerIndex) const;
+
+            /*!
+             * The event-loop receiving the packages of the sessions of the worker.
+             * Work scheduled on this loop (e.g. the play-out and encoding of the sessions) runs in the thread of the worker
+             *
+             * \return the event-loop of the given worker
+             */
+            ohmcomm::network::EventLoop& getEventLoop(const unsigned int workerIndex);
+
+            /*!
+             * \return the number of sessions of all workers
+             */
+            unsigned int getNumberOfSessions() const;
+
+            /*!
+             * Applies the options to the sockets of all workers
+             *
+             * \return whether all options were applied to all sockets
+             */
+            bool setSocketOptions(const SocketOptions& options);
+
+        private:
+            struct Worker
+            {
+                std::unique_ptr<ohmcomm::network::EventLoop> loop;
+                std::shared_ptr<SharedMediaSocket> socket;
+            };
+
+            std::vector<Worker> workers;
+
+            /*!
+             * Attaches the program to the group of sockets sharing the port, which selects the socket by the port of the sender
+             *
+             * \return whether the program was attached
+             */
+            bool attachSteeringProgram(const int socket, const bool isIPv6, const unsigned int numWorkers);
+        };
+    }
+}
+
+#endif	/* MEDIAWORKERPOOL_H */
+
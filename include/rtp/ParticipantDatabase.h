@@ -8,6 +8,7 @@
 #ifndef PARTICIPANT_DATABASE_H
 #define	PARTICIPANT_DATABASE_H
 
+#include <atomic>
 #include <map>
 #include <chrono>
 #include <memory>
@@ -15,6 +16,7 @@
 #include <functional>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 
 namespace ohmcomm
 {
@@ -156,15 +158,30 @@ namespace ohmcomm
              */
             inline static Participant& remote(const uint32_t ssrc)
             {
-                std::lock_guard<std::mutex> guard(databaseMutex);
-                if (!isInDatabase(ssrc))
+                Participant* participant;
                 {
-                    participants.emplace(std::make_pair(ssrc, Participant{ssrc, false}));
-                    fireNewRemote(ssrc);
+                    std::lock_guard<std::mutex> guard(databaseMutex);
+                    const auto it = participants.find(ssrc);
+                    if (it != participants.end())
+                    {
+                        return it->second;
+                    }
+                    participant = &participants.emplace(std::make_pair(ssrc, Participant{ssrc, false})).first->second;
                 }
-                return participants.at(ssrc);
+                //the listeners are fired without the lock held, see #removeParticipant()
+                fireNewRemote(ssrc);
+                return *participant;
             }
 
+            /*!
+             * Unlike #remote(), this method does not create a new participant
+             * 
+             * \param ssrc the SSRC of the remote participant
+             * 
+             * \return the remote participant, or nullptr if there is none
+             */
+            static Participant* find(const uint32_t ssrc);
+
             /*!
              * \param ssrc the SSRC to check
              * 
@@ -186,6 +203,9 @@ namespace ohmcomm
             /*!
              * Removes the remote participant with the given SSRC from the list of active participants
              * 
+             * The listeners are notified after the database is unlocked, since they may shut down the threads (or wait for the event-loops)
+             * accessing the database
+             * 
              * \param ssrc The SSRC to remove
              * 
              * \return whether a participant for this SSRC was found and removed
@@ -216,6 +236,8 @@ namespace ohmcomm
             static std::map<uint32_t, Participant> participants;
             //need to wrap references, since they cannot be stored in vectors
             static std::vector<std::reference_wrapper<ParticipantListener>> listeners;
+            //the number of participants removed so far, invalidates the ParticipantCaches
+            static std::atomic<uint32_t> numRemovals;
 
             static Participant initLocalParticipant();
             
@@ -229,6 +251,44 @@ namespace ohmcomm
             static void fireConnectedRemote(const uint32_t ssrc, const std::string& address, const uint16_t port);
             
             friend struct Participant;
+            friend class ParticipantCache;
+        };
+
+        /*!
+         * Caches the participants looked up by a single thread (e.g. the worker receiving the packages of a session),
+         * so the global database is only locked for participants not yet seen instead of for every package.
+         *
+         * All cached participants are dropped, once any participant is removed from the database.
+         * The cache itself is not thread-safe.
+         */
+        class ParticipantCache
+        {
+        public:
+            ParticipantCache();
+
+            /*!
+             * \param ssrc the SSRC of the remote participant
+             *
+             * \return the remote participant, which is created if it doesn't exist, see ParticipantDatabase#remote()
+             */
+            Participant& remote(const uint32_t ssrc);
+
+            /*!
+             * \param ssrc the SSRC of the remote participant
+             *
+             * \return the remote participant, or nullptr if there is none, see ParticipantDatabase#find()
+             */
+            Participant* find(const uint32_t ssrc);
+
+        private:
+            std::unordered_map<uint32_t, Participant*> participants;
+            //the number of removals from the database, when the cache was last validated
+            uint32_t numRemovals;
+
+            /*!
+             * Drops the cached participants, if any participant was removed since the last call
+             */
+            void validate();
         };
     }
 }
@@ -0,0 +1,89 @@
+/*
+ * File:   PlayoutDelayEstimator.h
+ */
+
+#ifndef PLAYOUTDELAYESTIMATOR_H
+#define	PLAYOUTDELAYESTIMATOR_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+namespace ohmcomm
+{
+    namespace rtp
+    {
+
+        /*!
+         * Estimates the playout delay required to keep the late losses below a given quantile.
+         *
+         * For every received package, the delay relative to the fastest package of the recent packages is calculated
+         * (from the RTP timestamp and the time of reception) and added to a histogram.
+         * Older values are weighted down exponentially, so the estimation adapts to changing network-conditions within a few packages.
+         * The target delay is the smallest delay, which covers the given quantile of all (weighted) package delays.
+         */
+        class PlayoutDelayEstimator
+        {
+        public:
+            /*!
+             * \param lateLossQuantile The quantile of packages (between 0 and 1) to arrive in time, e.g. 0.97
+             */
+            PlayoutDelayEstimator(const double lateLossQuantile);
+
+            /*!
+             * Adds the delay of the received package to the distribution
+             *
+             * \param sequenceNumber The sequence number of the package
+             * \param rtpTimestamp The RTP timestamp of the package, in milliseconds
+             * \param receptionTime The time the package was received
+             */
+            void addPackage(const uint16_t sequenceNumber, const uint32_t rtpTimestamp, const std::chrono::steady_clock::time_point receptionTime);
+
+            /*!
+             * \return whether enough packages were received to estimate the delay
+             */
+            bool hasEstimation() const;
+
+            /*!
+             * \return the estimated playout delay in milliseconds
+             */
+            uint32_t getTargetDelay() const;
+
+            /*!
+             * \return the estimated playout delay in number of packages
+             */
+            uint16_t getTargetDelayPackages() const;
+
+            /*!
+             * Discards all collected delays
+             */
+            void reset();
+
+        private:
+            //the width of a histogram bin, in milliseconds
+            static constexpr unsigned int BIN_WIDTH{2};
+            //the number of bins, all larger delays are counted in the last bin
+            static constexpr unsigned int NUM_BINS{256};
+            //the weight of the previous distribution for every new package
+            static constexpr double FORGETTING_FACTOR{0.99};
+            //the number of packages to determine the fastest package from
+            static constexpr unsigned int MIN_DELAY_WINDOW{128};
+            //the number of packages required before the estimation is used
+            static constexpr unsigned int MIN_PACKAGES{10};
+
+            const double lateLossQuantile;
+            std::array<double, NUM_BINS> histogram;
+            double totalWeight;
+            //the relative delays (reception time minus RTP timestamp) of the last packages
+            std::array<int32_t, MIN_DELAY_WINDOW> relativeDelays;
+            unsigned int numPackages;
+            uint16_t lastSequenceNumber;
+            uint32_t lastTimestamp;
+            //the estimated duration of the audio in a single package, in milliseconds
+            double packageDuration;
+            uint32_t targetDelay;
+        };
+    }
+}
+
+#endif	/* PLAYOUTDELAYESTIMATOR_H */
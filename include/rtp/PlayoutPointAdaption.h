@@ -8,11 +8,46 @@
 #ifndef PLAYOUTPOINTADAPTION_H
 #define	PLAYOUTPOINTADAPTION_H
 
+#include <atomic>
+#include <memory>
+
+#include "PlayoutDelayEstimator.h"
+
 namespace ohmcomm
 {
     namespace rtp
     {
 
+        /*!
+         * The algorithms available to adapt the playout delay
+         */
+        enum class PlayoutAdaptionMode
+        {
+            //! Increase/decrease the delay by one package, if the ratio of late losses exceeds fixed thresholds
+            LATE_LOSS_THRESHOLDS,
+            //! Set the delay to the given quantile of the distribution of package delays (see PlayoutDelayEstimator)
+            DELAY_QUANTILE
+        };
+
+        /*!
+         * The settings for the playout point adaption
+         */
+        struct PlayoutAdaptionSettings
+        {
+            //! The algorithm to use
+            PlayoutAdaptionMode mode;
+            //! The quantile of packages to arrive in time (between 0 and 1), only used for DELAY_QUANTILE
+            double lateLossQuantile;
+            //! Whether to drop/insert single frames to compensate the clock-drift between remote and local device (see ClockDriftCompensation)
+            bool compensateClockDrift;
+
+            PlayoutAdaptionSettings(const PlayoutAdaptionMode mode = PlayoutAdaptionMode::LATE_LOSS_THRESHOLDS, const double lateLossQuantile = 0.97,
+                                    const bool compensateClockDrift = true) :
+                mode(mode), lateLossQuantile(lateLossQuantile), compensateClockDrift(compensateClockDrift)
+            {
+            }
+        };
+
         /*!
          * Mixin to support dynamic playout point adaption for jitter-buffers
          */
@@ -23,9 +58,11 @@ namespace ohmcomm
             /*!
              * \param adaptionCycle The number of package receptions before adapting the playout delay
              * \param initialPackagesDelay the initial playout delay
+             * \param settings the algorithm to use for adapting the playout delay
              */
-            PlayoutPointAdaption(const uint16_t adaptionCycle, const uint16_t initialPackagesDelay = 0) : adaptionCycle(adaptionCycle),
-            numDelayPackages(initialPackagesDelay), numLateLosses(0), numWrites(0)
+            PlayoutPointAdaption(const uint16_t adaptionCycle, const uint16_t initialPackagesDelay = 0, const PlayoutAdaptionSettings& settings = PlayoutAdaptionSettings()) :
+            adaptionCycle(adaptionCycle), initialPackagesDelay(initialPackagesDelay), numDelayPackages(initialPackagesDelay), numLateLosses(0), numWrites(0),
+            delayEstimator(settings.mode == PlayoutAdaptionMode::DELAY_QUANTILE ? new PlayoutDelayEstimator(settings.lateLossQuantile) : nullptr)
             {
 
             }
@@ -39,7 +76,15 @@ namespace ohmcomm
              */
             inline bool isAdaptionBufferFilled() const
             {
-                return getSize() >= numDelayPackages;
+                return getSize() >= numDelayPackages.load(std::memory_order_relaxed);
+            }
+
+            /*!
+             * \return the number of packages currently held back to generate the playout delay
+             */
+            inline uint16_t getPlayoutDelayPackages() const
+            {
+                return numDelayPackages.load(std::memory_order_relaxed);
             }
 
             /*!
@@ -48,9 +93,22 @@ namespace ohmcomm
              * NOTE: this method must be called on every package reception
              * 
              * \param isLateLoss whether the received package was a late loss
+             * \param sequenceNumber the sequence number of the received package
+             * \param rtpTimestamp the RTP timestamp of the received package
+             * \param receptionTime the time the package was received
              */
-            inline void packageReceived(const bool isLateLoss)
+            inline void packageReceived(const bool isLateLoss, const uint16_t sequenceNumber, const uint32_t rtpTimestamp, const std::chrono::steady_clock::time_point receptionTime)
             {
+                if(delayEstimator)
+                {
+                    //late losses are part of the delay distribution too
+                    delayEstimator->addPackage(sequenceNumber, rtpTimestamp, receptionTime);
+                    if(delayEstimator->hasEstimation())
+                    {
+                        numDelayPackages = delayEstimator->getTargetDelayPackages();
+                    }
+                    return;
+                }
                 //increase number of packages received since last update
                 ++numWrites;
                 if (isLateLoss)
@@ -75,6 +133,18 @@ namespace ohmcomm
                 }
             }
 
+            /*!
+             * Resets the playout delay to its initial value, e.g. when the buffer is reused for another stream
+             */
+            inline void resetAdaption()
+            {
+                numDelayPackages = initialPackagesDelay;
+                numLateLosses = 0;
+                numWrites = 0;
+                if(delayEstimator)
+                    delayEstimator->reset();
+            }
+
             /*!
              * \return the number of packages in this buffer
              */
@@ -86,12 +156,17 @@ namespace ohmcomm
             constexpr static double LATE_LOSS_DECREASE_THRESHOLD = 0.05;
             //interval for adapting the playout point, in number of package receptions
             const uint16_t adaptionCycle;
+            //the playout delay to start with
+            const uint16_t initialPackagesDelay;
             //number of packages to be held back to generate the required delay
-            uint16_t numDelayPackages;
+            //this is written on package reception and read on play-out, which may run in different threads
+            std::atomic<uint16_t> numDelayPackages;
             //number of late losses since the last adaption
             uint16_t numLateLosses;
             //number of packages received since the last adaption
             uint16_t numWrites;
+            //the estimator for the delay-distribution, only set for PlayoutAdaptionMode::DELAY_QUANTILE
+            const std::unique_ptr<PlayoutDelayEstimator> delayEstimator;
         };
     }
 }
@@ -8,7 +8,10 @@
 #include "network/NetworkWrapper.h"
 #include "RTPBufferHandler.h"
 #include "RTPListener.h"
+#include "RTPSender.h"
+#include "SharedMediaSocket.h"
 #include "JitterBuffers.h"
+#include "Parameters.h"
 
 namespace ohmcomm
 {
@@ -18,9 +21,11 @@ namespace ohmcomm
         /*!
          * AudioProcessor wrapping/unwrapping audio-frames in/out of a RTP-package
          *
-         * This implementation uses a separate thread (see RTPListener) to receive packages.
-         * This was implemented to avoid blocking the audio-loop while waiting for packages.
-         * The received RTPPackages are buffered in an RTPBuffer
+         * This implementation uses a separate thread (see RTPListener) to receive packages and another one (see RTPSender) to send them.
+         * This was implemented to avoid blocking the audio-loop while waiting for the network.
+         * The received RTPPackages are buffered in an RTPBuffer per remote.
+         *
+         * On output, the packages of every remote are provided as separate stream (see StreamData#numStreams) to be decoded and mixed
          */
         class ProcessorRTP : public AudioProcessor
         {
@@ -36,6 +41,37 @@ namespace ohmcomm
              */
             ProcessorRTP(const std::string name, const NetworkConfiguration& networkConfig, const PayloadType payloadType);
 
+            /*!
+             * Constructs a new ProcessorRTP for a session on a socket shared with other sessions.
+             * The packages are received by the shared socket and RTCP is always multiplexed on the same port
+             *
+             * \param name The name of the AudioProcessor
+             *
+             * \param networkConfig The network-configuration of the remote, the local port is determined by the shared socket
+             *
+             * \param payloadType The payload-type for the RTP packages
+             *
+             * \param sharedSocket The local socket to add the session to
+             */
+            ProcessorRTP(const std::string name, const NetworkConfiguration& networkConfig, const PayloadType payloadType, const std::shared_ptr<SharedMediaSocket> sharedSocket);
+
+            /*!
+             * Constructs a new ProcessorRTP sending and receiving via the given network, e.g. an endpoint of a NetworkEmulator.
+             * RTCP is always multiplexed on the same network
+             *
+             * \param name The name of the AudioProcessor
+             *
+             * \param network The network to use for RTP and RTCP
+             *
+             * \param payloadType The payload-type for the RTP packages
+             *
+             * \param ourselves The local participant to send as, so several processors in a single process can use their own SSRC
+             */
+            ProcessorRTP(const std::string name, const std::shared_ptr<ohmcomm::network::NetworkWrapper> network, const PayloadType payloadType,
+                         Participant& ourselves = ParticipantDatabase::self());
+
+            ~ProcessorRTP();
+
             void configure(const AudioConfiguration& audioConfig, const std::shared_ptr<ConfigurationMode> configMode, const uint16_t bufferSize, const ProcessorCapabilities& chainCapabilities) override;
 
             void startup() override;
@@ -48,18 +84,67 @@ namespace ohmcomm
             //! Delay until treating input as silence
             //!Treat as silence after 500ms of no input
             static constexpr unsigned short SILENCE_DELAY{500};
+            //! Interval (in ms) to repeat the comfort-noise parameters during silence, even if the noise does not change
+            static constexpr unsigned short COMFORT_NOISE_INTERVAL{200};
+            //! Change of the noise-level (in dB) to immediately send new comfort-noise parameters
+            static constexpr uint8_t COMFORT_NOISE_LEVEL_CHANGE{3};
+            //! The default jitter-buffer settings, if not configured otherwise
+            static constexpr uint16_t DEFAULT_BUFFER_CAPACITY{128};
+            static constexpr uint16_t DEFAULT_BUFFER_MAX_DELAY{200};
+            static constexpr uint16_t DEFAULT_BUFFER_MIN_PACKAGES{1};
             const std::shared_ptr<ohmcomm::network::NetworkWrapper> network;
-            JitterBuffers buffers;
+            //the session on a shared socket, nullptr if the network is used exclusively
+            const std::shared_ptr<SharedMediaSocket::Session> sharedSession;
+            //whether RTCP is multiplexed on the network, regardless of the configured RTCP-port
+            const bool alwaysMultiplexRTCP;
+            std::unique_ptr<JitterBuffers> buffers;
             Participant& ourselves;
             std::unique_ptr<RTPPackageHandler> rtpPackage;
-            std::unique_ptr<RTPListener> rtpListener;
+            //declared before the listener, which may pass multiplexed packages to it and therefore must be destroyed first
             std::unique_ptr<RTCPHandler> rtcpHandler;
+            std::unique_ptr<RTPListener> rtpListener;
+            std::unique_ptr<RTPSender> rtpSender;
             bool isDTXEnabled;
             bool lastPackageWasSilent;
             unsigned short totalSilenceDelayPackages;
             unsigned int currentSilenceDelayPackages;
+            unsigned short comfortNoiseIntervalPackages;
+            unsigned int packagesSinceComfortNoise;
+            uint8_t lastComfortNoiseLevel;
+            //the size of the last audio-payload received, to pass a dummy payload of the same size to the decoder on comfort-noise
+            unsigned int lastPayloadSize;
+            //the SSRCs of the remotes read in the current output-cycle, one stream per remote
+            uint32_t activeStreams[JitterBuffers::DEFAULT_MAX_STREAMS];
+            unsigned int numActiveStreams;
 
             void initPackageHandler(unsigned int maxBufferSize);
+
+            /*!
+             * Sends the comfort-noise parameters of the current silent package (see RFC 3389),
+             * at the start of a silence period, if the noise-level changed or after the comfort-noise interval elapsed
+             */
+            void sendComfortNoise(const StreamData* userData, const bool isSilenceStart);
+
+            /*!
+             * Queues the RTP-package consisting of the given header and payload for sending and updates the statistics
+             */
+            void sendPackage(const RTPHeader* header, const void* payload, const unsigned int payloadSize, const unsigned int numFrames);
+
+            /*!
+             * \return a multicast-wrapper joining the group, if the remote address is a multicast-group, a plain UDP-wrapper otherwise
+             */
+            static std::shared_ptr<ohmcomm::network::NetworkWrapper> createNetworkWrapper(const ohmcomm::NetworkConfiguration& networkConfig);
+
+            /*!
+             * \return the size of a single sample of the given audio-format, in bytes
+             */
+            static unsigned int getSampleSize(const unsigned int audioFormatFlag);
+
+            /*!
+             * \return the configured value for the given jitter-buffer setting or the default value, if it is not configured
+             */
+            static uint16_t getJitterBufferSetting(const std::shared_ptr<ConfigurationMode> configMode, const Parameter* param, const std::string& message,
+                                                   const uint16_t defaultValue, const uint16_t minValue);
         };
     }
 }
@@ -10,6 +10,7 @@
 
 #include <memory>
 #include <thread>
+#include "network/EventLoop.h"
 #include "network/NetworkWrapper.h"
 #include "ParticipantDatabase.h"
 #include "RTCPPackageHandler.h"
@@ -21,9 +22,11 @@ namespace ohmcomm
     {
 
         /*!
-         * The RTCPHandler manages a thread for RTCP-communication.
+         * The RTCPHandler manages the RTCP-communication, either on a shared EventLoop or (if not supported) in its own thread.
          * 
          * The port occupied by RTCP is per standard the RTP-port +1.
+         * If RTP and RTCP are multiplexed on the RTP-port (RFC 5761), the RTP-socket is shared and the RTCP-packages are received
+         * by the RTPListener, so this class only sends the reports.
          * 
          * The RTCP handler is managed by the RTP-processor
          */
@@ -31,6 +34,16 @@ namespace ohmcomm
         {
         public:
             RTCPHandler(const NetworkConfiguration& rtcpConfig, const std::shared_ptr<ConfigurationMode> configMode, const bool isActiveSender = true);
+
+            /*!
+             * Creates a RTCP-handler multiplexing RTCP with RTP on the given wrapper (rtcp-mux)
+             *
+             * \param rtpWrapper The NetworkWrapper used for RTP, the received RTCP-packages must be passed by the RTPListener
+             *
+             * \param ourselves The local participant to send the reports for
+             */
+            RTCPHandler(const std::shared_ptr<ohmcomm::network::NetworkWrapper> rtpWrapper, const std::shared_ptr<ConfigurationMode> configMode, const bool isActiveSender = true,
+                        Participant& ourselves = ParticipantDatabase::self());
             ~RTCPHandler();
 
             virtual void onRemoteAdded(const unsigned int ssrc) override;
@@ -38,37 +51,62 @@ namespace ohmcomm
             virtual void onRemoteRemoved(const unsigned int ssrc) override;
 
         private:
-            const std::unique_ptr<ohmcomm::network::NetworkWrapper> wrapper;
+            const std::shared_ptr<ohmcomm::network::NetworkWrapper> wrapper;
             const std::shared_ptr<ConfigurationMode> configMode;
             const bool isActiveSender;
+            //whether the socket is shared with RTP
+            const bool isMultiplexed;
             RTCPPackageHandler rtcpHandler;
             Participant& ourselves;
 
             std::thread listenerThread;
             bool threadRunning = false;
+            //the event-loop watching the socket, nullptr if the listener-thread is used
+            ohmcomm::network::EventLoop* eventLoop = nullptr;
+            int loopSocket = INVALID_SOCKET;
+            ohmcomm::network::EventLoop::TimerID reportTimer = 0;
 
             //send SR/RR every X seconds
             static const std::chrono::seconds sendSRInterval;
             //timeout before the remote is considered offline
             static const std::chrono::seconds remoteDropoutTimeout;
+            //the interval to check for the next report, if a multiplexed handler runs its own thread
+            static constexpr std::chrono::milliseconds MULTIPLEXED_WAIT_INTERVAL{100};
 
             /*!
              * Method called in the parallel thread, receiving RTCP-packages and handling them
              */
             void runThread();
+
+            /*!
+             * Receives and handles a single RTCP-package
+             */
+            void receivePackage();
+
+            /*!
+             * Handles a single received package, if it is an RTCP-package
+             */
+            void handlePackage(const void* receiveBuffer, const unsigned int receivedSize);
+
+            /*!
+             * Checks for timed-out remotes and sends a report, called every #sendSRInterval
+             */
+            void sendReport();
             
              /*!
-             * Shuts down the RTCP-thread
+             * Shuts down the RTCP-thread (or removes the socket from the event-loop)
              */
             void shutdown();
 
             /*!
-             * Starts the RTCP-thread
+             * Starts the RTCP-thread (or adds the socket to an event-loop)
+             *
+             * \param loop The event-loop to watch the socket in, one of the shared loops if not given
              */
-            void startUp();
+            void startUp(ohmcomm::network::EventLoop* loop = nullptr);
 
             /*!
-             * This method handles received RTCP packages and is called only from #runThread()
+             * This method handles received RTCP packages and is called only from #handlePackage()
              * 
              * \return the SSRC of the originating participant
              */
@@ -77,7 +115,7 @@ namespace ohmcomm
             void shutdownInternal();
 
             /*!
-             * Sends a Source Description-package, only called from #runThread()
+             * Sends a Source Description-package, only called from #sendReport()
              */
             void sendSourceDescription();
 
@@ -110,6 +148,8 @@ namespace ohmcomm
             
             //enables access to private methods for RTP-processor
             friend class ProcessorRTP;
+            //passes the multiplexed RTCP-packages
+            friend class RTPListener;
         };
     }
 }
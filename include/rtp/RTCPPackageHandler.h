@@ -195,6 +195,20 @@ namespace ohmcomm
              */
             static bool isRTCPPackage(const void* packageBuffer, const unsigned int packageLength);
 
+            /*!
+             * Distinguishes RTCP- from RTP-packages received on the same port (rtcp-mux), as specified in RFC 5761 section 4.
+             *
+             * The second byte of an RTCP-package (the package-type) is within 192 to 223, which is only reached by RTP-packages
+             * with the payload-types 64 to 95. These must not be used, if RTP and RTCP are multiplexed.
+             *
+             * \param packageBuffer The buffer storing the package-data
+             *
+             * \param packageLength The length of the package in bytes
+             *
+             * \return Whether the package is to be handled as RTCP-package
+             */
+            static bool isMultiplexedRTCPPackage(const void* packageBuffer, const unsigned int packageLength);
+
             /*!
              * \param lengthHeaderField The value of the RTCP header-field "length"
              *
@@ -9,10 +9,13 @@
 #define	RTPBUFFER_H
 
 #include <mutex>    //std::mutex
+#include <vector>
 
+#include "ParticipantDatabase.h"
 #include "RTPBufferHandler.h"
 #include "PlayoutPointAdaption.h"
 #include "LossConcealment.h"
+#include "ClockDriftCompensation.h"
 
 namespace ohmcomm
 {
@@ -22,7 +25,7 @@ namespace ohmcomm
         /*!
          * Serves as jitter-buffer for RTP packages
          */
-        class RTPBuffer : public RTPBufferHandler, private PlayoutPointAdaption, private LossConcealment
+        class RTPBuffer : public RTPBufferHandler, private PlayoutPointAdaption, private LossConcealment, private ClockDriftCompensation
         {
         public:
             /*!
@@ -30,8 +33,11 @@ namespace ohmcomm
              * \param maxCapacity The maximum number of packages to buffer
              * \param maxDelay The maximum delay in milliseconds before dropping packages
              * \param minBufferPackages The minimum of packages to buffer before returning valid audio-data
+             * \param maxPayloadSize The maximum size in bytes of the payload of a single package
+             * \param adaptionSettings The algorithm to adapt the playout delay with
              */
-            RTPBuffer(uint32_t ssrc, uint16_t maxCapacity, uint16_t maxDelay, uint16_t minBufferPackages = 1);
+            RTPBuffer(uint32_t ssrc, uint16_t maxCapacity, uint16_t maxDelay, uint16_t minBufferPackages = 1, unsigned int maxPayloadSize = DEFAULT_MAX_PAYLOAD_SIZE,
+                      const PlayoutAdaptionSettings& adaptionSettings = PlayoutAdaptionSettings());
             ~RTPBuffer();
 
             /*!
@@ -43,7 +49,8 @@ namespace ohmcomm
              *
              * Returns zero on success or one of the RTPBufferStatus-codes listed in RTPBuffer.h
              */
-            RTPBufferStatus addPackage(const RTPPackageHandler &package, unsigned int contentSize) override;
+            using RTPBufferHandler::addPackage;
+            RTPBufferStatus addPackage(const RTPPackageHandler &package, unsigned int contentSize, const std::chrono::steady_clock::time_point receptionTime) override;
 
             /*!
              * Reads the oldest package in the buffer and writes it into the package-variable
@@ -53,27 +60,42 @@ namespace ohmcomm
              */
             RTPBufferStatus readPackage(RTPPackageHandler &package) override;
 
+            /*!
+             * Reads the oldest package in the buffer without copying it, the leased entry is not overwritten until the lease is released
+             */
+            RTPBufferStatus leasePackage(PackageLease& lease) override;
+
             /*!
              * Returns the size of the buffer, the number of stored elements
              */
             unsigned int getSize() const override;
+
+            /*!
+             * Resets the buffer, this method is thread-safe
+             */
+            void reset(const uint32_t ssrc) override;
+        protected:
+
+            void releasePackage(const PackageLease& lease) override;
+
         private:
 
             bool repeatLastPackage(RTPPackageHandler& package, const uint16_t packageSequenceNumber) override;
             /*!
-             * Mutex guarding all access to ringBuffer, nextReadIndex, size and minSequenceNumber
+             * Mutex guarding all access to the arena, occupiedSlots, nextReadIndex, size, minSequenceNumber and leasedIndex
              */
             std::mutex bufferMutex;
 
+            //! The size of a cache-line, all slots in the arena are aligned to
+            static constexpr std::size_t CACHE_LINE_SIZE{64};
+
             /*!
-             * Internal data structure to buffer RTP packages
+             * Internal data structure to buffer RTP packages.
+             *
+             * The entries are placed into the arena, each directly followed by its package data
              */
             struct RTPBufferPackage
             {
-                /*!
-                 * The valid-state of the buffer entry
-                 */
-                bool isValid;
                 /*!
                  * The RTPHeader
                  */
@@ -86,34 +108,49 @@ namespace ohmcomm
                  * The package size in bytes (size of the content)
                  */
                 unsigned int contentSize;
-                /*!
-                 * The size of the buffer, this is at least contentSize
-                 */
-                unsigned int bufferSize;
-                /*!
-                 * The package data
-                 */
-                void *packageContent;
 
-                RTPBufferPackage() : isValid(false), header(), receptionTimestamp(std::chrono::steady_clock::time_point::min()), contentSize(0), bufferSize(0), packageContent(nullptr)
+                RTPBufferPackage() : header(), receptionTimestamp(std::chrono::steady_clock::time_point::min()), contentSize(0)
                 {
 
                 }
 
-                ~RTPBufferPackage()
+                /*!
+                 * \return the package data, stored directly behind this entry
+                 */
+                inline char* getContent()
                 {
-                    free(packageContent);
+                    return reinterpret_cast<char*>(this) + sizeof(RTPBufferPackage);
                 }
             };
 
             /*!
-             * The ring-buffer containing the packages
+             * The memory allocated on construction, large enough to hold the cache-line aligned arena
+             */
+            char* arenaMemory;
+            /*!
+             * The (cache-line aligned) memory for all entries and their package data
+             */
+            char* arena;
+            /*!
+             * The distance in bytes between two entries in the arena, a multiple of CACHE_LINE_SIZE
              */
-            RTPBuffer::RTPBufferPackage *ringBuffer;
+            const std::size_t slotSize;
+            /*!
+             * The maximum size of a single payload
+             */
+            const unsigned int maxPayloadSize;
+            /*!
+             * Bit-set of all entries containing a valid package, the bit for index i is (i % 64) in the word (i / 64)
+             */
+            std::vector<uint64_t> occupiedSlots;
             /*!
              * The remote SSRC this buffer is associated with
              */
-            const uint32_t ssrc;
+            uint32_t ssrc;
+            /*!
+             * The participants to count the lost packages for, only accessed by the reading thread
+             */
+            ParticipantCache participants;
             /*!
              * The maximum entries in the buffer, size of the array
              */
@@ -143,10 +180,69 @@ namespace ohmcomm
              */
             uint16_t minSequenceNumber;
 
+            /*!
+             * The index of the entry currently leased by the consumer or capacity, if no entry is leased.
+             * The leased entry must not be overwritten by new packages
+             */
+            uint16_t leasedIndex;
+
+            /*!
+             * The package to write concealment-packages into, when leasing a package from an underflowing buffer
+             */
+            RTPPackageHandler concealmentPackage;
+
             /*!
              * Calculates the new index in the buffer
              */
             uint16_t calculateIndex(uint16_t index, uint16_t offset);
+
+            /*!
+             * \return the entry at the given index in the ring
+             */
+            inline RTPBufferPackage& getPackage(uint16_t index)
+            {
+                return *reinterpret_cast<RTPBufferPackage*>(arena + index * slotSize);
+            }
+
+            inline bool isOccupied(uint16_t index) const
+            {
+                return (occupiedSlots[index / 64] & (UINT64_C(1) << (index % 64))) != 0;
+            }
+
+            inline void setOccupied(uint16_t index)
+            {
+                occupiedSlots[index / 64] |= UINT64_C(1) << (index % 64);
+            }
+
+            inline void clearOccupied(uint16_t index)
+            {
+                occupiedSlots[index / 64] &= ~(UINT64_C(1) << (index % 64));
+            }
+
+            /*!
+             * Searches the ring for the next entry containing a valid package, starting at the given index and wrapping around
+             *
+             * \return the index of the next occupied entry or capacity, if the buffer is empty
+             */
+            uint16_t findOccupiedIndex(uint16_t startIndex) const;
+
+            /*!
+             * \return the index of the first occupied entry in [fromIndex, toIndex) or toIndex, if there is none
+             */
+            uint16_t findOccupiedIndex(uint16_t fromIndex, uint16_t toIndex) const;
+
+            /*!
+             * Determines the next package to play out and updates the state of the buffer accordingly. Must be called with the mutex locked.
+             *
+             * \param package The package to write concealment- and repeated packages into
+             * \param bufferPack Is set to the entry to play out or nullptr, if the package to play out was written into the package
+             */
+            RTPBufferStatus nextPackage(RTPPackageHandler& package, RTPBufferPackage*& bufferPack);
+
+            /*!
+             * \return the cache-line aligned start of the given memory
+             */
+            static char* alignToCacheLine(char* memory);
         };
     }
 }
@@ -183,7 +183,8 @@ namespace ohmcomm
              *
              * Returns zero on success or one of the RTPBufferStatus-codes listed in RTPBuffer.h
              */
-            RTPBufferStatus addPackage(const RTPPackageHandler &package, unsigned int contentSize);
+            using RTPBufferHandler::addPackage;
+            RTPBufferStatus addPackage(const RTPPackageHandler &package, unsigned int contentSize, const std::chrono::steady_clock::time_point receptionTime) override;
 
             /*!
              * Reads the current package in the buffer and writes it into the package-variable
@@ -193,7 +194,14 @@ namespace ohmcomm
              */
             RTPBufferStatus readPackage(RTPPackageHandler &package);
 
+            /*!
+             * This buffer does not support leasing packages in place, so the package is copied into an internal package
+             */
+            RTPBufferStatus leasePackage(PackageLease& lease);
+
             unsigned int getSize() const;
+
+            void reset(const uint32_t ssrc);
         private:
             int isPowerOfTwo(unsigned int x);
             void initializeRingBuffer(unsigned int contentSize, unsigned int rtpHeaderSize);
@@ -221,6 +229,7 @@ namespace ohmcomm
             uint16_t maxDelay;
             uint16_t minBufferPackages;
             uint16_t log;
+            RTPPackageHandler leasedPackage{DEFAULT_MAX_PAYLOAD_SIZE};
         };
     }
 }
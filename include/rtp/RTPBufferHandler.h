@@ -1,6 +1,7 @@
 #ifndef RTPBUFFERHANDLER_H
 #define	RTPBUFFERHANDLER_H
 
+#include "BufferClock.h"
 #include "RTPPackageHandler.h"
 #include "Statistics.h"
 
@@ -35,6 +36,109 @@ namespace ohmcomm
             RTP_BUFFER_IS_PUFFERING
         };
 
+        class RTPBufferHandler;
+
+        /*!
+         * Read-only view of a package played out of a jitter-buffer (see RTPBufferHandler#leasePackage).
+         *
+         * Other than RTPBufferHandler#readPackage, the package is not copied out of the buffer.
+         * The buffer guarantees to not overwrite the package data until the lease is released, which happens at the latest
+         * when the lease is destroyed or used to lease the next package.
+         *
+         * NOTE: The lease must be released before the buffer is destroyed or reset
+         */
+        class PackageLease
+        {
+        public:
+
+            PackageLease() : owner(nullptr), header(nullptr), payload(nullptr), payloadSize(0), slotIndex(0)
+            {
+            }
+
+            PackageLease(PackageLease&& other) : owner(other.owner), header(other.header), payload(other.payload), payloadSize(other.payloadSize), slotIndex(other.slotIndex)
+            {
+                other.owner = nullptr;
+                other.header = nullptr;
+                other.payload = nullptr;
+                other.payloadSize = 0;
+            }
+
+            PackageLease(const PackageLease&) = delete;
+
+            ~PackageLease()
+            {
+                release();
+            }
+
+            PackageLease& operator=(PackageLease&& other)
+            {
+                if(this != &other)
+                {
+                    release();
+                    owner = other.owner;
+                    header = other.header;
+                    payload = other.payload;
+                    payloadSize = other.payloadSize;
+                    slotIndex = other.slotIndex;
+                    other.owner = nullptr;
+                    other.header = nullptr;
+                    other.payload = nullptr;
+                    other.payloadSize = 0;
+                }
+                return *this;
+            }
+
+            PackageLease& operator=(const PackageLease&) = delete;
+
+            /*!
+             * \return whether this lease currently references a package
+             */
+            inline bool isValid() const
+            {
+                return header != nullptr;
+            }
+
+            /*!
+             * \return the RTP header of the leased package
+             */
+            inline const RTPHeader* getHeader() const
+            {
+                return header;
+            }
+
+            /*!
+             * \return the payload of the leased package
+             */
+            inline const void* getPayload() const
+            {
+                return payload;
+            }
+
+            /*!
+             * \return the size in bytes of the payload
+             */
+            inline unsigned int getPayloadSize() const
+            {
+                return payloadSize;
+            }
+
+            /*!
+             * Gives the package back to the buffer, the package must not be accessed afterwards
+             */
+            inline void release();
+
+        private:
+            //the buffer to give the package back to, nullptr if the buffer doesn't need to be notified
+            RTPBufferHandler* owner;
+            const RTPHeader* header;
+            const void* payload;
+            unsigned int payloadSize;
+            //the buffer-specific position of the leased package
+            unsigned int slotIndex;
+
+            friend class RTPBufferHandler;
+        };
+
         /*!
          * Abstract super-type for all classes used as RTPBuffer (Jitter-Buffer)
          */
@@ -53,8 +157,22 @@ namespace ohmcomm
              * \param package The package to add
              *
              * \param contentSize The size of the audio data in the package
+             *
+             * \param receptionTime The time the package was received, e.g. the arrival-time reported by the kernel
+             */
+            virtual RTPBufferStatus addPackage(const RTPPackageHandler &package, unsigned int contentSize, const std::chrono::steady_clock::time_point receptionTime) = 0;
+
+            /*!
+             * Adds a packet received just now to the buffer
+             *
+             * \param package The package to add
+             *
+             * \param contentSize The size of the audio data in the package
              */
-            virtual RTPBufferStatus addPackage(const RTPPackageHandler &package, unsigned int contentSize) = 0;
+            inline RTPBufferStatus addPackage(const RTPPackageHandler &package, unsigned int contentSize)
+            {
+                return addPackage(package, contentSize, BufferClock::now());
+            }
 
             /*!
              * Reads a package from the buffer and writes its content into the given parameter
@@ -63,11 +181,87 @@ namespace ohmcomm
              */
             virtual RTPBufferStatus readPackage(RTPPackageHandler &package) = 0;
 
+            /*!
+             * Reads a package from the buffer like #readPackage, but without copying it.
+             *
+             * The package (or the concealment-package created on underflow) stays accessible via the lease, until the lease is released.
+             * Any lease previously held by the given object is released first.
+             *
+             * NOTE: Only a single lease per buffer may be held at any time
+             *
+             * \param lease The lease to reference the package with
+             */
+            virtual RTPBufferStatus leasePackage(PackageLease& lease) = 0;
+
             /*!
              * Returns the number of currently buffered packages
              */
             virtual unsigned int getSize() const = 0;
+
+            /*!
+             * Drops all buffered packages and resets the state of this buffer, so it can be reused for another stream.
+             *
+             * NOTE: Unless stated otherwise by the implementation, this method must not be called while packages are added or read
+             *
+             * \param ssrc The SSRC of the remote, which packages are buffered from now on
+             */
+            virtual void reset(const uint32_t ssrc) = 0;
+
+            //! The default maximum payload size, large enough for any package fitting into an Ethernet frame
+            static constexpr unsigned int DEFAULT_MAX_PAYLOAD_SIZE{1500};
+
+        protected:
+
+            /*!
+             * Called when a lease referencing this buffer is released, the leased package may be overwritten afterwards
+             */
+            virtual void releasePackage(const PackageLease& lease)
+            {
+            }
+
+            /*!
+             * Lets the lease reference the given package
+             *
+             * \param lease The (released) lease to fill
+             * \param owner The buffer to notify on release or nullptr, if the buffer doesn't need to be notified
+             * \param header The RTP header of the package
+             * \param payload The payload of the package
+             * \param payloadSize The size in bytes of the payload
+             * \param slotIndex The buffer-specific position of the package, passed back on release
+             */
+            static inline void assignLease(PackageLease& lease, RTPBufferHandler* owner, const RTPHeader* header, const void* payload,
+                                           const unsigned int payloadSize, const unsigned int slotIndex = 0)
+            {
+                lease.owner = owner;
+                lease.header = header;
+                lease.payload = payload;
+                lease.payloadSize = payloadSize;
+                lease.slotIndex = slotIndex;
+            }
+
+            /*!
+             * \return the buffer-specific position of the leased package
+             */
+            static inline unsigned int getLeasedSlot(const PackageLease& lease)
+            {
+                return lease.slotIndex;
+            }
+
+            friend class PackageLease;
         };
+
+        inline void PackageLease::release()
+        {
+            RTPBufferHandler* previousOwner = owner;
+            owner = nullptr;
+            if(previousOwner != nullptr)
+            {
+                previousOwner->releasePackage(*this);
+            }
+            header = nullptr;
+            payload = nullptr;
+            payloadSize = 0;
+        }
     }
 }
 #endif
@@ -0,0 +1,203 @@
+#ifndef RTPBUFFERLOCKFREE_H
+#define	RTPBUFFERLOCKFREE_H
+
+#include <atomic>
+#include <vector>
+
+#include "ParticipantDatabase.h"
+#include "RTPBufferHandler.h"
+#include "PlayoutPointAdaption.h"
+#include "LossConcealment.h"
+#include "ClockDriftCompensation.h"
+
+namespace ohmcomm
+{
+    namespace rtp
+    {
+
+        /*!
+         * Jitter-buffer for RTP packages without any locking.
+         *
+         * This buffer has the same reordering, late-loss and play-out behavior as RTPBuffer, but is restricted to
+         * a single producer (the RTPListener calling addPackage) and a single consumer (the audio-thread calling readPackage).
+         * In exchange, neither of the two threads ever needs to wait for the other one, so a burst of received packages
+         * can't stall the audio-callback.
+         *
+         * Every slot in the ring is owned either by the producer (empty) or by the consumer (filled).
+         * The ownership is passed on via an atomic state per slot, so the package-data itself is never accessed concurrently.
+         */
+        class RTPBufferLockFree : public RTPBufferHandler, private PlayoutPointAdaption, private LossConcealment, private ClockDriftCompensation
+        {
+        public:
+            /*!
+             * \param ssrc The SSRC of the remote which packages are buffered here
+             * \param maxCapacity The maximum number of packages to buffer
+             * \param maxDelay The maximum delay in milliseconds before dropping packages
+             * \param minBufferPackages The minimum of packages to buffer before returning valid audio-data
+             * \param maxPayloadSize The maximum size in bytes of the payload of a single package
+             * \param adaptionSettings The algorithm to adapt the playout delay with
+             */
+            RTPBufferLockFree(uint32_t ssrc, uint16_t maxCapacity, uint16_t maxDelay, uint16_t minBufferPackages = 1, unsigned int maxPayloadSize = DEFAULT_MAX_PAYLOAD_SIZE,
+                              const PlayoutAdaptionSettings& adaptionSettings = PlayoutAdaptionSettings());
+            ~RTPBufferLockFree();
+
+            /*!
+             * Adds a new package to the buffer.
+             *
+             * NOTE: This method must only be called from a single thread
+             */
+            using RTPBufferHandler::addPackage;
+            RTPBufferStatus addPackage(const RTPPackageHandler &package, unsigned int contentSize, const std::chrono::steady_clock::time_point receptionTime) override;
+
+            /*!
+             * Reads the oldest package in the buffer and writes it into the package-variable.
+             *
+             * NOTE: This method must only be called from a single thread
+             */
+            RTPBufferStatus readPackage(RTPPackageHandler &package) override;
+
+            /*!
+             * Reads the oldest package in the buffer without copying it, the lease stays valid until the next package is read or leased.
+             *
+             * NOTE: This method must only be called from the same thread as #readPackage
+             */
+            RTPBufferStatus leasePackage(PackageLease& lease) override;
+
+            unsigned int getSize() const override;
+
+            void reset(const uint32_t ssrc) override;
+        private:
+
+            bool repeatLastPackage(RTPPackageHandler& package, const uint16_t packageSequenceNumber) override;
+
+            //the slot is owned by the producer and can be written into
+            static constexpr uint32_t SLOT_EMPTY{0};
+            //flag determining that the slot contains a package and is owned by the consumer, the lower 16 bits are the sequence number
+            static constexpr uint32_t SLOT_FILLED{0x10000};
+            //flag for the resynchronization-request, the lower 16 bits are the new minimum sequence number
+            static constexpr uint32_t RESYNC_REQUESTED{0x10000};
+
+            /*!
+             * Internal data structure to buffer RTP packages
+             */
+            struct Slot
+            {
+                /*!
+                 * The ownership-state of this slot, either SLOT_EMPTY or SLOT_FILLED combined with the sequence number
+                 */
+                std::atomic<uint32_t> state;
+                /*!
+                 * The RTPHeader
+                 */
+                RTPHeader header;
+                /*!
+                 * The timestamp this package was received
+                 */
+                std::chrono::steady_clock::time_point receptionTimestamp;
+                /*!
+                 * The package size in bytes (size of the content)
+                 */
+                unsigned int contentSize;
+                /*!
+                 * The package data, allocated once on construction
+                 */
+                std::vector<char> packageContent;
+
+                Slot() : state(SLOT_EMPTY), header(), receptionTimestamp(std::chrono::steady_clock::time_point::min()), contentSize(0), packageContent()
+                {
+
+                }
+            };
+
+            /*!
+             * The ring-buffer containing the packages, the position of a package is determined by its sequence number
+             */
+            Slot* ringBuffer;
+            /*!
+             * The remote SSRC this buffer is associated with
+             */
+            uint32_t ssrc;
+            /*!
+             * The participants to count the lost packages for, only accessed by the reading thread
+             */
+            ParticipantCache participants;
+            /*!
+             * The maximum entries in the buffer, size of the array
+             */
+            const uint16_t capacity;
+            /*!
+             * The maximum delay (in milliseconds) before dropping a package
+             */
+            const std::chrono::steady_clock::duration maxDelay;
+            /*!
+             * The maximum size of a single payload
+             */
+            const unsigned int maxPayloadSize;
+            /*!
+             * The number of buffered elements, incremented by the producer and decremented by the consumer
+             */
+            std::atomic<uint16_t> size;
+            /*!
+             * The minimum sequence number still accepted, published by the consumer
+             */
+            std::atomic<uint16_t> minSequenceNumber;
+            /*!
+             * Request of the producer to restart the sequence at a new minimum sequence number (first package, after DTX)
+             */
+            std::atomic<uint32_t> resyncRequest;
+
+            //consumer-only state
+            /*!
+             * The minimum sequence number as seen by the consumer
+             */
+            uint16_t readSequenceNumber;
+            /*!
+             * The slot of the last package played out. It is kept filled until the next package is played,
+             * so it can be repeated without copying it out of the buffer.
+             */
+            Slot* lastPlayedSlot;
+            /*!
+             * The package to write concealment-packages into, when leasing a package from an underflowing buffer
+             */
+            RTPPackageHandler concealmentPackage;
+
+            //producer-only state
+            bool hasReceivedPackage;
+
+            /*!
+             * \return the slot the package with the given sequence number is stored in
+             */
+            inline Slot& getSlot(const uint16_t sequenceNumber)
+            {
+                return ringBuffer[sequenceNumber % capacity];
+            }
+
+            /*!
+             * Determines the next package to play out and updates the state of the buffer accordingly
+             *
+             * \param package The package to write concealment- and repeated packages into
+             * \param playedSlot Is set to the slot to play out or nullptr, if the package to play out was written into the package
+             */
+            RTPBufferStatus nextPackage(RTPPackageHandler& package, Slot*& playedSlot);
+
+            /*!
+             * Searches for the oldest valid package, dropping all packages too old on the way
+             *
+             * \return the slot of the next package to play or nullptr, if there is none
+             */
+            Slot* findNextSlot(const std::chrono::steady_clock::time_point currentTimestamp);
+
+            /*!
+             * Passes the ownership of the given slot back to the producer
+             */
+            void releaseSlot(Slot& slot);
+
+            /*!
+             * Publishes the new minimum sequence number to the producer
+             */
+            void updateMinSequenceNumber(const uint16_t sequenceNumber);
+        };
+    }
+}
+#endif	/* RTPBUFFERLOCKFREE_H */
+
@@ -318,7 +318,7 @@ namespace ohmcomm
 
             inline void setPayloadType(PayloadType type)
             {
-                data[1] = data[1] | (type & 0x7F);
+                data[1] = (data[1] & 0x80) | (type & 0x7F);
             }
 
             inline uint16_t getSequenceNumber() const
@@ -9,9 +9,11 @@
 #define	RTPLISTENER_H
 
 #include <thread>
+#include <vector>
 
 #include "ParticipantDatabase.h"
 #include "RTPBufferHandler.h"
+#include "network/EventLoop.h"
 #include "network/NetworkWrapper.h"
 #include "JitterBuffers.h"
 
@@ -19,17 +21,31 @@ namespace ohmcomm
 {
     namespace rtp
     {
+        class RTCPHandler;
+        class SharedMediaSocket;
 
         /*!
          * Listening-thread for incoming RTP-packages
          *
-         * This class starts a new thread which writes all received RTP-packages to the RTPBuffer.
+         * This class writes all received RTP-packages to the RTPBuffer. If the NetworkWrapper provides a socket, it is watched by a shared EventLoop,
+         * otherwise a new thread is started, blocking in the receive-call.
+         *
+         * Packages are received in batches of up to RECEIVE_BATCH_SIZE packages (if supported by the NetworkWrapper) into preallocated buffers.
+         * All packages of a batch from the same remote are handled together, looking up the jitter-buffer and participant only once.
+         *
+         * If RTP and RTCP are multiplexed on the same socket (RFC 5761), the RTCP-packages are distinguished by their payload-type
+         * and passed to the RTCPHandler.
+         *
+         * For a SharedMediaSocket, a single listener receives the packages of all sessions and writes them into the buffers of their session.
          * 
          * The RTP-listener instance is managed by the ProcessorRTP
          */
         class RTPListener
         {
         public:
+            //the maximum number of packages received at once
+            static constexpr unsigned int RECEIVE_BATCH_SIZE{ohmcomm::network::NetworkWrapper::MAX_RECEIVE_BATCH};
+
             /*!
              * Constructs a new RTPListener
              *
@@ -39,32 +55,98 @@ namespace ohmcomm
              *
              * \param receiveBufferSize The maximum size (in bytes) a RTP-package can fill, according to the configuration
              *
+             * \param rtcpHandler The RTCPHandler to pass the multiplexed RTCP-packages to, nullptr if RTCP uses its own socket
+             *
+             * \param ownSSRC The SSRC of the local participant, whose packages looped back (e.g. by a multicast-group) are dropped
+             *
+             */
+            RTPListener(std::shared_ptr<ohmcomm::network::NetworkWrapper> wrapper, JitterBuffers& buffers, unsigned int receiveBufferSize, RTCPHandler* rtcpHandler = nullptr,
+                        const uint32_t ownSSRC = ParticipantDatabase::self().ssrc);
+
+            /*!
+             * Constructs a new RTPListener for all sessions of a shared socket
+             *
+             * \param sharedSocket The socket to look up the session of every package in
+             *
+             * \param wrapper The NetworkWrapper of the shared socket
+             *
+             * \param receiveBufferSize The maximum size (in bytes) a RTP-package can fill
              */
-            RTPListener(std::shared_ptr<ohmcomm::network::NetworkWrapper> wrapper, JitterBuffers& buffers, unsigned int receiveBufferSize);
+            RTPListener(SharedMediaSocket& sharedSocket, std::shared_ptr<ohmcomm::network::NetworkWrapper> wrapper, unsigned int receiveBufferSize);
             RTPListener(const RTPListener& orig);
             ~RTPListener();
 
         private:
+            RTPListener(std::shared_ptr<ohmcomm::network::NetworkWrapper> wrapper, JitterBuffers* buffers, RTCPHandler* rtcpHandler, SharedMediaSocket* sharedSocket,
+                        unsigned int receiveBufferSize, const uint32_t ownSSRC);
+
             const std::shared_ptr<ohmcomm::network::NetworkWrapper> wrapper;
-            JitterBuffers& buffers;
-            RTPPackageHandler rtpHandler;
+            //the buffers and RTCP-handler of the single session, nullptr for a shared socket
+            JitterBuffers* const buffers;
+            RTCPHandler* const rtcpHandler;
+            SharedMediaSocket* const sharedSocket;
+            const uint32_t ownSSRC;
+            //one package-handler per package in a batch, holding the receive-buffers
+            std::vector<RTPPackageHandler> rtpHandlers;
+            std::vector<void*> receiveBuffers;
+            std::vector<ohmcomm::network::NetworkWrapper::Package> receivedPackages;
             std::thread receiveThread;
             bool threadRunning = false;
+            //the event-loop watching the socket, nullptr if the receive-thread is used
+            ohmcomm::network::EventLoop* eventLoop = nullptr;
+            int loopSocket = INVALID_SOCKET;
+            ohmcomm::network::EventLoop::TimerID idleTimer = 0;
+            //the counter of packages dropped by the kernel, as last reported by the wrapper
+            uint32_t droppedPackages = 0;
+            //the participants of this listener, so the receiving threads don't contend for the participant-database
+            ParticipantCache participants;
 
             /*!
              * Method called in the parallel thread, receiving packages and writing them into RTPBuffer
              */
             void runThread();
+
+            /*!
+             * Receives a single batch of packages and writes them into the RTPBuffer
+             */
+            void receivePackages();
+
+            /*!
+             * Writes the given number of received packages into their jitter-buffers, grouped by SSRC (and session)
+             *
+             * The participants are updated and multiplexed RTCP-packages are handled only after releasing the sessions of a shared socket,
+             * since their listeners may close the session (e.g. on a BYE).
+             */
+            void processPackages(const unsigned int numPackages);
+
+            /*!
+             * Releases the buffers of remotes which stopped sending
+             */
+            void removeIdleBuffers();
+
+            /*!
+             * Writes a single package into the jitter-buffer
+             *
+             * \return whether the package was added to the buffer
+             */
+            bool writePackage(const RTPPackageHandler& rtpHandler, const ohmcomm::network::NetworkWrapper::Package& receivedPackage, RTPBufferHandler& buffer);
+
+            /*!
+             * Updates the participant for a package written into the jitter-buffer, the participant is looked up if not yet set
+             */
+            void updateParticipant(const RTPPackageHandler& rtpHandler, const ohmcomm::network::NetworkWrapper::Package& receivedPackage, Participant*& participant);
             
             /*!
-             * Shuts down the receive-thread
+             * Shuts down the receive-thread (or removes the socket from the event-loop)
              */
             void shutdown();
 
             /*!
-             * Starts the receive-thread
+             * Starts the receive-thread (or adds the socket to an event-loop)
+             *
+             * \param loop The event-loop to watch the socket in, one of the shared loops if not given
              */
-            void startUp();
+            void startUp(ohmcomm::network::EventLoop* loop = nullptr);
 
             /*!
              * Calculates the new extended highest sequence number for the received package
@@ -73,6 +155,7 @@ namespace ohmcomm
             
             //enables access to private methods for RTP-processor
             friend class ProcessorRTP;
+            friend class SharedMediaSocket;
         };
     }
 }
@@ -45,6 +45,16 @@ namespace ohmcomm
              */
             virtual const void* createNewRTPPackage(const void* audioData, unsigned int payloadSize);
 
+            /*!
+             * Generates the header for a new RTP-package without copying the payload,
+             * for sending the header and the payload from separate buffers
+             *
+             * \param payloadSize The size in bytes of the payload to be sent with the header
+             *
+             * Returns a pointer to the new header, stored in the internal buffer
+             */
+            RTPHeader* createNewRTPHeader(unsigned int payloadSize);
+
             /*!
              * Returns a pointer to the payload of the internal RTP-package
              */
@@ -118,11 +128,25 @@ namespace ohmcomm
              */
             void createSilencePackage();
 
+            /*!
+             * Creates a comfort-noise package (see RFC 3389) in the internal work-buffer.
+             *
+             * \param noiseParameters The comfort-noise payload, the noise-level and reflection-coefficients
+             *
+             * \param parametersSize The size of the payload in bytes
+             */
+            void createComfortNoisePackage(const void* noiseParameters, unsigned int parametersSize);
+
             /*!
              * Returns the current RTP timestamp for the internal clock
              */
             uint32_t getCurrentRTPTimestamp() const;
 
+            /*!
+             * Returns the RTP timestamp of the internal clock for the given point in time, e.g. the reception-time of a package
+             */
+            uint32_t getRTPTimestamp(const std::chrono::steady_clock::time_point time) const;
+
             /*!
              * This method tries to determine whether the received buffer holds an RTP package.
              *
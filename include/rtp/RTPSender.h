@@ -0,0 +1,108 @@
+/*
+ * File:   RTPSender.h
+ */
+
+#ifndef RTPSENDER_H
+#define	RTPSENDER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "network/NetworkWrapper.h"
+
+namespace ohmcomm
+{
+    namespace rtp
+    {
+
+        /*!
+         * Sending-thread for outgoing RTP-packages
+         *
+         * The audio-thread only copies the packages into a queue of preallocated slots, which is drained by a separate thread.
+         * So a blocking send (e.g. on a full socket-buffer) does not stall the audio-loop.
+         *
+         * The header and payload of a package are copied into separate regions of the slot and sent with a single scatter-gather call,
+         * so they never need to be joined into a contiguous buffer.
+         *
+         * The queue has a single producer (the audio-thread) and a single consumer (the sending-thread) and does not lock.
+         * If the queue is full, new packages are dropped.
+         *
+         * The RTP-sender instance is managed by the ProcessorRTP
+         */
+        class RTPSender
+        {
+        public:
+            //! The number of packages which can be queued at most, a power of two
+            static constexpr uint32_t QUEUE_CAPACITY{32};
+
+            /*!
+             * \param wrapper The NetworkWrapper to use for sending packages
+             * \param maxPayloadSize The maximum size (in bytes) of the payload of a single RTP-package
+             */
+            RTPSender(std::shared_ptr<ohmcomm::network::NetworkWrapper> wrapper, unsigned int maxPayloadSize);
+            ~RTPSender();
+
+            /*!
+             * Copies the package into the queue to be sent by the sending-thread, this method never blocks.
+             *
+             * NOTE: This method must only be called from a single thread
+             *
+             * \param header The header of the RTP-package to send
+             * \param headerSize The size of the header, at most RTPHeader::MAX_HEADER_SIZE bytes
+             * \param payload The payload of the RTP-package
+             * \param payloadSize The size of the payload, in bytes
+             *
+             * \return whether the package was queued, false if the queue is full (or the package too large) and the package was dropped
+             */
+            bool enqueuePackage(const void* header, const unsigned int headerSize, const void* payload, const unsigned int payloadSize);
+
+            /*!
+             * \return the number of packages currently queued
+             */
+            unsigned int getQueueSize() const;
+
+            /*!
+             * Starts the sending-thread
+             */
+            void startUp();
+
+            /*!
+             * Shuts down the sending-thread, after all queued packages are sent
+             */
+            void shutdown();
+
+        private:
+            //the time to wait for new packages before checking whether to shut down
+            static constexpr std::chrono::milliseconds WAIT_TIMEOUT{10};
+
+            const std::shared_ptr<ohmcomm::network::NetworkWrapper> wrapper;
+            const unsigned int maxPayloadSize;
+            //the size of a slot: the maximum header-size followed by the maximum payload-size
+            const unsigned int slotSize;
+            //the slots for the package-data, QUEUE_CAPACITY slots of slotSize bytes
+            std::vector<char> packageData;
+            std::vector<unsigned int> headerSizes;
+            std::vector<unsigned int> payloadSizes;
+            //the number of packages queued and sent in total, the difference is the number of packages in the queue
+            std::atomic<uint32_t> writeIndex;
+            std::atomic<uint32_t> readIndex;
+            std::thread sendThread;
+            std::atomic<bool> threadRunning;
+            //only used to wait for new packages, the queue itself is not guarded
+            std::mutex waitMutex;
+            std::condition_variable packageAvailable;
+
+            /*!
+             * Method called in the parallel thread, sending all queued packages
+             */
+            void runThread();
+        };
+    }
+}
+#endif	/* RTPSENDER_H */
+
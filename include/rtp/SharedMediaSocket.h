@@ -0,0 +1,175 @@
+/*
+ * File:   SharedMediaSocket.h
+ */
+
+#ifndef SHAREDMEDIASOCKET_H
+#define	SHAREDMEDIASOCKET_H
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "network/EventLoop.h"
+#include "network/UDPWrapper.h"
+#include "RTPBufferHandler.h"
+
+namespace ohmcomm
+{
+    namespace rtp
+    {
+        class JitterBuffers;
+        class MediaWorkerPool;
+        class RTCPHandler;
+        class RTPListener;
+
+        /*!
+         * A single local UDP-port shared by many RTP-sessions (e.g. the calls of a media-server), so the number of sessions is not
+         * limited by the number of ports and all sessions are received by a single RTPListener instead of one thread per session.
+         *
+         * The received packages are assigned to the sessions by their SSRC. The SSRC of a remote is learned from its first package,
+         * which is assigned to the session with the matching remote address. Packages are only accepted from the remote address of their session,
+         * so two remotes using the same SSRC are still told apart.
+         *
+         * RTCP is always multiplexed on the same port (RFC 5761) and passed to the RTCPHandler of the session.
+         *
+         * Every session sends via its own Session-object, a NetworkWrapper sending over the shared socket to the remote of the session.
+         */
+        class SharedMediaSocket : public std::enable_shared_from_this<SharedMediaSocket>
+        {
+        public:
+
+            /*!
+             * A single session on the shared socket.
+             *
+             * The session only sends packages, the packages received are written into the buffers passed to #startReceiving().
+             * Closing the session stops receiving, the shared socket is kept open as long as there are any sessions.
+             */
+            class Session : public ohmcomm::network::NetworkWrapper
+            {
+            public:
+                ~Session();
+
+                int sendData(const void* buffer, const unsigned int bufferSize) override;
+                int sendData(const BufferSegment* segments, const unsigned int numSegments) override;
+
+                /*!
+                 * The packages of a session are received by the shared socket, so this method always fails with INVALID_SOCKET
+                 */
+                Package receiveData(void* buffer, unsigned int bufferSize) override;
+
+                /*!
+                 * Stops receiving packages for this session
+                 */
+                void closeNetwork() override;
+
+                /*!
+                 * Starts writing the packages received from the remote into the given buffers
+                 *
+                 * \param buffers The jitter-buffers of this session
+                 * \param rtcpHandler The RTCPHandler to pass the (multiplexed) RTCP-packages to, may be nullptr
+                 */
+                void startReceiving(JitterBuffers& buffers, RTCPHandler* rtcpHandler);
+
+                /*!
+                 * \return the address packages are sent to and accepted from
+                 */
+                const ohmcomm::network::SocketAddress& getRemoteAddress() const;
+
+                /*!
+                 * \return the event-loop receiving the packages of this session, nullptr if they are received in a thread
+                 */
+                ohmcomm::network::EventLoop* getEventLoop() const;
+
+            private:
+                const std::shared_ptr<SharedMediaSocket> socket;
+                const ohmcomm::network::SocketAddress remoteAddress;
+                //only accessed with the sessions-mutex of the socket locked
+                JitterBuffers* buffers;
+                RTCPHandler* rtcpHandler;
+                bool isOpen;
+
+                Session(const std::shared_ptr<SharedMediaSocket> socket, const ohmcomm::network::SocketAddress& remoteAddress);
+
+                friend class SharedMediaSocket;
+                friend class RTPListener;
+            };
+
+            /*!
+             * Creates a new socket bound to the given local port and starts receiving
+             *
+             * \param localPort The local port to share
+             * \param isIPv6 Whether the socket is used for IPv6 (or IPv4) remotes
+             * \param maxPayloadSize The maximum size (in bytes) of the payload of a single package
+             */
+            static std::shared_ptr<SharedMediaSocket> create(const unsigned short localPort, const bool isIPv6 = false,
+                                                             const unsigned int maxPayloadSize = RTPBufferHandler::DEFAULT_MAX_PAYLOAD_SIZE);
+
+            ~SharedMediaSocket();
+
+            /*!
+             * Adds a new session for the given remote address
+             *
+             * \param remoteIPAddress The IP-address of the remote
+             * \param remotePort The port of the remote
+             *
+             * \return the new session
+             */
+            std::shared_ptr<Session> openSession(const std::string& remoteIPAddress, const unsigned short remotePort);
+
+            /*!
+             * \return the number of sessions currently receiving
+             */
+            unsigned int getNumberOfSessions() const;
+
+            /*!
+             * Applies the options to the shared socket, for all sessions
+             *
+             * \return whether all options were applied
+             */
+            bool setSocketOptions(const SocketOptions& options);
+
+        private:
+            const std::shared_ptr<ohmcomm::network::UDPWrapper> wrapper;
+            std::unique_ptr<RTPListener> listener;
+            //guards the sessions, is held while the packages of a batch are written into the buffers of their sessions
+            mutable std::mutex sessionsMutex;
+            std::vector<Session*> sessions;
+            //the sessions by the SSRCs learned, only contains the first session for SSRCs used by several remotes
+            std::unordered_map<uint32_t, Session*> sessionsBySSRC;
+
+            SharedMediaSocket(const unsigned short localPort, const bool isIPv6, const unsigned int maxPayloadSize,
+                              const bool reusePort = false, ohmcomm::network::EventLoop* eventLoop = nullptr);
+
+            /*!
+             * Looks up the session for a received package, the sessions-mutex must be locked
+             *
+             * \param ssrc The SSRC of the sender of the package
+             * \param address The address the package was received from
+             *
+             * \return the receiving session or nullptr, if the package belongs to no session
+             */
+            Session* findSession(const uint32_t ssrc, const ohmcomm::network::SocketAddress& address);
+
+            /*!
+             * Releases the idle jitter-buffers of all sessions
+             */
+            void removeIdleBuffers();
+
+            void removeSession(Session* session);
+
+            /*!
+             * Stops receiving packages for all sessions
+             */
+            void stopReceiving();
+
+            //enables access to private methods for the listener
+            friend class RTPListener;
+            //creates the sockets sharing the port with other sockets
+            friend class MediaWorkerPool;
+        };
+    }
+}
+
+#endif	/* SHAREDMEDIASOCKET_H */
+
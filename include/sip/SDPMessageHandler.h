@@ -76,6 +76,8 @@ namespace ohmcomm
             static const std::string SDP_ATTRIBUTE_FMTP;
             //specifies RTCP-port, if not consecutive to RTP-port, see RFC 3605
             static const std::string SDP_ATTRIBUTE_RTCP;
+            //RTP and RTCP are multiplexed on a single port, RFC 5761
+            static const std::string SDP_ATTRIBUTE_RTCP_MUX;
             //SDES cryptographic extension, RFC 4568
             static const std::string SDP_ATTRIBUTE_CRYPTO;
 
@@ -93,7 +95,8 @@ namespace ohmcomm
                 const std::string search = firstValue.empty() ? tag : (tag + ':').append(firstValue);
                 std::vector<std::string> allAttributes = getFieldValues(SDP_ATTRIBUTE);
                 for (const std::string& a : allAttributes) {
-                    if (a.find(search) == 0) {
+                    //the tag must match completely, e.g. "rtcp" must not match "rtcp-mux"
+                    if (a.find(search) == 0 && (!firstValue.empty() || a.size() == tag.size() || a[tag.size()] == ':')) {
                         return a.substr(a.find(':') + 1);
                     }
                 }
@@ -137,9 +140,12 @@ namespace ohmcomm
              * 
              * \param cryptoContext An optional cryptographic context to use. When set, SRTP is supported in the media-description
              * 
+             * \param rtcpMultiplexing Whether to offer (or accept) multiplexing RTP and RTCP on a single port (RFC 5761).
+             * An answer must only contain this attribute, if the offer does
+             * 
              * \return the generated SDP session-description
              */
-            static std::string createSessionDescription(const std::string& localUserName, const NetworkConfiguration& config, const std::vector<MediaDescription>& media = {}, const std::shared_ptr<ohmcomm::crypto::CryptographicContext> cryptoContext = nullptr);
+            static std::string createSessionDescription(const std::string& localUserName, const NetworkConfiguration& config, const std::vector<MediaDescription>& media = {}, const std::shared_ptr<ohmcomm::crypto::CryptographicContext> cryptoContext = nullptr, const bool rtcpMultiplexing = true);
 
             /*!
              * Ready the session description from the given message and returns it
@@ -159,12 +165,21 @@ namespace ohmcomm
              * This method will return 0 (zero) for the remote-port or an empty string for the remote-address, if they are not
              * specified in the RTCP-attribute. See RFC 3605
              * 
+             * The local port is always 0 (zero)
+             * 
              * \param sdp The session-description
              * 
              * \return The custom RTCP configuration, if any
              */
             static NetworkConfiguration readRTCPAttribute(const SessionDescription& sdp);
 
+            /*!
+             * \param sdp The session-description
+             * 
+             * \return whether the session-description contains the "rtcp-mux" attribute, see RFC 5761
+             */
+            static bool isRTCPMultiplexed(const SessionDescription& sdp);
+
             /*!
              * Checks the correctness of the given SessionDescription.
              * NOTE: This function throws std::invalid_argument exceptions with a informative messages in case of an error
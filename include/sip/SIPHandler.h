@@ -11,9 +11,12 @@
 #include <thread>
 #include <exception>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
 
 #include "SIPSession.h"
 #include "SIPRequest.h"
+#include "network/EventLoop.h"
 
 namespace ohmcomm
 {
@@ -44,12 +47,12 @@ namespace ohmcomm
             void setRegisterWithServer(const std::string& registerUser = "", const std::string& registerPassword = "");
 
             /*!
-             * Shuts down the receive-thread
+             * Shuts down the receive-thread (or removes the socket from the event-loop)
              */
             void shutdown();
 
             /*!
-             * Starts the receive-thread
+             * Starts the SIP-session and the receive-thread, or adds the socket to a shared event-loop, if supported
              */
             void startUp();
 
@@ -60,6 +63,11 @@ namespace ohmcomm
             
         protected:
             void shutdownInternal() override;
+
+            /*!
+             * Shuts down the session, if the last remote left. On an event-loop, this runs in the SIP-thread, see #runCallTask()
+             */
+            void onRemoteRemoved(const unsigned int ssrc) override;
             
         private:
             static constexpr unsigned short SIP_BUFFER_SIZE{2048};
@@ -75,6 +83,15 @@ namespace ohmcomm
 
             std::thread sipThread;
             bool threadRunning = false;
+            //the event-loop watching the socket, nullptr if the SIP-thread is used
+            ohmcomm::network::EventLoop* eventLoop = nullptr;
+            int loopSocket = INVALID_SOCKET;
+            ohmcomm::network::EventLoop::TimerID authenticationTimer = 0;
+            //if the socket is watched by an event-loop, the SIP-thread runs the queued call setups and teardowns
+            std::mutex callMutex;
+            std::condition_variable callCondition;
+            std::deque<std::function<void()>> callTasks;
+            bool runsCallTasks = false;
             
             std::unique_ptr<SIPRequest> currentRequest;
             std::unique_ptr<Authentication> authentication;
@@ -84,6 +101,39 @@ namespace ohmcomm
              */
             void runThread();
 
+            /*!
+             * Method called in the parallel thread, if the socket is watched by an event-loop, running the queued call-tasks
+             */
+            void runCallTasks();
+
+            /*!
+             * Runs the setup or teardown of a call, which starts or stops the media-session.
+             *
+             * If the socket is watched by an event-loop, the task is queued for the SIP-thread,
+             * since it must neither stall the other sessions of the loop nor wait for the loops of the media-session.
+             */
+            void runCallTask(const std::function<void()>& task);
+
+            /*!
+             * Registers with the server or invites the remote
+             */
+            void startSession();
+
+            /*!
+             * Receives and handles a single SIP-package
+             */
+            void receivePackage();
+
+            /*!
+             * Refreshes the registration shortly before it expires
+             */
+            void refreshAuthentication();
+
+            /*!
+             * Called after the socket is not watched anymore
+             */
+            void endSession();
+
             void handleSIPRequest(const void* buffer, unsigned int packageLength, const ohmcomm::network::NetworkWrapper::Package& packageInfo);
             
             void handleINVITERequest(const ohmcomm::network::NetworkWrapper::Package& packageInfo, const SIPRequestHeader& requestHeader, std::string& requestBody, SIPUserAgent& remoteUA);
@@ -37,6 +37,17 @@ const Parameter* Parameters::AUDIO_PROCESSOR = Parameters::registerParameter(Par
 const Parameter* Parameters::PROFILE_PROCESSORS = Parameters::registerParameter(Parameter(ParameterCategory::PROCESSORS, 't', "profile-processors", "Enables profiling of the the execution time of audio-processors"));
 const Parameter* Parameters::ENABLE_DTX = Parameters::registerParameter(Parameter(ParameterCategory::NETWORK, 'd', "enable-dtx", "Enables DTX to not send any packages, if silence is detected."));
 const Parameter* Parameters::ENABLE_FEC = Parameters::registerParameter(Parameter(ParameterCategory::NETWORK, 'e', "enable-fec", "Enables FEC to include forward-error-correction data into supported formats."));
+const Parameter* Parameters::PLAYOUT_QUANTILE = Parameters::registerParameter(Parameter(ParameterCategory::NETWORK, 'q', "playout-quantile", "Adapts the playout delay to let the given percentage of packages (e.g. 97) arrive in time, instead of using fixed late-loss thresholds", ""));
+const Parameter* Parameters::LOCK_FREE_BUFFER = Parameters::registerParameter(Parameter(ParameterCategory::NETWORK, 'j', "lock-free-buffer", "Uses the lock-free jitter-buffer, which never blocks the audio-thread while receiving packages."));
+const Parameter* Parameters::JITTER_BUFFER_CAPACITY = Parameters::registerParameter(Parameter(ParameterCategory::NETWORK, 'b', "jitter-buffer-capacity", "The maximum number of packages buffered per remote", "128"));
+const Parameter* Parameters::JITTER_BUFFER_MAX_DELAY = Parameters::registerParameter(Parameter(ParameterCategory::NETWORK, 'm', "jitter-buffer-max-delay", "The maximum time (in ms) a package is buffered before it is dropped", "200"));
+const Parameter* Parameters::JITTER_BUFFER_MIN_PACKAGES = Parameters::registerParameter(Parameter(ParameterCategory::NETWORK, 'k', "jitter-buffer-min-packages", "The initial number of packages to buffer before starting the playout", "1"));
+const Parameter* Parameters::RTCP_MUX = Parameters::registerParameter(Parameter(ParameterCategory::NETWORK, 'x', "rtcp-mux", "Multiplexes RTP and RTCP on the RTP-port (RFC 5761) instead of using the next port for RTCP. The remote must be configured the same way."));
+const Parameter* Parameters::SOCKET_RECEIVE_BUFFER = Parameters::registerParameter(Parameter(ParameterCategory::NETWORK, 'B', "socket-receive-buffer", "The size (in bytes) of the kernel receive-buffer of the RTP-socket, e.g. to not drop bursts of packages after a network stall. Defaults to the system default", ""));
+const Parameter* Parameters::SOCKET_SEND_BUFFER = Parameters::registerParameter(Parameter(ParameterCategory::NETWORK, 'W', "socket-send-buffer", "The size (in bytes) of the kernel send-buffer of the RTP-socket. Defaults to the system default", ""));
+const Parameter* Parameters::DSCP = Parameters::registerParameter(Parameter(ParameterCategory::NETWORK, 'Q', "dscp", "Marks the RTP-packages with the given DSCP for prioritization by the network, e.g. 46 for Expedited Forwarding", std::to_string(SocketOptions::DSCP_EXPEDITED_FORWARDING)));
+const Parameter* Parameters::SOCKET_PRIORITY = Parameters::registerParameter(Parameter(ParameterCategory::NETWORK, 'Y', "socket-priority", "The priority (0 to 6) of the RTP-packages in the local network-queues (Linux only)", "6"));
+const Parameter* Parameters::BUSY_POLL = Parameters::registerParameter(Parameter(ParameterCategory::NETWORK, 'u', "busy-poll", "Busy-polls the network-device for the given time (in microseconds) before blocking for packages, trading CPU-time for latency (Linux only)", "50"));
 
 const Parameter* Parameters::USER_LOCAL_DEVICE = Parameters::registerParameter(Parameter(ParameterCategory::USER_INFO, 'C', "host-name", "The device name of the local host (SDES CNAME)", ""));
 const Parameter* Parameters::USER_EMAIL = Parameters::registerParameter(Parameter(ParameterCategory::USER_INFO, 'E', "user-email", "The email-address of this user (SDES EMAIL)", ""));
@@ -4,6 +4,7 @@
  *
  * Created on June 30, 2015, 5:06 PM
  */
+#include <algorithm>
 #include <fstream>
 
 #include "Statistics.h"
@@ -11,27 +12,78 @@
 
 using namespace ohmcomm;
 
-long Statistics::counters[] = {0};
+std::atomic<long> Statistics::counters[NUM_COUNTERS];
+std::mutex Statistics::shardsMutex;
+std::vector<Statistics::CounterShard*> Statistics::shards;
 std::vector<ProfilingAudioProcessor*> Statistics::audioProcessorStatistics;
 
+Statistics::CounterShard::CounterShard()
+{
+    for(std::atomic<long>& counter : counters)
+    {
+        counter.store(0, std::memory_order_relaxed);
+    }
+    std::lock_guard<std::mutex> guard(shardsMutex);
+    shards.push_back(this);
+}
+
+Statistics::CounterShard::~CounterShard()
+{
+    std::lock_guard<std::mutex> guard(shardsMutex);
+    for(int i = 0; i < NUM_COUNTERS; ++i)
+    {
+        Statistics::counters[i].fetch_add(counters[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    shards.erase(std::find(shards.begin(), shards.end(), this));
+}
+
+Statistics::CounterShard& Statistics::getLocalShard()
+{
+    static thread_local CounterShard shard;
+    return shard;
+}
+
+std::array<long, Statistics::NUM_COUNTERS> Statistics::readCounters()
+{
+    std::array<long, NUM_COUNTERS> values;
+    std::lock_guard<std::mutex> guard(shardsMutex);
+    for(int i = 0; i < NUM_COUNTERS; ++i)
+    {
+        values[i] = counters[i].load(std::memory_order_relaxed);
+        for(const CounterShard* shard : shards)
+        {
+            values[i] += shard->counters[i].load(std::memory_order_relaxed);
+        }
+    }
+    return values;
+}
+
 void Statistics::incrementCounter(int counterIndex, long byValue)
 {
-    counters[counterIndex] += byValue;
+    std::atomic<long>& counter = getLocalShard().counters[counterIndex];
+    //the owning thread is the only writer, so no (locked) read-modify-write is required
+    counter.store(counter.load(std::memory_order_relaxed) + byValue, std::memory_order_relaxed);
 }
 
 void Statistics::setCounter(int counterIndex, long newValue)
 {
-    counters[counterIndex] = newValue;
+    counters[counterIndex].store(newValue, std::memory_order_relaxed);
 }
 
 void Statistics::maxCounter(int counterIndex, long newValue)
 {
-    if(newValue > counters[counterIndex])
+    long oldValue = counters[counterIndex].load(std::memory_order_relaxed);
+    while(newValue > oldValue && !counters[counterIndex].compare_exchange_weak(oldValue, newValue, std::memory_order_relaxed))
     {
-        counters[counterIndex] = newValue;
+        //oldValue was updated, retry
     }
 }
 
+long Statistics::readCounter(int counterIndex)
+{
+    return readCounters()[counterIndex];
+}
+
 void Statistics::printStatisticsToFile(const std::string fileName)
 {
     std::ofstream fileStream(fileName.c_str(), std::ios_base::out|std::ios_base::trunc);
@@ -75,15 +127,24 @@ void Statistics::removeAllProfilers()
 
 void Statistics::resetStatistics()
 {
-    for(unsigned char i = 0; i < 20; ++i)
     {
-        Statistics::counters[i] = 0;
+        std::lock_guard<std::mutex> guard(shardsMutex);
+        for(unsigned char i = 0; i < NUM_COUNTERS; ++i)
+        {
+            Statistics::counters[i] = 0;
+            for(CounterShard* shard : shards)
+            {
+                shard->counters[i] = 0;
+            }
+        }
     }
     removeAllProfilers();
 }
 
 void Statistics::printStatistics(std::ostream& outputStream)
 {
+    //hides the global counters, which don't contain the increments of the running threads
+    const std::array<long, NUM_COUNTERS> counters = readCounters();
     const double seconds = counters[TOTAL_ELAPSED_MILLISECONDS] / 1000.0;
     if(seconds == 0)
     {
@@ -142,6 +203,9 @@ void Statistics::printStatistics(std::ostream& outputStream)
             << "%)" << std::endl;
     outputStream << "Lost " << counters[COUNTER_PACKAGES_LOST] << " RTP-packages ("
             << (counters[COUNTER_PACKAGES_LOST]/seconds) << " packages per second)" << std::endl;
+    outputStream << "Maximum send-queue depth was " << counters[RTP_SEND_QUEUE_MAXIMUM_DEPTH] << " packages, dropped "
+            << counters[RTP_SEND_QUEUE_DROPPED] << " packages on full send-queue" << std::endl;
+    outputStream << "Kernel dropped " << counters[SOCKET_RECEIVE_DROPPED] << " received packages on full socket receive-buffer" << std::endl;
     //Buffer statistics
     outputStream << std::endl;
     outputStream << "+++ Buffer statistics +++" << std::endl;
@@ -149,6 +213,8 @@ void Statistics::printStatistics(std::ostream& outputStream)
             << counters[RTP_BUFFER_LIMIT] << " packages ("
             << Utility::prettifyPercentage(counters[RTP_BUFFER_MAXIMUM_USAGE]/(double)counters[RTP_BUFFER_LIMIT]) << "%)"
             << std::endl;
+    outputStream << "Dropped " << counters[RTP_BUFFER_FRAMES_DROPPED] << " and inserted " << counters[RTP_BUFFER_FRAMES_INSERTED]
+            << " frames to compensate clock-drift" << std::endl;
     //Compression statistics
     //TODO is wrong, does not account for silence-packages
     outputStream << std::endl;
@@ -194,6 +260,7 @@ void Statistics::printAudioProcessorStatistic(std::ostream& outputStream)
 
 void Statistics::printRTCPStatistics(std::ostream& outputStream)
 {
+    const std::array<long, NUM_COUNTERS> counters = readCounters();
     const double seconds = counters[TOTAL_ELAPSED_MILLISECONDS] / 1000.0;
     outputStream << std::endl;
     outputStream << "+++ RTCP statistics +++" << std::endl;
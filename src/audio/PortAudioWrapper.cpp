@@ -231,6 +231,7 @@ int PortAudioWrapper::callback(void* inputBuffer, void* outputBuffer, unsigned l
     //reset maximum size, in case a processor illegally modifies it
     this->streamData->maxBufferSize = inputBufferSize;
     this->streamData->isSilentPackage = false;
+    this->streamData->comfortNoiseSize = 0;
     if (inputBuffer != nullptr)
     {
         processors.processAudioInput(inputBuffer, inputBufferSize, streamData);
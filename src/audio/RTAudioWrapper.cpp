@@ -58,6 +58,7 @@ auto RtAudioWrapper::callback(void *outputBuffer, void *inputBuffer, unsigned in
     //in case the two buffer sizes max vary
     this->streamData->maxBufferSize = inputBufferByteSize;
     this->streamData->isSilentPackage = false;
+    this->streamData->comfortNoiseSize = 0;
     if (inputBuffer != nullptr)
         processors.processAudioInput(inputBuffer, inputBufferByteSize, streamData);
 
@@ -5,6 +5,8 @@
  * Created on August 19, 2015, 4:48 PM
  */
 #include "config/ConfigurationMode.h"
+#include "Parameters.h"
+#include "error_types.h"
 
 using namespace ohmcomm;
 
@@ -50,6 +52,11 @@ const NetworkConfiguration ConfigurationMode::getRTCPNetworkConfiguration() cons
     {
         throw std::runtime_error("Configuration was not finished!");
     }
+    if(isCustomConfigurationSet(Parameters::RTCP_MUX->longName, "Multiplex RTP and RTCP on a single port"))
+    {
+        //RTCP uses the same ports as RTP (see RFC 5761)
+        return networkConfig;
+    }
     NetworkConfiguration rtcpConfig;
     rtcpConfig.localPort = networkConfig.localPort+1;
     rtcpConfig.remoteIPAddress = networkConfig.remoteIPAddress;
@@ -57,6 +64,36 @@ const NetworkConfiguration ConfigurationMode::getRTCPNetworkConfiguration() cons
     return rtcpConfig;
 }
 
+const SocketOptions ConfigurationMode::getSocketOptions() const
+{
+    SocketOptions options;
+    if(isCustomConfigurationSet(Parameters::SOCKET_RECEIVE_BUFFER->longName, "Set the size of the socket receive-buffer"))
+    {
+        options.receiveBufferSize = getCustomConfiguration(Parameters::SOCKET_RECEIVE_BUFFER->longName, "Size of the socket receive-buffer (in bytes)", 0);
+    }
+    if(isCustomConfigurationSet(Parameters::SOCKET_SEND_BUFFER->longName, "Set the size of the socket send-buffer"))
+    {
+        options.sendBufferSize = getCustomConfiguration(Parameters::SOCKET_SEND_BUFFER->longName, "Size of the socket send-buffer (in bytes)", 0);
+    }
+    if(isCustomConfigurationSet(Parameters::DSCP->longName, "Mark packages with a DSCP"))
+    {
+        options.dscp = getCustomConfiguration(Parameters::DSCP->longName, "DSCP to mark the packages with", SocketOptions::DSCP_EXPEDITED_FORWARDING);
+    }
+    if(isCustomConfigurationSet(Parameters::SOCKET_PRIORITY->longName, "Set the socket priority"))
+    {
+        options.priority = getCustomConfiguration(Parameters::SOCKET_PRIORITY->longName, "Priority of the packages (0 to 6)", 6);
+    }
+    if(isCustomConfigurationSet(Parameters::BUSY_POLL->longName, "Busy-poll for packages"))
+    {
+        options.busyPollMicroseconds = getCustomConfiguration(Parameters::BUSY_POLL->longName, "Time to busy-poll (in microseconds)", 50);
+    }
+    if(options.receiveBufferSize < 0 || options.sendBufferSize < 0 || options.dscp > 63 || options.busyPollMicroseconds < 0)
+    {
+        throw ohmcomm::configuration_error("Network", "Invalid socket options");
+    }
+    return options;
+}
+
 bool ConfigurationMode::isConfigured() const
 {
     return isConfigurationDone;
@@ -60,24 +60,40 @@ bool InteractiveConfiguration::runConfiguration()
 
 const std::string InteractiveConfiguration::getCustomConfiguration(const std::string key, const std::string message, const std::string defaultValue) const
 {
+    if(customConfig.count(key) != 0)
+        return customConfig.at(key);
     const unsigned char flags = defaultValue.empty() ? 0 : UserInput::INPUT_USE_DEFAULT;
-    return UserInput::inputString(message, defaultValue, flags);
+    const std::string value = UserInput::inputString(message, defaultValue, flags);
+    customConfig[key] = value;
+    return value;
 }
 
 int InteractiveConfiguration::getCustomConfiguration(const std::string key, const std::string message, const int defaultValue) const
 {
+    if(customConfig.count(key) != 0)
+        return atoi(customConfig.at(key).data());
     const unsigned char flags = UserInput::INPUT_ALLOW_NEGATIVE | UserInput::INPUT_ALLOW_ZERO | UserInput::INPUT_USE_DEFAULT;
-    return UserInput::inputNumber(message, defaultValue, flags);
+    const int value = UserInput::inputNumber(message, defaultValue, flags);
+    customConfig[key] = std::to_string(value);
+    return value;
 }
 
 bool InteractiveConfiguration::getCustomConfiguration(const std::string key, const std::string message, const bool defaultValue) const
 {
-    return UserInput::inputBoolean(message, defaultValue, UserInput::INPUT_USE_DEFAULT);
+    if(customConfig.count(key) != 0)
+        return atoi(customConfig.at(key).data());
+    const bool value = UserInput::inputBoolean(message, defaultValue, UserInput::INPUT_USE_DEFAULT);
+    customConfig[key] = std::to_string(value);
+    return value;
 }
 
 bool InteractiveConfiguration::isCustomConfigurationSet(const std::string key, const std::string message) const
 {
-    return UserInput::inputBoolean(message, false, 0);
+    if(customConfigSet.count(key) != 0)
+        return customConfigSet.at(key);
+    const bool isSet = UserInput::inputBoolean(message, false, 0);
+    customConfigSet[key] = isSet;
+    return isSet;
 }
 
 void InteractiveConfiguration::interactivelyConfigureAudioDevices(std::unique_ptr<AudioHandler>&& handler)
@@ -7,6 +7,7 @@
 
 #include "config/LibraryConfiguration.h"
 #include "audio/AudioHandlerFactory.h"
+#include "Parameters.h"
 
 using namespace ohmcomm;
 
@@ -78,6 +79,20 @@ void LibraryConfiguration::configureNetwork(const NetworkConfiguration& networkC
     isNetworkConfigured = true;
 }
 
+void LibraryConfiguration::configureSocketOptions(const SocketOptions& socketOptions)
+{
+    if(socketOptions.receiveBufferSize > 0)
+        configureCustomValue(Parameters::SOCKET_RECEIVE_BUFFER->longName, socketOptions.receiveBufferSize);
+    if(socketOptions.sendBufferSize > 0)
+        configureCustomValue(Parameters::SOCKET_SEND_BUFFER->longName, socketOptions.sendBufferSize);
+    if(socketOptions.dscp >= 0)
+        configureCustomValue(Parameters::DSCP->longName, socketOptions.dscp);
+    if(socketOptions.priority >= 0)
+        configureCustomValue(Parameters::SOCKET_PRIORITY->longName, socketOptions.priority);
+    if(socketOptions.busyPollMicroseconds > 0)
+        configureCustomValue(Parameters::BUSY_POLL->longName, socketOptions.busyPollMicroseconds);
+}
+
 void LibraryConfiguration::configureProcessors(const std::vector<std::string>& processorNames, bool profileProcessors)
 {
     this->profileProcessors = profileProcessors;
@@ -0,0 +1,268 @@
+/*
+ * File:   EventLoop.cpp
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include "Logger.h"
+#include "network/EventLoop.h"
+
+#ifdef __linux__
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>     //strerror
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+using namespace ohmcomm::network;
+
+constexpr unsigned int EventLoop::SHARED_LOOPS;
+constexpr int EventLoop::MAX_EVENTS;
+
+EventLoop::EventLoop() : pollDescriptor(-1), wakeupDescriptor(-1), loopRunning(false), nextTimerID(1)
+{
+#ifdef __linux__
+    pollDescriptor = epoll_create1(EPOLL_CLOEXEC);
+    wakeupDescriptor = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if(pollDescriptor < 0 || wakeupDescriptor < 0)
+    {
+        ohmcomm::error("EventLoop") << "Failed to create event-loop: " << strerror(errno) << ohmcomm::endl;
+        return;
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = wakeupDescriptor;
+    epoll_ctl(pollDescriptor, EPOLL_CTL_ADD, wakeupDescriptor, &event);
+#endif
+}
+
+EventLoop::~EventLoop()
+{
+    shutdown();
+#ifdef __linux__
+    if(wakeupDescriptor >= 0)
+    {
+        close(wakeupDescriptor);
+    }
+    if(pollDescriptor >= 0)
+    {
+        close(pollDescriptor);
+    }
+#endif
+}
+
+bool EventLoop::isSupported()
+{
+#ifdef __linux__
+    return true;
+#else
+    return false;
+#endif
+}
+
+EventLoop& EventLoop::getSharedLoop()
+{
+    static EventLoop sharedLoops[SHARED_LOOPS];
+    static std::atomic<unsigned int> nextLoop{0};
+    //not the dispatch-mutex, which would wait for the callback currently executed by the loop
+    static std::mutex startMutex;
+    EventLoop& loop = sharedLoops[nextLoop++ % SHARED_LOOPS];
+    std::lock_guard<std::mutex> guard(startMutex);
+    if(!loop.isRunning())
+    {
+        loop.startUp();
+    }
+    return loop;
+}
+
+void EventLoop::startUp()
+{
+    if(!loopRunning && pollDescriptor >= 0 && wakeupDescriptor >= 0)
+    {
+        if(loopThread.joinable())
+        {
+            //the loop stopped on an error
+            loopThread.join();
+        }
+        loopRunning = true;
+        loopThread = std::thread(&EventLoop::runLoop, this);
+    }
+}
+
+void EventLoop::shutdown()
+{
+    loopRunning = false;
+    wakeUp();
+    if(loopThread.joinable() && loopThread.get_id() != std::this_thread::get_id())
+    {
+        loopThread.join();
+    }
+}
+
+bool EventLoop::isRunning() const
+{
+    return loopRunning;
+}
+
+bool EventLoop::addSocket(const int socket, const Callback& onReadable)
+{
+#ifdef __linux__
+    std::lock_guard<std::recursive_mutex> guard(dispatchMutex);
+    //the callback reads everything available and must not block, if the readiness was spurious
+    const int flags = fcntl(socket, F_GETFL, 0);
+    if(flags < 0 || fcntl(socket, F_SETFL, flags | O_NONBLOCK) < 0)
+    {
+        ohmcomm::error("EventLoop") << "Failed to set socket to non-blocking mode: " << strerror(errno) << ohmcomm::endl;
+        return false;
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = socket;
+    if(epoll_ctl(pollDescriptor, EPOLL_CTL_ADD, socket, &event) < 0)
+    {
+        ohmcomm::error("EventLoop") << "Failed to add socket: " << strerror(errno) << ohmcomm::endl;
+        return false;
+    }
+    sockets[socket] = onReadable;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void EventLoop::removeSocket(const int socket)
+{
+#ifdef __linux__
+    //locking waits for a callback currently executed in the loop-thread
+    std::lock_guard<std::recursive_mutex> guard(dispatchMutex);
+    if(sockets.erase(socket) > 0)
+    {
+        epoll_ctl(pollDescriptor, EPOLL_CTL_DEL, socket, nullptr);
+    }
+#endif
+}
+
+EventLoop::TimerID EventLoop::addTimer(const std::chrono::milliseconds interval, const Callback& onExpired, const bool repeat)
+{
+    TimerID id;
+    {
+        std::lock_guard<std::recursive_mutex> guard(dispatchMutex);
+        id = nextTimerID++;
+        timers[id] = Timer{std::chrono::steady_clock::now() + interval, interval, repeat, onExpired};
+    }
+    //the new timer may expire before the current wait ends
+    wakeUp();
+    return id;
+}
+
+void EventLoop::cancelTimer(const TimerID timer)
+{
+    std::lock_guard<std::recursive_mutex> guard(dispatchMutex);
+    timers.erase(timer);
+}
+
+void EventLoop::runLoop()
+{
+#ifdef __linux__
+    ohmcomm::info("EventLoop") << "Event-loop started ..." << ohmcomm::endl;
+    epoll_event events[MAX_EVENTS];
+    while(loopRunning)
+    {
+        const int numEvents = epoll_wait(pollDescriptor, events, MAX_EVENTS, getWaitTimeout());
+        if(numEvents < 0 && errno != EINTR)
+        {
+            ohmcomm::error("EventLoop") << "Error waiting for events: " << strerror(errno) << ohmcomm::endl;
+            break;
+        }
+        std::lock_guard<std::recursive_mutex> guard(dispatchMutex);
+        for(int i = 0; i < numEvents && loopRunning; ++i)
+        {
+            if(events[i].data.fd == wakeupDescriptor)
+            {
+                eventfd_t value;
+                eventfd_read(wakeupDescriptor, &value);
+                continue;
+            }
+            //the socket may have been removed by a previous callback
+            const auto it = sockets.find(events[i].data.fd);
+            if(it != sockets.end())
+            {
+                //copy the callback, since it may remove its own socket
+                const Callback callback = it->second;
+                callback();
+            }
+        }
+        handleTimers();
+    }
+    loopRunning = false;
+    ohmcomm::info("EventLoop") << "Event-loop shut down" << ohmcomm::endl;
+#endif
+}
+
+void EventLoop::wakeUp()
+{
+#ifdef __linux__
+    if(wakeupDescriptor >= 0)
+    {
+        eventfd_write(wakeupDescriptor, 1);
+    }
+#endif
+}
+
+int EventLoop::getWaitTimeout()
+{
+    std::lock_guard<std::recursive_mutex> guard(dispatchMutex);
+    if(timers.empty())
+    {
+        return -1;
+    }
+    std::chrono::steady_clock::time_point nextExpiration = std::chrono::steady_clock::time_point::max();
+    for(const auto& timer : timers)
+    {
+        nextExpiration = std::min(nextExpiration, timer.second.expiration);
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if(nextExpiration <= now)
+    {
+        return 0;
+    }
+    //round up, so we don't wake up just before the timer expires
+    const auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(nextExpiration - now + std::chrono::milliseconds(1) - std::chrono::nanoseconds(1));
+    return static_cast<int>(timeout.count());
+}
+
+void EventLoop::handleTimers()
+{
+    const auto now = std::chrono::steady_clock::now();
+    std::vector<TimerID> expiredTimers;
+    for(const auto& timer : timers)
+    {
+        if(timer.second.expiration <= now)
+        {
+            expiredTimers.push_back(timer.first);
+        }
+    }
+    for(const TimerID id : expiredTimers)
+    {
+        //the timer may have been cancelled by a previous callback
+        const auto it = timers.find(id);
+        if(it == timers.end() || !loopRunning)
+        {
+            continue;
+        }
+        //copy the callback, since the timer may be removed
+        const Callback callback = it->second.callback;
+        if(it->second.repeat)
+        {
+            it->second.expiration = now + it->second.interval;
+        }
+        else
+        {
+            timers.erase(it);
+        }
+        callback();
+    }
+}
@@ -0,0 +1,388 @@
+/*
+ * File:   IOUringUDPWrapper.cpp
+ */
+#ifdef IO_URING_HEADER  //Only compile, if io_uring is enabled
+
+#include <algorithm>
+#include <errno.h>
+#include <signal.h>     //_NSIG
+#include <string.h>     //strerror
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "Logger.h"
+#include "network/IOUringUDPWrapper.h"
+
+using namespace ohmcomm::network;
+
+constexpr unsigned int IOUringUDPWrapper::NUM_BUFFERS;
+constexpr unsigned int IOUringUDPWrapper::MAX_PACKAGE_SIZE;
+constexpr uint64_t IOUringUDPWrapper::RECEIVE_REQUEST;
+constexpr uint16_t IOUringUDPWrapper::BUFFER_GROUP;
+constexpr unsigned int IOUringUDPWrapper::BUFFER_HEADER_SIZE;
+
+//the user-data of the request cancelling the receive-request
+static constexpr uint64_t CANCEL_REQUEST{2};
+//the size of the submission-queue, only the receive- and the cancel-request are ever queued
+static constexpr unsigned int SUBMISSION_QUEUE_SIZE{4};
+//the time to wait for a package, same as the receive-timeout of the socket
+static constexpr std::chrono::milliseconds MAX_WAIT_TIME{1000};
+
+//accessors for the head, tail and mask of the rings shared with the kernel, which are given as offsets into the mapped memory
+static inline uint32_t* getRingField(void* ring, const uint32_t offset)
+{
+    return (uint32_t*)((char*)ring + offset);
+}
+
+IOUringUDPWrapper::IOUringUDPWrapper(const ohmcomm::NetworkConfiguration& networkConfig) : UDPWrapper(networkConfig),
+    ringDescriptor(-1), submissionRing(MAP_FAILED), submissionRingSize(0), completionRing(MAP_FAILED), completionRingSize(0),
+    submissionEntries((io_uring_sqe*)MAP_FAILED), parameters(), bufferRing((io_uring_buf_ring*)MAP_FAILED), buffers(), receiveMessage(), isReceiveArmed(false),
+    submissionMutex()
+{
+    if(Socket != INVALID_SOCKET && setUpRing())
+    {
+        ohmcomm::info("UDP") << "Receiving packages via io_uring" << ohmcomm::endl;
+    }
+    else
+    {
+        tearDownRing();
+        ohmcomm::warn("UDP") << "io_uring is not available, receiving packages via the socket" << ohmcomm::endl;
+    }
+}
+
+IOUringUDPWrapper::~IOUringUDPWrapper()
+{
+    closeNetwork();
+    tearDownRing();
+}
+
+NetworkWrapper::Package IOUringUDPWrapper::receiveData(void* buffer, unsigned int bufferSize)
+{
+    NetworkWrapper::Package package{};
+    receiveData(&buffer, bufferSize, &package, 1);
+    return package;
+}
+
+unsigned int IOUringUDPWrapper::receiveData(void* const* buffers, const unsigned int bufferSize, Package* packages, const unsigned int numBuffers)
+{
+    if(ringDescriptor < 0)
+    {
+        return UDPWrapper::receiveData(buffers, bufferSize, packages, numBuffers);
+    }
+    const unsigned int batchSize = std::min(numBuffers, MAX_RECEIVE_BATCH);
+    const std::chrono::steady_clock::time_point timeout = std::chrono::steady_clock::now() + MAX_WAIT_TIME;
+    packages[0] = Package{};
+    while(true)
+    {
+        if(Socket == INVALID_SOCKET)
+        {
+            packages[0].status = INVALID_SOCKET;
+            return 1;
+        }
+        //1. take the packages already received from the completion-queue, without any system-call
+        uint32_t* completionHead = getRingField(completionRing, parameters.cq_off.head);
+        const uint32_t completionTail = __atomic_load_n(getRingField(completionRing, parameters.cq_off.tail), __ATOMIC_ACQUIRE);
+        const uint32_t completionMask = *getRingField(completionRing, parameters.cq_off.ring_mask);
+        const io_uring_cqe* completions = (const io_uring_cqe*)((char*)completionRing + parameters.cq_off.cqes);
+        const bool hasCompletions = *completionHead != completionTail;
+        const std::chrono::system_clock::time_point systemNow = std::chrono::system_clock::now();
+        const std::chrono::steady_clock::time_point steadyNow = std::chrono::steady_clock::now();
+        uint32_t head = *completionHead;
+        unsigned int numReceived = 0;
+        while(head != completionTail && numReceived < batchSize)
+        {
+            const io_uring_cqe& completion = completions[head & completionMask];
+            ++head;
+            if(completion.user_data != RECEIVE_REQUEST)
+            {
+                continue;
+            }
+            if(!(completion.flags & IORING_CQE_F_MORE))
+            {
+                //the kernel stopped receiving, e.g. since all buffers are in use
+                isReceiveArmed = false;
+            }
+            if(!(completion.flags & IORING_CQE_F_BUFFER))
+            {
+                if(completion.res < 0 && completion.res != -ENOBUFS && completion.res != -ECANCELED)
+                {
+                    ohmcomm::error("UDP") << "Error receiving via io_uring: " << strerror(-completion.res) << ohmcomm::endl;
+                }
+                continue;
+            }
+            const uint16_t bufferID = completion.flags >> IORING_CQE_BUFFER_SHIFT;
+            char* buffer = getBuffer(bufferID);
+            //the buffer holds the header, the sender-address and the ancillary data (with the space requested by the message) in front of the package
+            const io_uring_recvmsg_out* header = (const io_uring_recvmsg_out*)buffer;
+            char* name = buffer + sizeof(io_uring_recvmsg_out);
+            char* control = name + receiveMessage.msg_namelen;
+            const char* payload = control + receiveMessage.msg_controllen;
+            const unsigned int payloadSize = completion.res - (payload - buffer);
+
+            Package& package = packages[numReceived];
+            package = Package{};
+            memcpy(&package.address.ipv6, name, std::min(header->namelen, (uint32_t)sizeof(sockaddr_in6)));
+            package.address.isIPv6 = header->namelen == sizeof(sockaddr_in6);
+            package.status = std::min(payloadSize, bufferSize);
+            memcpy(buffers[numReceived], payload, package.status);
+            msghdr message{};
+            message.msg_control = control;
+            message.msg_controllen = header->controllen;
+            package.receptionTime = getReceptionTime(message, systemNow, steadyNow);
+            readDroppedPackages(message);
+            recycleBuffer(bufferID);
+            ++numReceived;
+        }
+        __atomic_store_n(completionHead, head, __ATOMIC_RELEASE);
+        if(!isReceiveArmed && Socket != INVALID_SOCKET)
+        {
+            std::lock_guard<std::mutex> guard(submissionMutex);
+            armReceive();
+        }
+        if(numReceived > 0)
+        {
+            return numReceived;
+        }
+        if(hasCompletions || std::chrono::steady_clock::now() >= timeout)
+        {
+            //only completions without packages, return instead of blocking (e.g. in an event-loop)
+            packages[0].status = RECEIVE_TIMEOUT;
+            return 1;
+        }
+        //2. wait for the next completion
+        const int result = waitForCompletion(std::chrono::duration_cast<std::chrono::milliseconds>(timeout - std::chrono::steady_clock::now()));
+        if(result < 0 && result != -ETIME && result != -EINTR)
+        {
+            ohmcomm::error("UDP") << "Error waiting for io_uring: " << strerror(-result) << ohmcomm::endl;
+            packages[0].status = INVALID_SOCKET;
+            return 1;
+        }
+    }
+}
+
+void IOUringUDPWrapper::closeNetwork()
+{
+    if(ringDescriptor >= 0 && Socket != INVALID_SOCKET)
+    {
+        //the armed receive-request holds a reference to the socket, which would keep the port bound
+        io_uring_sqe cancel{};
+        cancel.opcode = IORING_OP_ASYNC_CANCEL;
+        cancel.addr = RECEIVE_REQUEST;
+        cancel.user_data = CANCEL_REQUEST;
+        std::lock_guard<std::mutex> guard(submissionMutex);
+        submit(cancel);
+    }
+    UDPWrapper::closeNetwork();
+}
+
+int IOUringUDPWrapper::getSocketDescriptor() const
+{
+    if(ringDescriptor >= 0 && Socket != INVALID_SOCKET)
+    {
+        return ringDescriptor;
+    }
+    return Socket;
+}
+
+bool IOUringUDPWrapper::isRingActive() const
+{
+    return ringDescriptor >= 0;
+}
+
+bool IOUringUDPWrapper::setUpRing()
+{
+    parameters = io_uring_params{};
+    //every package received occupies a buffer until its completion is read, so the completion-queue can't overflow
+    parameters.flags = IORING_SETUP_CQSIZE;
+    parameters.cq_entries = 2 * NUM_BUFFERS;
+    ringDescriptor = syscall(__NR_io_uring_setup, SUBMISSION_QUEUE_SIZE, &parameters);
+    if(ringDescriptor < 0)
+    {
+        ohmcomm::warn("UDP") << "Failed to set up io_uring: " << strerror(errno) << ohmcomm::endl;
+        return false;
+    }
+    if(!(parameters.features & IORING_FEAT_EXT_ARG))
+    {
+        ohmcomm::warn("UDP") << "io_uring does not support waiting with timeout" << ohmcomm::endl;
+        return false;
+    }
+    submissionRingSize = parameters.sq_off.array + parameters.sq_entries * sizeof(uint32_t);
+    completionRingSize = parameters.cq_off.cqes + parameters.cq_entries * sizeof(io_uring_cqe);
+    if(parameters.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        submissionRingSize = completionRingSize = std::max(submissionRingSize, completionRingSize);
+    }
+    submissionRing = mmap(nullptr, submissionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringDescriptor, IORING_OFF_SQ_RING);
+    if(submissionRing == MAP_FAILED)
+    {
+        return false;
+    }
+    if(parameters.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        completionRing = submissionRing;
+    }
+    else
+    {
+        completionRing = mmap(nullptr, completionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringDescriptor, IORING_OFF_CQ_RING);
+        if(completionRing == MAP_FAILED)
+        {
+            return false;
+        }
+    }
+    submissionEntries = (io_uring_sqe*)mmap(nullptr, parameters.sq_entries * sizeof(io_uring_sqe), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                            ringDescriptor, IORING_OFF_SQES);
+    if(submissionEntries == MAP_FAILED)
+    {
+        return false;
+    }
+    //the queue holds the indices of the entries, we always use the entry with the same index
+    uint32_t* submissionArray = getRingField(submissionRing, parameters.sq_off.array);
+    for(uint32_t i = 0; i < parameters.sq_entries; ++i)
+    {
+        submissionArray[i] = i;
+    }
+
+    //the buffers the kernel selects from for every package received, the ring of buffers must be page-aligned
+    bufferRing = (io_uring_buf_ring*)mmap(nullptr, NUM_BUFFERS * sizeof(io_uring_buf), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(bufferRing == MAP_FAILED)
+    {
+        return false;
+    }
+    io_uring_buf_reg registration{};
+    registration.ring_addr = (uint64_t)bufferRing;
+    registration.ring_entries = NUM_BUFFERS;
+    registration.bgid = BUFFER_GROUP;
+    if(syscall(__NR_io_uring_register, ringDescriptor, IORING_REGISTER_PBUF_RING, &registration, 1) < 0)
+    {
+        ohmcomm::warn("UDP") << "Failed to register io_uring buffers: " << strerror(errno) << ohmcomm::endl;
+        return false;
+    }
+    buffers.resize(NUM_BUFFERS * (BUFFER_HEADER_SIZE + MAX_PACKAGE_SIZE));
+    for(uint16_t i = 0; i < NUM_BUFFERS; ++i)
+    {
+        recycleBuffer(i);
+    }
+
+    //the kernel reserves the space for the sender-address and the ancillary data given here in every buffer
+    receiveMessage = msghdr{};
+    receiveMessage.msg_namelen = sizeof(sockaddr_in6);
+    receiveMessage.msg_controllen = CONTROL_BUFFER_SIZE;
+    std::lock_guard<std::mutex> guard(submissionMutex);
+    if(!armReceive())
+    {
+        return false;
+    }
+    //kernels without multishot receives fail the request immediately
+    const io_uring_cqe* completions = (const io_uring_cqe*)((char*)completionRing + parameters.cq_off.cqes);
+    const uint32_t completionHead = *getRingField(completionRing, parameters.cq_off.head);
+    const uint32_t completionTail = __atomic_load_n(getRingField(completionRing, parameters.cq_off.tail), __ATOMIC_ACQUIRE);
+    const uint32_t completionMask = *getRingField(completionRing, parameters.cq_off.ring_mask);
+    for(uint32_t head = completionHead; head != completionTail; ++head)
+    {
+        if(completions[head & completionMask].user_data == RECEIVE_REQUEST && completions[head & completionMask].res < 0)
+        {
+            ohmcomm::warn("UDP") << "io_uring does not support multishot receives: " << strerror(-completions[head & completionMask].res) << ohmcomm::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+void IOUringUDPWrapper::tearDownRing()
+{
+    if(bufferRing != MAP_FAILED)
+    {
+        munmap(bufferRing, NUM_BUFFERS * sizeof(io_uring_buf));
+        bufferRing = (io_uring_buf_ring*)MAP_FAILED;
+    }
+    if(submissionEntries != MAP_FAILED)
+    {
+        munmap(submissionEntries, parameters.sq_entries * sizeof(io_uring_sqe));
+        submissionEntries = (io_uring_sqe*)MAP_FAILED;
+    }
+    if(completionRing != MAP_FAILED && completionRing != submissionRing)
+    {
+        munmap(completionRing, completionRingSize);
+    }
+    completionRing = MAP_FAILED;
+    if(submissionRing != MAP_FAILED)
+    {
+        munmap(submissionRing, submissionRingSize);
+        submissionRing = MAP_FAILED;
+    }
+    if(ringDescriptor >= 0)
+    {
+        //also cancels all requests still running
+        close(ringDescriptor);
+        ringDescriptor = -1;
+    }
+    buffers.clear();
+}
+
+bool IOUringUDPWrapper::submit(const io_uring_sqe& entry)
+{
+    uint32_t* submissionTail = getRingField(submissionRing, parameters.sq_off.tail);
+    const uint32_t submissionHead = __atomic_load_n(getRingField(submissionRing, parameters.sq_off.head), __ATOMIC_ACQUIRE);
+    const uint32_t tail = *submissionTail;
+    if(tail - submissionHead >= parameters.sq_entries)
+    {
+        return false;
+    }
+    submissionEntries[tail & *getRingField(submissionRing, parameters.sq_off.ring_mask)] = entry;
+    //the entry must be written, before the kernel sees the new tail
+    __atomic_store_n(submissionTail, tail + 1, __ATOMIC_RELEASE);
+    if(syscall(__NR_io_uring_enter, ringDescriptor, 1, 0, 0, nullptr, 0) < 0)
+    {
+        ohmcomm::error("UDP") << "Failed to submit io_uring request: " << strerror(errno) << ohmcomm::endl;
+        return false;
+    }
+    return true;
+}
+
+bool IOUringUDPWrapper::armReceive()
+{
+    io_uring_sqe receive{};
+    receive.opcode = IORING_OP_RECVMSG;
+    receive.fd = Socket;
+    receive.addr = (uint64_t)&receiveMessage;
+    receive.len = 1;
+    //keeps receiving into the selected buffers until cancelled or no buffer is available
+    receive.ioprio = IORING_RECV_MULTISHOT;
+    receive.flags = IOSQE_BUFFER_SELECT;
+    receive.buf_group = BUFFER_GROUP;
+    receive.user_data = RECEIVE_REQUEST;
+    isReceiveArmed = submit(receive);
+    return isReceiveArmed;
+}
+
+int IOUringUDPWrapper::waitForCompletion(const std::chrono::milliseconds timeout)
+{
+    const std::chrono::seconds seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+    __kernel_timespec waitTime{};
+    waitTime.tv_sec = seconds.count();
+    waitTime.tv_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(timeout - seconds).count();
+    io_uring_getevents_arg argument{};
+    argument.sigmask_sz = _NSIG / 8;
+    argument.ts = (uint64_t)&waitTime;
+    const int result = syscall(__NR_io_uring_enter, ringDescriptor, 0, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &argument, sizeof(argument));
+    return result < 0 ? -errno : result;
+}
+
+void IOUringUDPWrapper::recycleBuffer(const uint16_t bufferID)
+{
+    //only we write the tail, the kernel consumes the buffers from the head
+    const uint16_t tail = bufferRing->tail;
+    //the entries start at the beginning of the ring, but in C++ the empty struct in front of the flexible array of the kernel-header has a size
+    io_uring_buf& entry = ((io_uring_buf*)bufferRing)[tail & (NUM_BUFFERS - 1)];
+    entry.addr = (uint64_t)getBuffer(bufferID);
+    entry.len = BUFFER_HEADER_SIZE + MAX_PACKAGE_SIZE;
+    entry.bid = bufferID;
+    __atomic_store_n(&bufferRing->tail, (uint16_t)(tail + 1), __ATOMIC_RELEASE);
+}
+
+char* IOUringUDPWrapper::getBuffer(const uint16_t bufferID)
+{
+    return buffers.data() + bufferID * (BUFFER_HEADER_SIZE + MAX_PACKAGE_SIZE);
+}
+#endif
@@ -5,6 +5,9 @@
  * Created on February 27, 2016, 11:47 AM
  */
 #include <string.h>
+#ifndef _WIN32
+#include <netinet/in.h>
+#endif
 
 #include "Logger.h"
 #include "network/MulticastNetworkWrapper.h"
@@ -12,86 +15,281 @@
 
 using namespace ohmcomm::network;
 
+constexpr MulticastNetworkWrapper::GroupConfiguration MulticastNetworkWrapper::DEFAULT_GROUP_CONFIGURATION;
+
 MulticastNetworkWrapper::MulticastNetworkWrapper(const ohmcomm::NetworkConfiguration& initialDestination) : 
-    UDPWrapper(initialDestination), destinations()
+    UDPWrapper(initialDestination), destinations(), groupAddress({0}), groupInterface(0), groupJoined(false)
 {
     //add default remote-address to list of destinations
-    destinations.push_back(remoteAddress);
+    destinations.push_back(DestinationStatistics{remoteAddress, 0, 0, 0});
+#ifdef __linux__
+    updateMessages();
+#endif
 }
 
 int MulticastNetworkWrapper::sendData(const void* buffer, const unsigned int bufferSize)
 {
+    const BufferSegment segment{buffer, bufferSize};
+    return sendData(&segment, 1);
+}
+
+int MulticastNetworkWrapper::sendData(const BufferSegment* segments, const unsigned int numSegments)
+{
+#ifdef __linux__
+    if(numSegments > MAX_BUFFER_SEGMENTS)
+#else
+    if(numSegments != 1)
+#endif
+    {
+        //joins the segments and calls the single-buffer version
+        return NetworkWrapper::sendData(segments, numSegments);
+    }
+    std::lock_guard<std::mutex> guard(sendMutex);
     int totalBytesSent = 0;
-    for(const SocketAddress& dest: destinations)
+#ifdef __linux__
+    for(unsigned int i = 0; i < numSegments; ++i)
     {
-        const int socketAddressLength = dest.isIPv6 ? sizeof(sockaddr_in6) : sizeof (sockaddr_in);
-        const int status = sendto(this->Socket, (char*) buffer, (int) bufferSize, 0, (sockaddr*)&(dest.ipv6), socketAddressLength);
+        packageBuffers[i].iov_base = const_cast<void*>(segments[i].data);
+        packageBuffers[i].iov_len = segments[i].size;
+    }
+    for(mmsghdr& message : messages)
+    {
+        message.msg_hdr.msg_iovlen = numSegments;
+    }
+    //sendmmsg() stops at the first failed message, so we skip the failed destination and continue with the next one
+    unsigned int offset = 0;
+    while(offset < messages.size())
+    {
+        const int numSent = sendmmsg(this->Socket, messages.data() + offset, messages.size() - offset, 0);
+        if(numSent < 0)
+        {
+            if(errno == INTERRUPTED_BY_SYSTEM_CALL)
+            {
+                continue;
+            }
+            ohmcomm::error("Network") << "Error sending to " << destinations[offset].address.toString() << ": " << getLastError() << ohmcomm::endl;
+            ++destinations[offset].errors;
+            ++offset;
+            continue;
+        }
+        for(unsigned int i = offset; i < offset + numSent; ++i)
+        {
+            ++destinations[i].packagesSent;
+            destinations[i].bytesSent += messages[i].msg_len;
+            totalBytesSent += messages[i].msg_len;
+        }
+        offset += numSent;
+    }
+#else
+    const void* buffer = segments[0].data;
+    const unsigned int bufferSize = segments[0].size;
+    for(DestinationStatistics& dest: destinations)
+    {
+        const int socketAddressLength = dest.address.isIPv6 ? sizeof(sockaddr_in6) : sizeof (sockaddr_in);
+        const int status = sendto(this->Socket, (char*) buffer, (int) bufferSize, 0, (sockaddr*)&(dest.address.ipv6), socketAddressLength);
         if(status < 0)
         {
-            ohmcomm::error("Network") << "Error sending: " << getLastError() << ohmcomm::endl;
+            ohmcomm::error("Network") << "Error sending to " << dest.address.toString() << ": " << getLastError() << ohmcomm::endl;
+            ++dest.errors;
+            continue;
         }
+        ++dest.packagesSent;
+        dest.bytesSent += status;
         totalBytesSent += status;
     }
+#endif
     return totalBytesSent <= 0 ? 0 : totalBytesSent / destinations.size();
 }
 
-bool MulticastNetworkWrapper::addDestination(const std::string& destinationAddress, const unsigned short destinationPort)
+void MulticastNetworkWrapper::closeNetwork()
 {
-    const SocketAddress tmp = SocketAddress::fromAddressAndPort(destinationAddress, destinationPort);
-    for(const SocketAddress& addr : destinations)
+    if(Socket != INVALID_SOCKET)
     {
-        if(tmp.isIPv6 != addr.isIPv6)
+        for(const DestinationStatistics& dest : destinations)
         {
-            //different IP versions - cannot match
-            continue;
+            ohmcomm::info("Network") << "Sent " << dest.packagesSent << " packages (" << dest.bytesSent << " bytes) to " << dest.address.toString()
+                    << ", " << dest.errors << " errors" << ohmcomm::endl;
         }
-        else if(tmp.isIPv6)
+    }
+    leaveGroup();
+    UDPWrapper::closeNetwork();
+}
+
+bool MulticastNetworkWrapper::joinGroup(const GroupConfiguration& groupConfig)
+{
+    if(groupJoined)
+    {
+        return true;
+    }
+    if(!remoteAddress.isMulticastAddress())
+    {
+        ohmcomm::error("Network") << remoteAddress.toString() << " is no multicast-address" << ohmcomm::endl;
+        return false;
+    }
+    int status;
+    if(remoteAddress.isIPv6)
+    {
+        ipv6_mreq membership{};
+        membership.ipv6mr_multiaddr = remoteAddress.ipv6.sin6_addr;
+        membership.ipv6mr_interface = groupConfig.interfaceIndex;
+        status = setsockopt(Socket, IPPROTO_IPV6, IPV6_JOIN_GROUP, (char*) &membership, sizeof(membership));
+        if(status == 0)
         {
-            if(memcmp(&(tmp.ipv6.sin6_addr), &(addr.ipv6.sin6_addr), sizeof(tmp.ipv6.sin6_addr)) == 0 && tmp.ipv6.sin6_port == addr.ipv6.sin6_port)
-            {
-                //already in list
-                return false;
-            }
+            //the options for sending to the group
+            const int hopLimit = groupConfig.timeToLive;
+            const unsigned int loopback = groupConfig.loopback ? 1 : 0;
+            const unsigned int interfaceIndex = groupConfig.interfaceIndex;
+            status = setsockopt(Socket, IPPROTO_IPV6, IPV6_MULTICAST_HOPS, (char*) &hopLimit, sizeof(hopLimit));
+            status |= setsockopt(Socket, IPPROTO_IPV6, IPV6_MULTICAST_LOOP, (char*) &loopback, sizeof(loopback));
+            if(interfaceIndex != 0)
+                status |= setsockopt(Socket, IPPROTO_IPV6, IPV6_MULTICAST_IF, (char*) &interfaceIndex, sizeof(interfaceIndex));
         }
-        else
+    }
+    else
+    {
+#ifdef _WIN32
+        //Windows accepts the interface-index in place of the interface-address, if given as 0.0.0.<index>
+        ip_mreq membership{};
+        membership.imr_multiaddr = remoteAddress.ipv4.sin_addr;
+        membership.imr_interface.s_addr = htonl(groupConfig.interfaceIndex);
+#else
+        ip_mreqn membership{};
+        membership.imr_multiaddr = remoteAddress.ipv4.sin_addr;
+        membership.imr_address.s_addr = htonl(INADDR_ANY);
+        membership.imr_ifindex = groupConfig.interfaceIndex;
+#endif
+        status = setsockopt(Socket, IPPROTO_IP, IP_ADD_MEMBERSHIP, (char*) &membership, sizeof(membership));
+        if(status == 0)
         {
-            if(memcmp(&(tmp.ipv4.sin_addr), &(addr.ipv4.sin_addr), sizeof(tmp.ipv4.sin_addr)) == 0 && tmp.ipv4.sin_port == addr.ipv4.sin_port)
-            {
-                //already in list
-                return false;
-            }
+            const unsigned char timeToLive = groupConfig.timeToLive;
+            const unsigned char loopback = groupConfig.loopback ? 1 : 0;
+            status = setsockopt(Socket, IPPROTO_IP, IP_MULTICAST_TTL, (char*) &timeToLive, sizeof(timeToLive));
+            status |= setsockopt(Socket, IPPROTO_IP, IP_MULTICAST_LOOP, (char*) &loopback, sizeof(loopback));
+            if(groupConfig.interfaceIndex != 0)
+                status |= setsockopt(Socket, IPPROTO_IP, IP_MULTICAST_IF, (char*) &membership, sizeof(membership));
         }
     }
-    destinations.push_back(tmp);
+    if(status != 0)
+    {
+        ohmcomm::error("Network") << "Error joining multicast-group " << remoteAddress.toString() << ": " << getLastError() << ohmcomm::endl;
+        return false;
+    }
+    if(remoteAddress.isIPv6 && groupConfig.interfaceIndex != 0)
+    {
+        //scoped (e.g. interface- or link-local) groups are only reachable via the interface given as scope
+        std::lock_guard<std::mutex> guard(sendMutex);
+        const auto group = findDestination(remoteAddress);
+        remoteAddress.ipv6.sin6_scope_id = groupConfig.interfaceIndex;
+        if(group != destinations.end())
+        {
+            (*group).address.ipv6.sin6_scope_id = groupConfig.interfaceIndex;
+        }
+    }
+    groupAddress = remoteAddress;
+    groupInterface = groupConfig.interfaceIndex;
+    groupJoined = true;
+    ohmcomm::info("Network") << "Joined multicast-group " << groupAddress.toString() << ohmcomm::endl;
+    return true;
+}
+
+void MulticastNetworkWrapper::leaveGroup()
+{
+    if(!groupJoined)
+    {
+        return;
+    }
+    if(groupAddress.isIPv6)
+    {
+        ipv6_mreq membership{};
+        membership.ipv6mr_multiaddr = groupAddress.ipv6.sin6_addr;
+        membership.ipv6mr_interface = groupInterface;
+        setsockopt(Socket, IPPROTO_IPV6, IPV6_LEAVE_GROUP, (char*) &membership, sizeof(membership));
+    }
+    else
+    {
+#ifdef _WIN32
+        ip_mreq membership{};
+        membership.imr_multiaddr = groupAddress.ipv4.sin_addr;
+        membership.imr_interface.s_addr = htonl(groupInterface);
+#else
+        ip_mreqn membership{};
+        membership.imr_multiaddr = groupAddress.ipv4.sin_addr;
+        membership.imr_address.s_addr = htonl(INADDR_ANY);
+        membership.imr_ifindex = groupInterface;
+#endif
+        setsockopt(Socket, IPPROTO_IP, IP_DROP_MEMBERSHIP, (char*) &membership, sizeof(membership));
+    }
+    groupJoined = false;
+    ohmcomm::info("Network") << "Left multicast-group " << groupAddress.toString() << ohmcomm::endl;
+}
+
+bool MulticastNetworkWrapper::isGroupJoined() const
+{
+    return groupJoined;
+}
+
+bool MulticastNetworkWrapper::addDestination(const std::string& destinationAddress, const unsigned short destinationPort)
+{
+    const SocketAddress tmp = SocketAddress::fromAddressAndPort(destinationAddress, destinationPort);
+    //adding a destination may reallocate the list, the message-headers point into
+    std::lock_guard<std::mutex> guard(sendMutex);
+    if(findDestination(tmp) != destinations.end())
+    {
+        //already in list
+        return false;
+    }
+    destinations.push_back(DestinationStatistics{tmp, 0, 0, 0});
+#ifdef __linux__
+    updateMessages();
+#endif
     return true;
 }
 
 bool MulticastNetworkWrapper::removeDestination(const std::string& destinationAddress, const unsigned short destinationPort)
 {
-    SocketAddress tmp = SocketAddress::fromAddressAndPort(destinationAddress, destinationPort);
+    const SocketAddress tmp = SocketAddress::fromAddressAndPort(destinationAddress, destinationPort);
+    std::lock_guard<std::mutex> guard(sendMutex);
+    const auto it = findDestination(tmp);
+    if(it == destinations.end())
+    {
+        return false;
+    }
+    destinations.erase(it);
+#ifdef __linux__
+    updateMessages();
+#endif
+    return true;
+}
+
+std::vector<MulticastNetworkWrapper::DestinationStatistics> MulticastNetworkWrapper::getDestinationStatistics() const
+{
+    std::lock_guard<std::mutex> guard(sendMutex);
+    return destinations;
+}
+
+#ifdef __linux__
+void MulticastNetworkWrapper::updateMessages()
+{
+    messages.assign(destinations.size(), mmsghdr{});
+    for(unsigned int i = 0; i < destinations.size(); ++i)
+    {
+        msghdr& header = messages[i].msg_hdr;
+        header.msg_name = &(destinations[i].address.ipv6);
+        header.msg_namelen = destinations[i].address.isIPv6 ? sizeof(sockaddr_in6) : sizeof(sockaddr_in);
+        header.msg_iov = packageBuffers;
+        header.msg_iovlen = 1;
+    }
+}
+#endif
+
+std::vector<MulticastNetworkWrapper::DestinationStatistics>::iterator MulticastNetworkWrapper::findDestination(const SocketAddress& address)
+{
     for(auto i = destinations.begin(); i < destinations.end(); ++i)
     {
-        if(tmp.isIPv6 != (*i).isIPv6)
-        {
-            //different IP versions - cannot match
-            continue;
-        }
-        else if(tmp.isIPv6)
+        if((*i).address == address)
         {
-            if(memcmp(&(tmp.ipv6.sin6_addr), &((*i).ipv6.sin6_addr), sizeof(tmp.ipv6.sin6_addr)) == 0 && tmp.ipv6.sin6_port == (*i).ipv6.sin6_port)
-            {
-                destinations.erase(i);
-                return true;
-            }
-        }
-        else
-        {
-            if(memcmp(&(tmp.ipv4.sin_addr), &((*i).ipv4.sin_addr), sizeof(tmp.ipv4.sin_addr)) == 0 && tmp.ipv4.sin_port == (*i).ipv4.sin_port)
-            {
-                destinations.erase(i);
-                return true;
-            }
+            return i;
         }
     }
-    return false;
-}
\ No newline at end of file
+    return destinations.end();
+}
@@ -0,0 +1,293 @@
+/*
+ * File:   NetworkEmulator.cpp
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "network/NetworkEmulator.h"
+
+using namespace ohmcomm::network;
+
+constexpr std::chrono::milliseconds NetworkEmulator::DEFAULT_RECEIVE_TIMEOUT;
+
+void NetworkImpairments::setBurstLoss(const double lossRate, const double burstLength)
+{
+    //in the bad state, every package is lost, so the bad state lasts for a burst on average
+    //and is entered often enough to lose the given ratio of packages (stationary probability of the bad state)
+    lossInGood = 0;
+    lossInBad = 1;
+    badToGoodProbability = 1.0 / std::max(burstLength, 1.0);
+    goodToBadProbability = lossRate >= 1 ? 1 : lossRate * badToGoodProbability / (1 - lossRate);
+}
+
+NetworkEmulator::Endpoint::Endpoint(const std::shared_ptr<NetworkEmulator> network, const SocketAddress& localAddress, const SocketAddress& remoteAddress,
+                                    const NetworkImpairments& impairments, const uint32_t seed) :
+    network(network), localAddress(localAddress), remoteAddress(remoteAddress), impairments(impairments), random(seed), isInBadState(false), linkBusyUntil(),
+    queue(), isOpen(true)
+{
+}
+
+NetworkEmulator::Endpoint::~Endpoint()
+{
+    closeNetwork();
+}
+
+int NetworkEmulator::Endpoint::sendData(const void* buffer, const unsigned int bufferSize)
+{
+    const BufferSegment segment{buffer, bufferSize};
+    return sendData(&segment, 1);
+}
+
+int NetworkEmulator::Endpoint::sendData(const BufferSegment* segments, const unsigned int numSegments)
+{
+    std::lock_guard<std::mutex> guard(network->networkMutex);
+    if(!isOpen)
+    {
+        return INVALID_SOCKET;
+    }
+    network->deliverPackage(*this, segments, numSegments);
+    unsigned int size = 0;
+    for(unsigned int i = 0; i < numSegments; ++i)
+    {
+        size += segments[i].size;
+    }
+    return size;
+}
+
+NetworkWrapper::Package NetworkEmulator::Endpoint::receiveData(void* buffer, unsigned int bufferSize)
+{
+    Package package{};
+    receiveData(&buffer, bufferSize, &package, 1);
+    return package;
+}
+
+unsigned int NetworkEmulator::Endpoint::receiveData(void* const* buffers, const unsigned int bufferSize, Package* packages, const unsigned int numBuffers)
+{
+    std::unique_lock<std::mutex> lock(network->networkMutex);
+    const auto timeout = std::chrono::steady_clock::now() + network->receiveTimeout;
+    while(isOpen && (queue.empty() || queue.top().deliveryTime > network->getTime()))
+    {
+        //on the real clock, the first package is due at its delivery-time, on the virtual clock only after advancing the time
+        auto wakeUp = timeout;
+        if(!network->virtualTime && !queue.empty())
+        {
+            wakeUp = std::min(wakeUp, queue.top().deliveryTime);
+        }
+        if(network->packagesChanged.wait_until(lock, wakeUp) == std::cv_status::timeout && std::chrono::steady_clock::now() >= timeout)
+        {
+            break;
+        }
+    }
+    if(!isOpen)
+    {
+        packages[0].status = INVALID_SOCKET;
+        return 1;
+    }
+    const std::chrono::steady_clock::time_point now = network->getTime();
+    unsigned int numReceived = 0;
+    while(numReceived < std::min(numBuffers, MAX_RECEIVE_BATCH) && !queue.empty() && queue.top().deliveryTime <= now)
+    {
+        const QueuedPackage& queued = queue.top();
+        //like UDP, the remainder of a package exceeding the buffer is discarded
+        const unsigned int size = std::min((unsigned int)queued.data.size(), bufferSize);
+        memcpy(buffers[numReceived], queued.data.data(), size);
+        packages[numReceived].address = queued.sender;
+        packages[numReceived].status = size;
+        packages[numReceived].receptionTime = queued.deliveryTime;
+        queue.pop();
+        ++numReceived;
+    }
+    if(numReceived == 0)
+    {
+        packages[0].status = RECEIVE_TIMEOUT;
+        return 1;
+    }
+    return numReceived;
+}
+
+std::wstring NetworkEmulator::Endpoint::getLastError() const
+{
+    std::lock_guard<std::mutex> guard(network->networkMutex);
+    return isOpen ? L"No error" : L"Endpoint was closed";
+}
+
+void NetworkEmulator::Endpoint::closeNetwork()
+{
+    network->removeEndpoint(this);
+}
+
+void NetworkEmulator::Endpoint::setImpairments(const NetworkImpairments& impairments)
+{
+    std::lock_guard<std::mutex> guard(network->networkMutex);
+    this->impairments = impairments;
+}
+
+const SocketAddress& NetworkEmulator::Endpoint::getLocalAddress() const
+{
+    return localAddress;
+}
+
+unsigned int NetworkEmulator::Endpoint::getNumberOfQueuedPackages() const
+{
+    std::lock_guard<std::mutex> guard(network->networkMutex);
+    return queue.size();
+}
+
+bool NetworkEmulator::Endpoint::isPackageLost()
+{
+    std::uniform_real_distribution<double> probability(0, 1);
+    const bool isLost = probability(random) < (isInBadState ? impairments.lossInBad : impairments.lossInGood);
+    //the state for the next package
+    if(isInBadState)
+    {
+        isInBadState = probability(random) >= impairments.badToGoodProbability;
+    }
+    else
+    {
+        isInBadState = probability(random) < impairments.goodToBadProbability;
+    }
+    return isLost;
+}
+
+std::chrono::microseconds NetworkEmulator::Endpoint::getPackageDelay()
+{
+    std::uniform_real_distribution<double> probability(0, 1);
+    const double jitter = impairments.jitter.count();
+    if(jitter <= 0 || probability(random) < impairments.reorderProbability)
+    {
+        return impairments.delay;
+    }
+    double additionalDelay = jitter;
+    switch(impairments.distribution)
+    {
+        case DelayDistribution::UNIFORM:
+            additionalDelay = std::uniform_real_distribution<double>(0, 2 * jitter)(random);
+            break;
+        case DelayDistribution::NORMAL:
+            additionalDelay = std::max(std::normal_distribution<double>(jitter, jitter)(random), 0.0);
+            break;
+        case DelayDistribution::EXPONENTIAL:
+            additionalDelay = std::exponential_distribution<double>(1 / jitter)(random);
+            break;
+        case DelayDistribution::PARETO:
+        {
+            //the mean of a pareto-distribution with shape a and scale x is a * x / (a - 1), shifted to start at zero
+            const double shape = 1.5;
+            const double scale = jitter * (shape - 1) / shape;
+            additionalDelay = scale / std::pow(1 - probability(random), 1 / shape) - scale;
+            break;
+        }
+        case DelayDistribution::CONSTANT:
+        default:
+            break;
+    }
+    return impairments.delay + std::chrono::microseconds((long long)additionalDelay);
+}
+
+std::shared_ptr<NetworkEmulator> NetworkEmulator::create(const bool virtualTime, const uint32_t seed, const std::chrono::milliseconds receiveTimeout)
+{
+    return std::shared_ptr<NetworkEmulator>(new NetworkEmulator(virtualTime, seed, receiveTimeout));
+}
+
+NetworkEmulator::NetworkEmulator(const bool virtualTime, const uint32_t seed, const std::chrono::milliseconds receiveTimeout) :
+    virtualTime(virtualTime), seed(seed), receiveTimeout(receiveTimeout), networkMutex(), packagesChanged(), virtualNow(std::chrono::steady_clock::now()),
+    endpoints(), nextSequence(0)
+{
+}
+
+std::shared_ptr<NetworkEmulator::Endpoint> NetworkEmulator::createEndpoint(const NetworkConfiguration& networkConfig, const NetworkImpairments& impairments,
+                                                                          const std::string& localIPAddress)
+{
+    std::lock_guard<std::mutex> guard(networkMutex);
+    //every endpoint gets its own sequence of random numbers, independent of the packages sent by the other endpoints
+    std::shared_ptr<Endpoint> endpoint(new Endpoint(shared_from_this(), SocketAddress::fromAddressAndPort(localIPAddress, networkConfig.localPort),
+                                                    SocketAddress::fromAddressAndPort(networkConfig.remoteIPAddress, networkConfig.remotePort), impairments,
+                                                    seed + endpoints.size()));
+    endpoints.push_back(endpoint.get());
+    return endpoint;
+}
+
+std::chrono::steady_clock::time_point NetworkEmulator::now() const
+{
+    std::lock_guard<std::mutex> guard(networkMutex);
+    return getTime();
+}
+
+void NetworkEmulator::advanceTime(const std::chrono::microseconds duration)
+{
+    if(!virtualTime)
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> guard(networkMutex);
+        virtualNow += duration;
+    }
+    packagesChanged.notify_all();
+}
+
+bool NetworkEmulator::isVirtualTime() const
+{
+    return virtualTime;
+}
+
+std::chrono::steady_clock::time_point NetworkEmulator::getTime() const
+{
+    return virtualTime ? virtualNow : std::chrono::steady_clock::now();
+}
+
+void NetworkEmulator::deliverPackage(Endpoint& sender, const NetworkWrapper::BufferSegment* segments, const unsigned int numSegments)
+{
+    const auto receiver = std::find_if(endpoints.begin(), endpoints.end(), [&sender](const Endpoint* endpoint)
+    {
+        return endpoint->localAddress == sender.remoteAddress;
+    });
+    if(sender.isPackageLost() || receiver == endpoints.end())
+    {
+        return;
+    }
+    Endpoint::QueuedPackage package{};
+    package.sender = sender.localAddress;
+    for(unsigned int i = 0; i < numSegments; ++i)
+    {
+        package.data.insert(package.data.end(), (const char*)segments[i].data, (const char*)segments[i].data + segments[i].size);
+    }
+    //the package leaves the link after all packages sent before, taking the time to transmit all of its bits
+    std::chrono::steady_clock::time_point departureTime = getTime();
+    if(sender.impairments.bandwidth > 0)
+    {
+        departureTime = std::max(departureTime, sender.linkBusyUntil) +
+                std::chrono::microseconds(package.data.size() * 8 * 1000000 / sender.impairments.bandwidth);
+        sender.linkBusyUntil = departureTime;
+    }
+    std::uniform_real_distribution<double> probability(0, 1);
+    const bool isDuplicated = probability(sender.random) < sender.impairments.duplicateProbability;
+    if(isDuplicated)
+    {
+        Endpoint::QueuedPackage duplicate = package;
+        duplicate.deliveryTime = departureTime + sender.getPackageDelay();
+        duplicate.sequence = nextSequence++;
+        (*receiver)->queue.push(std::move(duplicate));
+    }
+    package.deliveryTime = departureTime + sender.getPackageDelay();
+    package.sequence = nextSequence++;
+    (*receiver)->queue.push(std::move(package));
+    packagesChanged.notify_all();
+}
+
+void NetworkEmulator::removeEndpoint(Endpoint* endpoint)
+{
+    {
+        std::lock_guard<std::mutex> guard(networkMutex);
+        if(!endpoint->isOpen)
+        {
+            return;
+        }
+        endpoint->isOpen = false;
+        endpoint->queue = decltype(endpoint->queue)();
+        endpoints.erase(std::remove(endpoints.begin(), endpoints.end(), endpoint), endpoints.end());
+    }
+    //wakes up the receiving thread of the endpoint
+    packagesChanged.notify_all();
+}
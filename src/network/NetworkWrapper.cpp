@@ -5,6 +5,35 @@
 
 using namespace ohmcomm::network;
 
+constexpr unsigned int NetworkWrapper::MAX_BUFFER_SEGMENTS;
+constexpr unsigned int NetworkWrapper::MAX_RECEIVE_BATCH;
+
+int NetworkWrapper::sendData(const BufferSegment* segments, const unsigned int numSegments)
+{
+    unsigned int totalSize = 0;
+    for(unsigned int i = 0; i < numSegments; ++i)
+    {
+        totalSize += segments[i].size;
+    }
+    if(gatherBuffer.size() < totalSize)
+    {
+        gatherBuffer.resize(totalSize);
+    }
+    unsigned int offset = 0;
+    for(unsigned int i = 0; i < numSegments; ++i)
+    {
+        memcpy(gatherBuffer.data() + offset, segments[i].data, segments[i].size);
+        offset += segments[i].size;
+    }
+    return sendData(gatherBuffer.data(), totalSize);
+}
+
+unsigned int NetworkWrapper::receiveData(void* const* buffers, const unsigned int bufferSize, Package* packages, const unsigned int numBuffers)
+{
+    packages[0] = receiveData(buffers[0], bufferSize);
+    return 1;
+}
+
 std::wstring NetworkWrapper::getLastError() const
 {
     int error;
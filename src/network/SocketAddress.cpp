@@ -1,4 +1,6 @@
 
+#include <string.h>     //memcmp
+
 #include "network/SocketAddress.h"
 #include "network/NetworkGrammars.h"
 #include "Utility.h"
@@ -20,6 +22,39 @@ std::pair<std::string, uint16_t> SocketAddress::toAddressAndPort() const
     return std::make_pair(std::string(buffer), port);
 }
 
+std::string SocketAddress::toString() const
+{
+    const auto addressAndPort = toAddressAndPort();
+    if(isIPv6)
+    {
+        return std::string("[") + addressAndPort.first + "]:" + std::to_string(addressAndPort.second);
+    }
+    return addressAndPort.first + ":" + std::to_string(addressAndPort.second);
+}
+
+bool SocketAddress::isMulticastAddress() const
+{
+    if(isIPv6)
+    {
+        return ipv6.sin6_addr.s6_addr[0] == 0xFF;
+    }
+    return (ntohl(ipv4.sin_addr.s_addr) & 0xF0000000) == 0xE0000000;
+}
+
+bool SocketAddress::operator==(const SocketAddress& other) const
+{
+    if(isIPv6 != other.isIPv6)
+    {
+        //different IP versions - cannot match
+        return false;
+    }
+    if(isIPv6)
+    {
+        return memcmp(&(ipv6.sin6_addr), &(other.ipv6.sin6_addr), sizeof(ipv6.sin6_addr)) == 0 && ipv6.sin6_port == other.ipv6.sin6_port;
+    }
+    return memcmp(&(ipv4.sin_addr), &(other.ipv4.sin_addr), sizeof(ipv4.sin_addr)) == 0 && ipv4.sin_port == other.ipv4.sin_port;
+}
+
 SocketAddress SocketAddress::fromAddressAndPort(const std::string& address, const uint16_t port)
 {
     SocketAddress addr = {0};
@@ -2,10 +2,29 @@
 #include "network/TCPWrapper.h"
 #include "network/NetworkGrammars.h"
 
+#include <algorithm>
+#ifndef _WIN32
+#include <netinet/tcp.h>    //TCP_NODELAY
+#endif
+
 using namespace ohmcomm::network;
 
+constexpr unsigned int TCPWrapper::FRAME_HEADER_SIZE;
+constexpr unsigned int TCPWrapper::MAX_PACKAGE_SIZE;
+
+//the reassembly-buffer holds at least one complete package of maximum size plus the beginning of the next package
+static constexpr unsigned int RECEIVE_BUFFER_SIZE{2 * (TCPWrapper::FRAME_HEADER_SIZE + TCPWrapper::MAX_PACKAGE_SIZE)};
+
+#ifdef MSG_NOSIGNAL
+//a connection closed by the remote must not kill the process (SIGPIPE), sending fails instead
+static constexpr int SEND_FLAGS{MSG_DONTWAIT | MSG_NOSIGNAL};
+#elif !defined(_WIN32)
+static constexpr int SEND_FLAGS{MSG_DONTWAIT};
+#endif
+
 TCPWrapper::TCPWrapper(unsigned short localPort, const std::string remoteIPAddress, unsigned short remotePort) :
-    localAddress({0}), remoteAddress({0})
+    localAddress({0}), remoteAddress({0}), receiveBuffer(RECEIVE_BUFFER_SIZE), receiveStart(0), receiveEnd(0), sendMutex(),
+    pendingBuffer(FRAME_HEADER_SIZE + MAX_PACKAGE_SIZE), pendingStart(0), pendingEnd(0), droppedSends(0), isCongested(false)
 {
 	initializeNetworkConfig(localPort, remoteIPAddress, remotePort);
 	initializeNetwork();
@@ -93,6 +112,8 @@ bool TCPWrapper::createSocket()
     setsockopt(Socket, SOL_SOCKET, SO_RCVTIMEO, (char*) &timeout, sizeof(timeout));
     //we need to allow reuse-address for fast re-binding after closing
     setsockopt(Socket, SOL_SOCKET, SO_REUSEADDR, (char*) &yes, sizeof (int));
+    //send every package immediately instead of waiting for the acknowledgment of the previous one (Nagle's algorithm)
+    setsockopt(Socket, IPPROTO_TCP, TCP_NODELAY, (char*) &yes, sizeof (int));
     
     if (bind(Socket, (sockaddr*)&(this->localAddress), addressLength) == SOCKET_ERROR)
     {
@@ -118,31 +139,185 @@ bool TCPWrapper::createSocket()
 
 int TCPWrapper::sendData(const void *buffer, const unsigned int bufferSize)
 {
-    return sendto(this->Socket, (char*)buffer, (int)bufferSize, 0, (sockaddr*)&(this->remoteAddress), getSocketAddressLength());
+    const BufferSegment segment{buffer, bufferSize};
+    return sendData(&segment, 1);
 }
 
-NetworkWrapper::Package TCPWrapper::receiveData(void *buffer, unsigned int bufferSize)
+int TCPWrapper::sendData(const BufferSegment* segments, const unsigned int numSegments)
 {
+    if(numSegments > MAX_BUFFER_SEGMENTS)
+    {
+        //joins the segments and sends them as a single segment
+        return NetworkWrapper::sendData(segments, numSegments);
+    }
+    unsigned int packageSize = 0;
+    for(unsigned int i = 0; i < numSegments; ++i)
+    {
+        packageSize += segments[i].size;
+    }
+    if(packageSize > MAX_PACKAGE_SIZE)
+    {
+        ohmcomm::error("TCP") << "Package of " << packageSize << " bytes exceeds the maximum size of " << MAX_PACKAGE_SIZE << " bytes" << ohmcomm::endl;
+        return -1;
+    }
+    //RFC 4571: the length of the package as 16-bit unsigned integer in network byte order
+    const unsigned char header[FRAME_HEADER_SIZE] = {(unsigned char)(packageSize >> 8), (unsigned char)(packageSize & 0xFF)};
+    std::lock_guard<std::mutex> guard(sendMutex);
 #ifdef _WIN32
-    int addressLength = getSocketAddressLength();
+    //the header and the package are joined, so they are sent with a single system-call
+    memcpy(pendingBuffer.data(), header, FRAME_HEADER_SIZE);
+    unsigned int offset = FRAME_HEADER_SIZE;
+    for(unsigned int i = 0; i < numSegments; ++i)
+    {
+        memcpy(pendingBuffer.data() + offset, segments[i].data, segments[i].size);
+        offset += segments[i].size;
+    }
+    const int result = send(Socket, pendingBuffer.data(), (int)offset, 0);
+    return result == SOCKET_ERROR ? -1 : (int)packageSize;
 #else
-    unsigned int addressLength = getSocketAddressLength();
+    //the remainder of the previous package, the header and the package are written with a single system-call
+    iovec vectors[MAX_BUFFER_SEGMENTS + 2];
+    unsigned int numVectors = 0;
+    const unsigned int pendingSize = pendingEnd - pendingStart;
+    if(pendingSize > 0)
+    {
+        vectors[numVectors++] = {pendingBuffer.data() + pendingStart, pendingSize};
+    }
+    const unsigned int firstPackageVector = numVectors;
+    vectors[numVectors++] = {(void*)header, FRAME_HEADER_SIZE};
+    for(unsigned int i = 0; i < numSegments; ++i)
+    {
+        vectors[numVectors++] = {const_cast<void*>(segments[i].data), segments[i].size};
+    }
+    msghdr message{};
+    message.msg_iov = vectors;
+    message.msg_iovlen = numVectors;
+    ssize_t sent = sendmsg(Socket, &message, SEND_FLAGS);
+    if(sent < 0)
+    {
+        if(errno != EAGAIN && errno != EWOULDBLOCK)
+        {
+            return -1;
+        }
+        sent = 0;
+    }
+    if((size_t)sent < pendingSize)
+    {
+        //the package would be queued behind the remainder of the previous one, so it is dropped instead of adding latency
+        pendingStart += sent;
+        ++droppedSends;
+        if(!isCongested)
+        {
+            ohmcomm::warn("TCP") << "Connection is congested, dropping packages ..." << ohmcomm::endl;
+            isCongested = true;
+        }
+        return 0;
+    }
+    pendingStart = 0;
+    pendingEnd = 0;
+    //the package was started, so its remainder is kept to be sent first to not break the framing
+    size_t skip = sent - pendingSize;
+    for(unsigned int i = firstPackageVector; i < numVectors; ++i)
+    {
+        if(skip >= vectors[i].iov_len)
+        {
+            skip -= vectors[i].iov_len;
+            continue;
+        }
+        memcpy(pendingBuffer.data() + pendingEnd, (const char*)vectors[i].iov_base + skip, vectors[i].iov_len - skip);
+        pendingEnd += vectors[i].iov_len - skip;
+        skip = 0;
+    }
+    if(isCongested && pendingEnd == 0)
+    {
+        ohmcomm::info("TCP") << "Connection recovered, " << droppedSends << " packages dropped so far" << ohmcomm::endl;
+        isCongested = false;
+    }
+    return packageSize;
 #endif
-    NetworkWrapper::Package package{};
-    package.status = recvfrom(this->Socket, (char*)buffer, (int)bufferSize, 0, (sockaddr*)&(package.address.ipv6), &addressLength);
-    if (package.status == -1)
+}
+
+NetworkWrapper::Package TCPWrapper::receiveData(void *buffer, unsigned int bufferSize)
+{
+    Package package{};
+    receiveData(&buffer, bufferSize, &package, 1);
+    return package;
+}
+
+unsigned int TCPWrapper::receiveData(void* const* buffers, const unsigned int bufferSize, Package* packages, const unsigned int numBuffers)
+{
+    const unsigned int batchSize = std::min(numBuffers, MAX_RECEIVE_BATCH);
+    unsigned int numReceived = readPackages(buffers, bufferSize, packages, batchSize);
+    if(numReceived > 0)
+    {
+        return numReceived;
+    }
+    //moves the beginning of the next package to the front to make room for its remainder
+    if(receiveStart > 0)
+    {
+        memmove(receiveBuffer.data(), receiveBuffer.data() + receiveStart, receiveEnd - receiveStart);
+        receiveEnd -= receiveStart;
+        receiveStart = 0;
+    }
+    packages[0] = Package{};
+    const int received = recv(Socket, receiveBuffer.data() + receiveEnd, (int)(receiveBuffer.size() - receiveEnd), 0);
+    if(received == 0)
+    {
+        //the remote closed the connection
+        packages[0].status = INVALID_SOCKET;
+        return 1;
+    }
+    if(received < 0)
     {
         if(hasTimedOut() || errno == INTERRUPTED_BY_SYSTEM_CALL)
         {
             //we have timed-out (or were interrupted by some other system call), so notify caller and return
-            package.status = RECEIVE_TIMEOUT;
-            return package;
+            packages[0].status = RECEIVE_TIMEOUT;
+            return 1;
         }
         std::wcerr << this->getLastError();
+        packages[0].status = INVALID_SOCKET;
+        return 1;
     }
-    if(addressLength == sizeof(sockaddr_in6))
-        package.address.isIPv6 = true;
-    return package;
+    receiveEnd += received;
+    numReceived = readPackages(buffers, bufferSize, packages, batchSize);
+    if(numReceived == 0)
+    {
+        //only a part of the next package was received, which is completed by the next call
+        packages[0].status = RECEIVE_TIMEOUT;
+        return 1;
+    }
+    return numReceived;
+}
+
+unsigned int TCPWrapper::readPackages(void* const* buffers, const unsigned int bufferSize, Package* packages, const unsigned int numBuffers)
+{
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    unsigned int numReceived = 0;
+    while(numReceived < numBuffers && receiveEnd - receiveStart >= FRAME_HEADER_SIZE)
+    {
+        const unsigned char* frame = (const unsigned char*)receiveBuffer.data() + receiveStart;
+        const unsigned int packageSize = (frame[0] << 8) | frame[1];
+        if(receiveEnd - receiveStart < FRAME_HEADER_SIZE + packageSize)
+        {
+            break;
+        }
+        //like UDP, the remainder of a package exceeding the buffer is discarded
+        const unsigned int size = std::min(packageSize, bufferSize);
+        memcpy(buffers[numReceived], frame + FRAME_HEADER_SIZE, size);
+        packages[numReceived] = Package{};
+        packages[numReceived].status = size;
+        packages[numReceived].address = remoteAddress;
+        packages[numReceived].receptionTime = now;
+        receiveStart += FRAME_HEADER_SIZE + packageSize;
+        ++numReceived;
+    }
+    if(receiveStart == receiveEnd)
+    {
+        receiveStart = 0;
+        receiveEnd = 0;
+    }
+    return numReceived;
 }
 
 void TCPWrapper::closeNetwork()
@@ -159,6 +334,16 @@ void TCPWrapper::closeNetwork()
     }
 }
 
+int TCPWrapper::getSocketDescriptor() const
+{
+    return Socket;
+}
+
+uint32_t TCPWrapper::getNumberOfDroppedSends() const
+{
+    return droppedSends;
+}
+
 int TCPWrapper::getSocketAddressLength()
 {
     if(remoteAddress.isIPv6)
@@ -1,11 +1,53 @@
+#include <algorithm>
+
 #include "Logger.h"
 #include "network/UDPWrapper.h"
 #include "network/NetworkGrammars.h"
 
+#ifndef _WIN32
+#include <sys/uio.h>    //iovec
+#endif
+
 using namespace ohmcomm::network;
 
+#ifdef __linux__
+constexpr unsigned int UDPWrapper::CONTROL_BUFFER_SIZE;
+
+void UDPWrapper::readDroppedPackages(msghdr& message)
+{
+    for(cmsghdr* control = CMSG_FIRSTHDR(&message); control != nullptr; control = CMSG_NXTHDR(&message, control))
+    {
+        if(control->cmsg_level == SOL_SOCKET && control->cmsg_type == SO_RXQ_OVFL)
+        {
+            //the total number of packages dropped by the socket, before this package was queued
+            uint32_t counter;
+            memcpy(&counter, CMSG_DATA(control), sizeof(counter));
+            droppedPackages = counter;
+        }
+    }
+}
+
+std::chrono::steady_clock::time_point UDPWrapper::getReceptionTime(msghdr& message, const std::chrono::system_clock::time_point systemNow, const std::chrono::steady_clock::time_point steadyNow)
+{
+    for(cmsghdr* control = CMSG_FIRSTHDR(&message); control != nullptr; control = CMSG_NXTHDR(&message, control))
+    {
+        if(control->cmsg_level == SOL_SOCKET && control->cmsg_type == SCM_TIMESTAMPNS)
+        {
+            timespec kernelTime;
+            memcpy(&kernelTime, CMSG_DATA(control), sizeof(kernelTime));
+            const std::chrono::system_clock::time_point receptionTime(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                    std::chrono::seconds(kernelTime.tv_sec) + std::chrono::nanoseconds(kernelTime.tv_nsec)));
+            //the package can't be received in the future, e.g. if the wall-clock was adjusted in between
+            const std::chrono::system_clock::duration age = std::max(systemNow - receptionTime, std::chrono::system_clock::duration::zero());
+            return steadyNow - std::chrono::duration_cast<std::chrono::steady_clock::duration>(age);
+        }
+    }
+    return steadyNow;
+}
+#endif
+
 UDPWrapper::UDPWrapper(unsigned short portIncoming, const std::string remoteIPAddress, unsigned short portOutgoing) :
-localAddress({0}), remoteAddress({0})
+localAddress({0}), remoteAddress({0}), reusePort(false), droppedPackages(0)
 {
     initializeNetworkConfig(portIncoming, remoteIPAddress, portOutgoing);
     initializeNetwork();
@@ -16,6 +58,13 @@ UDPWrapper(networkConfig.localPort, networkConfig.remoteIPAddress, networkConfig
 {
 }
 
+UDPWrapper::UDPWrapper(const ohmcomm::NetworkConfiguration& networkConfig, const bool reusePort) :
+localAddress({0}), remoteAddress({0}), reusePort(reusePort), droppedPackages(0)
+{
+    initializeNetworkConfig(networkConfig.localPort, networkConfig.remoteIPAddress, networkConfig.remotePort);
+    initializeNetwork();
+}
+
 UDPWrapper::~UDPWrapper()
 {
     if(Socket >= 0)
@@ -96,6 +145,26 @@ bool UDPWrapper::createSocket()
         perror("setsockopt");
         ohmcomm::info("UDP") << "Reuse: " << getLastError() << ohmcomm::endl;
     }
+#ifdef SO_REUSEPORT
+    //must be set before binding, for all sockets sharing the port
+    if(reusePort && setsockopt(Socket, SOL_SOCKET, SO_REUSEPORT, (char*) &yes, sizeof (int)) < 0)
+    {
+        ohmcomm::error("UDP") << "Failed to share local port: " << getLastError() << ohmcomm::endl;
+    }
+#endif
+
+#ifdef __linux__
+    //let the kernel timestamp the arrival of packages, so the delay until the package is read is not counted as network-jitter
+    if(setsockopt(Socket, SOL_SOCKET, SO_TIMESTAMPNS, (char*) &yes, sizeof (int)) < 0)
+    {
+        ohmcomm::info("UDP") << "Kernel timestamps: " << getLastError() << ohmcomm::endl;
+    }
+    //let the kernel report the packages dropped on a full receive-buffer
+    if(setsockopt(Socket, SOL_SOCKET, SO_RXQ_OVFL, (char*) &yes, sizeof (int)) < 0)
+    {
+        ohmcomm::info("UDP") << "Drop counter: " << getLastError() << ohmcomm::endl;
+    }
+#endif
 
     if (bind(Socket, (sockaddr*)&(this->localAddress), addressLength) == SOCKET_ERROR)
     {
@@ -114,8 +183,56 @@ int UDPWrapper::sendData(const void *buffer, const unsigned int bufferSize)
     return sendto(this->Socket, (char*) buffer, (int) bufferSize, 0, (sockaddr*)&(this->remoteAddress), getSocketAddressLength());
 }
 
+int UDPWrapper::sendData(const BufferSegment* segments, const unsigned int numSegments)
+{
+#ifdef _WIN32
+    return NetworkWrapper::sendData(segments, numSegments);
+#else
+    if(numSegments > MAX_BUFFER_SEGMENTS)
+    {
+        return NetworkWrapper::sendData(segments, numSegments);
+    }
+    return sendDataTo(remoteAddress, segments, numSegments);
+#endif
+}
+
+int UDPWrapper::sendDataTo(const SocketAddress& destination, const BufferSegment* segments, const unsigned int numSegments)
+{
+    const int addressLength = destination.isIPv6 ? sizeof(sockaddr_in6) : sizeof(sockaddr_in);
+#ifndef _WIN32
+    if(numSegments <= MAX_BUFFER_SEGMENTS)
+    {
+        iovec buffers[MAX_BUFFER_SEGMENTS];
+        for(unsigned int i = 0; i < numSegments; ++i)
+        {
+            buffers[i].iov_base = const_cast<void*>(segments[i].data);
+            buffers[i].iov_len = segments[i].size;
+        }
+        msghdr message{};
+        message.msg_name = const_cast<sockaddr_in6*>(&(destination.ipv6));
+        message.msg_namelen = addressLength;
+        message.msg_iov = buffers;
+        message.msg_iovlen = numSegments;
+        return sendmsg(this->Socket, &message, 0);
+    }
+#endif
+    //the default implementation of joining the segments always sends to the configured remote
+    std::vector<char> package;
+    for(unsigned int i = 0; i < numSegments; ++i)
+    {
+        package.insert(package.end(), (const char*) segments[i].data, (const char*) segments[i].data + segments[i].size);
+    }
+    return sendto(this->Socket, package.data(), (int) package.size(), 0, (const sockaddr*)&(destination.ipv6), addressLength);
+}
+
 NetworkWrapper::Package UDPWrapper::receiveData(void *buffer, unsigned int bufferSize)
 {
+#ifdef __linux__
+    //receive a batch of a single package to retrieve the kernel-timestamp
+    NetworkWrapper::Package package{};
+    receiveData(&buffer, bufferSize, &package, 1);
+    return package;
+#else
 #ifdef _WIN32
     int addressLength = getSocketAddressLength();
 #else
@@ -135,7 +252,62 @@ NetworkWrapper::Package UDPWrapper::receiveData(void *buffer, unsigned int buffe
     }
     if(addressLength == sizeof(sockaddr_in6))
         package.address.isIPv6 = true;
+    package.receptionTime = std::chrono::steady_clock::now();
     return package;
+#endif
+}
+
+unsigned int UDPWrapper::receiveData(void* const* buffers, const unsigned int bufferSize, Package* packages, const unsigned int numBuffers)
+{
+#ifndef __linux__
+    return NetworkWrapper::receiveData(buffers, bufferSize, packages, numBuffers);
+#else
+    const unsigned int batchSize = std::min(numBuffers, MAX_RECEIVE_BATCH);
+    mmsghdr messages[MAX_RECEIVE_BATCH];
+    iovec vectors[MAX_RECEIVE_BATCH];
+    //the ancillary data holding the kernel-timestamps and drop-counters
+    char controls[MAX_RECEIVE_BATCH][CONTROL_BUFFER_SIZE];
+    for(unsigned int i = 0; i < batchSize; ++i)
+    {
+        packages[i] = Package{};
+        vectors[i].iov_base = buffers[i];
+        vectors[i].iov_len = bufferSize;
+        messages[i].msg_hdr = msghdr{};
+        messages[i].msg_hdr.msg_name = &(packages[i].address.ipv6);
+        messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in6);
+        messages[i].msg_hdr.msg_iov = &vectors[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+        messages[i].msg_hdr.msg_control = controls[i];
+        messages[i].msg_hdr.msg_controllen = sizeof(controls[i]);
+    }
+    //blocks (until the receive-timeout) for the first package only, then takes all packages already queued
+    const int numReceived = recvmmsg(this->Socket, messages, batchSize, MSG_WAITFORONE, nullptr);
+    if(numReceived <= 0)
+    {
+        packages[0].status = INVALID_SOCKET;
+        if(hasTimedOut() || errno == INTERRUPTED_BY_SYSTEM_CALL)
+        {
+            //we have timed-out (or were interrupted by some other system call), so notify caller and return
+            packages[0].status = RECEIVE_TIMEOUT;
+        }
+        else
+        {
+            std::wcerr << this->getLastError();
+        }
+        return 1;
+    }
+    const std::chrono::system_clock::time_point systemNow = std::chrono::system_clock::now();
+    const std::chrono::steady_clock::time_point steadyNow = std::chrono::steady_clock::now();
+    for(int i = 0; i < numReceived; ++i)
+    {
+        packages[i].status = messages[i].msg_len;
+        packages[i].address.isIPv6 = messages[i].msg_hdr.msg_namelen == sizeof(sockaddr_in6);
+        packages[i].receptionTime = getReceptionTime(messages[i].msg_hdr, systemNow, steadyNow);
+    }
+    //the counter is only attached to packages queued after a drop, the last package reports the latest value
+    readDroppedPackages(messages[numReceived - 1].msg_hdr);
+    return numReceived;
+#endif
 }
 
 void UDPWrapper::closeNetwork()
@@ -152,6 +324,90 @@ void UDPWrapper::closeNetwork()
     }
 }
 
+int UDPWrapper::getSocketDescriptor() const
+{
+    return Socket;
+}
+
+bool UDPWrapper::setSocketOptions(const SocketOptions& options)
+{
+    bool success = true;
+    if(options.receiveBufferSize > 0)
+    {
+        success &= setSocketOption(SOL_SOCKET, SO_RCVBUF, options.receiveBufferSize, "receive-buffer size");
+#ifdef SO_RCVBUFFORCE
+        //the kernel doubles the value set (for its book-keeping), but caps it at net.core.rmem_max, which only privileged processes may exceed
+        int bufferSize = 0;
+        socklen_t length = sizeof(bufferSize);
+        if(getsockopt(Socket, SOL_SOCKET, SO_RCVBUF, (char*) &bufferSize, &length) == 0 && bufferSize / 2 < options.receiveBufferSize)
+        {
+            setsockopt(Socket, SOL_SOCKET, SO_RCVBUFFORCE, (char*) &options.receiveBufferSize, sizeof(int));
+            length = sizeof(bufferSize);
+            if(getsockopt(Socket, SOL_SOCKET, SO_RCVBUF, (char*) &bufferSize, &length) == 0 && bufferSize / 2 < options.receiveBufferSize)
+            {
+                ohmcomm::warn("UDP") << "Receive-buffer size limited to " << bufferSize / 2 << " bytes by the system (net.core.rmem_max)" << ohmcomm::endl;
+            }
+        }
+#endif
+    }
+    if(options.sendBufferSize > 0)
+    {
+        success &= setSocketOption(SOL_SOCKET, SO_SNDBUF, options.sendBufferSize, "send-buffer size");
+    }
+    if(options.dscp >= 0)
+    {
+        //the DSCP are the upper 6 bits of the TOS (IPv4) or traffic-class (IPv6), the lower 2 bits are left to ECN
+        const int trafficClass = (options.dscp & 0x3F) << 2;
+        if(remoteAddress.isIPv6)
+        {
+#ifdef IPV6_TCLASS
+            success &= setSocketOption(IPPROTO_IPV6, IPV6_TCLASS, trafficClass, "IPv6 traffic-class");
+#else
+            ohmcomm::warn("UDP") << "Setting the IPv6 traffic-class is not supported" << ohmcomm::endl;
+            success = false;
+#endif
+        }
+        else
+        {
+            success &= setSocketOption(IPPROTO_IP, IP_TOS, trafficClass, "IPv4 TOS");
+        }
+    }
+    if(options.priority >= 0)
+    {
+#ifdef SO_PRIORITY
+        success &= setSocketOption(SOL_SOCKET, SO_PRIORITY, options.priority, "socket priority");
+#else
+        ohmcomm::warn("UDP") << "Setting the socket priority is not supported" << ohmcomm::endl;
+        success = false;
+#endif
+    }
+    if(options.busyPollMicroseconds > 0)
+    {
+#ifdef SO_BUSY_POLL
+        success &= setSocketOption(SOL_SOCKET, SO_BUSY_POLL, options.busyPollMicroseconds, "busy-polling");
+#else
+        ohmcomm::warn("UDP") << "Busy-polling is not supported" << ohmcomm::endl;
+        success = false;
+#endif
+    }
+    return success;
+}
+
+uint32_t UDPWrapper::getNumberOfDroppedPackages() const
+{
+    return droppedPackages;
+}
+
+bool UDPWrapper::setSocketOption(const int level, const int option, const int value, const char* description)
+{
+    if(setsockopt(Socket, level, option, (char*) &value, sizeof(int)) < 0)
+    {
+        ohmcomm::warn("UDP") << "Failed to set " << description << ": " << getLastError() << ohmcomm::endl;
+        return false;
+    }
+    return true;
+}
+
 int UDPWrapper::getSocketAddressLength()
 {
     if(remoteAddress.isIPv6)
@@ -0,0 +1,176 @@
+/*
+ * File:   AudioMixer.cpp
+ */
+
+#include <algorithm>
+#include <limits>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "configuration.h"
+#include "processors/AudioMixer.h"
+
+using namespace ohmcomm;
+
+AudioMixer::AudioMixer() : audioFormatFlag(0), sampleSize(0), integerMix(), floatMix(), numSamples(0), numStreams(0)
+{
+}
+
+bool AudioMixer::configure(const unsigned int audioFormatFlag, const unsigned int maxBufferSize)
+{
+    this->audioFormatFlag = 0;
+    integerMix.clear();
+    floatMix.clear();
+    switch(audioFormatFlag)
+    {
+        case AudioConfiguration::AUDIO_FORMAT_SINT16:
+            sampleSize = sizeof(int16_t);
+            integerMix.assign(maxBufferSize / sampleSize, 0);
+            break;
+        case AudioConfiguration::AUDIO_FORMAT_FLOAT32:
+            sampleSize = sizeof(float);
+            floatMix.assign(maxBufferSize / sampleSize, 0.0f);
+            break;
+        default:
+            return false;
+    }
+    this->audioFormatFlag = audioFormatFlag;
+    startMix();
+    return true;
+}
+
+bool AudioMixer::isConfigured() const
+{
+    return audioFormatFlag != 0;
+}
+
+void AudioMixer::startMix()
+{
+    numSamples = 0;
+    numStreams = 0;
+}
+
+void AudioMixer::addStream(const void* buffer, const unsigned int bufferSize)
+{
+    if(audioFormatFlag == AudioConfiguration::AUDIO_FORMAT_SINT16)
+    {
+        addSamples((const int16_t*)buffer, std::min(bufferSize / sampleSize, (unsigned int)integerMix.size()));
+    }
+    else
+    {
+        addSamples((const float*)buffer, std::min(bufferSize / sampleSize, (unsigned int)floatMix.size()));
+    }
+    ++numStreams;
+}
+
+unsigned int AudioMixer::getNumberOfStreams() const
+{
+    return numStreams;
+}
+
+unsigned int AudioMixer::writeMix(void* outputBuffer, const unsigned int maxBufferSize) const
+{
+    if(audioFormatFlag == 0)
+    {
+        return 0;
+    }
+    const unsigned int count = std::min(numSamples, maxBufferSize / sampleSize);
+    if(audioFormatFlag == AudioConfiguration::AUDIO_FORMAT_SINT16)
+    {
+        writeSamples((int16_t*)outputBuffer, count);
+    }
+    else
+    {
+        writeSamples((float*)outputBuffer, count);
+    }
+    return count * sampleSize;
+}
+
+void AudioMixer::addSamples(const int16_t* samples, const unsigned int count)
+{
+    //the first stream (or a longer stream) initializes the accumulator, so it never needs to be cleared
+    const unsigned int numAdded = std::min(count, numSamples);
+    int32_t* mix = integerMix.data();
+    unsigned int i = 0;
+#ifdef __SSE2__
+    for(; i + 8 <= numAdded; i += 8)
+    {
+        const __m128i values = _mm_loadu_si128((const __m128i*)(samples + i));
+        //sign-extend to 32 bit by shifting the duplicated 16 bit values
+        const __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(values, values), 16);
+        const __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(values, values), 16);
+        _mm_storeu_si128((__m128i*)(mix + i), _mm_add_epi32(_mm_loadu_si128((const __m128i*)(mix + i)), low));
+        _mm_storeu_si128((__m128i*)(mix + i + 4), _mm_add_epi32(_mm_loadu_si128((const __m128i*)(mix + i + 4)), high));
+    }
+#endif
+    for(; i < numAdded; ++i)
+    {
+        mix[i] += samples[i];
+    }
+    for(; i < count; ++i)
+    {
+        mix[i] = samples[i];
+    }
+    numSamples = std::max(numSamples, count);
+}
+
+void AudioMixer::addSamples(const float* samples, const unsigned int count)
+{
+    const unsigned int numAdded = std::min(count, numSamples);
+    float* mix = floatMix.data();
+    unsigned int i = 0;
+#ifdef __SSE2__
+    for(; i + 4 <= numAdded; i += 4)
+    {
+        _mm_storeu_ps(mix + i, _mm_add_ps(_mm_loadu_ps(mix + i), _mm_loadu_ps(samples + i)));
+    }
+#endif
+    for(; i < numAdded; ++i)
+    {
+        mix[i] += samples[i];
+    }
+    for(; i < count; ++i)
+    {
+        mix[i] = samples[i];
+    }
+    numSamples = std::max(numSamples, count);
+}
+
+void AudioMixer::writeSamples(int16_t* samples, const unsigned int count) const
+{
+    const int32_t* mix = integerMix.data();
+    unsigned int i = 0;
+#ifdef __SSE2__
+    for(; i + 8 <= count; i += 8)
+    {
+        //packing into 16 bit saturates the sums
+        const __m128i low = _mm_loadu_si128((const __m128i*)(mix + i));
+        const __m128i high = _mm_loadu_si128((const __m128i*)(mix + i + 4));
+        _mm_storeu_si128((__m128i*)(samples + i), _mm_packs_epi32(low, high));
+    }
+#endif
+    for(; i < count; ++i)
+    {
+        samples[i] = (int16_t)std::max(std::min(mix[i], (int32_t)std::numeric_limits<int16_t>::max()), (int32_t)std::numeric_limits<int16_t>::min());
+    }
+}
+
+void AudioMixer::writeSamples(float* samples, const unsigned int count) const
+{
+    const float* mix = floatMix.data();
+    unsigned int i = 0;
+#ifdef __SSE2__
+    const __m128 maxValue = _mm_set1_ps(1.0f);
+    const __m128 minValue = _mm_set1_ps(-1.0f);
+    for(; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(samples + i, _mm_max_ps(_mm_min_ps(_mm_loadu_ps(mix + i), maxValue), minValue));
+    }
+#endif
+    for(; i < count; ++i)
+    {
+        samples[i] = std::max(std::min(mix[i], 1.0f), -1.0f);
+    }
+}
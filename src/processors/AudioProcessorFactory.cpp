@@ -16,6 +16,8 @@
 #include "codecs/ProcessoriLBC.h"
 #include "codecs/GSMCodec.h"
 #include "codecs/AMRCodec.h"
+#include "processors/PacketLossConcealment.h"
+#include "processors/ComfortNoiseGenerator.h"
 
 using namespace ohmcomm;
 
@@ -27,6 +29,8 @@ const std::string AudioProcessorFactory::GAIN_CONTROL = "Gain Control";
 const std::string AudioProcessorFactory::ILBC_CODEC = "iLBC-Codec";
 const std::string AudioProcessorFactory::GSM_CODEC = "GSM";
 const std::string AudioProcessorFactory::AMR_CODEC = "AMR-Codec";
+const std::string AudioProcessorFactory::LOSS_CONCEALMENT = "Loss Concealment";
+const std::string AudioProcessorFactory::COMFORT_NOISE = "Comfort Noise";
 
 AudioProcessor* AudioProcessorFactory::getAudioProcessor(const std::string name, bool createProfiler)
 {
@@ -73,6 +77,14 @@ AudioProcessor* AudioProcessorFactory::getAudioProcessor(const std::string name,
     if(name == AMR_CODEC)
         processor = new codecs::AMRCodec(AMR_CODEC);
     #endif
+    #ifdef PACKETLOSSCONCEALMENT_H
+    if(name == LOSS_CONCEALMENT)
+        processor = new PacketLossConcealment(LOSS_CONCEALMENT);
+    #endif
+    #ifdef COMFORTNOISEGENERATOR_H
+    if(name == COMFORT_NOISE)
+        processor = new ComfortNoiseGenerator(COMFORT_NOISE);
+    #endif
     if(processor != nullptr)
     {
         if(createProfiler)
@@ -111,6 +123,12 @@ const std::vector<std::string> AudioProcessorFactory::getAudioProcessorNames()
     #ifdef AMRCODEC_H
     processorNames.push_back(AMR_CODEC);
     #endif
+    #ifdef PACKETLOSSCONCEALMENT_H
+    processorNames.push_back(LOSS_CONCEALMENT);
+    #endif
+    #ifdef COMFORTNOISEGENERATOR_H
+    processorNames.push_back(COMFORT_NOISE);
+    #endif
     return processorNames;
 }
 
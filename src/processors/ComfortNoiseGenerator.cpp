@@ -0,0 +1,266 @@
+/*
+ * File:   ComfortNoiseGenerator.cpp
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "processors/ComfortNoiseGenerator.h"
+
+using namespace ohmcomm;
+
+static constexpr ProcessorCapabilities comfortNoiseCapabilities = {false, false, true, true, false, 0, 0};
+
+ComfortNoiseGenerator::ComfortNoiseGenerator(const std::string& name) : AudioProcessor(name, comfortNoiseCapabilities), numInputChannels(0), numOutputChannels(0),
+    analyzer(nullptr), synthesizer(nullptr), fullScale(1.0), currentParameters{}, currentParametersSize(0), predictorCoefficients{}, predictorOrder(0),
+    excitationGain(0.0), filterState{}, randomState(0x2545F491)
+{
+}
+
+template<>
+int16_t ComfortNoiseGenerator::clipSample<int16_t>(const double value)
+{
+    if(value >= std::numeric_limits<int16_t>::max())
+        return std::numeric_limits<int16_t>::max();
+    if(value <= std::numeric_limits<int16_t>::min())
+        return std::numeric_limits<int16_t>::min();
+    return (int16_t)std::lround(value);
+}
+
+template<>
+float ComfortNoiseGenerator::clipSample<float>(const double value)
+{
+    return (float)std::max(std::min(value, 1.0), -1.0);
+}
+
+unsigned int ComfortNoiseGenerator::getSupportedAudioFormats() const
+{
+    return AudioConfiguration::AUDIO_FORMAT_SINT16 | (sizeof(float) == 4 ? AudioConfiguration::AUDIO_FORMAT_FLOAT32 : 0);
+}
+
+unsigned int ComfortNoiseGenerator::getSupportedSampleRates() const
+{
+    return AudioConfiguration::SAMPLE_RATE_ALL;
+}
+
+const std::vector<int> ComfortNoiseGenerator::getSupportedBufferSizes(unsigned int sampleRate) const
+{
+    return {BUFFER_SIZE_ANY};
+}
+
+PayloadType ComfortNoiseGenerator::getSupportedPlayloadType() const
+{
+    return PayloadType::ALL;
+}
+
+void ComfortNoiseGenerator::configure(const AudioConfiguration& audioConfig, const std::shared_ptr<ConfigurationMode> configMode, const uint16_t bufferSize, const ProcessorCapabilities& chainCapabilities)
+{
+    switch(audioConfig.audioFormatFlag)
+    {
+        case AudioConfiguration::AUDIO_FORMAT_SINT16:
+            analyzer = &ComfortNoiseGenerator::analyze<int16_t>;
+            synthesizer = &ComfortNoiseGenerator::synthesize<int16_t>;
+            fullScale = -(double)std::numeric_limits<int16_t>::min();
+            break;
+        case AudioConfiguration::AUDIO_FORMAT_FLOAT32:
+            analyzer = &ComfortNoiseGenerator::analyze<float>;
+            synthesizer = &ComfortNoiseGenerator::synthesize<float>;
+            fullScale = 1.0;
+            break;
+        default:
+            throw ohmcomm::configuration_error("Comfort Noise", "Unsupported audio-format");
+    }
+    numInputChannels = audioConfig.inputDeviceChannels;
+    numOutputChannels = audioConfig.outputDeviceChannels;
+    currentParametersSize = 0;
+    excitationGain = 0.0;
+    std::fill(filterState, filterState + MODEL_ORDER, 0.0);
+}
+
+bool ComfortNoiseGenerator::cleanUp()
+{
+    return true;
+}
+
+unsigned int ComfortNoiseGenerator::processInputData(void* inputBuffer, const unsigned int inputBufferByteSize, StreamData* userData)
+{
+    if(userData->isSilentPackage)
+    {
+        //describe the background-noise, so the RTP-processor can send it instead of the audio
+        (this->*analyzer)(inputBuffer, inputBufferByteSize, userData);
+    }
+    return inputBufferByteSize;
+}
+
+unsigned int ComfortNoiseGenerator::processOutputData(void* outputBuffer, const unsigned int outputBufferByteSize, StreamData* userData)
+{
+    if(userData->comfortNoiseSize == 0)
+    {
+        return outputBufferByteSize;
+    }
+    updateParameters(userData->comfortNoise, userData->comfortNoiseSize);
+    //the decoder only received a dummy package, so we fill the whole output-buffer
+    userData->isSilentPackage = false;
+    return (this->*synthesizer)(outputBuffer, userData->nBufferFrames, userData->maxBufferSize);
+}
+
+unsigned int ComfortNoiseGenerator::encodeParameters(const double level, const double* reflectionCoefficients, const unsigned int order, uint8_t* payload)
+{
+    //the noise-level is transmitted in -dBov with 7 bits, the highest bit is reserved
+    payload[0] = (uint8_t)std::max(std::min(std::lround(level), (long)MIN_NOISE_LEVEL), 0L);
+    for(unsigned int i = 0; i < order; ++i)
+    {
+        //the reflection-coefficients are linearly quantized with 8 bits
+        payload[i + 1] = (uint8_t)std::max(std::min(std::lround(reflectionCoefficients[i] * 127) + 127, 254L), 0L);
+    }
+    return order + 1;
+}
+
+unsigned int ComfortNoiseGenerator::decodeParameters(const uint8_t* payload, const unsigned int payloadSize, double& level, double* reflectionCoefficients)
+{
+    if(payloadSize == 0)
+    {
+        level = MIN_NOISE_LEVEL;
+        return 0;
+    }
+    level = payload[0] & 0x7F;
+    const unsigned int order = std::min(payloadSize - 1, MODEL_ORDER);
+    for(unsigned int i = 0; i < order; ++i)
+    {
+        //restrict the coefficients to keep the synthesis-filter stable
+        reflectionCoefficients[i] = std::max(std::min((payload[i + 1] - 127) / 127.0, 0.99), -0.99);
+    }
+    return order;
+}
+
+template<typename AudioFormat>
+void ComfortNoiseGenerator::analyze(const void* buffer, const unsigned int bufferSize, StreamData* userData)
+{
+    const AudioFormat* samples = (const AudioFormat*) buffer;
+    const unsigned int numFrames = bufferSize / (sizeof(AudioFormat) * numInputChannels);
+    const unsigned int order = std::min(MODEL_ORDER, numFrames > 0 ? numFrames - 1 : 0);
+    //auto-correlation of the down-mixed signal, normalized to full-scale
+    const double scale = 1.0 / (fullScale * numInputChannels);
+    double autoCorrelation[MODEL_ORDER + 1] = {0};
+    for(unsigned int f = 0; f < numFrames; ++f)
+    {
+        double sample = 0.0;
+        for(unsigned int c = 0; c < numInputChannels; ++c)
+        {
+            sample += samples[f * numInputChannels + c];
+        }
+        sample *= scale;
+        for(unsigned int lag = 0; lag <= order && lag <= f; ++lag)
+        {
+            double previous = 0.0;
+            for(unsigned int c = 0; c < numInputChannels; ++c)
+            {
+                previous += samples[(f - lag) * numInputChannels + c];
+            }
+            autoCorrelation[lag] += sample * previous * scale;
+        }
+    }
+    if(numFrames == 0 || autoCorrelation[0] <= 0.0)
+    {
+        //absolute silence
+        userData->comfortNoise[0] = MIN_NOISE_LEVEL;
+        userData->comfortNoiseSize = 1;
+        return;
+    }
+    const double level = -10 * std::log10(autoCorrelation[0] / numFrames);
+
+    //Levinson-Durbin recursion, the reflection-coefficients of the predictor describe the spectral envelope
+    //add a small noise-floor to keep the recursion stable for ill-conditioned signals
+    autoCorrelation[0] *= 1.0001;
+    double coefficients[MODEL_ORDER] = {0};
+    double previousCoefficients[MODEL_ORDER] = {0};
+    double reflectionCoefficients[MODEL_ORDER] = {0};
+    double error = autoCorrelation[0];
+    for(unsigned int i = 0; i < order; ++i)
+    {
+        double accumulator = autoCorrelation[i + 1];
+        for(unsigned int j = 0; j < i; ++j)
+        {
+            accumulator += coefficients[j] * autoCorrelation[i - j];
+        }
+        const double k = -accumulator / error;
+        std::copy(coefficients, coefficients + i, previousCoefficients);
+        for(unsigned int j = 0; j < i; ++j)
+        {
+            coefficients[j] = previousCoefficients[j] + k * previousCoefficients[i - 1 - j];
+        }
+        coefficients[i] = k;
+        reflectionCoefficients[i] = k;
+        error *= (1.0 - k * k);
+    }
+    userData->comfortNoiseSize = encodeParameters(level, reflectionCoefficients, order, userData->comfortNoise);
+}
+
+template<typename AudioFormat>
+unsigned int ComfortNoiseGenerator::synthesize(void* buffer, const unsigned int numFrames, const unsigned int maxBufferSize)
+{
+    AudioFormat* samples = (AudioFormat*) buffer;
+    const unsigned int numSynthesizedFrames = std::min(numFrames, maxBufferSize / (unsigned int)(sizeof(AudioFormat) * numOutputChannels));
+    for(unsigned int f = 0; f < numSynthesizedFrames; ++f)
+    {
+        //all-pole filter shaping the white noise with the spectral envelope
+        double sample = excitationGain * nextRandom();
+        for(unsigned int j = 0; j < predictorOrder; ++j)
+        {
+            sample -= predictorCoefficients[j] * filterState[j];
+        }
+        for(unsigned int j = predictorOrder; j > 1; --j)
+        {
+            filterState[j - 1] = filterState[j - 2];
+        }
+        filterState[0] = sample;
+        const AudioFormat outputSample = clipSample<AudioFormat>(sample);
+        for(unsigned int c = 0; c < numOutputChannels; ++c)
+        {
+            samples[f * numOutputChannels + c] = outputSample;
+        }
+    }
+    return numSynthesizedFrames * numOutputChannels * sizeof(AudioFormat);
+}
+
+void ComfortNoiseGenerator::updateParameters(const uint8_t* payload, const unsigned int payloadSize)
+{
+    if(payloadSize == currentParametersSize && std::memcmp(payload, currentParameters, payloadSize) == 0)
+    {
+        //keep the filter running
+        return;
+    }
+    currentParametersSize = std::min(payloadSize, StreamData::MAX_COMFORT_NOISE_SIZE);
+    std::memcpy(currentParameters, payload, currentParametersSize);
+
+    double level;
+    double reflectionCoefficients[MODEL_ORDER];
+    predictorOrder = decodeParameters(payload, currentParametersSize, level, reflectionCoefficients);
+    //convert the reflection-coefficients to the direct-form filter-coefficients
+    double previousCoefficients[MODEL_ORDER];
+    double residualEnergy = 1.0;
+    for(unsigned int i = 0; i < predictorOrder; ++i)
+    {
+        const double k = reflectionCoefficients[i];
+        std::copy(predictorCoefficients, predictorCoefficients + i, previousCoefficients);
+        for(unsigned int j = 0; j < i; ++j)
+        {
+            predictorCoefficients[j] = previousCoefficients[j] + k * previousCoefficients[i - 1 - j];
+        }
+        predictorCoefficients[i] = k;
+        residualEnergy *= (1.0 - k * k);
+    }
+    //scale the excitation so the filtered noise has the requested level, uniform noise in [-1, 1] has a variance of 1/3
+    excitationGain = level >= MIN_NOISE_LEVEL ? 0.0 : fullScale * std::pow(10.0, -level / 20) * std::sqrt(3.0 * residualEnergy);
+}
+
+double ComfortNoiseGenerator::nextRandom()
+{
+    //xorshift, fast and good enough for noise
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState / (double)UINT32_MAX * 2.0 - 1.0;
+}
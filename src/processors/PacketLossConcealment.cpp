@@ -0,0 +1,271 @@
+/*
+ * File:   PacketLossConcealment.cpp
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "processors/PacketLossConcealment.h"
+
+using namespace ohmcomm;
+
+static constexpr ProcessorCapabilities concealmentCapabilities = {false, false, true, false, false, 0, 0};
+
+PacketLossConcealment::PacketLossConcealment(const std::string& name) : AudioProcessor(name, concealmentCapabilities), numChannels(0), processor(nullptr),
+    minPeriod(0), maxPeriod(0), decimation(1), fadeStartFrames(0), fadeEndFrames(0), history(), historyFrames(0), historyFill(0), pitchSearchBuffer(),
+    pitchBuffer(), pitchPeriod(0), pitchPosition(0), concealedFrames(0), crossFadeBuffer()
+{
+}
+
+template<>
+int16_t PacketLossConcealment::toSample<int16_t>(const float value)
+{
+    if(value >= std::numeric_limits<int16_t>::max())
+        return std::numeric_limits<int16_t>::max();
+    if(value <= std::numeric_limits<int16_t>::min())
+        return std::numeric_limits<int16_t>::min();
+    return (int16_t)std::lround(value);
+}
+
+template<>
+float PacketLossConcealment::toSample<float>(const float value)
+{
+    return value;
+}
+
+unsigned int PacketLossConcealment::getSupportedAudioFormats() const
+{
+    return AudioConfiguration::AUDIO_FORMAT_SINT16 | (sizeof(float) == 4 ? AudioConfiguration::AUDIO_FORMAT_FLOAT32 : 0);
+}
+
+unsigned int PacketLossConcealment::getSupportedSampleRates() const
+{
+    return AudioConfiguration::SAMPLE_RATE_ALL;
+}
+
+const std::vector<int> PacketLossConcealment::getSupportedBufferSizes(unsigned int sampleRate) const
+{
+    return {BUFFER_SIZE_ANY};
+}
+
+PayloadType PacketLossConcealment::getSupportedPlayloadType() const
+{
+    return PayloadType::ALL;
+}
+
+void PacketLossConcealment::configure(const AudioConfiguration& audioConfig, const std::shared_ptr<ConfigurationMode> configMode, const uint16_t bufferSize, const ProcessorCapabilities& chainCapabilities)
+{
+    switch(audioConfig.audioFormatFlag)
+    {
+        case AudioConfiguration::AUDIO_FORMAT_SINT16:
+            processor = &PacketLossConcealment::process<int16_t>;
+            break;
+        case AudioConfiguration::AUDIO_FORMAT_FLOAT32:
+            processor = &PacketLossConcealment::process<float>;
+            break;
+        default:
+            throw ohmcomm::configuration_error("Loss Concealment", "Unsupported audio-format");
+    }
+    numChannels = audioConfig.outputDeviceChannels;
+    minPeriod = std::max(audioConfig.sampleRate / MAX_PITCH, 1u);
+    maxPeriod = std::max(audioConfig.sampleRate / MIN_PITCH, minPeriod);
+    decimation = std::max(audioConfig.sampleRate / PITCH_SEARCH_RATE, 1u);
+    fadeStartFrames = audioConfig.sampleRate * FADE_START / 1000;
+    fadeEndFrames = audioConfig.sampleRate * FADE_END / 1000;
+
+    //we need one window of the maximum period to correlate and one maximum period to correlate with
+    historyFrames = 2 * maxPeriod;
+    historyFill = 0;
+    //allocate all buffers here, so no memory is allocated in the audio-thread
+    history.assign(historyFrames * numChannels, 0.0f);
+    pitchSearchBuffer.assign(historyFrames, 0.0f);
+    pitchBuffer.assign(maxPeriod * numChannels, 0.0f);
+    crossFadeBuffer.assign((maxPeriod / 4 + 1) * numChannels, 0.0f);
+    pitchPeriod = 0;
+    pitchPosition = 0;
+    concealedFrames = 0;
+}
+
+bool PacketLossConcealment::cleanUp()
+{
+    historyFill = 0;
+    concealedFrames = 0;
+    return true;
+}
+
+unsigned int PacketLossConcealment::processInputData(void* inputBuffer, const unsigned int inputBufferByteSize, StreamData* userData)
+{
+    //nothing to conceal on the sending side
+    return inputBufferByteSize;
+}
+
+unsigned int PacketLossConcealment::processOutputData(void* outputBuffer, const unsigned int outputBufferByteSize, StreamData* userData)
+{
+    (this->*processor)(outputBuffer, outputBufferByteSize, userData);
+    return outputBufferByteSize;
+}
+
+template<typename AudioFormat>
+void PacketLossConcealment::process(void* buffer, const unsigned int bufferSize, StreamData* userData)
+{
+    AudioFormat* samples = (AudioFormat*) buffer;
+    const unsigned int numFrames = bufferSize / (sizeof(AudioFormat) * numChannels);
+    if(userData->isSilentPackage)
+    {
+        //the package was lost (or the buffer is empty), continue the previous audio
+        if(concealedFrames == 0)
+        {
+            startConcealment();
+        }
+        const bool isAudible = pitchPeriod != 0 && concealedFrames < fadeEndFrames;
+        extrapolate(samples, numFrames);
+        userData->isSilentPackage = !isAudible;
+    }
+    else if(concealedFrames > 0)
+    {
+        //first package after a loss, fade from the extrapolated into the real audio
+        const unsigned int overlap = pitchPeriod == 0 ? 0 : std::min(numFrames, std::max(pitchPeriod / 4, 1u));
+        extrapolate(crossFadeBuffer.data(), overlap);
+        for(unsigned int f = 0; f < overlap; ++f)
+        {
+            const float weight = (f + 1) / (float)(overlap + 1);
+            for(unsigned int c = 0; c < numChannels; ++c)
+            {
+                const unsigned int i = f * numChannels + c;
+                samples[i] = toSample<AudioFormat>(weight * samples[i] + (1.0f - weight) * crossFadeBuffer[i]);
+            }
+        }
+        concealedFrames = 0;
+    }
+    appendHistory(samples, numFrames);
+}
+
+void PacketLossConcealment::startConcealment()
+{
+    pitchPeriod = 0;
+    pitchPosition = 0;
+    if(historyFill < historyFrames)
+    {
+        //not enough audio played yet, conceal with silence
+        return;
+    }
+    //search the pitch on the down-mixed signal
+    for(unsigned int f = 0; f < historyFrames; ++f)
+    {
+        float sum = 0.0f;
+        for(unsigned int c = 0; c < numChannels; ++c)
+        {
+            sum += history[f * numChannels + c];
+        }
+        pitchSearchBuffer[f] = sum;
+    }
+    //coarse search, only every decimation-th sample and lag
+    float bestCorrelation = -2.0f;
+    unsigned int bestLag = minPeriod;
+    for(unsigned int lag = minPeriod; lag <= maxPeriod; lag += decimation)
+    {
+        const float correlation = correlate(pitchSearchBuffer.data(), historyFrames, maxPeriod, lag, decimation);
+        if(correlation > bestCorrelation)
+        {
+            bestCorrelation = correlation;
+            bestLag = lag;
+        }
+    }
+    //refine around the best coarse lag with the full sample-rate
+    if(decimation > 1)
+    {
+        const unsigned int fromLag = std::max(bestLag - std::min(bestLag, decimation - 1), minPeriod);
+        const unsigned int toLag = std::min(bestLag + decimation - 1, maxPeriod);
+        bestCorrelation = -2.0f;
+        for(unsigned int lag = fromLag; lag <= toLag; ++lag)
+        {
+            const float correlation = correlate(pitchSearchBuffer.data(), historyFrames, maxPeriod, lag, 1);
+            if(correlation > bestCorrelation)
+            {
+                bestCorrelation = correlation;
+                bestLag = lag;
+            }
+        }
+    }
+    pitchPeriod = bestLag;
+
+    //copy the last period and blend its end with the samples one period earlier,
+    //so the transition from the end of the pitch-buffer back to its start matches the original signal
+    const float* lastPeriod = history.data() + (historyFrames - pitchPeriod) * numChannels;
+    std::memcpy(pitchBuffer.data(), lastPeriod, pitchPeriod * numChannels * sizeof(float));
+    const unsigned int overlap = std::max(pitchPeriod / 4, 1u);
+    const float* previousPeriod = lastPeriod - pitchPeriod * numChannels;
+    for(unsigned int f = pitchPeriod - overlap; f < pitchPeriod; ++f)
+    {
+        const float weight = (f - (pitchPeriod - overlap) + 1) / (float)(overlap + 1);
+        for(unsigned int c = 0; c < numChannels; ++c)
+        {
+            const unsigned int i = f * numChannels + c;
+            pitchBuffer[i] = (1.0f - weight) * pitchBuffer[i] + weight * previousPeriod[i];
+        }
+    }
+}
+
+template<typename AudioFormat>
+void PacketLossConcealment::extrapolate(AudioFormat* output, const unsigned int numFrames)
+{
+    if(pitchPeriod == 0)
+    {
+        std::memset(output, 0, numFrames * numChannels * sizeof(AudioFormat));
+        concealedFrames = std::min(concealedFrames + numFrames, fadeEndFrames + 1);
+        return;
+    }
+    for(unsigned int f = 0; f < numFrames; ++f)
+    {
+        float gain = 1.0f;
+        if(concealedFrames >= fadeEndFrames)
+            gain = 0.0f;
+        else if(concealedFrames > fadeStartFrames)
+            gain = (fadeEndFrames - concealedFrames) / (float)(fadeEndFrames - fadeStartFrames);
+        for(unsigned int c = 0; c < numChannels; ++c)
+        {
+            output[f * numChannels + c] = toSample<AudioFormat>(gain * pitchBuffer[pitchPosition * numChannels + c]);
+        }
+        pitchPosition = (pitchPosition + 1) % pitchPeriod;
+        //stop counting once silenced, so long losses can't overflow the counter
+        if(concealedFrames <= fadeEndFrames)
+            ++concealedFrames;
+    }
+}
+
+template<typename AudioFormat>
+void PacketLossConcealment::appendHistory(const AudioFormat* samples, const unsigned int numFrames)
+{
+    if(numFrames >= historyFrames)
+    {
+        samples += (numFrames - historyFrames) * numChannels;
+        std::copy(samples, samples + historyFrames * numChannels, history.begin());
+    }
+    else
+    {
+        const unsigned int numKept = (historyFrames - numFrames) * numChannels;
+        std::memmove(history.data(), history.data() + numFrames * numChannels, numKept * sizeof(float));
+        std::copy(samples, samples + numFrames * numChannels, history.begin() + numKept);
+    }
+    historyFill = std::min(historyFill + numFrames, historyFrames);
+}
+
+float PacketLossConcealment::correlate(const float* signal, const unsigned int signalLength, const unsigned int length, const unsigned int lag, const unsigned int step)
+{
+    float crossProduct = 0.0f;
+    float energy = 0.0f;
+    float lagEnergy = 0.0f;
+    for(unsigned int i = signalLength - length; i < signalLength; i += step)
+    {
+        crossProduct += signal[i] * signal[i - lag];
+        energy += signal[i] * signal[i];
+        lagEnergy += signal[i - lag] * signal[i - lag];
+    }
+    if(energy <= 0.0f || lagEnergy <= 0.0f)
+    {
+        return 0.0f;
+    }
+    return crossProduct / std::sqrt(energy * lagEnergy);
+}
@@ -5,14 +5,21 @@
  * Created on February 22, 2016, 11:17 AM
  */
 
+#include <cstring>
+
 #include "Logger.h"
 #include "processors/ProcessorManager.h"
+#include "processors/AudioProcessorFactory.h"
 #include "processors/ProfilingAudioProcessor.h"
 #include "processors/Resampler.h"
 
 using namespace ohmcomm;
 
-ProcessorManager::ProcessorManager() : audioProcessors(), processorsSampleRate(0)
+constexpr unsigned int ProcessorManager::MAX_MIXED_STREAMS;
+constexpr unsigned int ProcessorManager::MAX_CONCEALED_CYCLES;
+
+ProcessorManager::ProcessorManager() : audioProcessors(), numStreamProcessors(0), streamProcessors(), streamDecoders(), mixer(), streamBuffer(),
+    outputCycle(0), processorsSampleRate(0)
 {
 
 }
@@ -27,6 +34,8 @@ void ProcessorManager::printAudioProcessorOrder(std::ostream& OutputStream) cons
 bool ProcessorManager::addProcessor(AudioProcessor *audioProcessor)
 {
     if (hasAudioProcessor(audioProcessor) == false) {
+        //the stream-decoders need to be re-configured for the new chain
+        clearStreamDecoders();
         audioProcessors.push_back(std::unique_ptr<AudioProcessor>(audioProcessor));
         if (ProfilingAudioProcessor * profiler = dynamic_cast<ProfilingAudioProcessor*> (audioProcessor)) {
             //if this is a profiling processor, we need to add it to statistics to be printed on exit
@@ -41,6 +50,7 @@ bool ProcessorManager::removeAudioProcessor(AudioProcessor *audioProcessor)
 {
     for (size_t i = 0; i < audioProcessors.size(); i++) {
         if ((audioProcessors.at(i))->getName() == audioProcessor->getName()) {
+            clearStreamDecoders();
             audioProcessors.erase(audioProcessors.begin() + i);
             if (ProfilingAudioProcessor * profiler = dynamic_cast<ProfilingAudioProcessor*> (audioProcessor)) {
                 Statistics::removeProfiler(profiler);
@@ -58,6 +68,7 @@ bool ProcessorManager::removeAudioProcessor(std::string nameOfAudioProcessor)
             if (ProfilingAudioProcessor * profiler = dynamic_cast<ProfilingAudioProcessor*> (audioProcessors.at(i).get())) {
                 Statistics::removeProfiler(profiler);
             }
+            clearStreamDecoders();
             audioProcessors.erase(audioProcessors.begin() + i);
             return true; // Successful removed
         }
@@ -67,6 +78,7 @@ bool ProcessorManager::removeAudioProcessor(std::string nameOfAudioProcessor)
 
 bool ProcessorManager::clearAudioProcessors()
 {
+    clearStreamDecoders();
     audioProcessors.clear();
     Statistics::removeAllProfilers();
     return true;
@@ -74,8 +86,22 @@ bool ProcessorManager::clearAudioProcessors()
 
 unsigned int ProcessorManager::processAudioOutput(void *outputBuffer, const unsigned int &outputBufferByteSize, StreamData *streamData)
 {
-    unsigned int bufferSize = outputBufferByteSize;
-    for (unsigned int i = audioProcessors.size(); i > 0; i--) {
+    if (audioProcessors.empty()) {
+        return outputBufferByteSize;
+    }
+    ++outputCycle;
+    streamData->numStreams = 1;
+    streamData->streamIndex = 0;
+    streamData->streamId = 0;
+    //the last processor reads the first stream and tells us, how many streams there are
+    unsigned int bufferSize = audioProcessors.back()->processOutputData(outputBuffer, outputBufferByteSize, streamData);
+    if (streamData->numStreams > 1 && mixer.isConfigured()) {
+        bufferSize = mixStreams(outputBuffer, bufferSize, streamData);
+    } else {
+        bufferSize = decodeStream(outputBuffer, bufferSize, streamData);
+    }
+    //the processors decoding the streams are already run
+    for (unsigned int i = audioProcessors.size() - 1 - numStreamProcessors; i > 0; i--) {
         bufferSize = audioProcessors.at(i - 1)->processOutputData(outputBuffer, bufferSize, streamData);
     }
     return bufferSize;
@@ -112,6 +138,16 @@ bool ProcessorManager::configureAudioProcessors(const AudioConfiguration& audioC
             return false;
         }
     }
+    try
+    {
+        configureStreamDecoders(tmpConfig, configMode, bufferSize, combinedCaps);
+    }
+    catch(const ohmcomm::configuration_error& error)
+    {
+        ohmcomm::error("Processors") << "Configuration of the stream-decoders failed!" << ohmcomm::endl;
+        ohmcomm::error("Processors") << error.what() << ohmcomm::endl;
+        return false;
+    }
     return true;
 }
 
@@ -120,6 +156,9 @@ void ProcessorManager::startupAudioProcessors()
     for (const auto& processor : audioProcessors) {
         processor->startup();
     }
+    for (const auto& processor : streamProcessors) {
+        processor->startup();
+    }
 }
 
 bool ProcessorManager::cleanUpAudioProcessors()
@@ -129,6 +168,10 @@ bool ProcessorManager::cleanUpAudioProcessors()
         if (result == false) // Cleanup failed
             return false;
     }
+    for (const auto& processor : streamProcessors) {
+        if (processor->cleanUp() == false)
+            return false;
+    }
     return true;
 }
 
@@ -319,6 +362,153 @@ const ProcessorCapabilities ProcessorManager::getCombinedCapabilities()
     return caps;
 }
 
+void ProcessorManager::configureStreamDecoders(const AudioConfiguration& audioConfiguration, const std::shared_ptr<ConfigurationMode> configMode,
+                                               const uint16_t bufferSize, const ProcessorCapabilities& chainCapabilities)
+{
+    clearStreamDecoders();
+    if (audioProcessors.empty() || !mixer.configure(audioConfiguration.audioFormatFlag, bufferSize)) {
+        //only the first stream is played
+        return;
+    }
+    //the (last) codec and all processors between it and the last processor need to be run for every stream separately
+    unsigned int firstStreamProcessor = audioProcessors.size() - 1;
+    for (unsigned int i = 0; i < audioProcessors.size() - 1; i++) {
+        if (audioProcessors.at(i)->getCapabilities().isCodec)
+            firstStreamProcessor = i;
+    }
+    streamBuffer.resize(bufferSize);
+    if (firstStreamProcessor == audioProcessors.size() - 1) {
+        //the streams are not encoded, so they can be mixed directly
+        return;
+    }
+    streamDecoders.resize(MAX_MIXED_STREAMS);
+    for (unsigned int d = 0; d < streamDecoders.size(); d++) {
+        StreamDecoder& decoder = streamDecoders[d];
+        decoder.streamId = 0;
+        decoder.lastUsed = 0;
+        decoder.lastActive = 0;
+        for (unsigned int i = firstStreamProcessor; i < audioProcessors.size() - 1; i++) {
+            if (d == 0) {
+                //the first decoder uses the processors of the chain, so playing a single stream behaves as before
+                decoder.processors.push_back(audioProcessors.at(i).get());
+                continue;
+            }
+            AudioProcessor* processor = nullptr;
+            try
+            {
+                processor = AudioProcessorFactory::getAudioProcessor(audioProcessors.at(i)->getName(), false);
+            }
+            catch(const std::invalid_argument& error)
+            {
+                ohmcomm::warn("Processors") << "Can't create another instance of '" << audioProcessors.at(i)->getName() << "', mixing disabled!" << ohmcomm::endl;
+                clearStreamDecoders();
+                return;
+            }
+            streamProcessors.push_back(std::unique_ptr<AudioProcessor>(processor));
+            processor->configure(audioConfiguration, configMode, bufferSize, chainCapabilities);
+            decoder.processors.push_back(processor);
+        }
+    }
+    numStreamProcessors = audioProcessors.size() - 1 - firstStreamProcessor;
+    ohmcomm::info("Processors") << "Decoding up to " << MAX_MIXED_STREAMS << " streams separately for mixing" << ohmcomm::endl;
+}
+
+void ProcessorManager::clearStreamDecoders()
+{
+    numStreamProcessors = 0;
+    streamDecoders.clear();
+    streamProcessors.clear();
+    streamBuffer.clear();
+    mixer.configure(0, 0);
+}
+
+unsigned int ProcessorManager::decodeStream(void* buffer, unsigned int bufferSize, StreamData* streamData)
+{
+    if (streamDecoders.empty()) {
+        return bufferSize;
+    }
+    //keep the decoder for the stream or reassign the least recently used one
+    StreamDecoder* decoder = findDecoder(streamData->streamId);
+    if (decoder == nullptr) {
+        decoder = &streamDecoders.front();
+        for (StreamDecoder& d : streamDecoders) {
+            if (d.lastUsed < decoder->lastUsed)
+                decoder = &d;
+        }
+        decoder->streamId = streamData->streamId;
+        decoder->lastActive = 0;
+    }
+    decoder->lastUsed = outputCycle;
+    if (!streamData->isSilentPackage) {
+        decoder->lastActive = outputCycle;
+    }
+    for (unsigned int i = decoder->processors.size(); i > 0; i--) {
+        bufferSize = decoder->processors[i - 1]->processOutputData(buffer, bufferSize, streamData);
+    }
+    return bufferSize;
+}
+
+ProcessorManager::StreamDecoder* ProcessorManager::findDecoder(const uint32_t streamId)
+{
+    for (StreamDecoder& d : streamDecoders) {
+        if (d.lastUsed != 0 && d.streamId == streamId) {
+            return &d;
+        }
+    }
+    return nullptr;
+}
+
+bool ProcessorManager::isConcealingStream(const uint32_t streamId)
+{
+    const StreamDecoder* decoder = findDecoder(streamId);
+    return decoder != nullptr && decoder->lastActive != 0 && outputCycle - decoder->lastActive <= MAX_CONCEALED_CYCLES;
+}
+
+unsigned int ProcessorManager::mixStreams(void* outputBuffer, unsigned int bufferSize, StreamData* streamData)
+{
+    AudioProcessor* source = audioProcessors.back().get();
+    const unsigned int numStreams = streamData->numStreams;
+    const unsigned int maxBufferSize = streamData->maxBufferSize;
+    //keep the state of the first stream, to play it as usual if no stream provides any audio-data
+    const unsigned int firstStreamSize = bufferSize;
+    const uint32_t firstStreamId = streamData->streamId;
+    uint8_t firstComfortNoise[StreamData::MAX_COMFORT_NOISE_SIZE];
+    const uint8_t firstComfortNoiseSize = streamData->comfortNoiseSize;
+    std::memcpy(firstComfortNoise, streamData->comfortNoise, firstComfortNoiseSize);
+
+    mixer.startMix();
+    for (unsigned int index = 0; index < numStreams; index++) {
+        void* buffer = outputBuffer;
+        if (index > 0) {
+            //the first stream is already read into the output-buffer
+            buffer = streamBuffer.data();
+            streamData->streamIndex = index;
+            streamData->isSilentPackage = false;
+            streamData->comfortNoiseSize = 0;
+            streamData->maxBufferSize = std::min(maxBufferSize, (unsigned int)streamBuffer.size());
+            bufferSize = source->processOutputData(buffer, streamData->maxBufferSize, streamData);
+        }
+        if (streamData->isSilentPackage && !isConcealingStream(streamData->streamId)) {
+            //skip streams which are underflowing or silent for a while, the codec conceals the losses of the streams recently active
+            continue;
+        }
+        mixer.addStream(buffer, decodeStream(buffer, bufferSize, streamData));
+    }
+    streamData->streamIndex = 0;
+    streamData->maxBufferSize = maxBufferSize;
+    if (mixer.getNumberOfStreams() == 0) {
+        //nobody is talking, play the first stream as if it was the only one, e.g. to conceal the loss or play comfort-noise
+        streamData->streamId = firstStreamId;
+        streamData->isSilentPackage = true;
+        streamData->comfortNoiseSize = firstComfortNoiseSize;
+        std::memcpy(streamData->comfortNoise, firstComfortNoise, firstComfortNoiseSize);
+        return decodeStream(outputBuffer, firstStreamSize, streamData);
+    }
+    streamData->isSilentPackage = false;
+    streamData->comfortNoiseSize = 0;
+    return mixer.writeMix(outputBuffer, maxBufferSize);
+}
+
 unsigned int ProcessorManager::autoSelectAudioFormat(unsigned int supportedFormats)
 {
     if ((supportedFormats & AudioConfiguration::AUDIO_FORMAT_FLOAT64) == AudioConfiguration::AUDIO_FORMAT_FLOAT64) {
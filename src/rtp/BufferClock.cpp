@@ -0,0 +1,14 @@
+/*
+ * File:   BufferClock.cpp
+ */
+
+#include "rtp/BufferClock.h"
+
+using namespace ohmcomm::rtp;
+
+BufferClock::TimeSource BufferClock::timeSource = &std::chrono::steady_clock::now;
+
+void BufferClock::setTimeSource(TimeSource source)
+{
+    timeSource = source != nullptr ? source : &std::chrono::steady_clock::now;
+}
@@ -5,39 +5,195 @@
  * Created on February 25, 2016, 2:00 PM
  */
 
+#include "Logger.h"
 #include "rtp/JitterBuffers.h"
 #include "rtp/RTPBuffer.h"
+#include "rtp/RTPBufferLockFree.h"
 
 using namespace ohmcomm::rtp;
 
-JitterBuffers::JitterBuffers(const uint16_t maxCapacity, const uint16_t maxDelay, const uint16_t minBufferPackage) :
-    maximumCapacity(maxCapacity), maximumDelay(maxDelay), minBufferPackages(minBufferPackage)
+constexpr uint16_t JitterBuffers::DEFAULT_MAX_STREAMS;
+constexpr std::chrono::seconds JitterBuffers::IDLE_TIMEOUT;
+constexpr std::chrono::seconds JitterBuffers::RELEASE_GRACE_PERIOD;
+
+static uint32_t calculateDirectorySize(const uint16_t maxStreams)
+{
+    //keep the load-factor of the directory below 0.5
+    uint32_t size = 1;
+    while(size < 2u * maxStreams)
+    {
+        size <<= 1;
+    }
+    return size;
+}
+
+JitterBuffers::JitterBuffers(const uint16_t maxCapacity, const uint16_t maxDelay, const uint16_t minBufferPackage, const JitterBufferType bufferType,
+                             const unsigned int maxPayloadSize, const uint16_t maxStreams, const PlayoutAdaptionSettings& adaptionSettings) :
+    maxStreams(maxStreams), directorySize(calculateDirectorySize(maxStreams)), pool(new PoolEntry[maxStreams]),
+    directory(new std::atomic<uint64_t>[directorySize]), lastIdleCheck(std::chrono::steady_clock::now().time_since_epoch().count())
+{
+    for(uint16_t i = 0; i < maxStreams; ++i)
+    {
+        //the SSRC is set when assigning the buffer
+        if(bufferType == JitterBufferType::LOCK_FREE)
+            pool[i].buffer.reset(new RTPBufferLockFree(0, maxCapacity, maxDelay, minBufferPackage, maxPayloadSize, adaptionSettings));
+        else
+            pool[i].buffer.reset(new RTPBuffer(0, maxCapacity, maxDelay, minBufferPackage, maxPayloadSize, adaptionSettings));
+        pool[i].releaseTime = std::chrono::steady_clock::time_point::min();
+    }
+    for(uint32_t i = 0; i < directorySize; ++i)
+    {
+        directory[i].store(ENTRY_EMPTY);
+    }
+}
+
+RTPBufferHandler* JitterBuffers::getBuffer(const uint32_t ssrc)
 {
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    uint64_t value;
+    if(findDirectoryPosition(ssrc, value) == directorySize)
+    {
+        //SSRC not yet known, assign a new buffer
+        std::lock_guard<std::mutex> guard(mutex);
+        //the buffer could have been assigned while we were waiting for the lock
+        if(findDirectoryPosition(ssrc, value) == directorySize)
+        {
+            uint16_t index = 0;
+            while(index < maxStreams && (pool[index].inUse || pool[index].releaseTime + RELEASE_GRACE_PERIOD > now))
+            {
+                ++index;
+            }
+            if(index == maxStreams)
+            {
+                ohmcomm::warn("RTP") << "No free jitter-buffer for SSRC " << ssrc << ohmcomm::endl;
+                return nullptr;
+            }
+            //find first free position, removed positions can be reused, since the SSRC is not in the directory
+            uint32_t position = getStartPosition(ssrc, directorySize);
+            while(directory[position].load(std::memory_order_relaxed) != ENTRY_EMPTY && directory[position].load(std::memory_order_relaxed) != ENTRY_REMOVED)
+            {
+                position = (position + 1) & (directorySize - 1);
+            }
+            PoolEntry& entry = pool[index];
+            entry.buffer->reset(ssrc);
+            entry.ssrc = ssrc;
+            entry.inUse = true;
+            entry.lastActivity.store(now.time_since_epoch().count(), std::memory_order_relaxed);
+            //publish the buffer to the look-ups
+            value = ((uint64_t)(index + 1) << 32) | ssrc;
+            directory[position].store(value, std::memory_order_release);
+        }
+    }
+    PoolEntry& entry = pool[getPoolIndex(value)];
+    entry.lastActivity.store(now.time_since_epoch().count(), std::memory_order_relaxed);
+    return entry.buffer.get();
+}
 
+RTPBufferHandler* JitterBuffers::findBuffer(const uint32_t ssrc) const
+{
+    uint64_t value;
+    if(findDirectoryPosition(ssrc, value) == directorySize)
+    {
+        return nullptr;
+    }
+    return pool[getPoolIndex(value)].buffer.get();
 }
 
-const std::unique_ptr<RTPBufferHandler>& JitterBuffers::getBuffer(const uint32_t ssrc)
+unsigned int JitterBuffers::getActiveSSRCs(uint32_t* ssrcs, const unsigned int maxSSRCs) const
 {
-    //needs to by locked due to direct access by 2 threads
-    mutex.lock();
-    if(buffers.find(ssrc) == buffers.end())
+    unsigned int numSSRCs = 0;
+    for(uint32_t position = 0; position < directorySize && numSSRCs < maxSSRCs; ++position)
     {
-        buffers.insert(std::pair<uint32_t, std::unique_ptr<RTPBufferHandler>>(ssrc, std::unique_ptr<RTPBufferHandler>(new RTPBuffer(ssrc, maximumCapacity, maximumDelay, minBufferPackages))));
+        const uint64_t value = directory[position].load(std::memory_order_acquire);
+        if(value != ENTRY_EMPTY && value != ENTRY_REMOVED)
+        {
+            ssrcs[numSSRCs] = (uint32_t)value;
+            ++numSSRCs;
+        }
     }
-    mutex.unlock();
-    return buffers.at(ssrc);
+    return numSSRCs;
 }
 
 void JitterBuffers::removeBuffer(const uint32_t ssrc)
 {
-    mutex.lock();
-    buffers.erase(ssrc);
-    mutex.unlock();
+    std::lock_guard<std::mutex> guard(mutex);
+    uint64_t value;
+    const uint32_t position = findDirectoryPosition(ssrc, value);
+    if(position != directorySize)
+    {
+        releaseEntry(position, std::chrono::steady_clock::now());
+    }
+}
+
+void JitterBuffers::removeIdleBuffers()
+{
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::rep lastCheck = lastIdleCheck.load(std::memory_order_relaxed);
+    if(std::chrono::steady_clock::duration(now.time_since_epoch().count() - lastCheck) < std::chrono::seconds(1) ||
+        !lastIdleCheck.compare_exchange_strong(lastCheck, now.time_since_epoch().count()))
+    {
+        //checked recently (or concurrently)
+        return;
+    }
+    std::lock_guard<std::mutex> guard(mutex);
+    for(uint16_t i = 0; i < maxStreams; ++i)
+    {
+        if(pool[i].inUse && std::chrono::steady_clock::duration(now.time_since_epoch().count() - pool[i].lastActivity.load(std::memory_order_relaxed)) > IDLE_TIMEOUT)
+        {
+            ohmcomm::info("RTP") << "Releasing jitter-buffer of idle SSRC " << pool[i].ssrc << ohmcomm::endl;
+            uint64_t value;
+            releaseEntry(findDirectoryPosition(pool[i].ssrc, value), now);
+        }
+    }
 }
 
 void JitterBuffers::cleanup()
 {
-    mutex.lock();
-    buffers.clear();
-    mutex.unlock();
+    std::lock_guard<std::mutex> guard(mutex);
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    for(uint32_t position = 0; position < directorySize; ++position)
+    {
+        const uint64_t value = directory[position].load(std::memory_order_relaxed);
+        if(value != ENTRY_EMPTY && value != ENTRY_REMOVED)
+        {
+            releaseEntry(position, now);
+        }
+    }
+}
+
+uint32_t JitterBuffers::findDirectoryPosition(const uint32_t ssrc, uint64_t& value) const
+{
+    uint32_t position = getStartPosition(ssrc, directorySize);
+    for(uint32_t i = 0; i < directorySize; ++i)
+    {
+        value = directory[position].load(std::memory_order_acquire);
+        if(value == ENTRY_EMPTY)
+        {
+            //end of the probing sequence
+            return directorySize;
+        }
+        if(value != ENTRY_REMOVED && (uint32_t)value == ssrc)
+        {
+            return position;
+        }
+        position = (position + 1) & (directorySize - 1);
+    }
+    return directorySize;
+}
+
+void JitterBuffers::releaseEntry(const uint32_t position, const std::chrono::steady_clock::time_point now)
+{
+    PoolEntry& entry = pool[getPoolIndex(directory[position].load(std::memory_order_relaxed))];
+    directory[position].store(ENTRY_REMOVED, std::memory_order_release);
+    //removed entries at the end of a probing sequence are not needed to continue probing, so they are emptied again.
+    //Otherwise, the removed entries would accumulate with every SSRC ever seen and look-ups of unknown SSRCs would probe the whole directory
+    uint32_t current = position;
+    while(directory[current].load(std::memory_order_relaxed) == ENTRY_REMOVED &&
+          directory[(current + 1) & (directorySize - 1)].load(std::memory_order_relaxed) == ENTRY_EMPTY)
+    {
+        directory[current].store(ENTRY_EMPTY, std::memory_order_release);
+        current = (current - 1) & (directorySize - 1);
+    }
+    entry.inUse = false;
+    entry.releaseTime = now;
 }
@@ -0,0 +1,133 @@
+/*
+ * File:   MediaWorkerPool.cpp
+ */
+
+#include <algorithm>
+#include <thread>
+
+#include "Logger.h"
+#include "rtp/MediaWorkerPool.h"
+
+#ifdef __linux__
+#include <errno.h>
+#include <string.h>     //strerror
+#include <linux/filter.h>
+#endif
+
+using namespace ohmcomm::rtp;
+
+MediaWorkerPool::MediaWorkerPool(const unsigned short localPort, const unsigned int numWorkers, const bool isIPv6, const unsigned int maxPayloadSize) :
+    workers()
+{
+    workers.reserve(numWorkers);
+    for(unsigned int i = 0; i < std::max(numWorkers, 1u); ++i)
+    {
+        Worker worker;
+        worker.loop.reset(new ohmcomm::network::EventLoop());
+        worker.loop->startUp();
+        //the order of binding the sockets determines their index for the steering-program
+        worker.socket.reset(new SharedMediaSocket(localPort, isIPv6, maxPayloadSize, true, worker.loop.get()));
+        const bool isFirstWorker = workers.empty();
+        workers.push_back(std::move(worker));
+        if(isFirstWorker && numWorkers > 1 && !attachSteeringProgram(workers[0].socket->wrapper->getSocketDescriptor(), isIPv6, numWorkers))
+        {
+            ohmcomm::warn("RTP") << "Packages can't be steered to the workers, using a single worker!" << ohmcomm::endl;
+            break;
+        }
+    }
+    ohmcomm::info("RTP") << "Started " << workers.size() << " media-workers on port " << localPort << ohmcomm::endl;
+}
+
+MediaWorkerPool::~MediaWorkerPool()
+{
+    for(Worker& worker : workers)
+    {
+        //the sockets may be kept open by their sessions, but must not be watched by the loop anymore
+        worker.socket->stopReceiving();
+        worker.loop->shutdown();
+    }
+}
+
+unsigned int MediaWorkerPool::getDefaultNumberOfWorkers()
+{
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+unsigned int MediaWorkerPool::getNumberOfWorkers() const
+{
+    return workers.size();
+}
+
+unsigned int MediaWorkerPool::getWorkerIndex(const unsigned short remotePort) const
+{
+    //must match the steering-program
+    return remotePort % workers.size();
+}
+
+std::shared_ptr<SharedMediaSocket::Session> MediaWorkerPool::openSession(const std::string& remoteIPAddress, const unsigned short remotePort)
+{
+    return workers[getWorkerIndex(remotePort)].socket->openSession(remoteIPAddress, remotePort);
+}
+
+std::shared_ptr<SharedMediaSocket> MediaWorkerPool::getSocket(const unsigned int workerIndex) const
+{
+    return workers.at(workerIndex).socket;
+}
+
+ohmcomm::network::EventLoop& MediaWorkerPool::getEventLoop(const unsigned int workerIndex)
+{
+    return *workers.at(workerIndex).loop;
+}
+
+unsigned int MediaWorkerPool::getNumberOfSessions() const
+{
+    unsigned int numSessions = 0;
+    for(const Worker& worker : workers)
+    {
+        numSessions += worker.socket->getNumberOfSessions();
+    }
+    return numSessions;
+}
+
+bool MediaWorkerPool::setSocketOptions(const SocketOptions& options)
+{
+    bool success = true;
+    for(const Worker& worker : workers)
+    {
+        success &= worker.socket->setSocketOptions(options);
+    }
+    return success;
+}
+
+bool MediaWorkerPool::attachSteeringProgram(const int socket, const bool isIPv6, const unsigned int numWorkers)
+{
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_CBPF)
+    //the program is run with the UDP-payload as data, so the source-port is loaded relative to the IP-header (SKF_NET_OFF).
+    //Returns the index of the socket (in the order of binding), the source-port modulo the number of workers
+    sock_filter ipv4Code[] = {
+        //X = length of the IPv4-header
+        BPF_STMT(BPF_LDX | BPF_B | BPF_MSH, (uint32_t)SKF_NET_OFF),
+        //A = UDP source-port
+        BPF_STMT(BPF_LD | BPF_H | BPF_IND, (uint32_t)SKF_NET_OFF),
+        BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, numWorkers),
+        BPF_STMT(BPF_RET | BPF_A, 0)
+    };
+    sock_filter ipv6Code[] = {
+        //the fixed IPv6-header, extension-headers are not supported
+        BPF_STMT(BPF_LD | BPF_H | BPF_ABS, (uint32_t)SKF_NET_OFF + 40),
+        BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, numWorkers),
+        BPF_STMT(BPF_RET | BPF_A, 0)
+    };
+    sock_fprog program{};
+    program.filter = isIPv6 ? ipv6Code : ipv4Code;
+    program.len = isIPv6 ? sizeof(ipv6Code) / sizeof(sock_filter) : sizeof(ipv4Code) / sizeof(sock_filter);
+    if(setsockopt(socket, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program, sizeof(program)) < 0)
+    {
+        ohmcomm::error("RTP") << "Failed to attach steering-program: " << strerror(errno) << ohmcomm::endl;
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
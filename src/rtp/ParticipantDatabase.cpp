@@ -33,6 +33,7 @@ std::mutex ParticipantDatabase::databaseMutex;
 Participant ParticipantDatabase::localParticipant = initLocalParticipant();
 std::map<uint32_t, Participant> ParticipantDatabase::participants{};
 std::vector<std::reference_wrapper<ParticipantListener>> ParticipantDatabase::listeners{};
+std::atomic<uint32_t> ParticipantDatabase::numRemovals{0};
 
 Participant ParticipantDatabase::initLocalParticipant()
 {
@@ -41,12 +42,22 @@ Participant ParticipantDatabase::initLocalParticipant()
 
 bool ParticipantDatabase::removeParticipant(const uint32_t ssrc)
 {
-    std::lock_guard<std::mutex> guard(databaseMutex);
-    if (participants.erase(ssrc) > 0) {
-        fireRemoveRemote(ssrc);
-        return true;
+    {
+        std::lock_guard<std::mutex> guard(databaseMutex);
+        if (participants.erase(ssrc) == 0) {
+            return false;
+        }
+        ++numRemovals;
     }
-    return false;
+    fireRemoveRemote(ssrc);
+    return true;
+}
+
+Participant* ParticipantDatabase::find(const uint32_t ssrc)
+{
+    std::lock_guard<std::mutex> guard(databaseMutex);
+    const auto it = participants.find(ssrc);
+    return it != participants.end() ? &it->second : nullptr;
 }
 
 void ParticipantDatabase::registerListener(ParticipantListener& listener)
@@ -92,3 +103,48 @@ void ParticipantDatabase::fireConnectedRemote(const uint32_t ssrc, const std::st
         l.onRemoteConnected(ssrc, address, port);
     }
 }
+
+ParticipantCache::ParticipantCache() : participants(), numRemovals(ParticipantDatabase::numRemovals)
+{
+}
+
+Participant& ParticipantCache::remote(const uint32_t ssrc)
+{
+    validate();
+    const auto it = participants.find(ssrc);
+    if(it != participants.end())
+    {
+        return *it->second;
+    }
+    Participant& participant = ParticipantDatabase::remote(ssrc);
+    participants.emplace(ssrc, &participant);
+    return participant;
+}
+
+Participant* ParticipantCache::find(const uint32_t ssrc)
+{
+    validate();
+    const auto it = participants.find(ssrc);
+    if(it != participants.end())
+    {
+        return it->second;
+    }
+    Participant* participant = ParticipantDatabase::find(ssrc);
+    if(participant != nullptr)
+    {
+        participants.emplace(ssrc, participant);
+    }
+    return participant;
+}
+
+void ParticipantCache::validate()
+{
+    //only read on every access, the counter is only written when a participant is removed
+    const uint32_t currentRemovals = ParticipantDatabase::numRemovals;
+    if(currentRemovals != numRemovals)
+    {
+        //the pointers of the removed participants are dangling
+        participants.clear();
+        numRemovals = currentRemovals;
+    }
+}
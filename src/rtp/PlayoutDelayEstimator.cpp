@@ -0,0 +1,97 @@
+/*
+ * File:   PlayoutDelayEstimator.cpp
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "rtp/PlayoutDelayEstimator.h"
+
+using namespace ohmcomm::rtp;
+
+constexpr unsigned int PlayoutDelayEstimator::BIN_WIDTH;
+constexpr unsigned int PlayoutDelayEstimator::NUM_BINS;
+constexpr double PlayoutDelayEstimator::FORGETTING_FACTOR;
+constexpr unsigned int PlayoutDelayEstimator::MIN_DELAY_WINDOW;
+constexpr unsigned int PlayoutDelayEstimator::MIN_PACKAGES;
+
+PlayoutDelayEstimator::PlayoutDelayEstimator(const double lateLossQuantile) : lateLossQuantile(lateLossQuantile)
+{
+    reset();
+}
+
+void PlayoutDelayEstimator::addPackage(const uint16_t sequenceNumber, const uint32_t rtpTimestamp, const std::chrono::steady_clock::time_point receptionTime)
+{
+    const uint32_t receptionMillis = std::chrono::duration_cast<std::chrono::milliseconds>(receptionTime.time_since_epoch()).count();
+    //both values are in milliseconds, so their difference is the transit time plus a constant offset
+    const int32_t relativeDelay = (int32_t)(receptionMillis - rtpTimestamp);
+
+    //estimate the duration of a package from successive packages
+    if(numPackages > 0 && sequenceNumber == (uint16_t)(lastSequenceNumber + 1) && (int32_t)(rtpTimestamp - lastTimestamp) > 0)
+    {
+        const double duration = (int32_t)(rtpTimestamp - lastTimestamp);
+        packageDuration = packageDuration == 0 ? duration : 0.9 * packageDuration + 0.1 * duration;
+    }
+    lastSequenceNumber = sequenceNumber;
+    lastTimestamp = rtpTimestamp;
+
+    relativeDelays[numPackages % MIN_DELAY_WINDOW] = relativeDelay;
+    ++numPackages;
+    //the delay of this package relative to the fastest recent package
+    const int32_t minDelay = *std::min_element(relativeDelays.begin(), relativeDelays.begin() + std::min(numPackages, MIN_DELAY_WINDOW));
+    const unsigned int bin = std::min((unsigned int)(relativeDelay - minDelay) / BIN_WIDTH, NUM_BINS - 1);
+
+    //weigh down the previous delays and add the new one
+    for(double& weight : histogram)
+    {
+        weight *= FORGETTING_FACTOR;
+    }
+    histogram[bin] += 1.0;
+    totalWeight = totalWeight * FORGETTING_FACTOR + 1.0;
+
+    //find the smallest delay covering the requested quantile of packages
+    const double requiredWeight = lateLossQuantile * totalWeight;
+    double cumulativeWeight = 0;
+    unsigned int targetBin = 0;
+    while(targetBin < NUM_BINS - 1)
+    {
+        cumulativeWeight += histogram[targetBin];
+        if(cumulativeWeight >= requiredWeight)
+        {
+            break;
+        }
+        ++targetBin;
+    }
+    targetDelay = (targetBin + 1) * BIN_WIDTH;
+}
+
+bool PlayoutDelayEstimator::hasEstimation() const
+{
+    return numPackages >= MIN_PACKAGES && packageDuration > 0;
+}
+
+uint32_t PlayoutDelayEstimator::getTargetDelay() const
+{
+    return targetDelay;
+}
+
+uint16_t PlayoutDelayEstimator::getTargetDelayPackages() const
+{
+    if(packageDuration <= 0)
+    {
+        return 0;
+    }
+    return (uint16_t)std::ceil(targetDelay / packageDuration);
+}
+
+void PlayoutDelayEstimator::reset()
+{
+    histogram.fill(0);
+    totalWeight = 0;
+    relativeDelays.fill(0);
+    numPackages = 0;
+    lastSequenceNumber = 0;
+    lastTimestamp = 0;
+    packageDuration = 0;
+    targetDelay = 0;
+}
@@ -1,20 +1,48 @@
+#include <algorithm>
+
 #include "Logger.h"
 #include "rtp/ProcessorRTP.h"
 #include "Statistics.h"
 #include "Parameters.h"
 #include "network/UDPWrapper.h"
+#include "network/IOUringUDPWrapper.h"
+#include "network/MulticastNetworkWrapper.h"
 #include "rtp/RTPBuffer.h"
 
 using namespace ohmcomm::rtp;
 
 ProcessorRTP::ProcessorRTP(const std::string name, const ohmcomm::NetworkConfiguration& networkConfig, const ohmcomm::PayloadType payloadType) : 
-    AudioProcessor(name), network(new ohmcomm::network::UDPWrapper(networkConfig)), buffers(128, 200, 1), ourselves(ParticipantDatabase::self()), lastPackageWasSilent(false),
-        totalSilenceDelayPackages(0), currentSilenceDelayPackages(0)
-        //XXX make jitter-settings configurable (or at least use better values)
+    AudioProcessor(name), network(createNetworkWrapper(networkConfig)), sharedSession(), alwaysMultiplexRTCP(false), buffers(), ourselves(ParticipantDatabase::self()), lastPackageWasSilent(false),
+        totalSilenceDelayPackages(0), currentSilenceDelayPackages(0), comfortNoiseIntervalPackages(0), packagesSinceComfortNoise(0), lastComfortNoiseLevel(0),
+        lastPayloadSize(0), activeStreams{}, numActiveStreams(0)
+{
+    ourselves.payloadType = payloadType;
+}
+
+ProcessorRTP::ProcessorRTP(const std::string name, const ohmcomm::NetworkConfiguration& networkConfig, const ohmcomm::PayloadType payloadType, const std::shared_ptr<SharedMediaSocket> sharedSocket) :
+    AudioProcessor(name), network(sharedSocket->openSession(networkConfig.remoteIPAddress, networkConfig.remotePort)),
+        sharedSession(std::static_pointer_cast<SharedMediaSocket::Session>(network)), alwaysMultiplexRTCP(true), buffers(), ourselves(ParticipantDatabase::self()),
+        lastPackageWasSilent(false), totalSilenceDelayPackages(0), currentSilenceDelayPackages(0), comfortNoiseIntervalPackages(0), packagesSinceComfortNoise(0),
+        lastComfortNoiseLevel(0), lastPayloadSize(0), activeStreams{}, numActiveStreams(0)
 {
     ourselves.payloadType = payloadType;
 }
 
+ProcessorRTP::ProcessorRTP(const std::string name, const std::shared_ptr<ohmcomm::network::NetworkWrapper> network, const ohmcomm::PayloadType payloadType, Participant& ourselves) :
+    AudioProcessor(name), network(network), sharedSession(), alwaysMultiplexRTCP(true), buffers(), ourselves(ourselves), lastPackageWasSilent(false),
+        totalSilenceDelayPackages(0), currentSilenceDelayPackages(0), comfortNoiseIntervalPackages(0), packagesSinceComfortNoise(0), lastComfortNoiseLevel(0),
+        lastPayloadSize(0), activeStreams{}, numActiveStreams(0)
+{
+    ourselves.payloadType = payloadType;
+}
+
+ProcessorRTP::~ProcessorRTP()
+{
+    //the session may outlive this processor, so stop writing into our buffers
+    if(sharedSession)
+        sharedSession->closeNetwork();
+}
+
 void ProcessorRTP::configure(const ohmcomm::AudioConfiguration& audioConfig, const std::shared_ptr<ohmcomm::ConfigurationMode> configMode, const uint16_t bufferSize, const ohmcomm::ProcessorCapabilities& chainCapabilities)
 {
     //check whether to enable DTX at all
@@ -28,16 +56,85 @@ void ProcessorRTP::configure(const ohmcomm::AudioConfiguration& audioConfig, con
             //calculate the number of packages to fill the specified delay
             const double timeOfPackage = audioConfig.framesPerPackage / (double)audioConfig.sampleRate;
             totalSilenceDelayPackages = (SILENCE_DELAY /1000.0) / timeOfPackage;
+            comfortNoiseIntervalPackages = (COMFORT_NOISE_INTERVAL / 1000.0) / timeOfPackage;
+        }
+    }
+    const uint16_t bufferCapacity = getJitterBufferSetting(configMode, Parameters::JITTER_BUFFER_CAPACITY, "Maximum number of packages in the jitter-buffer", DEFAULT_BUFFER_CAPACITY, 1);
+    const uint16_t bufferMaxDelay = getJitterBufferSetting(configMode, Parameters::JITTER_BUFFER_MAX_DELAY, "Maximum delay (in ms) of packages in the jitter-buffer", DEFAULT_BUFFER_MAX_DELAY, 1);
+    const uint16_t bufferMinPackages = getJitterBufferSetting(configMode, Parameters::JITTER_BUFFER_MIN_PACKAGES, "Initial number of packages to buffer", DEFAULT_BUFFER_MIN_PACKAGES, 0);
+    if(bufferMinPackages > bufferCapacity)
+    {
+        throw ohmcomm::configuration_error("RTP", "Initial number of packages to buffer exceeds jitter-buffer capacity");
+    }
+    ohmcomm::info("RTP") << "Using jitter-buffer for " << bufferCapacity << " packages, with a maximum delay of " << bufferMaxDelay << " ms" << ohmcomm::endl;
+    JitterBufferType bufferType = JitterBufferType::RTP_BUFFER;
+    if(configMode->isCustomConfigurationSet(Parameters::LOCK_FREE_BUFFER->longName, "Use lock-free jitter-buffer"))
+    {
+        ohmcomm::info("RTP") << "Using lock-free jitter-buffer" << ohmcomm::endl;
+        bufferType = JitterBufferType::LOCK_FREE;
+    }
+    PlayoutAdaptionSettings adaptionSettings;
+    if(configMode->isCustomConfigurationSet(Parameters::PLAYOUT_QUANTILE->longName, "Adapt playout delay to quantile of package delays"))
+    {
+        const int quantile = configMode->getCustomConfiguration(Parameters::PLAYOUT_QUANTILE->longName, "Percentage of packages to arrive in time", 97);
+        if(quantile <= 0 || quantile > 100)
+        {
+            throw ohmcomm::configuration_error("RTP", "Invalid playout quantile, must be a percentage");
+        }
+        ohmcomm::info("RTP") << "Adapting playout delay to the " << quantile << "% quantile of package delays" << ohmcomm::endl;
+        adaptionSettings = PlayoutAdaptionSettings(PlayoutAdaptionMode::DELAY_QUANTILE, quantile / 100.0);
+    }
+    buffers.reset(new JitterBuffers(bufferCapacity, bufferMaxDelay, bufferMinPackages, bufferType, bufferSize, JitterBuffers::DEFAULT_MAX_STREAMS, adaptionSettings));
+    const SocketOptions socketOptions = configMode->getSocketOptions();
+    if(sharedSession && !socketOptions.isDefault())
+    {
+        //the options would apply to all sessions, so they are set on the SharedMediaSocket
+        ohmcomm::warn("RTP") << "Socket options are ignored for a session of a shared socket" << ohmcomm::endl;
+    }
+    else if(!network->setSocketOptions(socketOptions))
+    {
+        ohmcomm::warn("RTP") << "Failed to apply all socket options" << ohmcomm::endl;
+    }
+    const bool isActiveSender = (audioConfig.playbackMode & PlaybackMode::INPUT) != 0;
+    if(sharedSession)
+    {
+        //the shared socket receives the packages for all of its sessions
+        rtcpHandler.reset(new RTCPHandler(network, configMode, isActiveSender, ourselves));
+        sharedSession->startReceiving(*buffers, rtcpHandler.get());
+    }
+    else
+    {
+        const NetworkConfiguration rtcpConfig = alwaysMultiplexRTCP ? NetworkConfiguration{} : configMode->getRTCPNetworkConfiguration();
+        const bool isRTCPMultiplexed = alwaysMultiplexRTCP || rtcpConfig.localPort == configMode->getNetworkConfiguration().localPort;
+        if(isRTCPMultiplexed)
+        {
+            ohmcomm::info("RTP") << "Multiplexing RTP and RTCP on the same port" << ohmcomm::endl;
+            rtcpHandler.reset(new RTCPHandler(network, configMode, isActiveSender, ourselves));
         }
+        else
+        {
+            rtcpHandler.reset(new RTCPHandler(rtcpConfig, configMode, isActiveSender));
+        }
+        rtpListener.reset(new RTPListener(network, *buffers, bufferSize, isRTCPMultiplexed ? rtcpHandler.get() : nullptr, ourselves.ssrc));
     }
-    rtpListener.reset(new RTPListener(network, buffers, bufferSize));
-    rtcpHandler.reset(new RTCPHandler(configMode->getRTCPNetworkConfiguration(), configMode, (audioConfig.playbackMode & PlaybackMode::INPUT) != 0));
+    //the packages sent can't be larger than the recorded audio-data
+    const unsigned int maxPayloadSize = audioConfig.framesPerPackage * std::max(audioConfig.inputDeviceChannels, audioConfig.outputDeviceChannels) *
+            getSampleSize(audioConfig.audioFormatFlag);
+    rtpSender.reset(new RTPSender(network, maxPayloadSize));
 }
 
 void ProcessorRTP::startup()
 {
-    rtpListener->startUp();
-    rtcpHandler->startUp();
+    //RTP and RTCP share a loop, since tearing down the session from a callback waits for the callbacks of all its sockets and timers
+    ohmcomm::network::EventLoop* loop = nullptr;
+    if(sharedSession)
+        loop = sharedSession->getEventLoop();
+    else if(ohmcomm::network::EventLoop::isSupported())
+        loop = &ohmcomm::network::EventLoop::getSharedLoop();
+    if(rtpListener)
+        rtpListener->startUp(loop);
+    rtpSender->startUp();
+    rtcpHandler->startUp(loop);
 }
 
 unsigned int ProcessorRTP::processInputData(void *inputBuffer, const unsigned int inputBufferByteSize, ohmcomm::StreamData *userData)
@@ -53,29 +150,28 @@ unsigned int ProcessorRTP::processInputData(void *inputBuffer, const unsigned in
         ++currentSilenceDelayPackages;
         if(currentSilenceDelayPackages > totalSilenceDelayPackages)
         {
+            if(userData->comfortNoiseSize > 0)
+            {
+                sendComfortNoise(userData, !lastPackageWasSilent);
+            }
+            else
+            {
+                ohmcomm::debug("RTP") << "Not sending silent package" << ohmcomm::endl;
+            }
             lastPackageWasSilent = true;
-            ohmcomm::debug("RTP") << "Not sending silent package" << ohmcomm::endl;
             return inputBufferByteSize;
         }
     }
-    const void* newRTPPackage = rtpPackage->createNewRTPPackage(inputBuffer, inputBufferByteSize);
+    //the payload is not copied into the RTP-package, but sent directly from the input-buffer
+    RTPHeader* newRTPHeader = rtpPackage->createNewRTPHeader(inputBufferByteSize);
     if(lastPackageWasSilent)
     {
         //set the marker bit after a silence period
-        ((RTPHeader*)newRTPPackage)->setMarker(true);
+        newRTPHeader->setMarker(true);
         lastPackageWasSilent = false;
         currentSilenceDelayPackages = 0;
     }
-    //only send the number of bytes really required: header + actual payload-size
-    this->network->sendData(newRTPPackage, rtpPackage->getRTPHeaderSize() + inputBufferByteSize);
-
-    ourselves.extendedHighestSequenceNumber += 1;
-    ourselves.totalPackages += 1;
-    ourselves.totalBytes += rtpPackage->getRTPHeaderSize() + inputBufferByteSize;
-    Statistics::incrementCounter(Statistics::COUNTER_FRAMES_SENT, userData->nBufferFrames);
-    Statistics::incrementCounter(Statistics::COUNTER_PACKAGES_SENT, 1);
-    Statistics::incrementCounter(Statistics::COUNTER_HEADER_BYTES_SENT, rtpPackage->getRTPHeaderSize());
-    Statistics::incrementCounter(Statistics::COUNTER_PAYLOAD_BYTES_SENT, inputBufferByteSize);
+    sendPackage(newRTPHeader, inputBuffer, inputBufferByteSize, userData->nBufferFrames);
 
     //no changes in buffer-size
     return inputBufferByteSize;
@@ -88,9 +184,41 @@ unsigned int ProcessorRTP::processOutputData(void *outputBuffer, const unsigned
     {
         initPackageHandler(userData->maxBufferSize);
     }
-    //read package from buffer
-    //XXX workaround to support one2one conversation with new code
-    auto result = buffers.getBuffer((*ParticipantDatabase::getAllRemoteParticipants().begin()).first)->readPackage(*rtpPackage);
+    if(userData->streamIndex == 0)
+    {
+        //the streams of all other remotes are read by successive calls with the following stream-indices
+        numActiveStreams = buffers->getActiveSSRCs(activeStreams, JitterBuffers::DEFAULT_MAX_STREAMS);
+        userData->numStreams = numActiveStreams;
+    }
+    //read package from the buffer of the requested remote
+    const bool isValidStream = userData->streamIndex < numActiveStreams;
+    userData->streamId = isValidStream ? activeStreams[userData->streamIndex] : 0;
+    RTPBufferHandler* buffer = isValidStream ? buffers->findBuffer(userData->streamId) : nullptr;
+    RTPBufferStatus result;
+    //the package is read in place from the jitter-buffer and only copied into the output-buffer
+    PackageLease lease;
+    if(buffer == nullptr)
+    {
+        //no package received yet
+        rtpPackage->createSilencePackage();
+        result = RTPBufferStatus::RTP_BUFFER_OUTPUT_UNDERFLOW;
+    }
+    else
+    {
+        result = buffer->leasePackage(lease);
+    }
+
+    if(lease.isValid() && lease.getHeader()->getPayloadType() == PayloadType::CN)
+    {
+        //the remote is in a silence period, the comfort-noise generator synthesizes the noise from the parameters
+        //and the decoder is passed a silent package of the usual size
+        userData->isSilentPackage = true;
+        userData->comfortNoiseSize = std::min(lease.getPayloadSize(), StreamData::MAX_COMFORT_NOISE_SIZE);
+        memcpy(userData->comfortNoise, lease.getPayload(), userData->comfortNoiseSize);
+        memset(outputBuffer, 0, lastPayloadSize);
+        return lastPayloadSize;
+    }
+    userData->comfortNoiseSize = 0;
 
     if (result == RTPBufferStatus::RTP_BUFFER_IS_PUFFERING)
     {
@@ -99,15 +227,18 @@ unsigned int ProcessorRTP::processOutputData(void *outputBuffer, const unsigned
     else if (result == RTPBufferStatus::RTP_BUFFER_OUTPUT_UNDERFLOW)
     {
         userData->isSilentPackage = true;
-        ohmcomm::warn("RTP") << "Output Buffer underflow" << ohmcomm::endl;
+        //while mixing, underflowing remotes are skipped
+        if(numActiveStreams <= 1)
+            ohmcomm::warn("RTP") << "Output Buffer underflow" << ohmcomm::endl;
     }
     else
     {
         userData->isSilentPackage = false;
+        lastPayloadSize = lease.getPayloadSize();
     }
 
-    const void* recvAudioData = rtpPackage->getRTPPackageData();
-    unsigned int receivedPayloadSize = rtpPackage->getActualPayloadSize();
+    const void* recvAudioData = lease.isValid() ? lease.getPayload() : rtpPackage->getRTPPackageData();
+    unsigned int receivedPayloadSize = lease.isValid() ? lease.getPayloadSize() : rtpPackage->getActualPayloadSize();
     memcpy(outputBuffer, recvAudioData, receivedPayloadSize);
 
     //set received payload size for all following processors to use
@@ -123,19 +254,114 @@ bool ProcessorRTP::cleanUp()
     }
     if(rtpListener)
         rtpListener->shutdown();
+    //sends the remaining packages before closing the network
+    if(rtpSender)
+        rtpSender->shutdown();
     if(rtcpHandler)
         rtcpHandler->shutdown();
     //close network anyway
     network->closeNetwork();
-    buffers.cleanup();
+    if(buffers)
+        buffers->cleanup();
     return true;
 }
 
+std::shared_ptr<ohmcomm::network::NetworkWrapper> ProcessorRTP::createNetworkWrapper(const ohmcomm::NetworkConfiguration& networkConfig)
+{
+    if(ohmcomm::network::SocketAddress::fromAddressAndPort(networkConfig.remoteIPAddress, networkConfig.remotePort).isMulticastAddress())
+    {
+        //send a single package to all members of the group instead of one per remote
+        std::shared_ptr<ohmcomm::network::MulticastNetworkWrapper> multicast(new ohmcomm::network::MulticastNetworkWrapper(networkConfig));
+        if(networkConfig.localPort != networkConfig.remotePort)
+        {
+            ohmcomm::warn("RTP") << "The local port should equal the port of the multicast-group to receive the packages of the other members!" << ohmcomm::endl;
+        }
+        multicast->joinGroup();
+        return multicast;
+    }
+#ifdef IO_URING_HEADER
+    return std::shared_ptr<ohmcomm::network::NetworkWrapper>(new ohmcomm::network::IOUringUDPWrapper(networkConfig));
+#else
+    return std::shared_ptr<ohmcomm::network::NetworkWrapper>(new ohmcomm::network::UDPWrapper(networkConfig));
+#endif
+}
+
+unsigned int ProcessorRTP::getSampleSize(const unsigned int audioFormatFlag)
+{
+    switch(audioFormatFlag)
+    {
+        case AudioConfiguration::AUDIO_FORMAT_SINT8:
+            return 1;
+        case AudioConfiguration::AUDIO_FORMAT_SINT16:
+            return 2;
+        case AudioConfiguration::AUDIO_FORMAT_SINT24:
+            return 3;
+        case AudioConfiguration::AUDIO_FORMAT_SINT32:
+        case AudioConfiguration::AUDIO_FORMAT_FLOAT32:
+            return 4;
+        default:
+            return 8;
+    }
+}
+
+uint16_t ProcessorRTP::getJitterBufferSetting(const std::shared_ptr<ohmcomm::ConfigurationMode> configMode, const ohmcomm::Parameter* param, const std::string& message,
+                                              const uint16_t defaultValue, const uint16_t minValue)
+{
+    if(!configMode->isCustomConfigurationSet(param->longName, message))
+    {
+        return defaultValue;
+    }
+    const int value = configMode->getCustomConfiguration(param->longName, message, (int)defaultValue);
+    if(value < minValue || value > UINT16_MAX)
+    {
+        throw ohmcomm::configuration_error("RTP", std::string("Invalid value for ") + param->longName);
+    }
+    return (uint16_t)value;
+}
+
+void ProcessorRTP::sendComfortNoise(const ohmcomm::StreamData* userData, const bool isSilenceStart)
+{
+    ++packagesSinceComfortNoise;
+    const uint8_t noiseLevel = userData->comfortNoise[0];
+    const uint8_t levelChange = noiseLevel > lastComfortNoiseLevel ? noiseLevel - lastComfortNoiseLevel : lastComfortNoiseLevel - noiseLevel;
+    if(!isSilenceStart && packagesSinceComfortNoise < comfortNoiseIntervalPackages && levelChange < COMFORT_NOISE_LEVEL_CHANGE)
+    {
+        ohmcomm::debug("RTP") << "Not sending silent package" << ohmcomm::endl;
+        return;
+    }
+    packagesSinceComfortNoise = 0;
+    lastComfortNoiseLevel = noiseLevel;
+    //comfort-noise packages share the sequence numbers and timestamps with the audio-packages, but have their own payload-type
+    RTPHeader* noiseHeader = rtpPackage->createNewRTPHeader(userData->comfortNoiseSize);
+    noiseHeader->setPayloadType(PayloadType::CN);
+    sendPackage(noiseHeader, userData->comfortNoise, userData->comfortNoiseSize, 0);
+}
+
+void ProcessorRTP::sendPackage(const RTPHeader* header, const void* payload, const unsigned int payloadSize, const unsigned int numFrames)
+{
+    const unsigned int headerSize = rtpPackage->getRTPHeaderSize();
+    //only send the number of bytes really required: header + actual payload-size
+    //the package is only copied here and sent by the sender-thread, so the audio-thread never blocks on the network
+    if(!rtpSender->enqueuePackage(header, headerSize, payload, payloadSize))
+    {
+        ohmcomm::warn("RTP") << "Send-queue full, dropping package" << ohmcomm::endl;
+        return;
+    }
+
+    ourselves.extendedHighestSequenceNumber += 1;
+    ourselves.totalPackages += 1;
+    ourselves.totalBytes += headerSize + payloadSize;
+    Statistics::incrementCounter(Statistics::COUNTER_FRAMES_SENT, numFrames);
+    Statistics::incrementCounter(Statistics::COUNTER_PACKAGES_SENT, 1);
+    Statistics::incrementCounter(Statistics::COUNTER_HEADER_BYTES_SENT, headerSize);
+    Statistics::incrementCounter(Statistics::COUNTER_PAYLOAD_BYTES_SENT, payloadSize);
+}
+
 void ProcessorRTP::initPackageHandler(unsigned int maxBufferSize)
 {
     if(rtpPackage.get() == nullptr)
     {
-        rtpPackage.reset(new RTPPackageHandler(maxBufferSize));
+        rtpPackage.reset(new RTPPackageHandler(maxBufferSize, ourselves));
     }
     ourselves.initialRTPTimestamp = rtpPackage->getInitialTimestamp();
     ourselves.extendedHighestSequenceNumber = rtpPackage->getCurrentSequenceNumber();
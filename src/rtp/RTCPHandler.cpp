@@ -21,10 +21,21 @@ using namespace ohmcomm::rtp;
 //standard-conform minimum interval of 5 seconds (no need to be adaptive, as long as we only have one remote) (RFC3550 Section 6.2)
 const std::chrono::seconds RTCPHandler::sendSRInterval{5};
 const std::chrono::seconds RTCPHandler::remoteDropoutTimeout{60};
+constexpr std::chrono::milliseconds RTCPHandler::MULTIPLEXED_WAIT_INTERVAL;
 
 RTCPHandler::RTCPHandler(const ohmcomm::NetworkConfiguration& rtcpConfig, const std::shared_ptr<ohmcomm::ConfigurationMode> configMode, const bool isActiveSender):
     wrapper(new ohmcomm::network::UDPWrapper(rtcpConfig)), configMode(configMode),
-        isActiveSender(isActiveSender), rtcpHandler(), ourselves(ParticipantDatabase::self())
+        isActiveSender(isActiveSender), isMultiplexed(false), rtcpHandler(), ourselves(ParticipantDatabase::self())
+{
+    //make sure, RTCP for self is set
+    if(!ourselves.rtcpData)
+        ourselves.rtcpData.reset(new RTCPData);
+    ParticipantDatabase::registerListener(*this);
+}
+
+RTCPHandler::RTCPHandler(const std::shared_ptr<ohmcomm::network::NetworkWrapper> rtpWrapper, const std::shared_ptr<ohmcomm::ConfigurationMode> configMode, const bool isActiveSender,
+                         Participant& ourselves):
+    wrapper(rtpWrapper), configMode(configMode), isActiveSender(isActiveSender), isMultiplexed(true), rtcpHandler(), ourselves(ourselves)
 {
     //make sure, RTCP for self is set
     if(!ourselves.rtcpData)
@@ -36,14 +47,33 @@ RTCPHandler::~RTCPHandler()
 {
     ParticipantDatabase::unregisterListener(*this);
     // Wait until thread has really stopped
-    listenerThread.join();
+    if(listenerThread.joinable())
+        listenerThread.join();
 }
 
-void RTCPHandler::startUp()
+void RTCPHandler::startUp(ohmcomm::network::EventLoop* loop)
 {
     if(!threadRunning)
     {
         threadRunning = true;
+        //a multiplexed socket is watched by the RTPListener
+        const int socket = isMultiplexed ? INVALID_SOCKET : wrapper->getSocketDescriptor();
+        if(ohmcomm::network::EventLoop::isSupported() && (isMultiplexed || socket != INVALID_SOCKET))
+        {
+            //set before the socket is watched, in case the first package already shuts down the handler
+            eventLoop = loop != nullptr ? loop : &ohmcomm::network::EventLoop::getSharedLoop();
+            loopSocket = socket;
+            ohmcomm::info("RTCP") << "RTCP-Handler started ..." << ohmcomm::endl;
+            //the first report is sent immediately
+            sendReport();
+            reportTimer = eventLoop->addTimer(sendSRInterval, [this]() { sendReport(); });
+            if(isMultiplexed || eventLoop->addSocket(socket, [this]() { receivePackage(); }))
+            {
+                return;
+            }
+            eventLoop->cancelTimer(reportTimer);
+            eventLoop = nullptr;
+        }
         listenerThread = std::thread(&RTCPHandler::runThread, this);
     }
 }
@@ -72,8 +102,19 @@ void RTCPHandler::shutdownInternal()
 {
     // notify the thread to stop
     threadRunning = false;
-    // close the socket
-    wrapper->closeNetwork();
+    if(eventLoop != nullptr)
+    {
+        //the socket must be removed before it is closed
+        eventLoop->removeSocket(loopSocket);
+        eventLoop->cancelTimer(reportTimer);
+        eventLoop = nullptr;
+        ohmcomm::info("RTCP") << "RTCP-Handler shut down!" << ohmcomm::endl;
+    }
+    if(!isMultiplexed)
+    {
+        // close the socket, a multiplexed socket is closed by the RTP-processor
+        wrapper->closeNetwork();
+    }
 }
 
 
@@ -85,44 +126,70 @@ void RTCPHandler::runThread()
     {
         if((std::chrono::steady_clock::now() - sendSRInterval) >= ourselves.rtcpData->lastSRTimestamp)
         {
-            const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
-            const auto allParticipants = ParticipantDatabase::getAllRemoteParticipants();
-            for(auto it = allParticipants.begin(); it != allParticipants.end(); ++it)
-            {
-                if(now - (*it).second.lastPackageReceived > remoteDropoutTimeout)
-                {
-                    //remote has not send any package for quite some time, end conversation
-                    ohmcomm::info("RTCP") << "Dialog partner has timed out, shutting down!" << ohmcomm::endl;
-                    shutdownInternal();
-                    //notifies OHMComm about remote leaving
-                    ParticipantDatabase::removeParticipant((*it).second.ssrc);
-                    break;
-                }
-            }
-            //send report (SR/RR) every X seconds
-            ourselves.rtcpData->lastSRTimestamp = std::chrono::steady_clock::now();
-            sendSourceDescription();
+            sendReport();
         }
-        //wait for package and store into RTCPPackageHandler
-        const ohmcomm::network::NetworkWrapper::Package result = this->wrapper->receiveData(rtcpHandler.rtcpPackageBuffer.data(), rtcpHandler.rtcpPackageBuffer.capacity());
-        if(threadRunning == false || result.isInvalidSocket())
+        if(threadRunning && !isMultiplexed)
         {
-            //socket was already closed
-            shutdownInternal();
+            receivePackage();
         }
-        else if(result.hasTimedOut())
+        else if(threadRunning)
         {
-            //just continue to next loop iteration, checking if thread should continue running
+            //the packages are received by the RTPListener, we only need to wake up for the next report
+            std::this_thread::sleep_for(MULTIPLEXED_WAIT_INTERVAL);
         }
-        else if (RTCPPackageHandler::isRTCPPackage(rtcpHandler.rtcpPackageBuffer.data(), result.getReceivedSize()))
+    }
+    ohmcomm::info("RTCP") << "RTCP-Handler shut down!" << ohmcomm::endl;
+}
+
+void RTCPHandler::receivePackage()
+{
+    //wait for package and store into RTCPPackageHandler
+    const ohmcomm::network::NetworkWrapper::Package result = this->wrapper->receiveData(rtcpHandler.rtcpPackageBuffer.data(), rtcpHandler.rtcpPackageBuffer.capacity());
+    if(threadRunning == false || result.isInvalidSocket())
+    {
+        //socket was already closed
+        shutdownInternal();
+    }
+    else if(result.hasTimedOut())
+    {
+        //just continue to next loop iteration, checking if thread should continue running
+    }
+    else
+    {
+        handlePackage(rtcpHandler.rtcpPackageBuffer.data(), result.getReceivedSize());
+    }
+}
+
+void RTCPHandler::handlePackage(const void* receiveBuffer, const unsigned int receivedSize)
+{
+    if (RTCPPackageHandler::isRTCPPackage(receiveBuffer, receivedSize))
+    {
+        Statistics::incrementCounter(Statistics::RTCP_PACKAGES_RECEIVED);
+        Statistics::incrementCounter(Statistics::RTCP_BYTES_RECEIVED, receivedSize);
+        const uint32_t ssrc = handleRTCPPackage(receiveBuffer, receivedSize);
+        ParticipantDatabase::remote(ssrc).lastPackageReceived = std::chrono::steady_clock::now();
+    }
+}
+
+void RTCPHandler::sendReport()
+{
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    const auto allParticipants = ParticipantDatabase::getAllRemoteParticipants();
+    for(auto it = allParticipants.begin(); it != allParticipants.end(); ++it)
+    {
+        if(now - (*it).second.lastPackageReceived > remoteDropoutTimeout)
         {
-            Statistics::incrementCounter(Statistics::RTCP_PACKAGES_RECEIVED);
-            Statistics::incrementCounter(Statistics::RTCP_BYTES_RECEIVED, result.getReceivedSize());
-            const uint32_t ssrc = handleRTCPPackage(rtcpHandler.rtcpPackageBuffer.data(), result.getReceivedSize());
-            ParticipantDatabase::remote(ssrc).lastPackageReceived = std::chrono::steady_clock::now();
+            //remote has not send any package for quite some time, end conversation
+            ohmcomm::info("RTCP") << "Dialog partner has timed out, shutting down!" << ohmcomm::endl;
+            shutdownInternal();
+            //notifies OHMComm about remote leaving
+            ParticipantDatabase::removeParticipant((*it).second.ssrc);
+            break;
         }
     }
-    ohmcomm::info("RTCP") << "RTCP-Handler shut down!" << ohmcomm::endl;
+    //send report (SR/RR) every X seconds
+    ourselves.rtcpData->lastSRTimestamp = std::chrono::steady_clock::now();
+    sendSourceDescription();
 }
 
 uint32_t RTCPHandler::handleRTCPPackage(const void* receiveBuffer, unsigned int receivedSize)
@@ -303,6 +303,17 @@ bool RTCPPackageHandler::isRTCPPackage(const void* packageBuffer, const unsigned
     return true;
 }
 
+bool RTCPPackageHandler::isMultiplexedRTCPPackage(const void* packageBuffer, const unsigned int packageLength)
+{
+    if(packageLength < RTCP_HEADER_SIZE)
+    {
+        return false;
+    }
+    //the package-type for RTCP, the marker-bit and payload-type for RTP
+    const uint8_t type = ((const uint8_t*)packageBuffer)[1];
+    return type >= 192 && type <= 223;
+}
+
 unsigned int RTCPPackageHandler::getRTCPPackageLength(unsigned int lengthHeaderField)
 {
     //"The length of this RTCP packet in 32-bit words minus one, including the header and any padding"
@@ -6,16 +6,48 @@
  */
 
 
+#include <new>  //placement new
+#include <algorithm> //std::fill
+
 #include "rtp/RTPBuffer.h"
 #include "rtp/ParticipantDatabase.h"
+#include "rtp/BufferClock.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 using namespace ohmcomm::rtp;
 
-RTPBuffer::RTPBuffer(uint32_t ssrc, uint16_t maxCapacity, uint16_t maxDelay, uint16_t minBufferPackages) : PlayoutPointAdaption(200, minBufferPackages),
-    ssrc(ssrc), capacity(maxCapacity), maxDelay(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::milliseconds(maxDelay)))
+/*!
+ * \return the number of trailing zero-bits, the value must not be zero
+ */
+static inline unsigned int countTrailingZeros(const uint64_t value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return index;
+#else
+    return __builtin_ctzll(value);
+#endif
+}
+
+RTPBuffer::RTPBuffer(uint32_t ssrc, uint16_t maxCapacity, uint16_t maxDelay, uint16_t minBufferPackages, unsigned int maxPayloadSize, const PlayoutAdaptionSettings& adaptionSettings) :
+    PlayoutPointAdaption(200, minBufferPackages, adaptionSettings), ClockDriftCompensation(adaptionSettings.compensateClockDrift),
+    slotSize(((sizeof(RTPBufferPackage) + maxPayloadSize + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE) * CACHE_LINE_SIZE), maxPayloadSize(maxPayloadSize),
+    occupiedSlots((maxCapacity + 63) / 64, 0),
+    ssrc(ssrc), capacity(maxCapacity), maxDelay(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::milliseconds(maxDelay))),
+    leasedIndex(maxCapacity), concealmentPackage(maxPayloadSize)
 {
     nextReadIndex = 0;
-    ringBuffer = new RTPBufferPackage[maxCapacity];
+    //allocate a single arena for all packages, so no memory needs to be allocated while receiving
+    arenaMemory = new char[maxCapacity * slotSize + CACHE_LINE_SIZE - 1];
+    arena = alignToCacheLine(arenaMemory);
+    for(uint16_t i = 0; i < maxCapacity; ++i)
+    {
+        new (&getPackage(i)) RTPBufferPackage();
+    }
     size = 0;
     minSequenceNumber = 0;
     Statistics::setCounter(Statistics::RTP_BUFFER_LIMIT, maxCapacity);
@@ -23,17 +55,22 @@ RTPBuffer::RTPBuffer(uint32_t ssrc, uint16_t maxCapacity, uint16_t maxDelay, uin
 
 RTPBuffer::~RTPBuffer()
 {
-    delete [] ringBuffer;
+    for(uint16_t i = 0; i < capacity; ++i)
+    {
+        getPackage(i).~RTPBufferPackage();
+    }
+    delete [] arenaMemory;
 }
 
-RTPBufferStatus RTPBuffer::addPackage(const RTPPackageHandler &package, unsigned int contentSize)
+RTPBufferStatus RTPBuffer::addPackage(const RTPPackageHandler &package, unsigned int contentSize, const std::chrono::steady_clock::time_point receptionTime)
 {
     std::lock_guard<std::mutex> guard(bufferMutex);
     const RTPHeader *receivedHeader = package.getRTPPackageHeader();
-    if(minSequenceNumber == 0 || receivedHeader->isMarked())
+    if(minSequenceNumber == 0 || receivedHeader->isMarked() || (size == 0 && receivedHeader->getPayloadType() == PayloadType::CN))
     {
         //if we receive our first package, we need to set minSequenceNumber
         //same for a marked package after a silent period (for DTX)
+        //and for a comfort-noise package within a silent period, since the concealed packages skipped the sequence numbers in between
         //TODO same for any first package after a silent period (to correctly handle lost marked package and large consecutive losses)
         minSequenceNumber = receivedHeader->getSequenceNumber();
     }
@@ -44,7 +81,7 @@ RTPBufferStatus RTPBuffer::addPackage(const RTPPackageHandler &package, unsigned
     {
         //late loss
         //discard package, because it is older than the minimum sequence number to hold
-        packageReceived(true);
+        packageReceived(true, receivedHeader->getSequenceNumber(), receivedHeader->getTimestamp(), receptionTime);
         return RTPBufferStatus::RTP_BUFFER_ALL_OKAY;
     }
 
@@ -59,36 +96,81 @@ RTPBufferStatus RTPBuffer::addPackage(const RTPPackageHandler &package, unsigned
         //TODO can occur if playout gets somehow stuck -> overwrite old packages (see alternative buffer)
         return RTPBufferStatus::RTP_BUFFER_INPUT_OVERFLOW;
     }
-    uint16_t newWriteIndex = calculateIndex(nextReadIndex, receivedHeader->getSequenceNumber()-minSequenceNumber);
-    //write package-data into buffer
-    ringBuffer[newWriteIndex].isValid = true;
-    ringBuffer[newWriteIndex].header = *receivedHeader;
-    if(ringBuffer[newWriteIndex].packageContent == nullptr)
+    if(contentSize > maxPayloadSize)
     {
-        //allocate new buffer with the current content-size
-        ringBuffer[newWriteIndex].bufferSize = contentSize;
-        ringBuffer[newWriteIndex].packageContent = malloc(contentSize);
+        //package does not fit into the slot
+        return RTPBufferStatus::RTP_BUFFER_INPUT_OVERFLOW;
     }
-    else if(ringBuffer[newWriteIndex].bufferSize < contentSize)
+    const uint16_t newWriteIndex = calculateIndex(nextReadIndex, receivedHeader->getSequenceNumber()-minSequenceNumber);
+    if(newWriteIndex == leasedIndex)
     {
-        //reallocate buffer, because the content would not fit
-        ringBuffer[newWriteIndex].bufferSize = contentSize;
-        ringBuffer[newWriteIndex].packageContent = realloc(ringBuffer[newWriteIndex].packageContent, contentSize);
+        //the entry is still accessed by the consumer
+        return RTPBufferStatus::RTP_BUFFER_INPUT_OVERFLOW;
     }
+    RTPBufferPackage& bufferPack = getPackage(newWriteIndex);
+    //write package-data into buffer
+    bufferPack.header = *receivedHeader;
     //save timestamp of reception
-    ringBuffer[newWriteIndex].receptionTimestamp = std::chrono::steady_clock::now();
-    ringBuffer[newWriteIndex].contentSize = contentSize;
-    memcpy(ringBuffer[newWriteIndex].packageContent, package.getRTPPackageData(), contentSize);
-    //update size
-    size++;
+    bufferPack.receptionTimestamp = receptionTime;
+    bufferPack.contentSize = contentSize;
+    memcpy(bufferPack.getContent(), package.getRTPPackageData(), contentSize);
+    //update size, if we did not overwrite a (duplicate) package
+    if(!isOccupied(newWriteIndex))
+    {
+        setOccupied(newWriteIndex);
+        size++;
+    }
     Statistics::maxCounter(Statistics::RTP_BUFFER_MAXIMUM_USAGE, size);
-    packageReceived(false);
+    packageReceived(false, receivedHeader->getSequenceNumber(), receivedHeader->getTimestamp(), bufferPack.receptionTimestamp);
     return RTPBufferStatus::RTP_BUFFER_ALL_OKAY;
 }
 
 RTPBufferStatus RTPBuffer::readPackage(RTPPackageHandler &package)
 {
     std::lock_guard<std::mutex> guard(bufferMutex);
+    RTPBufferPackage* bufferPack = nullptr;
+    const RTPBufferStatus status = nextPackage(package, bufferPack);
+    if(bufferPack != nullptr)
+    {
+        //This copies the content of the entry into package
+        char *packageBuffer = (char *)package.getWriteBuffer(bufferPack->contentSize + sizeof(bufferPack->header));
+        memcpy(packageBuffer, &(bufferPack->header), sizeof(bufferPack->header));
+        memcpy(packageBuffer + sizeof(bufferPack->header), bufferPack->getContent(), bufferPack->contentSize);
+        package.setActualPayloadSize(bufferPack->contentSize);
+    }
+    return status;
+}
+
+RTPBufferStatus RTPBuffer::leasePackage(PackageLease& lease)
+{
+    lease.release();
+    std::lock_guard<std::mutex> guard(bufferMutex);
+    RTPBufferPackage* bufferPack = nullptr;
+    const RTPBufferStatus status = nextPackage(concealmentPackage, bufferPack);
+    if(bufferPack != nullptr)
+    {
+        //the entry is protected from being overwritten until the lease is released
+        leasedIndex = (reinterpret_cast<char*>(bufferPack) - arena) / slotSize;
+        assignLease(lease, this, &bufferPack->header, bufferPack->getContent(), bufferPack->contentSize, leasedIndex);
+    }
+    else
+    {
+        assignLease(lease, nullptr, concealmentPackage.getRTPPackageHeader(), concealmentPackage.getRTPPackageData(), concealmentPackage.getActualPayloadSize());
+    }
+    return status;
+}
+
+void RTPBuffer::releasePackage(const PackageLease& lease)
+{
+    std::lock_guard<std::mutex> guard(bufferMutex);
+    if(leasedIndex == getLeasedSlot(lease))
+    {
+        leasedIndex = capacity;
+    }
+}
+
+RTPBufferStatus RTPBuffer::nextPackage(RTPPackageHandler& package, RTPBufferPackage*& bufferPack)
+{
     if(!isAdaptionBufferFilled())
     {
         //buffer has insufficient fill level
@@ -98,27 +180,48 @@ RTPBufferStatus RTPBuffer::readPackage(RTPPackageHandler &package)
         //for that, we need to insert, not replace packages
         return RTPBufferStatus::RTP_BUFFER_OUTPUT_UNDERFLOW;
     }
+    DriftCorrection correction = updateDriftCompensation((int)size - getPlayoutDelayPackages());
+    if(correction == DriftCorrection::INSERT_FRAME && minSequenceNumber != 0)
+    {
+        //the remote clock is slower than ours, play the last package again without consuming the next one
+        driftCorrectionApplied(correction);
+        if(repeatLastPackage(package, minSequenceNumber - 1))
+        {
+            return RTPBufferStatus::RTP_BUFFER_ALL_OKAY;
+        }
+        createConcealmentPackage(package);
+        return RTPBufferStatus::RTP_BUFFER_OUTPUT_UNDERFLOW;
+    }
     //need to search for oldest valid package, newer than minSequenceNumber and newer than currentTimestamp - maxDelay
-    uint16_t index = nextReadIndex;
-    const std::chrono::steady_clock::time_point currentTimestamp = std::chrono::steady_clock::now();
-    while(incrementIndex(index) != nextReadIndex)
+    //only the occupied entries are visited, packages too old are dropped when they are encountered
+    uint16_t index;
+    const std::chrono::steady_clock::time_point currentTimestamp = BufferClock::now();
+    while((index = findOccupiedIndex(nextReadIndex)) != capacity)
     {
-        //check whether package is too delayed
-        if(ringBuffer[index].isValid == true && ringBuffer[index].receptionTimestamp + maxDelay < currentTimestamp)
+        RTPBufferPackage& entry = getPackage(index);
+        //the sequence number is outside of the window [minSequenceNumber, minSequenceNumber + capacity) or the package is too delayed
+        if((uint16_t)(entry.header.getSequenceNumber() - minSequenceNumber) >= capacity || entry.receptionTimestamp + maxDelay < currentTimestamp)
         {
             //package is valid but too old, invalidate and skip
-            ringBuffer[index].isValid = false;
+            clearOccupied(index);
+            size--;
+            continue;
         }
-        else if(ringBuffer[index].isValid == true && ringBuffer[index].header.getSequenceNumber() >= minSequenceNumber)
+        if(correction == DriftCorrection::DROP_FRAME && size > 1)
         {
-            nextReadIndex = index;
-            break;
+            //the remote clock is faster than ours, skip this package (without counting it as lost)
+            driftCorrectionApplied(correction);
+            correction = DriftCorrection::NONE;
+            clearOccupied(index);
+            size--;
+            nextReadIndex = incrementIndex(index);
+            minSequenceNumber = (entry.header.getSequenceNumber() + 1) % UINT16_MAX;
+            continue;
         }
-        index = incrementIndex(index);
+        nextReadIndex = index;
+        break;
     }
-    //This copies the content of ringBuffer[readIndex] into package
-    RTPBufferPackage *bufferPack = &(ringBuffer[nextReadIndex]);
-    if(bufferPack->isValid == false)
+    if(index == capacity)
     {
         //no valid packages found -> buffer is empty
         //return concealment package
@@ -130,23 +233,27 @@ RTPBufferStatus RTPBuffer::readPackage(RTPPackageHandler &package)
         return RTPBufferStatus::RTP_BUFFER_OUTPUT_UNDERFLOW;
     }
 
-    char *packageBuffer = (char *)package.getWriteBuffer(bufferPack->contentSize + sizeof(bufferPack->header));
-    memcpy(packageBuffer, &(bufferPack->header), sizeof(bufferPack->header));
-    memcpy(packageBuffer + sizeof(bufferPack->header), bufferPack->packageContent, bufferPack->contentSize);
-    package.setActualPayloadSize(bufferPack->contentSize);
+    //the content stays in the entry until it is overwritten by a newer package
+    bufferPack = &getPackage(nextReadIndex);
+    updateComfortNoise(bufferPack->header, bufferPack->getContent(), bufferPack->contentSize);
 
     //Invalidate buffer-entry
-    bufferPack->isValid = false;
+    clearOccupied(nextReadIndex);
     //Increment Index, decrease size
     nextReadIndex = incrementIndex(nextReadIndex);
     size--;
     //we lost all packages between the last read and this one, so we subtract the sequence numbers
-    if(ParticipantDatabase::isInDatabase(ssrc))
+    const uint16_t numLost = (bufferPack->header.getSequenceNumber() - minSequenceNumber)%UINT16_MAX;
+    if(numLost > 0)
     {
         //don't create new remote here, if it doesn't exist anymore
-        ParticipantDatabase::remote(ssrc).packagesLost += (bufferPack->header.getSequenceNumber() - minSequenceNumber)%UINT16_MAX;
+        Participant* participant = participants.find(ssrc);
+        if(participant != nullptr)
+        {
+            participant->packagesLost += numLost;
+        }
+        Statistics::incrementCounter(Statistics::COUNTER_PACKAGES_LOST, numLost);
     }
-    Statistics::incrementCounter(Statistics::COUNTER_PACKAGES_LOST, (bufferPack->header.getSequenceNumber() - minSequenceNumber)%UINT16_MAX);
     //only accept newer packages (at least one sequence number more than last read package)
     minSequenceNumber = (bufferPack->header.getSequenceNumber() + 1) % UINT16_MAX;
     return RTPBufferStatus::RTP_BUFFER_ALL_OKAY;
@@ -157,22 +264,36 @@ unsigned int RTPBuffer::getSize() const
     return size;
 }
 
+void RTPBuffer::reset(const uint32_t ssrc)
+{
+    std::lock_guard<std::mutex> guard(bufferMutex);
+    this->ssrc = ssrc;
+    std::fill(occupiedSlots.begin(), occupiedSlots.end(), 0);
+    nextReadIndex = 0;
+    size = 0;
+    minSequenceNumber = 0;
+    leasedIndex = capacity;
+    resetAdaption();
+    resetConcealment();
+    resetDriftCompensation();
+}
+
 bool RTPBuffer::repeatLastPackage(RTPPackageHandler& package, const uint16_t packageSequenceNumber)
 {
     //reverse iterate the buffer to get to the position for the given sequence-number
     uint16_t index = nextReadIndex;
     while(index != incrementIndex(nextReadIndex))
     {
-        if(ringBuffer[index].header.getSequenceNumber() == packageSequenceNumber)
+        if(getPackage(index).header.getSequenceNumber() == packageSequenceNumber)
         {
-            RTPBufferPackage *bufferPack = &(ringBuffer[index]);
+            RTPBufferPackage *bufferPack = &getPackage(index);
             char *packageBuffer = (char *)package.getWriteBuffer(bufferPack->contentSize + sizeof(bufferPack->header));
             memcpy(packageBuffer, &(bufferPack->header), sizeof(bufferPack->header));
-            memcpy(packageBuffer + sizeof(bufferPack->header), bufferPack->packageContent, bufferPack->contentSize);
+            memcpy(packageBuffer + sizeof(bufferPack->header), bufferPack->getContent(), bufferPack->contentSize);
             package.setActualPayloadSize(bufferPack->contentSize);
             return true;
         }
-        index = index == 0 ? capacity : index-1;
+        index = index == 0 ? capacity - 1 : index-1;
     }
     return false;
 }
@@ -185,4 +306,41 @@ uint16_t RTPBuffer::calculateIndex(uint16_t index, uint16_t offset)
 uint16_t RTPBuffer::incrementIndex(uint16_t index)
 {
     return (index+1) % capacity;
+}
+
+uint16_t RTPBuffer::findOccupiedIndex(uint16_t startIndex) const
+{
+    //search from the start to the end of the ring, then wrap around
+    const uint16_t index = findOccupiedIndex(startIndex, capacity);
+    if(index != capacity)
+    {
+        return index;
+    }
+    const uint16_t wrappedIndex = findOccupiedIndex(0, startIndex);
+    return wrappedIndex != startIndex ? wrappedIndex : capacity;
+}
+
+uint16_t RTPBuffer::findOccupiedIndex(uint16_t fromIndex, uint16_t toIndex) const
+{
+    //use a wider type to not overflow when advancing past the last word
+    unsigned int index = fromIndex;
+    while(index < toIndex)
+    {
+        const unsigned int word = index / 64;
+        //mask out all entries before the start index
+        const uint64_t bits = occupiedSlots[word] & (~UINT64_C(0) << (index % 64));
+        if(bits != 0)
+        {
+            index = word * 64 + countTrailingZeros(bits);
+            return index < toIndex ? index : toIndex;
+        }
+        index = (word + 1) * 64;
+    }
+    return toIndex;
+}
+
+char* RTPBuffer::alignToCacheLine(char* memory)
+{
+    const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(memory);
+    return memory + ((CACHE_LINE_SIZE - (address % CACHE_LINE_SIZE)) % CACHE_LINE_SIZE);
 }
\ No newline at end of file
@@ -19,7 +19,7 @@ int RTPBufferAlternative::isPowerOfTwo(unsigned int x)
 	return ((x != 0) && ((x & (~x + 1)) == x));
 }
 
-RTPBufferStatus RTPBufferAlternative::addPackage(const RTPPackageHandler &package, unsigned int contentSize)
+RTPBufferStatus RTPBufferAlternative::addPackage(const RTPPackageHandler &package, unsigned int contentSize, const std::chrono::steady_clock::time_point receptionTime)
 {
 	// Calculate position in the ringBuffer for the package
 	const RTPHeader *rtpHeader = package.getRTPPackageHeader();
@@ -114,6 +114,14 @@ RTPBufferStatus RTPBufferAlternative::readPackage(RTPPackageHandler &package)
 	return RTPBufferStatus::RTP_BUFFER_ALL_OKAY;
 }
 
+RTPBufferStatus RTPBufferAlternative::leasePackage(PackageLease& lease)
+{
+	lease.release();
+	const RTPBufferStatus status = readPackage(leasedPackage);
+	assignLease(lease, nullptr, leasedPackage.getRTPPackageHeader(), leasedPackage.getRTPPackageData(), leasedPackage.getActualPayloadSize());
+	return status;
+}
+
 unsigned int RTPBufferAlternative::getSize() const
 {
     return amountOfPackages;
@@ -216,6 +224,29 @@ void RTPBufferAlternative::setCurrentReadPos()
 	isCurrentReadPosSet = true;
 }
 
+// Releases all packages, the buffer is re-initialized with the next package
+void RTPBufferAlternative::reset(const uint32_t ssrc)
+{
+	lockMutex();
+	// The ringBuffer is initialized again with the next package added
+	if (ringBuffer != nullptr)
+	{
+		for (int i = 0; i < maxCapacity; i++)
+		{
+			delete ringBuffer[i];
+		}
+		delete[] ringBuffer;
+		ringBuffer = nullptr;
+	}
+	isCurrentReadPosSet = false;
+	currentReadPos = 0;
+	lastReadSeqNr = 0;
+	amountOfUnderflowsInRow = 0;
+	amountOfPackages = 0;
+	bufferContainsPackages = false;
+	unlockMutex();
+}
+
 // Initialize the whole buffer
 void RTPBufferAlternative::initializeRingBuffer(unsigned int contentSize, unsigned int rtpHeaderSize)
 {
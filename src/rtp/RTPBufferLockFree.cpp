@@ -0,0 +1,270 @@
+#include "rtp/RTPBufferLockFree.h"
+#include "rtp/ParticipantDatabase.h"
+#include "rtp/BufferClock.h"
+
+using namespace ohmcomm::rtp;
+
+RTPBufferLockFree::RTPBufferLockFree(uint32_t ssrc, uint16_t maxCapacity, uint16_t maxDelay, uint16_t minBufferPackages, unsigned int maxPayloadSize,
+                                     const PlayoutAdaptionSettings& adaptionSettings) :
+    PlayoutPointAdaption(200, minBufferPackages, adaptionSettings), ClockDriftCompensation(adaptionSettings.compensateClockDrift), ssrc(ssrc), capacity(maxCapacity),
+    maxDelay(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::milliseconds(maxDelay))), maxPayloadSize(maxPayloadSize),
+    size(0), minSequenceNumber(0), resyncRequest(0), readSequenceNumber(0), lastPlayedSlot(nullptr), concealmentPackage(maxPayloadSize), hasReceivedPackage(false)
+{
+    ringBuffer = new Slot[maxCapacity];
+    //allocate all payload-buffers up front, so neither thread needs to allocate memory while running
+    for(uint16_t i = 0; i < maxCapacity; ++i)
+    {
+        ringBuffer[i].packageContent.resize(maxPayloadSize);
+    }
+    Statistics::setCounter(Statistics::RTP_BUFFER_LIMIT, maxCapacity);
+}
+
+RTPBufferLockFree::~RTPBufferLockFree()
+{
+    delete [] ringBuffer;
+}
+
+RTPBufferStatus RTPBufferLockFree::addPackage(const RTPPackageHandler &package, unsigned int contentSize, const std::chrono::steady_clock::time_point receptionTime)
+{
+    const RTPHeader *receivedHeader = package.getRTPPackageHeader();
+    const uint16_t sequenceNumber = receivedHeader->getSequenceNumber();
+    uint16_t currentMinSequenceNumber;
+    if(!hasReceivedPackage || receivedHeader->isMarked() || (size.load(std::memory_order_acquire) == 0 && receivedHeader->getPayloadType() == PayloadType::CN))
+    {
+        //if we receive our first package, we need to set the minimum sequence number
+        //same for a marked package after a silent period (for DTX)
+        //and for a comfort-noise package within a silent period, since the concealed packages skipped the sequence numbers in between
+        //since the minimum sequence number is owned by the consumer, we only request the change
+        hasReceivedPackage = true;
+        resyncRequest.store(RESYNC_REQUESTED | sequenceNumber, std::memory_order_release);
+        currentMinSequenceNumber = sequenceNumber;
+    }
+    else
+    {
+        //a pending resynchronization overrides the minimum sequence number published by the consumer
+        const uint32_t pendingResync = resyncRequest.load(std::memory_order_acquire);
+        currentMinSequenceNumber = pendingResync != 0 ? (pendingResync & 0xFFFF) : minSequenceNumber.load(std::memory_order_acquire);
+    }
+
+    //we need to check for upper limit of range, because at some point a wrap around UINT16_MAX is expected behavior
+    // -> if minSequenceNumber is larger than (UINT16_MAX - capacity), sequence_number around zero have to be allowed for
+    if(currentMinSequenceNumber < (UINT16_MAX - capacity) && sequenceNumber < currentMinSequenceNumber)
+    {
+        //late loss
+        //discard package, because it is older than the minimum sequence number to hold
+        packageReceived(true, sequenceNumber, receivedHeader->getTimestamp(), receptionTime);
+        return RTPBufferStatus::RTP_BUFFER_ALL_OKAY;
+    }
+    if(size.load(std::memory_order_acquire) >= capacity)
+    {
+        //buffer is full
+        return RTPBufferStatus::RTP_BUFFER_INPUT_OVERFLOW;
+    }
+    if(sequenceNumber - currentMinSequenceNumber >= capacity)
+    {
+        //package is far too new -> we have no choice but to discard it without getting into an undetermined state
+        return RTPBufferStatus::RTP_BUFFER_INPUT_OVERFLOW;
+    }
+    Slot& slot = getSlot(sequenceNumber);
+    if(slot.state.load(std::memory_order_acquire) != SLOT_EMPTY || contentSize > maxPayloadSize)
+    {
+        //the slot is still in use by the consumer (or the package is too large to be buffered at all)
+        return RTPBufferStatus::RTP_BUFFER_INPUT_OVERFLOW;
+    }
+    //write package-data into buffer, the slot is exclusively owned by this thread
+    slot.header = *receivedHeader;
+    slot.receptionTimestamp = receptionTime;
+    slot.contentSize = contentSize;
+    memcpy(slot.packageContent.data(), package.getRTPPackageData(), contentSize);
+    //pass slot to the consumer
+    slot.state.store(SLOT_FILLED | sequenceNumber, std::memory_order_release);
+    const uint16_t newSize = size.fetch_add(1, std::memory_order_acq_rel) + 1;
+    Statistics::maxCounter(Statistics::RTP_BUFFER_MAXIMUM_USAGE, newSize);
+    packageReceived(false, sequenceNumber, slot.header.getTimestamp(), slot.receptionTimestamp);
+    return RTPBufferStatus::RTP_BUFFER_ALL_OKAY;
+}
+
+RTPBufferStatus RTPBufferLockFree::readPackage(RTPPackageHandler &package)
+{
+    Slot* playedSlot = nullptr;
+    const RTPBufferStatus status = nextPackage(package, playedSlot);
+    if(playedSlot != nullptr)
+    {
+        char *packageBuffer = (char *)package.getWriteBuffer(playedSlot->contentSize + sizeof(playedSlot->header));
+        memcpy(packageBuffer, &(playedSlot->header), sizeof(playedSlot->header));
+        memcpy(packageBuffer + sizeof(playedSlot->header), playedSlot->packageContent.data(), playedSlot->contentSize);
+        package.setActualPayloadSize(playedSlot->contentSize);
+    }
+    return status;
+}
+
+RTPBufferStatus RTPBufferLockFree::leasePackage(PackageLease& lease)
+{
+    lease.release();
+    Slot* playedSlot = nullptr;
+    const RTPBufferStatus status = nextPackage(concealmentPackage, playedSlot);
+    if(playedSlot != nullptr)
+    {
+        //the last played slot is kept by the consumer until the next package is played, so there is nothing to do on release
+        assignLease(lease, nullptr, &playedSlot->header, playedSlot->packageContent.data(), playedSlot->contentSize);
+    }
+    else
+    {
+        assignLease(lease, nullptr, concealmentPackage.getRTPPackageHeader(), concealmentPackage.getRTPPackageData(), concealmentPackage.getActualPayloadSize());
+    }
+    return status;
+}
+
+RTPBufferStatus RTPBufferLockFree::nextPackage(RTPPackageHandler& package, Slot*& playedSlot)
+{
+    const uint32_t pendingResync = resyncRequest.load(std::memory_order_acquire);
+    if(pendingResync != 0)
+    {
+        updateMinSequenceNumber(pendingResync & 0xFFFF);
+        //only clear the request, if the producer has not requested another one in the meantime
+        uint32_t expected = pendingResync;
+        resyncRequest.compare_exchange_strong(expected, 0, std::memory_order_acq_rel);
+    }
+    if(!isAdaptionBufferFilled())
+    {
+        //buffer has insufficient fill level
+        //return concealment package
+        createConcealmentPackage(package);
+        //we do not increase the minimum sequence number here, because we want to stretch the play-out delay
+        //for that, we need to insert, not replace packages
+        return RTPBufferStatus::RTP_BUFFER_OUTPUT_UNDERFLOW;
+    }
+    const DriftCorrection correction = updateDriftCompensation((int)size.load(std::memory_order_acquire) - getPlayoutDelayPackages());
+    if(correction == DriftCorrection::INSERT_FRAME && lastPlayedSlot != nullptr)
+    {
+        //the remote clock is slower than ours, play the last package again without consuming the next one
+        driftCorrectionApplied(correction);
+        repeatLastPackage(package, lastPlayedSlot->header.getSequenceNumber());
+        return RTPBufferStatus::RTP_BUFFER_ALL_OKAY;
+    }
+    const std::chrono::steady_clock::time_point currentTimestamp = BufferClock::now();
+    Slot* nextSlot = findNextSlot(currentTimestamp);
+    if(nextSlot != nullptr && correction == DriftCorrection::DROP_FRAME && size.load(std::memory_order_acquire) > 1)
+    {
+        //the remote clock is faster than ours, skip this package (without counting it as lost)
+        driftCorrectionApplied(correction);
+        updateMinSequenceNumber((nextSlot->header.getSequenceNumber() + 1) % UINT16_MAX);
+        releaseSlot(*nextSlot);
+        size.fetch_sub(1, std::memory_order_acq_rel);
+        nextSlot = findNextSlot(currentTimestamp);
+    }
+    if(nextSlot == nullptr)
+    {
+        //no valid packages found -> buffer is empty
+        //return concealment package
+        concealLoss(package, readSequenceNumber);
+        //only accept newer packages (at least one sequence number more than the dummy package)
+        //but skip check for first package
+        if(readSequenceNumber != 0)
+            updateMinSequenceNumber((readSequenceNumber + 1) % UINT16_MAX);
+        return RTPBufferStatus::RTP_BUFFER_OUTPUT_UNDERFLOW;
+    }
+
+    playedSlot = nextSlot;
+    updateComfortNoise(nextSlot->header, nextSlot->packageContent.data(), nextSlot->contentSize);
+
+    //keep the played slot to be able to repeat it, but give back the previous one
+    if(lastPlayedSlot != nullptr)
+    {
+        releaseSlot(*lastPlayedSlot);
+    }
+    lastPlayedSlot = nextSlot;
+    size.fetch_sub(1, std::memory_order_acq_rel);
+
+    //we lost all packages between the last read and this one, so we subtract the sequence numbers
+    const uint16_t sequenceNumber = nextSlot->header.getSequenceNumber();
+    const uint16_t numLost = sequenceNumber - readSequenceNumber;
+    if(numLost > 0)
+    {
+        //don't create new remote here, if it doesn't exist anymore
+        Participant* participant = participants.find(ssrc);
+        if(participant != nullptr)
+        {
+            participant->packagesLost += numLost;
+        }
+        Statistics::incrementCounter(Statistics::COUNTER_PACKAGES_LOST, numLost);
+    }
+    //only accept newer packages (at least one sequence number more than last read package)
+    updateMinSequenceNumber((sequenceNumber + 1) % UINT16_MAX);
+    return RTPBufferStatus::RTP_BUFFER_ALL_OKAY;
+}
+
+RTPBufferLockFree::Slot* RTPBufferLockFree::findNextSlot(const std::chrono::steady_clock::time_point currentTimestamp)
+{
+    //need to search for oldest valid package, newer than minSequenceNumber and newer than currentTimestamp - maxDelay
+    for(uint16_t offset = 0; offset < capacity; ++offset)
+    {
+        Slot& slot = getSlot(readSequenceNumber + offset);
+        if(&slot == lastPlayedSlot)
+        {
+            continue;
+        }
+        const uint32_t state = slot.state.load(std::memory_order_acquire);
+        if((state & SLOT_FILLED) == 0)
+        {
+            continue;
+        }
+        const uint16_t distance = (state & 0xFFFF) - readSequenceNumber;
+        if(slot.receptionTimestamp + maxDelay < currentTimestamp || distance >= capacity)
+        {
+            //package is valid but too old (or was skipped), drop it
+            releaseSlot(slot);
+            size.fetch_sub(1, std::memory_order_acq_rel);
+            continue;
+        }
+        return &slot;
+    }
+    return nullptr;
+}
+
+unsigned int RTPBufferLockFree::getSize() const
+{
+    return size.load(std::memory_order_acquire);
+}
+
+void RTPBufferLockFree::reset(const uint32_t ssrc)
+{
+    this->ssrc = ssrc;
+    for(uint16_t i = 0; i < capacity; ++i)
+    {
+        releaseSlot(ringBuffer[i]);
+    }
+    size.store(0);
+    resyncRequest.store(0);
+    updateMinSequenceNumber(0);
+    lastPlayedSlot = nullptr;
+    hasReceivedPackage = false;
+    resetAdaption();
+    resetConcealment();
+    resetDriftCompensation();
+}
+
+bool RTPBufferLockFree::repeatLastPackage(RTPPackageHandler& package, const uint16_t packageSequenceNumber)
+{
+    //only the last played package is guaranteed to not be overwritten by the producer
+    if(lastPlayedSlot == nullptr || lastPlayedSlot->header.getSequenceNumber() != packageSequenceNumber)
+    {
+        return false;
+    }
+    char *packageBuffer = (char *)package.getWriteBuffer(lastPlayedSlot->contentSize + sizeof(lastPlayedSlot->header));
+    memcpy(packageBuffer, &(lastPlayedSlot->header), sizeof(lastPlayedSlot->header));
+    memcpy(packageBuffer + sizeof(lastPlayedSlot->header), lastPlayedSlot->packageContent.data(), lastPlayedSlot->contentSize);
+    package.setActualPayloadSize(lastPlayedSlot->contentSize);
+    return true;
+}
+
+void RTPBufferLockFree::releaseSlot(Slot& slot)
+{
+    slot.state.store(SLOT_EMPTY, std::memory_order_release);
+}
+
+void RTPBufferLockFree::updateMinSequenceNumber(const uint16_t sequenceNumber)
+{
+    readSequenceNumber = sequenceNumber;
+    minSequenceNumber.store(sequenceNumber, std::memory_order_release);
+}
@@ -6,31 +6,70 @@
  */
 
 #include "Logger.h"
+#include "rtp/RTCPHandler.h"
 #include "rtp/RTPListener.h"
+#include "rtp/SharedMediaSocket.h"
 #include "Statistics.h"
 
 using namespace ohmcomm::rtp;
 
-RTPListener::RTPListener(std::shared_ptr<ohmcomm::network::NetworkWrapper> wrapper, JitterBuffers& buffers, unsigned int receiveBufferSize) :
-    wrapper(wrapper), buffers(buffers), rtpHandler(receiveBufferSize)
+constexpr unsigned int RTPListener::RECEIVE_BATCH_SIZE;
+
+RTPListener::RTPListener(std::shared_ptr<ohmcomm::network::NetworkWrapper> wrapper, JitterBuffers& buffers, unsigned int receiveBufferSize, RTCPHandler* rtcpHandler,
+                         const uint32_t ownSSRC) :
+    RTPListener(wrapper, &buffers, rtcpHandler, nullptr, receiveBufferSize, ownSSRC)
+{
+}
+
+RTPListener::RTPListener(SharedMediaSocket& sharedSocket, std::shared_ptr<ohmcomm::network::NetworkWrapper> wrapper, unsigned int receiveBufferSize) :
+    RTPListener(wrapper, nullptr, nullptr, &sharedSocket, receiveBufferSize, ParticipantDatabase::self().ssrc)
+{
+}
+
+RTPListener::RTPListener(std::shared_ptr<ohmcomm::network::NetworkWrapper> wrapper, JitterBuffers* buffers, RTCPHandler* rtcpHandler, SharedMediaSocket* sharedSocket,
+                         unsigned int receiveBufferSize, const uint32_t ownSSRC) :
+    wrapper(wrapper), buffers(buffers), rtcpHandler(rtcpHandler), sharedSocket(sharedSocket), ownSSRC(ownSSRC), rtpHandlers(RECEIVE_BATCH_SIZE, RTPPackageHandler(receiveBufferSize)), receiveBuffers(RECEIVE_BATCH_SIZE),
+    receivedPackages(RECEIVE_BATCH_SIZE)
 {
+    for(unsigned int i = 0; i < RECEIVE_BATCH_SIZE; ++i)
+    {
+        receiveBuffers[i] = rtpHandlers[i].getWriteBuffer(rtpHandlers[i].getMaximumPackageSize());
+    }
 }
 
-RTPListener::RTPListener(const RTPListener& orig) : wrapper(orig.wrapper), buffers(orig.buffers), rtpHandler(orig.rtpHandler)
+RTPListener::RTPListener(const RTPListener& orig) : RTPListener(orig.wrapper, orig.buffers, orig.rtcpHandler, orig.sharedSocket, orig.rtpHandlers[0].getMaximumPayloadSize(), orig.ownSSRC)
 {
 }
 
 RTPListener::~RTPListener()
 {
+    shutdown();
     // Wait until thread has really stopped
-    receiveThread.join();
+    if(receiveThread.joinable())
+        receiveThread.join();
 }
 
-void RTPListener::startUp()
+void RTPListener::startUp(ohmcomm::network::EventLoop* loop)
 {
     if(!threadRunning)
     {
         threadRunning = true;
+        const int socket = wrapper->getSocketDescriptor();
+        if(ohmcomm::network::EventLoop::isSupported() && socket != INVALID_SOCKET)
+        {
+            //set before the socket is watched, in case the first receive already shuts down the listener
+            eventLoop = loop != nullptr ? loop : &ohmcomm::network::EventLoop::getSharedLoop();
+            loopSocket = socket;
+            //release the buffers of remotes which stopped sending, even if no more packages are received
+            idleTimer = eventLoop->addTimer(std::chrono::seconds(1), [this]() { removeIdleBuffers(); });
+            if(eventLoop->addSocket(socket, [this]() { receivePackages(); }))
+            {
+                ohmcomm::info("RTP") << "RTP-Listener started ..." << ohmcomm::endl;
+                return;
+            }
+            eventLoop->cancelTimer(idleTimer);
+            eventLoop = nullptr;
+        }
         receiveThread = std::thread(&RTPListener::runThread, this);
     }
 }
@@ -40,70 +79,237 @@ void RTPListener::runThread()
     ohmcomm::info("RTP") << "RTP-Listener started ..." << ohmcomm::endl;
     while(threadRunning)
     {
-        //1. wait for package and store into RTPPackage
-        const ohmcomm::network::NetworkWrapper::Package receivedPackage = this->wrapper->receiveData(rtpHandler.getWriteBuffer(rtpHandler.getMaximumPackageSize()), rtpHandler.getMaximumPackageSize());
-        if(receivedPackage.isInvalidSocket())
-        {
-            //socket was already closed
-            shutdown();
-        }
-        else if(receivedPackage.hasTimedOut())
+        receivePackages();
+    }
+    ohmcomm::info("RTP") << "RTP-Listener shut down" << ohmcomm::endl;
+}
+
+void RTPListener::receivePackages()
+{
+    //1. wait for packages and store them into the RTPPackages
+    const unsigned int numReceived = this->wrapper->receiveData(receiveBuffers.data(), rtpHandlers[0].getMaximumPackageSize(), receivedPackages.data(), RECEIVE_BATCH_SIZE);
+    if(eventLoop == nullptr)
+    {
+        //release the buffers of remotes which stopped sending
+        removeIdleBuffers();
+    }
+    if(receivedPackages[0].isInvalidSocket())
+    {
+        //socket was already closed
+        shutdown();
+    }
+    else if(receivedPackages[0].hasTimedOut())
+    {
+        //just continue to next loop iteration, checking if thread should continue running
+    }
+    else if(threadRunning)
+    {
+        //the kernel reports the packages dropped on a full receive-buffer as a counter per socket
+        const uint32_t totalDropped = wrapper->getNumberOfDroppedPackages();
+        if(totalDropped != droppedPackages)
         {
-            //just continue to next loop iteration, checking if thread should continue running
+            Statistics::incrementCounter(Statistics::SOCKET_RECEIVE_DROPPED, (uint32_t)(totalDropped - droppedPackages));
+            droppedPackages = totalDropped;
         }
-        else if(threadRunning && RTPPackageHandler::isRTPPackage(rtpHandler.getReadBuffer(), receivedPackage.getReceivedSize()))
+        processPackages(numReceived);
+    }
+}
+
+void RTPListener::processPackages(const unsigned int numPackages)
+{
+    //the sessions of a shared socket can't be removed while their packages are written into the buffers
+    std::unique_lock<std::mutex> sessionsLock;
+    if(sharedSocket != nullptr)
+    {
+        sessionsLock = std::unique_lock<std::mutex>(sharedSocket->sessionsMutex);
+    }
+    //the buffers to write the packages into, all packages not to be handled are marked with nullptr
+    JitterBuffers* packageBuffers[RECEIVE_BATCH_SIZE];
+    //the handlers of the RTCP-packages, nullptr for all other packages
+    RTCPHandler* packageRTCPHandlers[RECEIVE_BATCH_SIZE];
+    //whether the RTP-package was written into its buffer
+    bool isWritten[RECEIVE_BATCH_SIZE];
+    for(unsigned int i = 0; i < numPackages; ++i)
+    {
+        const void* package = rtpHandlers[i].getReadBuffer();
+        const unsigned int packageSize = receivedPackages[i].getReceivedSize();
+        packageBuffers[i] = nullptr;
+        packageRTCPHandlers[i] = nullptr;
+        isWritten[i] = false;
+        //RTCP is always multiplexed on a shared socket
+        const bool isRTCP = (rtcpHandler != nullptr || sharedSocket != nullptr) && RTCPPackageHandler::isMultiplexedRTCPPackage(package, packageSize);
+        JitterBuffers* sessionBuffers = buffers;
+        RTCPHandler* sessionRTCPHandler = rtcpHandler;
+        if(sharedSocket != nullptr)
         {
-            //2. write package to buffer
-            const uint8_t headerSize = rtpHandler.getRTPHeaderSize();
-            auto result = buffers.getBuffer(rtpHandler.getRTPPackageHeader()->getSSRC())->addPackage(rtpHandler, receivedPackage.getReceivedSize() - headerSize);
-            if (result == RTPBufferStatus::RTP_BUFFER_INPUT_OVERFLOW)
+            if(!isRTCP && !RTPPackageHandler::isRTPPackage(package, packageSize))
             {
-                ohmcomm::warn("RTP") << "Input Buffer overflow" << ohmcomm::endl;
+                continue;
             }
-            else if (result == RTPBufferStatus::RTP_BUFFER_PACKAGE_TO_OLD)
+            const uint32_t senderSSRC = isRTCP ? ((const RTCPHeader*)package)->getSSRC() : rtpHandlers[i].getRTPPackageHeader()->getSSRC();
+            const SharedMediaSocket::Session* session = sharedSocket->findSession(senderSSRC, receivedPackages[i].address);
+            if(session == nullptr)
             {
-                ohmcomm::warn("RTP") << "Package was too old, discarding" << ohmcomm::endl;
+                //from an unknown remote
+                continue;
             }
-            else
+            sessionBuffers = session->buffers;
+            sessionRTCPHandler = session->rtcpHandler;
+        }
+        if(isRTCP)
+        {
+            //RTCP multiplexed on the RTP-socket
+            packageRTCPHandlers[i] = sessionRTCPHandler;
+            continue;
+        }
+        if(RTPPackageHandler::isRTPPackage(package, packageSize)
+                //our own package, looped back by a multicast-group
+                && rtpHandlers[i].getRTPPackageHeader()->getSSRC() != ownSSRC)
+        {
+            packageBuffers[i] = sessionBuffers;
+        }
+    }
+    //handle all packages of a remote together, so the buffer and participant are only looked up once per batch
+    for(unsigned int first = 0; first < numPackages; ++first)
+    {
+        JitterBuffers* const sessionBuffers = packageBuffers[first];
+        if(sessionBuffers == nullptr)
+        {
+            continue;
+        }
+        const uint32_t ssrc = rtpHandlers[first].getRTPPackageHeader()->getSSRC();
+        RTPBufferHandler* buffer = sessionBuffers->getBuffer(ssrc);
+        for(unsigned int i = first; i < numPackages; ++i)
+        {
+            if(packageBuffers[i] != sessionBuffers || rtpHandlers[i].getRTPPackageHeader()->getSSRC() != ssrc)
             {
-                Participant& participant = ParticipantDatabase::remote(rtpHandler.getRTPPackageHeader()->getSSRC());
-                //on first RTP-package from remote, set values
-                if(participant.payloadType == PayloadType::ALL)
-                {
-                    participant.payloadType = rtpHandler.getRTPPackageHeader()->getPayloadType();
-                    //set initial extended highest sequence number
-                    participant.extendedHighestSequenceNumber = rtpHandler.getRTPPackageHeader()->getSequenceNumber();
-                    participant.initialRTPTimestamp = rtpHandler.getRTPPackageHeader()->getTimestamp();
-                    //set remote address
-                    auto remoteAddress = receivedPackage.address.toAddressAndPort();
-                    participant.setRemoteAddress(remoteAddress.first, remoteAddress.second);
-                }
-                else if(participant.payloadType != rtpHandler.getRTPPackageHeader()->getPayloadType())
-                {
-                    ohmcomm::warn("RTP") << "Invalid payload-type for remote! " << ohmcomm::endl;
-                }
-                else    //set extended highest sequence number
-                {
-                    participant.extendedHighestSequenceNumber  = calculateExtendedHighestSequenceNumber(participant, rtpHandler.getRTPPackageHeader()->getSequenceNumber());
-                }
-                participant.lastPackageReceived = std::chrono::steady_clock::now();
-                participant.totalPackages += 1;
-                participant.totalBytes += receivedPackage.getReceivedSize();
-                participant.calculateInterarrivalJitter(rtpHandler.getRTPPackageHeader()->getTimestamp(), rtpHandler.getCurrentRTPTimestamp());
-                
-                Statistics::incrementCounter(Statistics::COUNTER_PACKAGES_RECEIVED, 1);
-                Statistics::incrementCounter(Statistics::COUNTER_HEADER_BYTES_RECEIVED, headerSize);
-                Statistics::incrementCounter(Statistics::COUNTER_PAYLOAD_BYTES_RECEIVED, receivedPackage.getReceivedSize() - headerSize);
+                continue;
             }
+            packageBuffers[i] = nullptr;
+            if(buffer == nullptr)
+            {
+                //no more buffers available, drop packages of this remote
+                continue;
+            }
+            //2. write package to buffer
+            isWritten[i] = writePackage(rtpHandlers[i], receivedPackages[i], *buffer);
+        }
+    }
+    //the listeners of the participants may close the session, which locks the sessions again
+    if(sessionsLock.owns_lock())
+    {
+        sessionsLock.unlock();
+    }
+    Participant* participant = nullptr;
+    for(unsigned int i = 0; i < numPackages; ++i)
+    {
+        if(!isWritten[i])
+        {
+            continue;
+        }
+        //the packages of a remote mostly follow each other, so the participant is only looked up again on a change of the SSRC
+        if(participant != nullptr && participant->ssrc != rtpHandlers[i].getRTPPackageHeader()->getSSRC())
+        {
+            participant = nullptr;
+        }
+        updateParticipant(rtpHandlers[i], receivedPackages[i], participant);
+    }
+    //the RTCP-packages are handled last, since a BYE may remove the participant
+    for(unsigned int i = 0; i < numPackages; ++i)
+    {
+        if(packageRTCPHandlers[i] != nullptr)
+        {
+            packageRTCPHandlers[i]->handlePackage(rtpHandlers[i].getReadBuffer(), receivedPackages[i].getReceivedSize());
         }
     }
-    ohmcomm::info("RTP") << "RTP-Listener shut down" << ohmcomm::endl;
+}
+
+void RTPListener::removeIdleBuffers()
+{
+    if(sharedSocket != nullptr)
+    {
+        sharedSocket->removeIdleBuffers();
+    }
+    else
+    {
+        buffers->removeIdleBuffers();
+    }
+}
+
+static std::chrono::steady_clock::time_point getReceptionTime(const ohmcomm::network::NetworkWrapper::Package& receivedPackage)
+{
+    //the arrival-time reported by the network (e.g. the kernel), so the delay until the package is processed is not counted as jitter
+    return receivedPackage.receptionTime != std::chrono::steady_clock::time_point{} ? receivedPackage.receptionTime : std::chrono::steady_clock::now();
+}
+
+bool RTPListener::writePackage(const RTPPackageHandler& rtpHandler, const ohmcomm::network::NetworkWrapper::Package& receivedPackage, RTPBufferHandler& buffer)
+{
+    auto result = buffer.addPackage(rtpHandler, receivedPackage.getReceivedSize() - rtpHandler.getRTPHeaderSize(), getReceptionTime(receivedPackage));
+    if (result == RTPBufferStatus::RTP_BUFFER_INPUT_OVERFLOW)
+    {
+        ohmcomm::warn("RTP") << "Input Buffer overflow" << ohmcomm::endl;
+        return false;
+    }
+    else if (result == RTPBufferStatus::RTP_BUFFER_PACKAGE_TO_OLD)
+    {
+        ohmcomm::warn("RTP") << "Package was too old, discarding" << ohmcomm::endl;
+        return false;
+    }
+    return true;
+}
+
+void RTPListener::updateParticipant(const RTPPackageHandler& rtpHandler, const ohmcomm::network::NetworkWrapper::Package& receivedPackage, Participant*& participant)
+{
+    const uint8_t headerSize = rtpHandler.getRTPHeaderSize();
+    const std::chrono::steady_clock::time_point receptionTime = getReceptionTime(receivedPackage);
+    if(participant == nullptr)
+    {
+        participant = &participants.remote(rtpHandler.getRTPPackageHeader()->getSSRC());
+    }
+    //comfort-noise packages (see RFC 3389) are sent in between the audio-packages and don't determine the payload-type
+    const bool isComfortNoise = rtpHandler.getRTPPackageHeader()->getPayloadType() == PayloadType::CN;
+    //on first RTP-package from remote, set values
+    if(participant->payloadType == PayloadType::ALL)
+    {
+        if(!isComfortNoise)
+            participant->payloadType = rtpHandler.getRTPPackageHeader()->getPayloadType();
+        //set initial extended highest sequence number
+        participant->extendedHighestSequenceNumber = rtpHandler.getRTPPackageHeader()->getSequenceNumber();
+        participant->initialRTPTimestamp = rtpHandler.getRTPPackageHeader()->getTimestamp();
+        //set remote address
+        auto remoteAddress = receivedPackage.address.toAddressAndPort();
+        participant->setRemoteAddress(remoteAddress.first, remoteAddress.second);
+    }
+    else if(!isComfortNoise && participant->payloadType != rtpHandler.getRTPPackageHeader()->getPayloadType())
+    {
+        ohmcomm::warn("RTP") << "Invalid payload-type for remote! " << ohmcomm::endl;
+    }
+    else    //set extended highest sequence number
+    {
+        participant->extendedHighestSequenceNumber  = calculateExtendedHighestSequenceNumber(*participant, rtpHandler.getRTPPackageHeader()->getSequenceNumber());
+    }
+    participant->lastPackageReceived = receptionTime;
+    participant->totalPackages += 1;
+    participant->totalBytes += receivedPackage.getReceivedSize();
+    participant->calculateInterarrivalJitter(rtpHandler.getRTPPackageHeader()->getTimestamp(), rtpHandler.getRTPTimestamp(receptionTime));
+    
+    Statistics::incrementCounter(Statistics::COUNTER_PACKAGES_RECEIVED, 1);
+    Statistics::incrementCounter(Statistics::COUNTER_HEADER_BYTES_RECEIVED, headerSize);
+    Statistics::incrementCounter(Statistics::COUNTER_PAYLOAD_BYTES_RECEIVED, receivedPackage.getReceivedSize() - headerSize);
 }
 
 void RTPListener::shutdown()
 {
     // notify the thread to stop
     threadRunning = false;
+    if(eventLoop != nullptr)
+    {
+        //after this, no more callbacks are executed, so there is no need to wait
+        eventLoop->removeSocket(loopSocket);
+        eventLoop->cancelTimer(idleTimer);
+        eventLoop = nullptr;
+        ohmcomm::info("RTP") << "RTP-Listener shut down" << ohmcomm::endl;
+    }
 }
 
 uint32_t RTPListener::calculateExtendedHighestSequenceNumber(const Participant& participant, const uint16_t receivedSequenceNumber)
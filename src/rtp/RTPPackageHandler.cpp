@@ -22,6 +22,15 @@ RTPPackageHandler::~RTPPackageHandler()
 }
 
 const void* RTPPackageHandler::createNewRTPPackage(const void* audioData, unsigned int payloadSize)
+{
+    createNewRTPHeader(payloadSize);
+    // Copy audio-data in the buffer, behind the header
+    memcpy(workBuffer.data() + RTPHeader::MIN_HEADER_SIZE, audioData, payloadSize);
+
+    return workBuffer.data();
+}
+
+RTPHeader* RTPPackageHandler::createNewRTPHeader(unsigned int payloadSize)
 {
     RTPHeader newRTPHeader;
 
@@ -30,12 +39,11 @@ const void* RTPPackageHandler::createNewRTPPackage(const void* audioData, unsign
     newRTPHeader.setTimestamp(getCurrentRTPTimestamp());
     newRTPHeader.setSSRC(ourselves.ssrc);
 
-    // Copy RTPHeader and audio-data in the buffer
+    // Copy RTPHeader in the buffer
     memcpy(workBuffer.data(), &newRTPHeader, RTPHeader::MIN_HEADER_SIZE);
-    memcpy(workBuffer.data() + RTPHeader::MIN_HEADER_SIZE, audioData, payloadSize);
     actualPayloadSize = payloadSize;
 
-    return workBuffer.data();
+    return (RTPHeader*)workBuffer.data();
 }
 
 const void* RTPPackageHandler::getRTPPackageData() const
@@ -123,12 +131,26 @@ void RTPPackageHandler::createSilencePackage()
     actualPayloadSize = maximumPayloadSize;
 }
 
+void RTPPackageHandler::createComfortNoisePackage(const void* noiseParameters, unsigned int parametersSize)
+{
+    RTPHeader noiseHeader;
+    noiseHeader.setPayloadType(PayloadType::CN);
+    memcpy(workBuffer.data(), &noiseHeader, RTPHeader::MIN_HEADER_SIZE);
+    memcpy(workBuffer.data() + RTPHeader::MIN_HEADER_SIZE, noiseParameters, parametersSize);
+    actualPayloadSize = parametersSize;
+}
+
 uint32_t RTPPackageHandler::getCurrentRTPTimestamp() const
 {
     //we need steady clock so it will always change monotonically (etc. no change to/from daylight savings time)
-    //additionally, we need to count with milliseconds precision
+    return getRTPTimestamp(std::chrono::steady_clock::now());
+}
+
+uint32_t RTPPackageHandler::getRTPTimestamp(const std::chrono::steady_clock::time_point time) const
+{
+    //we need to count with milliseconds precision
     //we add the random starting timestamp to meet the condition specified in the RTP standard
-    return initialTimestamp + std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    return initialTimestamp + std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
 }
 
 bool RTPPackageHandler::isRTPPackage(const void* packageBuffer, unsigned int packageLength)
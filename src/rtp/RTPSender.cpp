@@ -0,0 +1,107 @@
+/*
+ * File:   RTPSender.cpp
+ */
+
+#include <cstring>
+
+#include "Logger.h"
+#include "rtp/RTPHeader.h"
+#include "rtp/RTPSender.h"
+#include "Statistics.h"
+
+using namespace ohmcomm::rtp;
+
+constexpr uint32_t RTPSender::QUEUE_CAPACITY;
+constexpr std::chrono::milliseconds RTPSender::WAIT_TIMEOUT;
+
+RTPSender::RTPSender(std::shared_ptr<ohmcomm::network::NetworkWrapper> wrapper, unsigned int maxPayloadSize) :
+    wrapper(wrapper), maxPayloadSize(maxPayloadSize), slotSize(RTPHeader::MAX_HEADER_SIZE + maxPayloadSize), packageData(QUEUE_CAPACITY * slotSize),
+    headerSizes(QUEUE_CAPACITY, 0), payloadSizes(QUEUE_CAPACITY, 0),
+    writeIndex(0), readIndex(0), sendThread(), threadRunning(false), waitMutex(), packageAvailable()
+{
+}
+
+RTPSender::~RTPSender()
+{
+    shutdown();
+}
+
+bool RTPSender::enqueuePackage(const void* header, const unsigned int headerSize, const void* payload, const unsigned int payloadSize)
+{
+    const uint32_t write = writeIndex.load(std::memory_order_relaxed);
+    const uint32_t queueSize = write - readIndex.load(std::memory_order_acquire);
+    if(queueSize >= QUEUE_CAPACITY || headerSize > RTPHeader::MAX_HEADER_SIZE || payloadSize > maxPayloadSize)
+    {
+        Statistics::incrementCounter(Statistics::RTP_SEND_QUEUE_DROPPED, 1);
+        return false;
+    }
+    const uint32_t slot = write & (QUEUE_CAPACITY - 1);
+    char* slotData = packageData.data() + slot * slotSize;
+    std::memcpy(slotData, header, headerSize);
+    std::memcpy(slotData + RTPHeader::MAX_HEADER_SIZE, payload, payloadSize);
+    headerSizes[slot] = headerSize;
+    payloadSizes[slot] = payloadSize;
+    //publishes the slot to the sending-thread
+    writeIndex.store(write + 1, std::memory_order_release);
+    Statistics::maxCounter(Statistics::RTP_SEND_QUEUE_MAXIMUM_DEPTH, queueSize + 1);
+    //does not block, the sending-thread may miss the notification at most until its wait times out
+    packageAvailable.notify_one();
+    return true;
+}
+
+unsigned int RTPSender::getQueueSize() const
+{
+    return writeIndex.load(std::memory_order_acquire) - readIndex.load(std::memory_order_acquire);
+}
+
+void RTPSender::startUp()
+{
+    if(!threadRunning)
+    {
+        threadRunning = true;
+        sendThread = std::thread(&RTPSender::runThread, this);
+    }
+}
+
+void RTPSender::shutdown()
+{
+    threadRunning = false;
+    packageAvailable.notify_one();
+    if(sendThread.joinable())
+    {
+        sendThread.join();
+    }
+}
+
+void RTPSender::runThread()
+{
+    ohmcomm::info("RTP") << "RTP-Sender started ..." << ohmcomm::endl;
+    while(true)
+    {
+        const uint32_t read = readIndex.load(std::memory_order_relaxed);
+        if(read == writeIndex.load(std::memory_order_acquire))
+        {
+            //send all queued packages before shutting down
+            if(!threadRunning)
+            {
+                break;
+            }
+            std::unique_lock<std::mutex> lock(waitMutex);
+            packageAvailable.wait_for(lock, WAIT_TIMEOUT, [this, read]() -> bool
+            {
+                return read != writeIndex.load(std::memory_order_acquire) || !threadRunning;
+            });
+            continue;
+        }
+        const uint32_t slot = read & (QUEUE_CAPACITY - 1);
+        const char* slotData = packageData.data() + slot * slotSize;
+        const ohmcomm::network::NetworkWrapper::BufferSegment segments[2] = {
+            {slotData, headerSizes[slot]},
+            {slotData + RTPHeader::MAX_HEADER_SIZE, payloadSizes[slot]}
+        };
+        wrapper->sendData(segments, 2);
+        //releases the slot to the audio-thread
+        readIndex.store(read + 1, std::memory_order_release);
+    }
+    ohmcomm::info("RTP") << "RTP-Sender shut down" << ohmcomm::endl;
+}
@@ -0,0 +1,178 @@
+/*
+ * File:   SharedMediaSocket.cpp
+ */
+
+#include <algorithm>
+
+#include "Logger.h"
+#include "network/IOUringUDPWrapper.h"
+#include "rtp/JitterBuffers.h"
+#include "rtp/RTPListener.h"
+#include "rtp/SharedMediaSocket.h"
+
+using namespace ohmcomm::rtp;
+
+SharedMediaSocket::Session::Session(const std::shared_ptr<SharedMediaSocket> socket, const ohmcomm::network::SocketAddress& remoteAddress) :
+    socket(socket), remoteAddress(remoteAddress), buffers(nullptr), rtcpHandler(nullptr), isOpen(true)
+{
+}
+
+SharedMediaSocket::Session::~Session()
+{
+    closeNetwork();
+}
+
+int SharedMediaSocket::Session::sendData(const void* buffer, const unsigned int bufferSize)
+{
+    const BufferSegment segment{buffer, bufferSize};
+    return sendData(&segment, 1);
+}
+
+int SharedMediaSocket::Session::sendData(const BufferSegment* segments, const unsigned int numSegments)
+{
+    return socket->wrapper->sendDataTo(remoteAddress, segments, numSegments);
+}
+
+ohmcomm::network::NetworkWrapper::Package SharedMediaSocket::Session::receiveData(void* buffer, unsigned int bufferSize)
+{
+    Package package{};
+    package.status = INVALID_SOCKET;
+    return package;
+}
+
+void SharedMediaSocket::Session::closeNetwork()
+{
+    socket->removeSession(this);
+}
+
+void SharedMediaSocket::Session::startReceiving(JitterBuffers& buffers, RTCPHandler* rtcpHandler)
+{
+    std::lock_guard<std::mutex> guard(socket->sessionsMutex);
+    this->buffers = &buffers;
+    this->rtcpHandler = rtcpHandler;
+}
+
+const ohmcomm::network::SocketAddress& SharedMediaSocket::Session::getRemoteAddress() const
+{
+    return remoteAddress;
+}
+
+ohmcomm::network::EventLoop* SharedMediaSocket::Session::getEventLoop() const
+{
+    return socket->listener->eventLoop;
+}
+
+static ohmcomm::network::UDPWrapper* createWrapper(const unsigned short localPort, const bool isIPv6, const bool reusePort)
+{
+    const ohmcomm::NetworkConfiguration config{localPort, isIPv6 ? "::" : "0.0.0.0", 0};
+#ifdef IO_URING_HEADER
+    //the sockets sharing a port are steered by their socket-descriptor, which is hidden behind the ring
+    if(!reusePort)
+    {
+        return new ohmcomm::network::IOUringUDPWrapper(config);
+    }
+#endif
+    return new ohmcomm::network::UDPWrapper(config, reusePort);
+}
+
+std::shared_ptr<SharedMediaSocket> SharedMediaSocket::create(const unsigned short localPort, const bool isIPv6, const unsigned int maxPayloadSize)
+{
+    return std::shared_ptr<SharedMediaSocket>(new SharedMediaSocket(localPort, isIPv6, maxPayloadSize));
+}
+
+SharedMediaSocket::SharedMediaSocket(const unsigned short localPort, const bool isIPv6, const unsigned int maxPayloadSize, const bool reusePort, ohmcomm::network::EventLoop* eventLoop) :
+    wrapper(createWrapper(localPort, isIPv6, reusePort)), listener(), sessionsMutex(), sessions(), sessionsBySSRC()
+{
+    listener.reset(new RTPListener(*this, wrapper, maxPayloadSize));
+    listener->startUp(eventLoop);
+    ohmcomm::info("RTP") << "Sharing local port " << localPort << " for all sessions" << ohmcomm::endl;
+}
+
+SharedMediaSocket::~SharedMediaSocket()
+{
+    stopReceiving();
+    //unblocks the receive-thread, if the socket is not watched by an event-loop
+    wrapper->closeNetwork();
+    listener.reset();
+}
+
+std::shared_ptr<SharedMediaSocket::Session> SharedMediaSocket::openSession(const std::string& remoteIPAddress, const unsigned short remotePort)
+{
+    std::shared_ptr<Session> session(new Session(shared_from_this(), ohmcomm::network::SocketAddress::fromAddressAndPort(remoteIPAddress, remotePort)));
+    std::lock_guard<std::mutex> guard(sessionsMutex);
+    sessions.push_back(session.get());
+    return session;
+}
+
+unsigned int SharedMediaSocket::getNumberOfSessions() const
+{
+    std::lock_guard<std::mutex> guard(sessionsMutex);
+    return sessions.size();
+}
+
+bool SharedMediaSocket::setSocketOptions(const SocketOptions& options)
+{
+    return wrapper->setSocketOptions(options);
+}
+
+SharedMediaSocket::Session* SharedMediaSocket::findSession(const uint32_t ssrc, const ohmcomm::network::SocketAddress& address)
+{
+    const auto it = sessionsBySSRC.find(ssrc);
+    if(it != sessionsBySSRC.end() && it->second->remoteAddress == address)
+    {
+        return it->second;
+    }
+    //first package of this SSRC (or the SSRC is also used by another remote)
+    for(Session* session : sessions)
+    {
+        if(session->remoteAddress == address)
+        {
+            if(it == sessionsBySSRC.end())
+            {
+                sessionsBySSRC[ssrc] = session;
+            }
+            return session;
+        }
+    }
+    return nullptr;
+}
+
+void SharedMediaSocket::removeIdleBuffers()
+{
+    std::lock_guard<std::mutex> guard(sessionsMutex);
+    for(Session* session : sessions)
+    {
+        if(session->buffers != nullptr)
+        {
+            session->buffers->removeIdleBuffers();
+        }
+    }
+}
+
+void SharedMediaSocket::removeSession(Session* session)
+{
+    //after this, no more packages are written into the buffers of the session
+    std::lock_guard<std::mutex> guard(sessionsMutex);
+    if(!session->isOpen)
+    {
+        return;
+    }
+    session->isOpen = false;
+    sessions.erase(std::remove(sessions.begin(), sessions.end(), session), sessions.end());
+    for(auto it = sessionsBySSRC.begin(); it != sessionsBySSRC.end();)
+    {
+        if(it->second == session)
+        {
+            it = sessionsBySSRC.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void SharedMediaSocket::stopReceiving()
+{
+    listener->shutdown();
+}
@@ -26,6 +26,7 @@ constexpr char SessionDescription::SDP_ATTRIBUTE;
 const std::string SessionDescription::SDP_ATTRIBUTE_RTPMAP("rtpmap");
 const std::string SessionDescription::SDP_ATTRIBUTE_FMTP("fmtp");
 const std::string SessionDescription::SDP_ATTRIBUTE_RTCP("rtcp");
+const std::string SessionDescription::SDP_ATTRIBUTE_RTCP_MUX("rtcp-mux");
 const std::string SessionDescription::SDP_ATTRIBUTE_CRYPTO("crypto");
 const std::string SessionDescription::SDP_MEDIA_RTP("RTP/AVP");
 const std::string SessionDescription::SDP_MEDIA_SRTP("RTP/SAVP");
@@ -34,7 +35,7 @@ SDPMessageHandler::SDPMessageHandler()
 {
 }
 
-std::string SDPMessageHandler::createSessionDescription(const std::string& localUserName, const ohmcomm::NetworkConfiguration& config, const std::vector<MediaDescription>& media, const std::shared_ptr<ohmcomm::crypto::CryptographicContext> cryptoContext)
+std::string SDPMessageHandler::createSessionDescription(const std::string& localUserName, const ohmcomm::NetworkConfiguration& config, const std::vector<MediaDescription>& media, const std::shared_ptr<ohmcomm::crypto::CryptographicContext> cryptoContext, const bool rtcpMultiplexing)
 {
     ohmcomm::rtp::NTPTimestamp now = ohmcomm::rtp::NTPTimestamp::now();
     std::string localIP = Utility::getLocalIPAddress(Utility::getNetworkType(config.remoteIPAddress));
@@ -167,6 +168,11 @@ std::string SDPMessageHandler::createSessionDescription(const std::string& local
             }
         }
     }
+    //a=rtcp-mux RTP and RTCP are sent and received on the same port (RFC 5761), an answer only contains it, if the offer did
+    if(rtcpMultiplexing)
+    {
+        lines.push_back(std::string("a=").append(SessionDescription::SDP_ATTRIBUTE_RTCP_MUX));
+    }
     //a=recvonly This specifies that the tools should be started in receive-only mode where applicable
     //a=sendrecv This specifies that the tools should be started in send and receive mode
     //a=sendonly This specifies that the tools should be started in send-only mode
@@ -344,6 +350,12 @@ ohmcomm::NetworkConfiguration SDPMessageHandler::readRTCPAttribute(const Session
     return config;
 }
 
+bool SDPMessageHandler::isRTCPMultiplexed(const SessionDescription& sdp)
+{
+    //a=rtcp-mux
+    return !sdp.getAttribute(SessionDescription::SDP_ATTRIBUTE_RTCP_MUX).empty();
+}
+
 void SDPMessageHandler::checkSessionDescription(const SessionDescription* sdp)
 {
     if(sdp == nullptr)
@@ -120,7 +120,8 @@ void SIPConfiguration::setConfig(const MediaDescription& media, const ohmcomm::N
     networkConfig.remotePort = media.port;
     //RTCP-config
     //allows for custom remote RTCP port (and address), see RFC 3605
-    rtcpConfig.localPort = networkConfig.localPort + 1;
+    //or for RTCP on the RTP-port, see RFC 5761
+    rtcpConfig.localPort = customRTCPConfig.localPort != 0 ? customRTCPConfig.localPort : networkConfig.localPort + 1;
     rtcpConfig.remotePort = networkConfig.remotePort + 1;
     rtcpConfig.remoteIPAddress = networkConfig.remoteIPAddress;
     if(customRTCPConfig.remotePort != 0)
@@ -21,8 +21,15 @@ SIPHandler::SIPHandler(const ohmcomm::NetworkConfiguration& sipConfig, const std
 
 SIPHandler::~SIPHandler()
 {
+    {
+        //the remaining call-tasks are still executed
+        std::lock_guard<std::mutex> guard(callMutex);
+        runsCallTasks = false;
+    }
+    callCondition.notify_one();
     // Wait until thread has really stopped
-    sipThread.join();
+    if(sipThread.joinable())
+        sipThread.join();
 }
 
 void SIPHandler::setRegisterWithServer(const std::string& registerUser, const std::string& registerPassword)
@@ -35,6 +42,26 @@ void SIPHandler::setRegisterWithServer(const std::string& registerUser, const st
 void SIPHandler::startUp()
 {
     threadRunning = true;
+    //any answer is queued by the socket until it is watched
+    startSession();
+    const int socket = network->getSocketDescriptor();
+    if(ohmcomm::network::EventLoop::isSupported() && socket != INVALID_SOCKET)
+    {
+        //set before the socket is watched, in case the first package already shuts down the session
+        eventLoop = &ohmcomm::network::EventLoop::getSharedLoop();
+        loopSocket = socket;
+        authenticationTimer = eventLoop->addTimer(std::chrono::seconds(1), [this]() { refreshAuthentication(); });
+        //the tasks queued by the first packages are run, once the thread is started
+        runsCallTasks = true;
+        if(eventLoop->addSocket(socket, [this]() { receivePackage(); }))
+        {
+            sipThread = std::thread(&SIPHandler::runCallTasks, this);
+            return;
+        }
+        runsCallTasks = false;
+        eventLoop->cancelTimer(authenticationTimer);
+        eventLoop = nullptr;
+    }
     sipThread = std::thread(&SIPHandler::runThread, this);
 }
 
@@ -69,12 +96,69 @@ void SIPHandler::shutdownInternal()
 {
     // notify the thread to stop
     threadRunning = false;
+    if(eventLoop != nullptr)
+    {
+        //the socket must be removed before it is closed
+        eventLoop->removeSocket(loopSocket);
+        eventLoop->cancelTimer(authenticationTimer);
+        eventLoop = nullptr;
+        endSession();
+    }
     state = SessionState::SHUTDOWN;
     // close the socket
     network->closeNetwork();
 }
 
 void SIPHandler::runThread()
+{
+    while (threadRunning)
+    {
+        receivePackage();
+        refreshAuthentication();
+    }
+    endSession();
+}
+
+void SIPHandler::runCallTasks()
+{
+    std::unique_lock<std::mutex> lock(callMutex);
+    while(runsCallTasks || !callTasks.empty())
+    {
+        if(callTasks.empty())
+        {
+            callCondition.wait(lock);
+            continue;
+        }
+        const std::function<void()> task = callTasks.front();
+        callTasks.pop_front();
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+}
+
+void SIPHandler::runCallTask(const std::function<void()>& task)
+{
+    {
+        std::lock_guard<std::mutex> guard(callMutex);
+        if(runsCallTasks)
+        {
+            callTasks.push_back(task);
+            callCondition.notify_one();
+            return;
+        }
+    }
+    //without an event-loop, the task is run in the calling thread
+    task();
+}
+
+void SIPHandler::onRemoteRemoved(const unsigned int ssrc)
+{
+    //the last remote may be removed by a callback of the loop of the media-session
+    runCallTask([this, ssrc]() { SIPSession::onRemoteRemoved(ssrc); });
+}
+
+void SIPHandler::startSession()
 {
     ohmcomm::rtp::ParticipantDatabase::registerListener(*this);
     ohmcomm::info("SIP") << "SIP-Handler started ..." << ohmcomm::endl;
@@ -97,40 +181,48 @@ void SIPHandler::runThread()
         //doesn't really matter, if we are the first to start, the other side won't receive our INVITE, otherwise we INVITE
         sendInviteRequest(userAgents.getRemoteUA());
     }
+}
 
-    while (threadRunning)
+void SIPHandler::receivePackage()
+{
+    //wait for package and store it in the SIPPackageHandler
+    const ohmcomm::network::NetworkWrapper::Package result = network->receiveData(buffer.data(), buffer.size());
+    if (threadRunning == false || result.isInvalidSocket())
     {
-        //wait for package and store it in the SIPPackageHandler
-        const ohmcomm::network::NetworkWrapper::Package result = network->receiveData(buffer.data(), buffer.size());
-        if (threadRunning == false || result.isInvalidSocket())
-        {
-            //socket was already closed
-            shutdownInternal();
-        }
-        else if (result.hasTimedOut())
-        {
-            //just continue to next loop iteration, checking if thread should continue running
-        }
-        else if (SIPPackageHandler::isRequestPackage(buffer.data(), result.getReceivedSize()))
-        {
-            handleSIPRequest(buffer.data(), result.getReceivedSize(), result);
-        }
-        else if (SIPPackageHandler::isResponsePackage(buffer.data(), result.getReceivedSize()))
-        {
-            handleSIPResponse(buffer.data(), result.getReceivedSize(), result);
-        }
-        if(authentication && authentication->getExpirationTime() - std::chrono::system_clock::now() < std::chrono::seconds(15))
+        //socket was already closed
+        shutdownInternal();
+    }
+    else if (result.hasTimedOut())
+    {
+        //just continue to next loop iteration, checking if thread should continue running
+    }
+    else if (SIPPackageHandler::isRequestPackage(buffer.data(), result.getReceivedSize()))
+    {
+        handleSIPRequest(buffer.data(), result.getReceivedSize(), result);
+    }
+    else if (SIPPackageHandler::isResponsePackage(buffer.data(), result.getReceivedSize()))
+    {
+        handleSIPResponse(buffer.data(), result.getReceivedSize(), result);
+    }
+}
+
+void SIPHandler::refreshAuthentication()
+{
+    if(threadRunning && authentication && authentication->getExpirationTime() - std::chrono::system_clock::now() < std::chrono::seconds(15))
+    {
+        //refresh authentication 15 seconds before it expires (should be enough time)
+        if(!currentRequest || dynamic_cast<REGISTERRequest*>(currentRequest.get()) == nullptr)
         {
-            //refresh authentication 15 seconds before it expires (should be enough time)
-            if(!currentRequest || dynamic_cast<REGISTERRequest*>(currentRequest.get()) == nullptr)
-            {
-                //only if we are not currently trying to authenticate
-                //otherwise, the refreshing could be initiated several times
-                ohmcomm::info("SIP") << "Refreshing registration ..." << ohmcomm::endl;
-                sendRegisterRequest(userAgents.getRemoteUA());
-            }
+            //only if we are not currently trying to authenticate
+            //otherwise, the refreshing could be initiated several times
+            ohmcomm::info("SIP") << "Refreshing registration ..." << ohmcomm::endl;
+            sendRegisterRequest(userAgents.getRemoteUA());
         }
     }
+}
+
+void SIPHandler::endSession()
+{
     state = SessionState::SHUTDOWN;
     ohmcomm::info("SIP") << "SIP-Handler shut down!" << ohmcomm::endl;
     ohmcomm::rtp::ParticipantDatabase::unregisterListener(*this);
@@ -294,7 +386,7 @@ void SIPHandler::handleBYERequest(const ohmcomm::network::NetworkWrapper::Packag
     userAgents.removeRemoteUA(remoteUA.tag);
     //end communication, if established
     shutdownInternal();
-    stopCallback();
+    runCallTask(stopCallback);
 }
 
 void SIPHandler::handleCANCELRequest(const ohmcomm::network::NetworkWrapper::Package& packageInfo, const SIPRequestHeader& requestHeader, const std::string& requestBody, SIPUserAgent& remoteUA)
@@ -313,7 +405,7 @@ void SIPHandler::handleCANCELRequest(const ohmcomm::network::NetworkWrapper::Pac
         {
             //our initial call failed, shut down
             shutdownInternal();
-            stopCallback();
+            runCallTask(stopCallback);
         }
     }
 }
@@ -553,11 +645,29 @@ void SIPHandler::updateNetworkConfig(const SIPHeader* header, const ohmcomm::net
         //reset network-wrapper to send new packages to correct address
         sipConfig.remoteIPAddress = remoteUA.ipAddress;
         sipConfig.remotePort = remoteUA.port;
+        if(eventLoop != nullptr)
+        {
+            //the socket must be removed before it is closed
+            eventLoop->removeSocket(loopSocket);
+        }
         network->closeNetwork();
         ohmcomm::info("SIP") << "Connecting to: " << sipConfig.remoteIPAddress << ':' << sipConfig.remotePort << ohmcomm::endl;
-        //wait for socket to be closed
-        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        if(eventLoop == nullptr)
+        {
+            //wait for socket to be closed
+            //an event-loop must not be stalled, the port of a closed UDP-socket can be bound again immediately
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        }
         network.reset(new ohmcomm::network::UDPWrapper(sipConfig));
+        if(eventLoop != nullptr)
+        {
+            //we are running in the callback of the old socket, so the loop is not waited for
+            loopSocket = network->getSocketDescriptor();
+            if(!eventLoop->addSocket(loopSocket, [this]() { receivePackage(); }))
+            {
+                ohmcomm::error("SIP") << "Failed to watch the new socket" << ohmcomm::endl;
+            }
+        }
         
         //update all configuration-dependant values
         userAgents.thisUA.ipAddress = ohmcomm::Utility::getLocalIPAddress(ohmcomm::Utility::getNetworkType(sipConfig.remoteIPAddress));
@@ -581,5 +691,5 @@ void SIPHandler::startCommunication(const MediaDescription& descr, const ohmcomm
             ohmcomm::info("SIP") << "Using custom remote RTCP port: " << rtcpConfig.remotePort << ohmcomm::endl;
         }
     }
-    addUserFunction(descr, rtpConfig, rtcpConfig);
+    runCallTask([this, descr, rtpConfig, rtcpConfig]() { addUserFunction(descr, rtpConfig, rtcpConfig); });
 }
\ No newline at end of file
@@ -16,6 +16,22 @@
 
 using namespace ohmcomm::sip;
 
+//reads the custom RTCP-configuration (RFC 3605) and whether RTCP is multiplexed with RTP on the same port (RFC 5761)
+static ohmcomm::NetworkConfiguration readRTCPConfiguration(const SessionDescription& sdp, const ohmcomm::NetworkConfiguration& rtpConfig)
+{
+    ohmcomm::NetworkConfiguration rtcpConfig = SDPMessageHandler::readRTCPAttribute(sdp);
+    if(SDPMessageHandler::isRTCPMultiplexed(sdp))
+    {
+        ohmcomm::info("SIP") << "Multiplexing RTP and RTCP on a single port" << ohmcomm::endl;
+        rtcpConfig.localPort = rtpConfig.localPort;
+        if(rtcpConfig.remotePort == 0)
+        {
+            rtcpConfig.remotePort = rtpConfig.remotePort;
+        }
+    }
+    return rtcpConfig;
+}
+
 void ohmcomm::sip::initializeSIPHeaderFields(const std::string& requestMethod, SIPHeader& header, const SIPRequestHeader* requestHeader, const SIPUserAgent& localUA, SIPUserAgent& remoteUA, const unsigned short localPort)
 {
     //mandatory header-fields:
@@ -548,7 +564,7 @@ bool INVITERequest::handleResponse(const ohmcomm::network::SocketAddress& source
     ohmcomm::info("SIP") << "Our INVITE was accepted, initializing communication" << ohmcomm::endl;
 
     //start communication
-    connectCallback(selectedMedias[mediaIndex], rtpConfig, SDPMessageHandler::readRTCPAttribute(sdp));
+    connectCallback(selectedMedias[mediaIndex], rtpConfig, readRTCPConfiguration(sdp, rtpConfig));
     state = SIPSession::SessionState::ESTABLISHED;
     return true;
 }
@@ -617,14 +633,15 @@ bool INVITERequest::handleRequest(const std::string& request_body)
     rtpConfig.remoteIPAddress = sdp.getConnectionAddress();
     rtpConfig.localPort = DEFAULT_NETWORK_PORT;
     rtpConfig.remotePort = availableMedias[bestMediaIndex].port;
-    const std::string messageBody = SDPMessageHandler::createSessionDescription(thisUA.userName, rtpConfig, {availableMedias[bestMediaIndex]});
+    //only accept multiplexing RTP and RTCP, if offered
+    const std::string messageBody = SDPMessageHandler::createSessionDescription(thisUA.userName, rtpConfig, {availableMedias[bestMediaIndex]}, nullptr, SDPMessageHandler::isRTCPMultiplexed(sdp));
     const std::string message = SIPPackageHandler::createResponsePackage(responseHeader, messageBody);
 
     ohmcomm::info("SIP") << "Accepting INVITE from " << requestHeader[SIP_HEADER_CONTACT] << ohmcomm::endl;
     network->sendData(message.data(), message.size());
 
     //start communication
-    connectCallback(availableMedias[bestMediaIndex], rtpConfig, SDPMessageHandler::readRTCPAttribute(sdp));
+    connectCallback(availableMedias[bestMediaIndex], rtpConfig, readRTCPConfiguration(sdp, rtpConfig));
     state = SIPSession::SessionState::ESTABLISHED;
     return true;
 }
@@ -5,10 +5,51 @@
  * Created on September 23, 2015, 5:26 PM
  */
 
+#include <algorithm>
+#include <cmath>
+
 #include "TestAudioProcessors.h"
+#include "codecs/g711common.h"
+#include "processors/AudioMixer.h"
+#include "processors/ProcessorManager.h"
 
 using namespace ohmcomm;
 
+/*!
+ * Provides a constant A-law encoded (or uncoded 16-bit) value per stream, like the RTP-processor provides one stream per remote
+ */
+class MultiStreamSource : public AudioProcessor
+{
+public:
+    //the values of the streams, a stream with value zero is underflowing
+    std::vector<int16_t> streamValues;
+    const bool isEncoded;
+
+    MultiStreamSource(const bool isEncoded = true) : AudioProcessor("Multi-Stream Source"), streamValues(), isEncoded(isEncoded)
+    {
+    }
+
+    unsigned int processInputData(void* inputBuffer, const unsigned int inputBufferByteSize, StreamData* userData) override
+    {
+        return inputBufferByteSize;
+    }
+
+    unsigned int processOutputData(void* outputBuffer, const unsigned int outputBufferByteSize, StreamData* userData) override
+    {
+        userData->numStreams = streamValues.size();
+        userData->streamId = 100 + userData->streamIndex;
+        const int16_t value = streamValues[userData->streamIndex];
+        userData->isSilentPackage = value == 0;
+        if(!isEncoded)
+        {
+            std::fill((int16_t*)outputBuffer, (int16_t*)outputBuffer + userData->nBufferFrames, value);
+            return userData->nBufferFrames * sizeof(int16_t);
+        }
+        std::fill((uint8_t*)outputBuffer, (uint8_t*)outputBuffer + userData->nBufferFrames, s16_to_alaw(value));
+        return userData->nBufferFrames;
+    }
+};
+
 TestAudioProcessors::TestAudioProcessors()
 {
 #ifdef OPUS_HEADER
@@ -20,6 +61,13 @@ TestAudioProcessors::TestAudioProcessors()
 #ifdef ILBC_HEADER
     TEST_ADD_WITH_STRING(TestAudioProcessors::testAudioProcessorConfiguration, AudioProcessorFactory::ILBC_CODEC);
 #endif
+    TEST_ADD_WITH_STRING(TestAudioProcessors::testAudioProcessorConfiguration, AudioProcessorFactory::LOSS_CONCEALMENT);
+    TEST_ADD(TestAudioProcessors::testPacketLossConcealment);
+    TEST_ADD_WITH_STRING(TestAudioProcessors::testAudioProcessorConfiguration, AudioProcessorFactory::COMFORT_NOISE);
+    TEST_ADD(TestAudioProcessors::testComfortNoise);
+    TEST_ADD(TestAudioProcessors::testAudioMixer);
+    TEST_ADD(TestAudioProcessors::testMixingStreams);
+    TEST_ADD(TestAudioProcessors::testMixingUncodedStreams);
 }
 
 void TestAudioProcessors::testAudioProcessorConfiguration(const std::string processorName)
@@ -45,6 +93,242 @@ void TestAudioProcessors::testAudioProcessorConfiguration(const std::string proc
     delete proc;
 }
 
+void TestAudioProcessors::testPacketLossConcealment()
+{
+    //a 200 Hz sine with 20ms packages at 48 kHz
+    const unsigned int sampleRate = 48000;
+    const unsigned int numFrames = 960;
+    const double frequency = 200;
+    AudioConfiguration audioConfig{};
+    audioConfig.outputDeviceChannels = 1;
+    audioConfig.audioFormatFlag = AudioConfiguration::AUDIO_FORMAT_SINT16;
+    audioConfig.sampleRate = sampleRate;
+    audioConfig.framesPerPackage = numFrames;
+    AudioProcessor* proc = AudioProcessorFactory::getAudioProcessor(AudioProcessorFactory::LOSS_CONCEALMENT, false);
+    proc->configure(audioConfig, nullptr, numFrames * sizeof(int16_t), ProcessorCapabilities{});
+
+    std::vector<int16_t> buffer(numFrames);
+    StreamData streamData{numFrames, 0, numFrames * sizeof(int16_t), false};
+    unsigned int frameIndex = 0;
+    for(unsigned int p = 0; p < 3; ++p)
+    {
+        for(unsigned int i = 0; i < numFrames; ++i, ++frameIndex)
+        {
+            buffer[i] = (int16_t)(10000 * std::sin(2 * M_PI * frequency * frameIndex / sampleRate));
+        }
+        streamData.isSilentPackage = false;
+        proc->processOutputData(buffer.data(), buffer.size() * sizeof(int16_t), &streamData);
+    }
+
+    //the first 10ms of the lost package should continue the sine
+    std::fill(buffer.begin(), buffer.end(), 0);
+    streamData.isSilentPackage = true;
+    proc->processOutputData(buffer.data(), buffer.size() * sizeof(int16_t), &streamData);
+    TEST_ASSERT_MSG(!streamData.isSilentPackage, "Lost package was not concealed");
+    double maxError = 0;
+    for(unsigned int i = 0; i < sampleRate / 100; ++i)
+    {
+        const double expected = 10000 * std::sin(2 * M_PI * frequency * (frameIndex + i) / sampleRate);
+        maxError = std::max(maxError, std::abs(expected - buffer[i]));
+    }
+    TEST_ASSERT_MSG(maxError < 500, "Concealed audio does not continue the signal");
+
+    //after 60ms of loss, the concealed audio is faded out
+    for(unsigned int p = 0; p < 3; ++p)
+    {
+        streamData.isSilentPackage = true;
+        proc->processOutputData(buffer.data(), buffer.size() * sizeof(int16_t), &streamData);
+    }
+    TEST_ASSERT_MSG(streamData.isSilentPackage, "Concealed audio is not faded out");
+    TEST_ASSERT_EQUALS(0, buffer[numFrames - 1]);
+    delete proc;
+}
+
+void TestAudioProcessors::testComfortNoise()
+{
+    const unsigned int numFrames = 960;
+    AudioConfiguration audioConfig{};
+    audioConfig.inputDeviceChannels = 1;
+    audioConfig.outputDeviceChannels = 2;
+    audioConfig.audioFormatFlag = AudioConfiguration::AUDIO_FORMAT_SINT16;
+    audioConfig.sampleRate = 48000;
+    audioConfig.framesPerPackage = numFrames;
+    AudioProcessor* proc = AudioProcessorFactory::getAudioProcessor(AudioProcessorFactory::COMFORT_NOISE, false);
+    proc->configure(audioConfig, nullptr, numFrames * sizeof(int16_t), ProcessorCapabilities{});
+
+    //background-noise with a level of about -40 dBov
+    std::vector<int16_t> buffer(numFrames * 2);
+    uint32_t random = 12345;
+    for(unsigned int i = 0; i < numFrames; ++i)
+    {
+        random = random * 1103515245 + 12345;
+        buffer[i] = (int16_t)((int)((random >> 16) % 1135) - 567);
+    }
+    StreamData streamData{numFrames, 0, (unsigned int)(buffer.size() * sizeof(int16_t)), true};
+    proc->processInputData(buffer.data(), numFrames * sizeof(int16_t), &streamData);
+    TEST_ASSERT_EQUALS(11, streamData.comfortNoiseSize);
+    TEST_ASSERT_MSG(streamData.comfortNoise[0] >= 39 && streamData.comfortNoise[0] <= 41, "Wrong noise-level calculated");
+
+    //synthesize the noise from the parameters, writing the whole (stereo) output-buffer
+    std::fill(buffer.begin(), buffer.end(), 0);
+    const unsigned int outputSize = proc->processOutputData(buffer.data(), 4, &streamData);
+    TEST_ASSERT_EQUALS(buffer.size() * sizeof(int16_t), outputSize);
+    TEST_ASSERT(!streamData.isSilentPackage);
+    double energy = 0;
+    for(unsigned int i = 0; i < numFrames; ++i)
+    {
+        TEST_ASSERT_EQUALS(buffer[2 * i], buffer[2 * i + 1]);
+        energy += buffer[2 * i] * (double)buffer[2 * i];
+    }
+    const double level = -10 * std::log10(energy / numFrames / (32768.0 * 32768.0));
+    TEST_ASSERT_MSG(level > 37 && level < 43, "Comfort noise has wrong level");
+    delete proc;
+}
+
+void TestAudioProcessors::testAudioMixer()
+{
+    //odd number of samples, to test the tail not processed with SIMD
+    const unsigned int numSamples = 21;
+    AudioMixer mixer;
+    TEST_ASSERT(!mixer.configure(AudioConfiguration::AUDIO_FORMAT_SINT24, numSamples * 3));
+    TEST_ASSERT(mixer.configure(AudioConfiguration::AUDIO_FORMAT_SINT16, numSamples * sizeof(int16_t)));
+
+    std::vector<int16_t> first(numSamples, 20000);
+    std::vector<int16_t> second(numSamples, -5000);
+    std::vector<int16_t> result(numSamples, 0);
+    //the second stream is longer, the additional samples are taken as they are
+    first[numSamples - 1] = 0;
+    mixer.startMix();
+    mixer.addStream(first.data(), (numSamples - 1) * sizeof(int16_t));
+    mixer.addStream(second.data(), numSamples * sizeof(int16_t));
+    mixer.addStream(first.data(), (numSamples - 1) * sizeof(int16_t));
+    TEST_ASSERT_EQUALS(3u, mixer.getNumberOfStreams());
+    TEST_ASSERT_EQUALS(numSamples * sizeof(int16_t), mixer.writeMix(result.data(), numSamples * sizeof(int16_t)));
+    for(unsigned int i = 0; i < numSamples - 1; ++i)
+    {
+        //the sum is saturated, independent of the order of the streams
+        TEST_ASSERT_EQUALS(32767, result[i]);
+    }
+    TEST_ASSERT_EQUALS(-5000, result[numSamples - 1]);
+
+    mixer.startMix();
+    mixer.addStream(second.data(), numSamples * sizeof(int16_t));
+    mixer.addStream(second.data(), numSamples * sizeof(int16_t));
+    mixer.writeMix(result.data(), numSamples * sizeof(int16_t));
+    TEST_ASSERT_EQUALS(-10000, result[0]);
+    TEST_ASSERT_EQUALS(-10000, result[numSamples - 1]);
+
+    TEST_ASSERT(mixer.configure(AudioConfiguration::AUDIO_FORMAT_FLOAT32, numSamples * sizeof(float)));
+    std::vector<float> floatFirst(numSamples, 0.75f);
+    std::vector<float> floatSecond(numSamples, -0.5f);
+    std::vector<float> floatResult(numSamples, 0.0f);
+    mixer.startMix();
+    mixer.addStream(floatFirst.data(), numSamples * sizeof(float));
+    mixer.addStream(floatFirst.data(), numSamples * sizeof(float));
+    mixer.writeMix(floatResult.data(), numSamples * sizeof(float));
+    TEST_ASSERT_EQUALS(1.0f, floatResult[0]);
+    TEST_ASSERT_EQUALS(1.0f, floatResult[numSamples - 1]);
+    mixer.addStream(floatSecond.data(), numSamples * sizeof(float));
+    mixer.writeMix(floatResult.data(), numSamples * sizeof(float));
+    TEST_ASSERT_EQUALS(1.0f, floatResult[numSamples - 1]);
+    mixer.startMix();
+    mixer.addStream(floatFirst.data(), numSamples * sizeof(float));
+    mixer.addStream(floatSecond.data(), numSamples * sizeof(float));
+    mixer.writeMix(floatResult.data(), numSamples * sizeof(float));
+    TEST_ASSERT_EQUALS(0.25f, floatResult[0]);
+    TEST_ASSERT_EQUALS(0.25f, floatResult[numSamples - 1]);
+}
+
+void TestAudioProcessors::testMixingStreams()
+{
+    const unsigned int numFrames = 160;
+    ProcessorManager manager;
+    MultiStreamSource* source = new MultiStreamSource();
+    TEST_ASSERT(manager.addProcessor(AudioProcessorFactory::getAudioProcessor(AudioProcessorFactory::G711_PCMA, false)));
+    TEST_ASSERT(manager.addProcessor(source));
+
+    AudioConfiguration audioConfig{};
+    audioConfig.audioFormatFlag = AudioConfiguration::AUDIO_FORMAT_SINT16;
+    audioConfig.sampleRate = 8000;
+    audioConfig.framesPerPackage = numFrames;
+    audioConfig.outputDeviceChannels = 1;
+    TEST_ASSERT(manager.configureAudioProcessors(audioConfig, nullptr, numFrames * sizeof(int16_t)));
+
+    StreamData streamData{};
+    streamData.nBufferFrames = numFrames;
+    streamData.maxBufferSize = numFrames * sizeof(int16_t);
+    std::vector<int16_t> output(numFrames);
+
+    //the third stream is underflowing and skipped
+    source->streamValues = {1000, -3000, 0, 500};
+    TEST_ASSERT_EQUALS(numFrames * sizeof(int16_t), manager.processAudioOutput(output.data(), numFrames * sizeof(int16_t), &streamData));
+    TEST_ASSERT(!streamData.isSilentPackage);
+    const int expected = alaw_to_s16(s16_to_alaw(1000)) + alaw_to_s16(s16_to_alaw(-3000)) + alaw_to_s16(s16_to_alaw(500));
+    TEST_ASSERT_EQUALS(expected, output[0]);
+    TEST_ASSERT_EQUALS(expected, output[numFrames - 1]);
+
+    //the lost package of a stream active before is still decoded (concealed by the codec) and mixed
+    source->streamValues = {1000, 0};
+    manager.processAudioOutput(output.data(), numFrames * sizeof(int16_t), &streamData);
+    TEST_ASSERT(!streamData.isSilentPackage);
+    TEST_ASSERT_EQUALS(alaw_to_s16(s16_to_alaw(1000)) + alaw_to_s16(s16_to_alaw(0)), output[0]);
+
+    //the mixed sum is saturated
+    source->streamValues = {30000, 30000};
+    manager.processAudioOutput(output.data(), numFrames * sizeof(int16_t), &streamData);
+    TEST_ASSERT_EQUALS(32767, output[0]);
+
+    //a single stream is played as it is
+    source->streamValues = {-3000};
+    TEST_ASSERT_EQUALS(numFrames * sizeof(int16_t), manager.processAudioOutput(output.data(), numFrames * sizeof(int16_t), &streamData));
+    TEST_ASSERT_EQUALS(alaw_to_s16(s16_to_alaw(-3000)), output[numFrames - 1]);
+
+    //if all streams are silent for a while, the silence of the first stream is played
+    source->streamValues = {0, 0};
+    for(unsigned int i = 0; i < ProcessorManager::MAX_CONCEALED_CYCLES; ++i)
+    {
+        manager.processAudioOutput(output.data(), numFrames * sizeof(int16_t), &streamData);
+    }
+    TEST_ASSERT_EQUALS(numFrames * sizeof(int16_t), manager.processAudioOutput(output.data(), numFrames * sizeof(int16_t), &streamData));
+    TEST_ASSERT(streamData.isSilentPackage);
+    TEST_ASSERT_EQUALS(alaw_to_s16(s16_to_alaw(0)), output[0]);
+    manager.cleanUpAudioProcessors();
+}
+
+void TestAudioProcessors::testMixingUncodedStreams()
+{
+    const unsigned int numFrames = 160;
+    ProcessorManager manager;
+    //without any codec, like raw L16 received by the RTP-processor
+    MultiStreamSource* source = new MultiStreamSource(false);
+    TEST_ASSERT(manager.addProcessor(source));
+
+    AudioConfiguration audioConfig{};
+    audioConfig.audioFormatFlag = AudioConfiguration::AUDIO_FORMAT_SINT16;
+    audioConfig.sampleRate = 8000;
+    audioConfig.framesPerPackage = numFrames;
+    audioConfig.outputDeviceChannels = 1;
+    TEST_ASSERT(manager.configureAudioProcessors(audioConfig, nullptr, numFrames * sizeof(int16_t)));
+
+    StreamData streamData{};
+    streamData.nBufferFrames = numFrames;
+    streamData.maxBufferSize = numFrames * sizeof(int16_t);
+    std::vector<int16_t> output(numFrames);
+
+    //the streams are mixed directly, the underflowing stream is skipped
+    source->streamValues = {1000, -3000, 0, 500};
+    TEST_ASSERT_EQUALS(numFrames * sizeof(int16_t), manager.processAudioOutput(output.data(), numFrames * sizeof(int16_t), &streamData));
+    TEST_ASSERT(!streamData.isSilentPackage);
+    TEST_ASSERT_EQUALS(1000 - 3000 + 500, output[0]);
+    TEST_ASSERT_EQUALS(1000 - 3000 + 500, output[numFrames - 1]);
+
+    //a single stream is played as it is
+    source->streamValues = {-3000};
+    TEST_ASSERT_EQUALS(numFrames * sizeof(int16_t), manager.processAudioOutput(output.data(), numFrames * sizeof(int16_t), &streamData));
+    TEST_ASSERT_EQUALS(-3000, output[numFrames - 1]);
+    manager.cleanUpAudioProcessors();
+}
+
 std::vector<unsigned int> TestAudioProcessors::getSampleRates(unsigned int supportedRatesFlag)
 {
     std::vector<unsigned int> sampleRates{};
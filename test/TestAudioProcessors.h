@@ -19,6 +19,16 @@ public:
     TestAudioProcessors();
 
     void testAudioProcessorConfiguration(const std::string processorName);
+
+    void testPacketLossConcealment();
+
+    void testComfortNoise();
+
+    void testAudioMixer();
+
+    void testMixingStreams();
+
+    void testMixingUncodedStreams();
     
 private:
     std::vector<unsigned int> getSampleRates(unsigned int supportedRatesFlag);
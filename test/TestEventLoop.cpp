@@ -0,0 +1,88 @@
+/* 
+ * File:   TestEventLoop.cpp
+ */
+
+#include "TestEventLoop.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "network/UDPWrapper.h"
+
+using namespace ohmcomm;
+using namespace ohmcomm::network;
+
+TestEventLoop::TestEventLoop() : Test::Suite()
+{
+    if(EventLoop::isSupported())
+    {
+        TEST_ADD(TestEventLoop::testSocketReadable);
+        TEST_ADD(TestEventLoop::testTimers);
+        TEST_ADD(TestEventLoop::testImmediateShutdown);
+    }
+}
+
+void TestEventLoop::testSocketReadable()
+{
+    UDPWrapper sender(NetworkConfiguration{DEFAULT_NETWORK_PORT + 20, "127.0.0.1", DEFAULT_NETWORK_PORT + 21});
+    UDPWrapper receiver(NetworkConfiguration{DEFAULT_NETWORK_PORT + 21, "127.0.0.1", DEFAULT_NETWORK_PORT + 20});
+    TEST_ASSERT(receiver.getSocketDescriptor() != INVALID_SOCKET);
+
+    EventLoop loop;
+    loop.startUp();
+    char buffer[64];
+    std::atomic<int> receivedSize{0};
+    TEST_ASSERT(loop.addSocket(receiver.getSocketDescriptor(), [&]()
+    {
+        receivedSize += receiver.receiveData(buffer, sizeof(buffer)).getReceivedSize();
+    }));
+    TEST_ASSERT_EQUALS(11, sender.sendData("Test-Data-1", 11));
+    for(int i = 0; i < 100 && receivedSize == 0; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    TEST_ASSERT_EQUALS(11, receivedSize.load());
+
+    //no more callbacks for removed sockets
+    loop.removeSocket(receiver.getSocketDescriptor());
+    TEST_ASSERT_EQUALS(11, sender.sendData("Test-Data-2", 11));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    TEST_ASSERT_EQUALS(11, receivedSize.load());
+    loop.shutdown();
+}
+
+void TestEventLoop::testTimers()
+{
+    EventLoop loop;
+    loop.startUp();
+    std::atomic<int> singleCount{0};
+    std::atomic<int> repeatCount{0};
+    loop.addTimer(std::chrono::milliseconds(10), [&]() { ++singleCount; }, false);
+    const EventLoop::TimerID timer = loop.addTimer(std::chrono::milliseconds(10), [&]() { ++repeatCount; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    loop.cancelTimer(timer);
+    const int numRepeats = repeatCount;
+    TEST_ASSERT_EQUALS(1, singleCount.load());
+    TEST_ASSERT(numRepeats >= 3);
+
+    //cancelled timers don't expire anymore
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    TEST_ASSERT_EQUALS(numRepeats, repeatCount.load());
+    loop.shutdown();
+}
+
+void TestEventLoop::testImmediateShutdown()
+{
+    UDPWrapper receiver(NetworkConfiguration{DEFAULT_NETWORK_PORT + 22, "127.0.0.1", DEFAULT_NETWORK_PORT + 23});
+    EventLoop loop;
+    loop.startUp();
+    TEST_ASSERT(loop.isRunning());
+    TEST_ASSERT(loop.addSocket(receiver.getSocketDescriptor(), []() {}));
+    loop.addTimer(std::chrono::seconds(10), []() {});
+    const auto start = std::chrono::steady_clock::now();
+    loop.shutdown();
+    //the loop is woken up instead of waiting for a timeout
+    TEST_ASSERT(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(100));
+    TEST_ASSERT(!loop.isRunning());
+}
@@ -0,0 +1,23 @@
+/* 
+ * File:   TestEventLoop.h
+ */
+
+#ifndef TESTEVENTLOOP_H
+#define TESTEVENTLOOP_H
+
+#include "cpptest.h"
+#include "network/EventLoop.h"
+
+class TestEventLoop : public Test::Suite
+{
+public:
+    TestEventLoop();
+
+    void testSocketReadable();
+
+    void testTimers();
+
+    void testImmediateShutdown();
+};
+
+#endif /* TESTEVENTLOOP_H */
@@ -0,0 +1,203 @@
+/* 
+ * File:   TestNetworkEmulator.cpp
+ */
+
+#include "TestNetworkEmulator.h"
+
+#include <thread>
+
+#include "config/LibraryConfiguration.h"
+#include "rtp/ProcessorRTP.h"
+
+using namespace ohmcomm;
+using namespace ohmcomm::network;
+
+static const NetworkConfiguration configA{DEFAULT_NETWORK_PORT, "127.0.0.1", DEFAULT_NETWORK_PORT + 2};
+static const NetworkConfiguration configB{DEFAULT_NETWORK_PORT + 2, "127.0.0.1", DEFAULT_NETWORK_PORT};
+
+TestNetworkEmulator::TestNetworkEmulator() : Test::Suite()
+{
+    TEST_ADD(TestNetworkEmulator::testDelay);
+    TEST_ADD(TestNetworkEmulator::testBurstLoss);
+    TEST_ADD(TestNetworkEmulator::testReorderingAndDuplication);
+    TEST_ADD(TestNetworkEmulator::testBandwidth);
+    TEST_ADD(TestNetworkEmulator::testProcessorsBackToBack);
+}
+
+void TestNetworkEmulator::testDelay()
+{
+    //on the virtual clock without blocking, the packages are only received after advancing the time
+    const std::shared_ptr<NetworkEmulator> network = NetworkEmulator::create(true, 42, std::chrono::milliseconds(0));
+    NetworkImpairments impairments;
+    impairments.delay = std::chrono::milliseconds(40);
+    const std::shared_ptr<NetworkEmulator::Endpoint> sender = network->createEndpoint(configA, impairments);
+    const std::shared_ptr<NetworkEmulator::Endpoint> receiver = network->createEndpoint(configB);
+    const std::chrono::steady_clock::time_point sendTime = network->now();
+
+    char buffer[64];
+    TEST_ASSERT_EQUALS(11, sender->sendData("Test-Data-1", 11));
+    TEST_ASSERT(receiver->receiveData(buffer, sizeof(buffer)).hasTimedOut());
+    network->advanceTime(std::chrono::milliseconds(39));
+    TEST_ASSERT(receiver->receiveData(buffer, sizeof(buffer)).hasTimedOut());
+    network->advanceTime(std::chrono::milliseconds(1));
+    const NetworkWrapper::Package package = receiver->receiveData(buffer, sizeof(buffer));
+    TEST_ASSERT_EQUALS(11u, package.getReceivedSize());
+    TEST_ASSERT_EQUALS(0, memcmp(buffer, "Test-Data-1", 11));
+    TEST_ASSERT(package.address == sender->getLocalAddress());
+    TEST_ASSERT(package.receptionTime == sendTime + std::chrono::milliseconds(40));
+    TEST_ASSERT_EQUALS(0u, receiver->getNumberOfQueuedPackages());
+
+    receiver->closeNetwork();
+    TEST_ASSERT(receiver->receiveData(buffer, sizeof(buffer)).isInvalidSocket());
+    TEST_ASSERT_EQUALS(INVALID_SOCKET, receiver->sendData("Test-Data-2", 11));
+}
+
+void TestNetworkEmulator::testBurstLoss()
+{
+    const std::shared_ptr<NetworkEmulator> network = NetworkEmulator::create(true, 42, std::chrono::milliseconds(0));
+    NetworkImpairments impairments;
+    impairments.setBurstLoss(0.1, 4);
+    const std::shared_ptr<NetworkEmulator::Endpoint> sender = network->createEndpoint(configA, impairments);
+    const std::shared_ptr<NetworkEmulator::Endpoint> receiver = network->createEndpoint(configB);
+
+    const unsigned int numPackages = 20000;
+    for(uint32_t i = 0; i < numPackages; ++i)
+    {
+        sender->sendData(&i, sizeof(i));
+    }
+    network->advanceTime(std::chrono::milliseconds(1));
+    unsigned int numReceived = 0;
+    unsigned int numBursts = 0;
+    uint32_t expected = 0;
+    uint32_t received = 0;
+    while(!receiver->receiveData(&received, sizeof(received)).hasTimedOut())
+    {
+        ++numReceived;
+        if(received != expected)
+        {
+            ++numBursts;
+        }
+        expected = received + 1;
+    }
+    const double lossRate = (numPackages - numReceived) / (double)numPackages;
+    const double burstLength = (numPackages - numReceived) / (double)numBursts;
+    TEST_ASSERT_MSG(lossRate > 0.08 && lossRate < 0.12, "Loss-rate does not match!");
+    TEST_ASSERT_MSG(burstLength > 3 && burstLength < 5, "Burst-length does not match!");
+
+    //the same seed results in the same losses
+    const std::shared_ptr<NetworkEmulator> network2 = NetworkEmulator::create(true, 42, std::chrono::milliseconds(0));
+    const std::shared_ptr<NetworkEmulator::Endpoint> sender2 = network2->createEndpoint(configA, impairments);
+    const std::shared_ptr<NetworkEmulator::Endpoint> receiver2 = network2->createEndpoint(configB);
+    for(uint32_t i = 0; i < numPackages; ++i)
+    {
+        sender2->sendData(&i, sizeof(i));
+    }
+    TEST_ASSERT_EQUALS(numReceived, receiver2->getNumberOfQueuedPackages());
+}
+
+void TestNetworkEmulator::testReorderingAndDuplication()
+{
+    const std::shared_ptr<NetworkEmulator> network = NetworkEmulator::create(true, 42, std::chrono::milliseconds(0));
+    NetworkImpairments impairments;
+    impairments.jitter = std::chrono::milliseconds(30);
+    impairments.reorderProbability = 0.3;
+    impairments.duplicateProbability = 1;
+    const std::shared_ptr<NetworkEmulator::Endpoint> sender = network->createEndpoint(configA, impairments);
+    const std::shared_ptr<NetworkEmulator::Endpoint> receiver = network->createEndpoint(configB);
+
+    const unsigned int numPackages = 100;
+    for(uint32_t i = 0; i < numPackages; ++i)
+    {
+        sender->sendData(&i, sizeof(i));
+        network->advanceTime(std::chrono::milliseconds(20));
+    }
+    network->advanceTime(std::chrono::milliseconds(30));
+    unsigned int numReceived = 0;
+    unsigned int numReordered = 0;
+    uint32_t highest = 0;
+    uint32_t received = 0;
+    while(!receiver->receiveData(&received, sizeof(received)).hasTimedOut())
+    {
+        ++numReceived;
+        if(received < highest)
+        {
+            ++numReordered;
+        }
+        highest = std::max(highest, received);
+    }
+    TEST_ASSERT_EQUALS(2 * numPackages, numReceived);
+    TEST_ASSERT(numReordered > 0);
+}
+
+void TestNetworkEmulator::testBandwidth()
+{
+    const std::shared_ptr<NetworkEmulator> network = NetworkEmulator::create(true, 42, std::chrono::milliseconds(0));
+    NetworkImpairments impairments;
+    //100 bytes take 10 ms
+    impairments.bandwidth = 80000;
+    const std::shared_ptr<NetworkEmulator::Endpoint> sender = network->createEndpoint(configA, impairments);
+    const std::shared_ptr<NetworkEmulator::Endpoint> receiver = network->createEndpoint(configB);
+    const std::chrono::steady_clock::time_point sendTime = network->now();
+
+    const std::vector<char> payload(100, 42);
+    for(unsigned int i = 0; i < 3; ++i)
+    {
+        sender->sendData(payload.data(), payload.size());
+    }
+    network->advanceTime(std::chrono::milliseconds(30));
+    char buffer[128];
+    for(unsigned int i = 1; i <= 3; ++i)
+    {
+        const NetworkWrapper::Package package = receiver->receiveData(buffer, sizeof(buffer));
+        TEST_ASSERT_EQUALS(100u, package.getReceivedSize());
+        TEST_ASSERT(package.receptionTime == sendTime + std::chrono::milliseconds(10 * i));
+    }
+}
+
+void TestNetworkEmulator::testProcessorsBackToBack()
+{
+    //two processors with their own SSRC in a single process, on the real clock
+    const std::shared_ptr<NetworkEmulator> network = NetworkEmulator::create(false, 42, std::chrono::milliseconds(100));
+    NetworkImpairments impairments;
+    impairments.delay = std::chrono::milliseconds(5);
+    rtp::Participant participantA(0xA0A0A0A0, true);
+    rtp::Participant participantB(0xB0B0B0B0, true);
+    rtp::ProcessorRTP processorA("RTP-A", network->createEndpoint(configA, impairments), PayloadType::L16_1, participantA);
+    rtp::ProcessorRTP processorB("RTP-B", network->createEndpoint(configB, impairments), PayloadType::L16_1, participantB);
+
+    AudioConfiguration audioConfig{};
+    audioConfig.audioFormatFlag = AudioConfiguration::AUDIO_FORMAT_SINT16;
+    audioConfig.sampleRate = 44100;
+    audioConfig.framesPerPackage = 64;
+    audioConfig.inputDeviceChannels = 1;
+    audioConfig.outputDeviceChannels = 1;
+    audioConfig.playbackMode = PlaybackMode::DUPLEX;
+    const std::shared_ptr<LibraryConfiguration> configMode(new LibraryConfiguration());
+    configMode->configureAudio("", &audioConfig);
+    configMode->configureNetwork(configA);
+    configMode->configureProcessors({}, false);
+    const uint16_t bufferSize = audioConfig.framesPerPackage * 2;
+    processorA.configure(audioConfig, configMode, bufferSize, ProcessorCapabilities{});
+    processorB.configure(audioConfig, configMode, bufferSize, ProcessorCapabilities{});
+    processorA.startup();
+    processorB.startup();
+
+    std::vector<char> input(bufferSize, 42);
+    std::vector<char> output(bufferSize, 0);
+    StreamData inputData{};
+    inputData.nBufferFrames = audioConfig.framesPerPackage;
+    inputData.maxBufferSize = bufferSize;
+    StreamData outputData = inputData;
+    for(unsigned int i = 0; i < 3; ++i)
+    {
+        processorA.processInputData(input.data(), bufferSize, &inputData);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    TEST_ASSERT_EQUALS((unsigned int)bufferSize, processorB.processOutputData(output.data(), bufferSize, &outputData));
+    TEST_ASSERT_EQUALS(1u, outputData.numStreams);
+    TEST_ASSERT_EQUALS(participantA.ssrc, outputData.streamId);
+    TEST_ASSERT(input == output);
+
+    processorA.cleanUp();
+    processorB.cleanUp();
+}
@@ -0,0 +1,27 @@
+/* 
+ * File:   TestNetworkEmulator.h
+ */
+
+#ifndef TESTNETWORKEMULATOR_H
+#define TESTNETWORKEMULATOR_H
+
+#include "cpptest.h"
+#include "network/NetworkEmulator.h"
+
+class TestNetworkEmulator : public Test::Suite
+{
+public:
+    TestNetworkEmulator();
+
+    void testDelay();
+
+    void testBurstLoss();
+
+    void testReorderingAndDuplication();
+
+    void testBandwidth();
+
+    void testProcessorsBackToBack();
+};
+
+#endif /* TESTNETWORKEMULATOR_H */
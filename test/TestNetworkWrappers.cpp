@@ -1,8 +1,17 @@
 #include "TestNetworkWrappers.h"
 
+#include <chrono>
+#include <thread>
+#include <vector>
+
 #include "network/UDPWrapper.h"
 #include "network/TCPWrapper.h"
 #include "network/MulticastNetworkWrapper.h"
+#include "network/IOUringUDPWrapper.h"
+
+#ifndef _WIN32
+#include <net/if.h> //if_nametoindex
+#endif
 
 using namespace ohmcomm;
 using namespace ohmcomm::network;
@@ -10,6 +19,9 @@ using namespace ohmcomm::network;
 static const char* UDP = "UDP";
 static const char* TCP = "TCP";
 static const char* MULTICAST = "MULTICAST";
+#ifdef IO_URING_HEADER
+static const char* IO_URING = "IO_URING";
+#endif
 
 TestNetworkWrappers::TestNetworkWrappers() : bufferSize(511), sendBuffer(new char[bufferSize]), receiveBuffer(new char[bufferSize])
 {
@@ -20,6 +32,18 @@ TestNetworkWrappers::TestNetworkWrappers() : bufferSize(511), sendBuffer(new cha
     TEST_ADD_WITH_STRING_LITERAL(TestNetworkWrappers::testIPv6, (char*)TCP);
     TEST_ADD_WITH_STRING_LITERAL(TestNetworkWrappers::testIPv6, (char*)MULTICAST);
     TEST_ADD(TestNetworkWrappers::testMulticastWrapper);
+    //IPv6 is not tested, since Linux only routes IPv6 multicast via interfaces flagged MULTICAST, which the loopback-interface is not by default
+    TEST_ADD_WITH_STRING_LITERAL(TestNetworkWrappers::testMulticastGroup, (char*)"239.255.12.34");
+    TEST_ADD_WITH_STRING_LITERAL(TestNetworkWrappers::testScatterGather, (char*)UDP);
+    TEST_ADD_WITH_STRING_LITERAL(TestNetworkWrappers::testScatterGather, (char*)MULTICAST);
+    TEST_ADD(TestNetworkWrappers::testBatchReceive);
+    TEST_ADD(TestNetworkWrappers::testSocketOptions);
+    TEST_ADD(TestNetworkWrappers::testTCPFraming);
+#ifdef IO_URING_HEADER
+    TEST_ADD_WITH_STRING_LITERAL(TestNetworkWrappers::testIPv4, (char*)IO_URING);
+    TEST_ADD_WITH_STRING_LITERAL(TestNetworkWrappers::testIPv6, (char*)IO_URING);
+    TEST_ADD(TestNetworkWrappers::testIOUringReceive);
+#endif
 }
 
 TestNetworkWrappers::~TestNetworkWrappers()
@@ -76,6 +100,14 @@ void TestNetworkWrappers::testMulticastWrapper()
     TEST_ASSERT(strcmp(sendBuffer.data(), &(recvBuffer1[0])) == 0);
     TEST_ASSERT(strcmp(sendBuffer.data(), &(recvBuffer2[0])) == 0);
     
+    //both destinations are accounted for
+    TEST_ASSERT_EQUALS(2u, sender.getDestinationStatistics().size());
+    for(const auto& stats : sender.getDestinationStatistics())
+    {
+        TEST_ASSERT_EQUALS(1ul, stats.packagesSent);
+        TEST_ASSERT_EQUALS((unsigned long)sendLength, stats.bytesSent);
+        TEST_ASSERT_EQUALS(0ul, stats.errors);
+    }
     
     //remove recipient
     TEST_ASSERT(sender.removeDestination("127.0.0.1", DEFAULT_NETWORK_PORT + 2));
@@ -89,6 +121,307 @@ void TestNetworkWrappers::testMulticastWrapper()
         receiveSize = receiver1.receiveData(&(recvBuffer1[0]), sendLength + 5).status;
     }
     TEST_ASSERT_EQUALS(sendLength, receiveSize);
+    TEST_ASSERT_EQUALS(1u, sender.getDestinationStatistics().size());
+    TEST_ASSERT_EQUALS(2ul, sender.getDestinationStatistics()[0].packagesSent);
+}
+
+void TestNetworkWrappers::testMulticastGroup(char* groupAddress)
+{
+    //both members listen on the port of the group, the group is joined on the loopback-interface to run on a single host
+#ifdef _WIN32
+    const unsigned int loopbackIndex = 1;
+#else
+    const unsigned int loopbackIndex = if_nametoindex("lo");
+#endif
+    const ohmcomm::NetworkConfiguration groupConfig{DEFAULT_NETWORK_PORT + 3, groupAddress, DEFAULT_NETWORK_PORT + 3};
+    ohmcomm::network::MulticastNetworkWrapper sender(groupConfig);
+    ohmcomm::network::MulticastNetworkWrapper receiver(groupConfig);
+    TEST_ASSERT(sender.joinGroup({1, true, loopbackIndex}));
+    TEST_ASSERT(receiver.joinGroup({1, true, loopbackIndex}));
+    TEST_ASSERT(sender.isGroupJoined());
+    
+    const std::string sendBuffer = "Hello, group!";
+    const int sendLength = sendBuffer.size();
+    //a single package is sent to the group
+    TEST_ASSERT_EQUALS(sendLength, sender.sendData(sendBuffer.data(), sendLength));
+    TEST_ASSERT_EQUALS(1ul, sender.getDestinationStatistics()[0].packagesSent);
+    
+    std::string recvBuffer(sendLength + 10, '\0');
+    int receiveSize = -2;
+    unsigned int numRetries = 3;
+    while(receiveSize == -2 && numRetries-- > 0)
+    {
+        receiveSize = receiver.receiveData(&(recvBuffer[0]), sendLength + 5).status;
+    }
+    TEST_ASSERT_EQUALS(sendLength, receiveSize);
+    TEST_ASSERT(strcmp(sendBuffer.data(), &(recvBuffer[0])) == 0);
+    
+    receiver.leaveGroup();
+    TEST_ASSERT(!receiver.isGroupJoined());
+    //a unicast address can't be joined
+    ohmcomm::network::MulticastNetworkWrapper unicast({DEFAULT_NETWORK_PORT + 4, "127.0.0.1", DEFAULT_NETWORK_PORT + 4});
+    TEST_ASSERT(!unicast.joinGroup());
+}
+
+void TestNetworkWrappers::testScatterGather(char* type)
+{
+    const ohmcomm::NetworkConfiguration senderConfig{DEFAULT_NETWORK_PORT + 5, "127.0.0.1", DEFAULT_NETWORK_PORT + 6};
+    std::unique_ptr<ohmcomm::network::NetworkWrapper> sender(strcmp(UDP, type) == 0 ? 
+        new ohmcomm::network::UDPWrapper(senderConfig) : new ohmcomm::network::MulticastNetworkWrapper(senderConfig));
+    ohmcomm::network::UDPWrapper receiver(ohmcomm::NetworkConfiguration{DEFAULT_NETWORK_PORT + 6, "127.0.0.1", DEFAULT_NETWORK_PORT + 5});
+    
+    const std::string header = "Header|";
+    const std::string payload = "Payload|";
+    const std::string trailer = "Trailer";
+    const ohmcomm::network::NetworkWrapper::BufferSegment segments[3] = {
+        {header.data(), (unsigned int)header.size()},
+        {payload.data(), (unsigned int)payload.size()},
+        {trailer.data(), (unsigned int)trailer.size()}
+    };
+    const std::string expected = header + payload + trailer;
+    TEST_ASSERT_EQUALS((int)expected.size(), sender->sendData(segments, 3));
+    
+    std::string recvBuffer(expected.size() + 10, '\0');
+    int receiveSize = -2;
+    unsigned int numRetries = 3;
+    while(receiveSize == -2 && numRetries-- > 0)
+    {
+        receiveSize = receiver.receiveData(&(recvBuffer[0]), recvBuffer.size()).status;
+    }
+    //the segments are received as a single package
+    TEST_ASSERT_EQUALS((int)expected.size(), receiveSize);
+    TEST_ASSERT_EQUALS(expected, recvBuffer.substr(0, expected.size()));
+}
+
+void TestNetworkWrappers::testBatchReceive()
+{
+    ohmcomm::network::UDPWrapper sender(ohmcomm::NetworkConfiguration{DEFAULT_NETWORK_PORT + 7, "127.0.0.1", DEFAULT_NETWORK_PORT + 8});
+    ohmcomm::network::UDPWrapper receiver(ohmcomm::NetworkConfiguration{DEFAULT_NETWORK_PORT + 8, "127.0.0.1", DEFAULT_NETWORK_PORT + 7});
+    //Linux enables the timestamping of packages asynchronously after the first socket requests it
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    
+    const unsigned int numPackages = 5;
+    const std::chrono::steady_clock::time_point beforeSending = std::chrono::steady_clock::now();
+    for(unsigned int i = 0; i < numPackages; ++i)
+    {
+        const std::string package = "Package " + std::to_string(i);
+        TEST_ASSERT_EQUALS((int)package.size(), sender.sendData(package.data(), package.size()));
+    }
+    //the packages wait in the socket-buffer, which must not count into their reception-time
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    
+    const unsigned int bufferSize = 32;
+    std::vector<char> receiveBuffer(numPackages * bufferSize);
+    void* buffers[numPackages];
+    ohmcomm::network::NetworkWrapper::Package packages[numPackages];
+    for(unsigned int i = 0; i < numPackages; ++i)
+    {
+        buffers[i] = receiveBuffer.data() + i * bufferSize;
+    }
+    unsigned int numReceived = 0;
+    unsigned int numRetries = 5;
+    while(numReceived < numPackages && numRetries-- > 0)
+    {
+        const unsigned int count = receiver.receiveData(buffers + numReceived, bufferSize, packages + numReceived, numPackages - numReceived);
+        if(packages[numReceived].hasTimedOut())
+        {
+            continue;
+        }
+        TEST_ASSERT(!packages[numReceived].isInvalidSocket());
+        numReceived += count;
+    }
+    //the packages are received in order, possibly in several batches
+    TEST_ASSERT_EQUALS(numPackages, numReceived);
+    for(unsigned int i = 0; i < numReceived; ++i)
+    {
+        const std::string package = "Package " + std::to_string(i);
+        TEST_ASSERT_EQUALS((int)package.size(), packages[i].status);
+        TEST_ASSERT_EQUALS(package, std::string((const char*)buffers[i], packages[i].getReceivedSize()));
+        TEST_ASSERT_EQUALS(std::string("127.0.0.1"), packages[i].address.toAddressAndPort().first);
+        //allow for rounding-errors when converting the kernel-timestamp
+        TEST_ASSERT(packages[i].receptionTime + std::chrono::milliseconds(1) >= beforeSending);
+#ifdef __linux__
+        //the kernel timestamps the arrival of the package, not the call to receive it
+        TEST_ASSERT(packages[i].receptionTime + std::chrono::milliseconds(40) <= std::chrono::steady_clock::now());
+#endif
+    }
+}
+
+void TestNetworkWrappers::testIOUringReceive()
+{
+#ifdef IO_URING_HEADER
+    ohmcomm::network::UDPWrapper sender(ohmcomm::NetworkConfiguration{DEFAULT_NETWORK_PORT + 7, "127.0.0.1", DEFAULT_NETWORK_PORT + 8});
+    std::unique_ptr<ohmcomm::network::IOUringUDPWrapper> receiver(
+        new ohmcomm::network::IOUringUDPWrapper(ohmcomm::NetworkConfiguration{DEFAULT_NETWORK_PORT + 8, "127.0.0.1", DEFAULT_NETWORK_PORT + 7}));
+    if(!receiver->isRingActive())
+    {
+        //the kernel does not support io_uring (or multishot receives), the fall-back is tested like the UDPWrapper
+        return;
+    }
+    TEST_ASSERT(receiver->getSocketDescriptor() != INVALID_SOCKET);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    //more packages than fit into a single batch, received without a system-call per package
+    const unsigned int numPackages = NetworkWrapper::MAX_RECEIVE_BATCH + 8;
+    const std::chrono::steady_clock::time_point beforeSending = std::chrono::steady_clock::now();
+    for(unsigned int i = 0; i < numPackages; ++i)
+    {
+        const std::string package = "Package " + std::to_string(i);
+        TEST_ASSERT_EQUALS((int)package.size(), sender.sendData(package.data(), package.size()));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    const unsigned int bufferSize = 32;
+    std::vector<char> receiveBuffer(numPackages * bufferSize);
+    std::vector<void*> buffers(numPackages);
+    std::vector<ohmcomm::network::NetworkWrapper::Package> packages(numPackages);
+    for(unsigned int i = 0; i < numPackages; ++i)
+    {
+        buffers[i] = receiveBuffer.data() + i * bufferSize;
+    }
+    unsigned int numReceived = 0;
+    unsigned int numRetries = 10;
+    while(numReceived < numPackages && numRetries-- > 0)
+    {
+        const unsigned int count = receiver->receiveData(buffers.data() + numReceived, bufferSize, packages.data() + numReceived, numPackages - numReceived);
+        if(packages[numReceived].hasTimedOut())
+        {
+            continue;
+        }
+        TEST_ASSERT(!packages[numReceived].isInvalidSocket());
+        TEST_ASSERT(count <= NetworkWrapper::MAX_RECEIVE_BATCH);
+        numReceived += count;
+    }
+    TEST_ASSERT_EQUALS(numPackages, numReceived);
+    for(unsigned int i = 0; i < numReceived; ++i)
+    {
+        const std::string package = "Package " + std::to_string(i);
+        TEST_ASSERT_EQUALS(package, std::string((const char*)buffers[i], packages[i].getReceivedSize()));
+        TEST_ASSERT_EQUALS(std::string("127.0.0.1"), packages[i].address.toAddressAndPort().first);
+        TEST_ASSERT_EQUALS(DEFAULT_NETWORK_PORT + 7, (int)packages[i].address.toAddressAndPort().second);
+        TEST_ASSERT(packages[i].receptionTime + std::chrono::milliseconds(1) >= beforeSending);
+        TEST_ASSERT(packages[i].receptionTime + std::chrono::milliseconds(40) <= std::chrono::steady_clock::now());
+    }
+
+    //closing the network wakes up the thread waiting for packages
+    std::thread receiveThread([&receiver, &packages, &buffers, bufferSize]()
+    {
+        do
+        {
+            receiver->receiveData(buffers.data(), bufferSize, packages.data(), 1);
+        }
+        while(packages[0].hasTimedOut());
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    const std::chrono::steady_clock::time_point beforeClosing = std::chrono::steady_clock::now();
+    receiver->closeNetwork();
+    receiveThread.join();
+    TEST_ASSERT(packages[0].isInvalidSocket());
+    TEST_ASSERT(std::chrono::steady_clock::now() - beforeClosing < std::chrono::milliseconds(500));
+    TEST_ASSERT_EQUALS(INVALID_SOCKET, receiver->getSocketDescriptor());
+#endif
+}
+
+void TestNetworkWrappers::testSocketOptions()
+{
+    ohmcomm::network::UDPWrapper sender(ohmcomm::NetworkConfiguration{DEFAULT_NETWORK_PORT + 7, "127.0.0.1", DEFAULT_NETWORK_PORT + 8});
+    ohmcomm::network::UDPWrapper receiver(ohmcomm::NetworkConfiguration{DEFAULT_NETWORK_PORT + 8, "127.0.0.1", DEFAULT_NETWORK_PORT + 7});
+    
+    SocketOptions options;
+    options.sendBufferSize = 32 * 1024;
+    options.dscp = SocketOptions::DSCP_EXPEDITED_FORWARDING;
+    TEST_ASSERT(sender.setSocketOptions(options));
+    int value = 0;
+    socklen_t length = sizeof(value);
+    TEST_ASSERT_EQUALS(0, getsockopt(sender.getSocketDescriptor(), IPPROTO_IP, IP_TOS, (char*)&value, &length));
+    TEST_ASSERT_EQUALS(SocketOptions::DSCP_EXPEDITED_FORWARDING << 2, value);
+    length = sizeof(value);
+    TEST_ASSERT_EQUALS(0, getsockopt(sender.getSocketDescriptor(), SOL_SOCKET, SO_SNDBUF, (char*)&value, &length));
+    TEST_ASSERT(value >= options.sendBufferSize);
+    
+    //a receive-buffer small enough to overflow with a burst of packages
+    options = SocketOptions{};
+    options.receiveBufferSize = 4096;
+    TEST_ASSERT(receiver.setSocketOptions(options));
+    TEST_ASSERT_EQUALS(0u, receiver.getNumberOfDroppedPackages());
+#ifdef __linux__
+    //Linux reports twice the size set
+    length = sizeof(value);
+    TEST_ASSERT_EQUALS(0, getsockopt(receiver.getSocketDescriptor(), SOL_SOCKET, SO_RCVBUF, (char*)&value, &length));
+    TEST_ASSERT(value / 2 >= options.receiveBufferSize);
+#endif
+    
+    const std::string package(512, 'x');
+    const unsigned int numPackages = 64;
+    for(unsigned int i = 0; i < numPackages; ++i)
+    {
+        sender.sendData(package.data(), package.size());
+    }
+    std::vector<char> receiveBuffer(package.size());
+    unsigned int numReceived = 0;
+    while(!receiver.receiveData(receiveBuffer.data(), receiveBuffer.size()).hasTimedOut())
+    {
+        ++numReceived;
+    }
+    TEST_ASSERT(numReceived > 0);
+    TEST_ASSERT(numReceived < numPackages);
+#ifdef __linux__
+    //the kernel reports the counter with the next package queued after the drops
+    sender.sendData(package.data(), package.size());
+    TEST_ASSERT_EQUALS((int)package.size(), receiver.receiveData(receiveBuffer.data(), receiveBuffer.size()).status);
+    TEST_ASSERT_EQUALS(numPackages - numReceived, receiver.getNumberOfDroppedPackages());
+#endif
+}
+
+void TestNetworkWrappers::testTCPFraming()
+{
+    //the socket is connected to itself, so it receives all packages it sends
+    ohmcomm::network::TCPWrapper wrapper(ohmcomm::NetworkConfiguration{DEFAULT_NETWORK_PORT + 7, "127.0.0.1", DEFAULT_NETWORK_PORT + 7});
+    
+    //sends packages of varying sizes without receiving, until the connection is congested
+    std::vector<char> package(1000);
+    uint32_t numSent = 0;
+    while(wrapper.getNumberOfDroppedSends() == 0 && numSent < 100000)
+    {
+        const unsigned int payloadSize = numSent % (package.size() - sizeof(numSent));
+        memcpy(package.data(), &numSent, sizeof(numSent));
+        memset(package.data() + sizeof(numSent), numSent & 0xFF, payloadSize);
+        const NetworkWrapper::BufferSegment segments[2] = {{package.data(), sizeof(numSent)}, {package.data() + sizeof(numSent), payloadSize}};
+        const int result = wrapper.sendData(segments, 2);
+        TEST_ASSERT(result == 0 || result == (int)(sizeof(numSent) + payloadSize));
+        ++numSent;
+    }
+    TEST_ASSERT(wrapper.getNumberOfDroppedSends() > 0);
+    
+    //every package received must be complete, no matter how the stream was split up
+    std::vector<std::vector<char>> buffers(NetworkWrapper::MAX_RECEIVE_BATCH, std::vector<char>(package.size()));
+    void* bufferPointers[NetworkWrapper::MAX_RECEIVE_BATCH];
+    for(unsigned int i = 0; i < NetworkWrapper::MAX_RECEIVE_BATCH; ++i)
+    {
+        bufferPointers[i] = buffers[i].data();
+    }
+    NetworkWrapper::Package packages[NetworkWrapper::MAX_RECEIVE_BATCH];
+    uint32_t numReceived = 0;
+    uint32_t expectedIndex = 0;
+    bool isTimedOut = false;
+    while(!isTimedOut)
+    {
+        const unsigned int numPackages = wrapper.receiveData(bufferPointers, package.size(), packages, NetworkWrapper::MAX_RECEIVE_BATCH);
+        isTimedOut = packages[0].hasTimedOut();
+        for(unsigned int i = 0; i < numPackages && !isTimedOut; ++i)
+        {
+            uint32_t index = 0;
+            memcpy(&index, buffers[i].data(), sizeof(index));
+            TEST_ASSERT_EQUALS((int)(sizeof(index) + index % (package.size() - sizeof(index))), packages[i].status);
+            TEST_ASSERT_EQUALS(std::string(packages[i].status - sizeof(index), (char)(index & 0xFF)), std::string(buffers[i].data() + sizeof(index), packages[i].status - sizeof(index)));
+            //the first packages are sent before the connection was congested
+            TEST_ASSERT_EQUALS(expectedIndex, index);
+            ++expectedIndex;
+            ++numReceived;
+        }
+    }
+    TEST_ASSERT(numReceived > 0);
+    TEST_ASSERT(numReceived < numSent);
 }
 
 void TestNetworkWrappers::testWrapper(ohmcomm::network::NetworkWrapper& wrapper)
@@ -148,5 +481,11 @@ std::unique_ptr<ohmcomm::network::NetworkWrapper> TestNetworkWrappers::getWrappe
     {
         return std::unique_ptr<ohmcomm::network::NetworkWrapper>(new ohmcomm::network::TCPWrapper(ohmcomm::NetworkConfiguration{DEFAULT_NETWORK_PORT, ip, DEFAULT_NETWORK_PORT}));
     }
+#ifdef IO_URING_HEADER
+    if(type == IO_URING)
+    {
+        return std::unique_ptr<ohmcomm::network::NetworkWrapper>(new ohmcomm::network::IOUringUDPWrapper(ohmcomm::NetworkConfiguration{DEFAULT_NETWORK_PORT, ip, DEFAULT_NETWORK_PORT}));
+    }
+#endif
     return std::unique_ptr<ohmcomm::network::NetworkWrapper>(new ohmcomm::network::MulticastNetworkWrapper(ohmcomm::NetworkConfiguration{DEFAULT_NETWORK_PORT, ip, DEFAULT_NETWORK_PORT}));
 }
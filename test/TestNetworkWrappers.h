@@ -17,6 +17,18 @@ public:
     void testIPv6(char* type);
     
     void testMulticastWrapper();
+    
+    void testMulticastGroup(char* groupAddress);
+    
+    void testScatterGather(char* type);
+    
+    void testBatchReceive();
+    
+    void testIOUringReceive();
+    
+    void testSocketOptions();
+    
+    void testTCPFraming();
 private:
     const unsigned int bufferSize;
     char* sendBuffer;
@@ -73,6 +73,18 @@ int main(int argc, char** argv)
         
         TestRTPBuffer testBuffer;
         testBuffer.run(output);
+        
+        TestRTPBuffer testLockFreeBuffer(ohmcomm::rtp::JitterBufferType::LOCK_FREE);
+        testLockFreeBuffer.run(output);
+        
+        TestJitterBuffers testJitterBuffers;
+        testJitterBuffers.run(output);
+        
+        TestPlayoutDelayEstimator testDelayEstimator;
+        testDelayEstimator.run(output);
+        
+        TestSharedMediaSocket testSharedSocket;
+        testSharedSocket.run(output);
     }
     if(runTests & TEST_CONFIG)
     {
@@ -89,6 +101,12 @@ int main(int argc, char** argv)
     {
         TestNetworkWrappers testNetwork;
         testNetwork.run(output);
+
+        TestEventLoop testEventLoop;
+        testEventLoop.run(output);
+
+        TestNetworkEmulator testNetworkEmulator;
+        testNetworkEmulator.run(output);
         
         TestNetworkGrammars testNetGrammars;
         testNetGrammars.run(output);
@@ -8,6 +8,8 @@
 #include "TestParameters.h"
 #include "TestConfigurationModes.h"
 #include "TestNetworkWrappers.h"
+#include "TestEventLoop.h"
+#include "TestNetworkEmulator.h"
 #include "TestNetworkGrammars.h"
 #include "TestSocketAddress.h"
 #include "TestUtility.h"
@@ -16,6 +18,9 @@
 #include "rtp/TestRTP.h"
 #include "rtp/TestRTCP.h"
 #include "rtp/TestRTPBuffer.h"
+#include "rtp/TestJitterBuffers.h"
+#include "rtp/TestPlayoutDelayEstimator.h"
+#include "rtp/TestSharedMediaSocket.h"
 #include "sip/TestSIPHandler.h"
 #include "sip/TestSIPPackages.h"
 #include "sip/TestSDP.h"
@@ -0,0 +1,87 @@
+/*
+ * File:   TestJitterBuffers.cpp
+ */
+
+#include "TestJitterBuffers.h"
+
+using namespace ohmcomm::rtp;
+
+TestJitterBuffers::TestJitterBuffers()
+{
+    TEST_ADD(TestJitterBuffers::testGetBuffer);
+    TEST_ADD(TestJitterBuffers::testRemoveBuffer);
+    TEST_ADD(TestJitterBuffers::testMaximumStreams);
+    TEST_ADD(TestJitterBuffers::testRemoveCollidingBuffers);
+}
+
+void TestJitterBuffers::testGetBuffer()
+{
+    JitterBuffers buffers(16, 100, 1, JitterBufferType::RTP_BUFFER, 256, 4);
+    TEST_ASSERT(buffers.findBuffer(42) == nullptr);
+    RTPBufferHandler* buffer = buffers.getBuffer(42);
+    TEST_ASSERT(buffer != nullptr);
+    //the same SSRC is always mapped to the same buffer
+    TEST_ASSERT_EQUALS(buffer, buffers.getBuffer(42));
+    TEST_ASSERT_EQUALS(buffer, buffers.findBuffer(42));
+    //other SSRCs get other buffers
+    RTPBufferHandler* otherBuffer = buffers.getBuffer(43);
+    TEST_ASSERT(otherBuffer != nullptr);
+    TEST_ASSERT(otherBuffer != buffer);
+}
+
+void TestJitterBuffers::testRemoveBuffer()
+{
+    JitterBuffers buffers(16, 100, 1, JitterBufferType::LOCK_FREE, 256, 4);
+    TEST_ASSERT(buffers.getBuffer(42) != nullptr);
+    TEST_ASSERT(buffers.getBuffer(43) != nullptr);
+    buffers.removeBuffer(42);
+    TEST_ASSERT(buffers.findBuffer(42) == nullptr);
+    //removing one SSRC must not affect the others
+    TEST_ASSERT(buffers.findBuffer(43) != nullptr);
+    uint32_t ssrcs[4];
+    TEST_ASSERT_EQUALS(1u, buffers.getActiveSSRCs(ssrcs, 4));
+    TEST_ASSERT_EQUALS(43u, ssrcs[0]);
+    buffers.cleanup();
+    TEST_ASSERT_EQUALS(0u, buffers.getActiveSSRCs(ssrcs, 4));
+    TEST_ASSERT(buffers.findBuffer(43) == nullptr);
+}
+
+void TestJitterBuffers::testMaximumStreams()
+{
+    JitterBuffers buffers(16, 100, 1, JitterBufferType::RTP_BUFFER, 256, 2);
+    TEST_ASSERT(buffers.getBuffer(1) != nullptr);
+    TEST_ASSERT(buffers.getBuffer(2) != nullptr);
+    //all buffers are in use
+    TEST_ASSERT(buffers.getBuffer(3) == nullptr);
+    //a released buffer is not reused immediately
+    buffers.removeBuffer(1);
+    TEST_ASSERT(buffers.getBuffer(3) == nullptr);
+    TEST_ASSERT(buffers.findBuffer(2) != nullptr);
+}
+
+void TestJitterBuffers::testRemoveCollidingBuffers()
+{
+    //the directory has 32 entries, so SSRCs equal modulo 32 start probing at the same position
+    JitterBuffers buffers(16, 100, 1, JitterBufferType::RTP_BUFFER, 256, 16);
+    const uint32_t ssrcs[4] = {5, 37, 69, 101};
+    for(const uint32_t ssrc : ssrcs)
+    {
+        TEST_ASSERT(buffers.getBuffer(ssrc) != nullptr);
+    }
+    //removing the end and the middle of the probing sequence must not hide the other SSRCs
+    buffers.removeBuffer(101);
+    buffers.removeBuffer(37);
+    TEST_ASSERT(buffers.findBuffer(5) != nullptr);
+    TEST_ASSERT(buffers.findBuffer(69) != nullptr);
+    TEST_ASSERT(buffers.findBuffer(37) == nullptr);
+    TEST_ASSERT(buffers.findBuffer(101) == nullptr);
+    buffers.removeBuffer(69);
+    TEST_ASSERT(buffers.findBuffer(5) != nullptr);
+    TEST_ASSERT(buffers.findBuffer(69) == nullptr);
+    //the emptied positions are reused
+    TEST_ASSERT(buffers.getBuffer(101) != nullptr);
+    TEST_ASSERT_EQUALS(buffers.getBuffer(101), buffers.findBuffer(101));
+    TEST_ASSERT(buffers.findBuffer(5) != nullptr);
+    uint32_t activeSSRCs[16];
+    TEST_ASSERT_EQUALS(2u, buffers.getActiveSSRCs(activeSSRCs, 16));
+}
@@ -0,0 +1,22 @@
+/*
+ * File:   TestJitterBuffers.h
+ */
+
+#ifndef TESTJITTERBUFFERS_H
+#define	TESTJITTERBUFFERS_H
+
+#include "cpptest.h"
+#include "rtp/JitterBuffers.h"
+
+class TestJitterBuffers: public Test::Suite
+{
+public:
+    TestJitterBuffers();
+
+    void testGetBuffer();
+    void testRemoveBuffer();
+    void testMaximumStreams();
+    void testRemoveCollidingBuffers();
+};
+
+#endif	/* TESTJITTERBUFFERS_H */
@@ -0,0 +1,70 @@
+/*
+ * File:   TestPlayoutDelayEstimator.cpp
+ */
+
+#include "TestPlayoutDelayEstimator.h"
+
+using namespace ohmcomm::rtp;
+
+TestPlayoutDelayEstimator::TestPlayoutDelayEstimator()
+{
+    TEST_ADD(TestPlayoutDelayEstimator::testConstantDelay);
+    TEST_ADD(TestPlayoutDelayEstimator::testDelayQuantile);
+    TEST_ADD(TestPlayoutDelayEstimator::testAdaptToHigherDelay);
+}
+
+void TestPlayoutDelayEstimator::testConstantDelay()
+{
+    PlayoutDelayEstimator estimator(0.97);
+    TEST_ASSERT(!estimator.hasEstimation());
+    addPackages(estimator, 100, 0, 0);
+    TEST_ASSERT(estimator.hasEstimation());
+    //no jitter -> only the width of a single bin
+    TEST_ASSERT(estimator.getTargetDelay() <= 2);
+    TEST_ASSERT_EQUALS(1, estimator.getTargetDelayPackages());
+}
+
+void TestPlayoutDelayEstimator::testDelayQuantile()
+{
+    //every 10th package is delayed by 50ms
+    PlayoutDelayEstimator estimator(0.97);
+    addPackages(estimator, 200, 10, 50);
+    TEST_ASSERT(estimator.getTargetDelay() >= 50);
+    //50ms delay need 3 packages of 20ms each
+    TEST_ASSERT_EQUALS(3, estimator.getTargetDelayPackages());
+
+    //accepting 20% of late losses, the delayed packages can be ignored
+    PlayoutDelayEstimator lossyEstimator(0.8);
+    addPackages(lossyEstimator, 200, 10, 50);
+    TEST_ASSERT(lossyEstimator.getTargetDelay() <= 2);
+}
+
+void TestPlayoutDelayEstimator::testAdaptToHigherDelay()
+{
+    PlayoutDelayEstimator estimator(0.97);
+    addPackages(estimator, 200, 0, 0);
+    TEST_ASSERT(estimator.getTargetDelay() <= 2);
+    //a few delayed packages are enough to adapt
+    addPackages(estimator, 10, 2, 40);
+    TEST_ASSERT(estimator.getTargetDelay() >= 40);
+}
+
+void TestPlayoutDelayEstimator::addPackages(PlayoutDelayEstimator& estimator, const unsigned int numPackages, const unsigned int delayedPackagesInterval, const unsigned int delay)
+{
+    //all packages are sent every 20ms and are received without any delay, except the delayed ones
+    static uint16_t sequenceNumber = 0;
+    static uint32_t timestamp = 0;
+    static std::chrono::steady_clock::time_point sendTime = std::chrono::steady_clock::now();
+    for(unsigned int i = 0; i < numPackages; ++i)
+    {
+        ++sequenceNumber;
+        timestamp += 20;
+        sendTime += std::chrono::milliseconds(20);
+        std::chrono::steady_clock::time_point receptionTime = sendTime;
+        if(delayedPackagesInterval > 0 && i % delayedPackagesInterval == delayedPackagesInterval - 1)
+        {
+            receptionTime += std::chrono::milliseconds(delay);
+        }
+        estimator.addPackage(sequenceNumber, timestamp, receptionTime);
+    }
+}
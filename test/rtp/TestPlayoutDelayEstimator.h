@@ -0,0 +1,27 @@
+/*
+ * File:   TestPlayoutDelayEstimator.h
+ */
+
+#ifndef TESTPLAYOUTDELAYESTIMATOR_H
+#define	TESTPLAYOUTDELAYESTIMATOR_H
+
+#include "cpptest.h"
+#include "rtp/PlayoutDelayEstimator.h"
+
+class TestPlayoutDelayEstimator: public Test::Suite
+{
+public:
+    TestPlayoutDelayEstimator();
+
+    void testConstantDelay();
+    void testDelayQuantile();
+    void testAdaptToHigherDelay();
+
+private:
+    /*!
+     * Adds the given number of packages of 20ms each, every n-th package is delayed by the given delay
+     */
+    static void addPackages(ohmcomm::rtp::PlayoutDelayEstimator& estimator, const unsigned int numPackages, const unsigned int delayedPackagesInterval, const unsigned int delay);
+};
+
+#endif	/* TESTPLAYOUTDELAYESTIMATOR_H */
@@ -166,6 +166,9 @@ void TestRTCP::testIsRTCPPackage()
     //tests
     TEST_ASSERT(true == handler.isRTCPPackage(rtcpPackage, handler.getRTCPPackageLength(rtcpHeader.getLength())));
     TEST_ASSERT(false == handler.isRTCPPackage(rtpPackage, h.getActualPayloadSize() + h.getRTPHeaderSize()));
+    //demultiplexing RTP and RTCP on the same port
+    TEST_ASSERT(RTCPPackageHandler::isMultiplexedRTCPPackage(rtcpPackage, handler.getRTCPPackageLength(rtcpHeader.getLength())));
+    TEST_ASSERT(!RTCPPackageHandler::isMultiplexedRTCPPackage(rtpPackage, h.getActualPayloadSize() + h.getRTPHeaderSize()));
 }
 
 
@@ -6,14 +6,45 @@
  */
 
 #include "TestRTP.h"
+#include "rtp/RTPSender.h"
+#include "Statistics.h"
+
+#include <mutex>
 
 using namespace ohmcomm::rtp;
 
 TestRTP::TestRTP() : Test::Suite()
 {
     TEST_ADD(TestRTP::testRTPPackage);
+    TEST_ADD(TestRTP::testRTPSender);
 }
 
+//Network-wrapper recording all packages sent, optionally blocking until released
+class RecordingNetworkWrapper : public ohmcomm::network::NetworkWrapper
+{
+public:
+    std::vector<std::string> packages;
+    std::mutex blockMutex;
+
+    using ohmcomm::network::NetworkWrapper::sendData;
+
+    int sendData(const void* buffer, const unsigned int bufferSize) override
+    {
+        std::lock_guard<std::mutex> lock(blockMutex);
+        packages.push_back(std::string((const char*)buffer, bufferSize));
+        return bufferSize;
+    }
+
+    Package receiveData(void* buffer, unsigned int bufferSize) override
+    {
+        return Package{ohmcomm::network::SocketAddress{}, RECEIVE_TIMEOUT};
+    }
+
+    void closeNetwork() override
+    {
+    }
+};
+
 void TestRTP::testRTPPackage()
 {
     Participant part(15,true);
@@ -34,3 +65,41 @@ void TestRTP::testRTPPackage()
     TEST_ASSERT(pack.getActualPayloadSize() <= pack.getMaximumPayloadSize());
     TEST_ASSERT(RTPPackageHandler::isRTPPackage(pack.getReadBuffer(), pack.getActualPayloadSize()));
 }
+
+void TestRTP::testRTPSender()
+{
+    std::shared_ptr<RecordingNetworkWrapper> network(new RecordingNetworkWrapper());
+    const long droppedBefore = ohmcomm::Statistics::readCounter(ohmcomm::Statistics::RTP_SEND_QUEUE_DROPPED);
+    {
+        RTPSender sender(network, 16);
+        const std::string header = "H";
+        //blocks the sending-thread, so the queue fills up
+        std::unique_lock<std::mutex> lock(network->blockMutex);
+        sender.startUp();
+        unsigned int numQueued = 0;
+        for(unsigned int i = 0; i < RTPSender::QUEUE_CAPACITY + 8; ++i)
+        {
+            const std::string package = std::to_string(i);
+            if(sender.enqueuePackage(header.data(), header.size(), package.data(), package.size()))
+            {
+                ++numQueued;
+            }
+        }
+        //the sending-thread may have taken one package out of the queue before blocking
+        TEST_ASSERT(numQueued >= RTPSender::QUEUE_CAPACITY);
+        TEST_ASSERT(numQueued <= RTPSender::QUEUE_CAPACITY + 1);
+        TEST_ASSERT(!sender.enqueuePackage(header.data(), header.size(), "This package is too large", 25));
+        TEST_ASSERT(ohmcomm::Statistics::readCounter(ohmcomm::Statistics::RTP_SEND_QUEUE_MAXIMUM_DEPTH) >= RTPSender::QUEUE_CAPACITY);
+        TEST_ASSERT_EQUALS(ohmcomm::Statistics::readCounter(ohmcomm::Statistics::RTP_SEND_QUEUE_DROPPED) - droppedBefore,
+                (long)(RTPSender::QUEUE_CAPACITY + 8 - numQueued + 1));
+        lock.unlock();
+        //all queued packages are sent before shutting down
+        sender.shutdown();
+        TEST_ASSERT_EQUALS(network->packages.size(), numQueued);
+    }
+    //the packages are sent in the order they were queued
+    for(unsigned int i = 0; i < network->packages.size(); ++i)
+    {
+        TEST_ASSERT_EQUALS(network->packages[i], "H" + std::to_string(i));
+    }
+}
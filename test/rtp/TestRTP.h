@@ -17,6 +17,8 @@ public:
     TestRTP();
 
     void testRTPPackage();
+
+    void testRTPSender();
 };
 
 #endif	/* TESTRTP_H */
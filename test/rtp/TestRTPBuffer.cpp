@@ -1,9 +1,11 @@
 #include "TestRTPBuffer.h"
+#include <memory>
+#include <vector>
 
 using namespace ohmcomm::rtp;
 
-TestRTPBuffer::TestRTPBuffer() : payloadSize(511), maxCapacity(128), maxDelay(100), minBufferPackages(20),
-handler(new RTPBuffer(150, maxCapacity, maxDelay, minBufferPackages)), package(payloadSize)
+TestRTPBuffer::TestRTPBuffer(const JitterBufferType bufferType) : bufferType(bufferType), payloadSize(511), maxPayloadSize(256), maxCapacity(128), maxDelay(100), minBufferPackages(20),
+handler(createBuffer(bufferType, maxCapacity, maxDelay, minBufferPackages, maxPayloadSize)), package(payloadSize)
 {
 	TEST_ADD(TestRTPBuffer::testMinBufferPackages);
 	TEST_ADD(TestRTPBuffer::testWriteFullBuffer);
@@ -11,6 +13,10 @@ handler(new RTPBuffer(150, maxCapacity, maxDelay, minBufferPackages)), package(p
 	TEST_ADD(TestRTPBuffer::testWriteOldPackage);
 	TEST_ADD(TestRTPBuffer::testPackageBlockLoss);
 	TEST_ADD(TestRTPBuffer::testContinousPackageLoss);
+	TEST_ADD(TestRTPBuffer::testWriteOversizedPackage);
+	TEST_ADD(TestRTPBuffer::testClockDriftCompensation);
+	TEST_ADD(TestRTPBuffer::testLeasePackage);
+	TEST_ADD(TestRTPBuffer::testComfortNoiseConcealment);
 }
 
 TestRTPBuffer::~TestRTPBuffer()
@@ -18,6 +24,15 @@ TestRTPBuffer::~TestRTPBuffer()
 	delete handler;
 }
 
+RTPBufferHandler* TestRTPBuffer::createBuffer(const JitterBufferType bufferType, const unsigned short maxCapacity, const unsigned short maxDelay, const unsigned short minBufferPackages, const unsigned int maxPayloadSize)
+{
+	if (bufferType == JitterBufferType::LOCK_FREE)
+	{
+		return new RTPBufferLockFree(150, maxCapacity, maxDelay, minBufferPackages, maxPayloadSize);
+	}
+	return new RTPBuffer(150, maxCapacity, maxDelay, minBufferPackages, maxPayloadSize);
+}
+
 void TestRTPBuffer::testMinBufferPackages()
 {
 	//fill with less packages than minBufferSize
@@ -105,6 +120,11 @@ void TestRTPBuffer::testPackageBlockLoss()
 		TEST_FAIL("RTPBuffer currently does not support this test!");
 		return;
 	}
+	if (dynamic_cast<RTPBufferLockFree*>(handler) != nullptr)
+	{
+		TEST_FAIL("RTPBufferLockFree currently does not support this test!");
+		return;
+	}
 
 	//we first empty the buffer
 	while (handler->getSize() > 0)
@@ -164,6 +184,11 @@ void TestRTPBuffer::testContinousPackageLoss()
 		TEST_FAIL("RTPBuffer currently does not support this test!");
 		return;
 	}
+	if (dynamic_cast<RTPBufferLockFree*>(handler) != nullptr)
+	{
+		TEST_FAIL("RTPBufferLockFree currently does not support this test!");
+		return;
+	}
 	if (dynamic_cast<RTPBufferAlternative*>(handler) != nullptr)
 	{
 		TEST_FAIL("RTPBufferAlternative currently does not support this test!");
@@ -199,3 +224,117 @@ void TestRTPBuffer::testContinousPackageLoss()
 	TEST_ASSERT_EQUALS(lastSeqNum, package.getRTPPackageHeader()->getSequenceNumber());
 	TEST_ASSERT_EQUALS(0, handler->getSize());
 }
+
+void TestRTPBuffer::testWriteOversizedPackage()
+{
+	const std::vector<char> payload(payloadSize, 'x');
+	unsigned int size = handler->getSize();
+
+	//a package larger than the preallocated slots must be rejected
+	package.createNewRTPPackage(payload.data(), payloadSize);
+	TEST_ASSERT_EQUALS(RTPBufferStatus::RTP_BUFFER_INPUT_OVERFLOW, handler->addPackage(package, payloadSize));
+	TEST_ASSERT_EQUALS(size, handler->getSize());
+
+	//a package with the maximum size fits
+	package.createNewRTPPackage(payload.data(), maxPayloadSize);
+	TEST_ASSERT_EQUALS(RTPBufferStatus::RTP_BUFFER_ALL_OKAY, handler->addPackage(package, maxPayloadSize));
+	TEST_ASSERT_EQUALS(size + 1, handler->getSize());
+}
+
+void TestRTPBuffer::testClockDriftCompensation()
+{
+	std::unique_ptr<RTPBufferHandler> buffer(createBuffer(bufferType, maxCapacity, maxDelay, 1, maxPayloadSize));
+	RTPPackageHandler package(payloadSize);
+	//the remote produces 1% more packages than we play out,
+	//without compensation, the buffer would overflow after ~12800 play-outs
+	for (unsigned int i = 0; i < 20000; i++)
+	{
+		package.createNewRTPPackage((char*)"Dadadummi!", 10);
+		TEST_ASSERT_EQUALS(RTPBufferStatus::RTP_BUFFER_ALL_OKAY, buffer->addPackage(package, 10));
+		if (i % 100 == 0)
+		{
+			package.createNewRTPPackage((char*)"Dadadummi!", 10);
+			TEST_ASSERT_EQUALS(RTPBufferStatus::RTP_BUFFER_ALL_OKAY, buffer->addPackage(package, 10));
+		}
+		buffer->readPackage(package);
+	}
+	//the buffer-level is kept flat by dropping single packages
+	TEST_ASSERT(buffer->getSize() < 32);
+}
+
+void TestRTPBuffer::testLeasePackage()
+{
+	std::unique_ptr<RTPBufferHandler> buffer(createBuffer(bufferType, maxCapacity, maxDelay, 1, maxPayloadSize));
+	RTPPackageHandler package(payloadSize);
+	package.createNewRTPPackage((char*)"First", 5);
+	const uint16_t firstSequenceNumber = package.getRTPPackageHeader()->getSequenceNumber();
+	TEST_ASSERT_EQUALS(RTPBufferStatus::RTP_BUFFER_ALL_OKAY, buffer->addPackage(package, 5));
+	package.createNewRTPPackage((char*)"Second", 6);
+	TEST_ASSERT_EQUALS(RTPBufferStatus::RTP_BUFFER_ALL_OKAY, buffer->addPackage(package, 6));
+
+	PackageLease lease;
+	TEST_ASSERT_EQUALS(RTPBufferStatus::RTP_BUFFER_ALL_OKAY, buffer->leasePackage(lease));
+	TEST_ASSERT(lease.isValid());
+	TEST_ASSERT_EQUALS(firstSequenceNumber, lease.getHeader()->getSequenceNumber());
+	TEST_ASSERT_EQUALS(5u, lease.getPayloadSize());
+	TEST_ASSERT(memcmp(lease.getPayload(), "First", 5) == 0);
+	TEST_ASSERT_EQUALS(1u, buffer->getSize());
+
+	//leasing the next package with the same lease releases the previous one
+	TEST_ASSERT_EQUALS(RTPBufferStatus::RTP_BUFFER_ALL_OKAY, buffer->leasePackage(lease));
+	TEST_ASSERT_EQUALS(6u, lease.getPayloadSize());
+	TEST_ASSERT(memcmp(lease.getPayload(), "Second", 6) == 0);
+	TEST_ASSERT_EQUALS(0u, buffer->getSize());
+
+	//on underflow, the lease references the concealment-package
+	TEST_ASSERT_EQUALS(RTPBufferStatus::RTP_BUFFER_OUTPUT_UNDERFLOW, buffer->leasePackage(lease));
+	TEST_ASSERT(lease.isValid());
+	lease.release();
+	TEST_ASSERT(!lease.isValid());
+}
+
+void TestRTPBuffer::testComfortNoiseConcealment()
+{
+	std::unique_ptr<RTPBufferHandler> buffer(createBuffer(bufferType, maxCapacity, maxDelay, 1, maxPayloadSize));
+	RTPPackageHandler package(payloadSize);
+	RTPPackageHandler readPackage(payloadSize);
+	const uint8_t noiseParameters[] = {40, 127, 100};
+	package.createNewRTPPackage((char*)"Audio", 5);
+	TEST_ASSERT_EQUALS(RTPBufferStatus::RTP_BUFFER_ALL_OKAY, buffer->addPackage(package, 5));
+	package.createNewRTPPackage(noiseParameters, sizeof(noiseParameters));
+	((RTPHeader*)package.getRTPPackageHeader())->setPayloadType(ohmcomm::PayloadType::CN);
+	TEST_ASSERT_EQUALS(RTPBufferStatus::RTP_BUFFER_ALL_OKAY, buffer->addPackage(package, sizeof(noiseParameters)));
+
+	TEST_ASSERT_EQUALS(RTPBufferStatus::RTP_BUFFER_ALL_OKAY, buffer->readPackage(readPackage));
+	TEST_ASSERT(readPackage.getRTPPackageHeader()->getPayloadType() != ohmcomm::PayloadType::CN);
+	TEST_ASSERT_EQUALS(RTPBufferStatus::RTP_BUFFER_ALL_OKAY, buffer->readPackage(readPackage));
+	TEST_ASSERT_EQUALS(ohmcomm::PayloadType::CN, readPackage.getRTPPackageHeader()->getPayloadType());
+
+	//the remote stopped sending, the comfort noise is continued
+	for(unsigned int i = 0; i < 10; ++i)
+	{
+		TEST_ASSERT_EQUALS(RTPBufferStatus::RTP_BUFFER_OUTPUT_UNDERFLOW, buffer->readPackage(readPackage));
+		TEST_ASSERT_EQUALS(ohmcomm::PayloadType::CN, readPackage.getRTPPackageHeader()->getPayloadType());
+		TEST_ASSERT_EQUALS(sizeof(noiseParameters), readPackage.getActualPayloadSize());
+		TEST_ASSERT(memcmp(readPackage.getRTPPackageData(), noiseParameters, sizeof(noiseParameters)) == 0);
+	}
+
+	//the next comfort-noise package is accepted, although the concealed packages advanced the sequence number
+	package.createNewRTPPackage(noiseParameters, sizeof(noiseParameters));
+	((RTPHeader*)package.getRTPPackageHeader())->setPayloadType(ohmcomm::PayloadType::CN);
+	TEST_ASSERT_EQUALS(RTPBufferStatus::RTP_BUFFER_ALL_OKAY, buffer->addPackage(package, sizeof(noiseParameters)));
+	TEST_ASSERT_EQUALS(RTPBufferStatus::RTP_BUFFER_ALL_OKAY, buffer->readPackage(readPackage));
+	TEST_ASSERT_EQUALS(ohmcomm::PayloadType::CN, readPackage.getRTPPackageHeader()->getPayloadType());
+
+	//the silence period ends with a marked audio package, afterwards losses are concealed with silence again
+	package.createNewRTPPackage((char*)"Audio", 5);
+	((RTPHeader*)package.getRTPPackageHeader())->setMarker(true);
+	TEST_ASSERT_EQUALS(RTPBufferStatus::RTP_BUFFER_ALL_OKAY, buffer->addPackage(package, 5));
+	TEST_ASSERT_EQUALS(RTPBufferStatus::RTP_BUFFER_ALL_OKAY, buffer->readPackage(readPackage));
+	TEST_ASSERT(readPackage.getRTPPackageHeader()->getPayloadType() != ohmcomm::PayloadType::CN);
+	for(unsigned int i = 0; i < 10; ++i)
+	{
+		TEST_ASSERT_EQUALS(RTPBufferStatus::RTP_BUFFER_OUTPUT_UNDERFLOW, buffer->readPackage(readPackage));
+	}
+	TEST_ASSERT(readPackage.getRTPPackageHeader()->getPayloadType() != ohmcomm::PayloadType::CN);
+}
@@ -5,11 +5,13 @@
 #include "rtp/RTPBufferHandler.h"
 #include "rtp/RTPBuffer.h"
 #include "rtp/RTPBufferAlternative.h"
+#include "rtp/RTPBufferLockFree.h"
+#include "rtp/JitterBuffers.h"
 
 class TestRTPBuffer : public Test::Suite
 {
 public:
-    TestRTPBuffer();
+    TestRTPBuffer(const ohmcomm::rtp::JitterBufferType bufferType = ohmcomm::rtp::JitterBufferType::RTP_BUFFER);
     ~TestRTPBuffer();
 
     void testMinBufferPackages();
@@ -18,15 +20,23 @@ public:
     void testWriteOldPackage();
     void testPackageBlockLoss();
     void testContinousPackageLoss();
+    void testWriteOversizedPackage();
+    void testClockDriftCompensation();
+    void testLeasePackage();
+    void testComfortNoiseConcealment();
 
 private:
+    const ohmcomm::rtp::JitterBufferType bufferType;
     const unsigned int payloadSize;
+    const unsigned int maxPayloadSize;
     const unsigned short maxCapacity;
     const unsigned short maxDelay;
     const unsigned short minBufferPackages;
     ohmcomm::rtp::RTPBufferHandler* handler;
     ohmcomm::rtp::RTPPackageHandler package;
 
+    static ohmcomm::rtp::RTPBufferHandler* createBuffer(const ohmcomm::rtp::JitterBufferType bufferType, const unsigned short maxCapacity, const unsigned short maxDelay, const unsigned short minBufferPackages, const unsigned int maxPayloadSize);
+
 };
 
 #endif // TESTRTPBUFFER_H
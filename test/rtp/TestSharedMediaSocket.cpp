@@ -0,0 +1,282 @@
+/*
+ * File:   TestSharedMediaSocket.cpp
+ */
+
+#include "TestSharedMediaSocket.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+
+#include "network/UDPWrapper.h"
+#include "rtp/JitterBuffers.h"
+#include "rtp/ParticipantDatabase.h"
+#include "rtp/RTPPackageHandler.h"
+#include "Statistics.h"
+
+using namespace ohmcomm;
+using namespace ohmcomm::rtp;
+
+static const unsigned short SHARED_PORT = DEFAULT_NETWORK_PORT + 30;
+
+//sends a single RTP-package from the given remote to the shared port
+static void sendPackage(ohmcomm::network::NetworkWrapper& remote, const uint32_t ssrc)
+{
+    Participant sender(ssrc, true);
+    RTPPackageHandler handler(64, sender);
+    const char payload[16] = {0};
+    const void* package = handler.createNewRTPPackage(payload, sizeof(payload));
+    remote.sendData(package, handler.getRTPHeaderSize() + sizeof(payload));
+}
+
+//closes the session as soon as the remote is added, like the call is ended on a remote leaving
+class ClosingListener : public ParticipantListener
+{
+public:
+    ClosingListener(SharedMediaSocket::Session& session) : session(session)
+    {
+    }
+
+    void onRemoteAdded(const unsigned int ssrc) override
+    {
+        session.closeNetwork();
+    }
+
+private:
+    SharedMediaSocket::Session& session;
+};
+
+//waits for another thread adding a remote, like the call is torn down waiting for the loop of another session
+class WaitingListener : public ParticipantListener
+{
+public:
+    void onRemoteAdded(const unsigned int ssrc) override
+    {
+        if(ssrc == OTHER_SSRC)
+        {
+            return;
+        }
+        otherThread = std::async(std::launch::async, []() { ParticipantDatabase::remote(OTHER_SSRC); });
+        otherThreadDone = otherThread.wait_for(std::chrono::seconds(1)) == std::future_status::ready;
+        isCalled = true;
+    }
+
+    static constexpr uint32_t OTHER_SSRC{0xAAAA};
+    std::future<void> otherThread;
+    bool otherThreadDone = false;
+    std::atomic<bool> isCalled{false};
+};
+
+constexpr uint32_t WaitingListener::OTHER_SSRC;
+
+static void waitForPackages()
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+}
+
+TestSharedMediaSocket::TestSharedMediaSocket() : Test::Suite()
+{
+    TEST_ADD(TestSharedMediaSocket::testDemultiplexBySSRC);
+    TEST_ADD(TestSharedMediaSocket::testSameSSRC);
+    TEST_ADD(TestSharedMediaSocket::testUnknownRemote);
+    TEST_ADD(TestSharedMediaSocket::testSendData);
+    TEST_ADD(TestSharedMediaSocket::testWorkerPool);
+    TEST_ADD(TestSharedMediaSocket::testCloseFromListener);
+    TEST_ADD(TestSharedMediaSocket::testWaitFromListener);
+    TEST_ADD(TestSharedMediaSocket::testRemovedParticipant);
+}
+
+void TestSharedMediaSocket::testDemultiplexBySSRC()
+{
+    ohmcomm::network::UDPWrapper remote1(NetworkConfiguration{DEFAULT_NETWORK_PORT + 31, "127.0.0.1", SHARED_PORT});
+    ohmcomm::network::UDPWrapper remote2(NetworkConfiguration{DEFAULT_NETWORK_PORT + 32, "127.0.0.1", SHARED_PORT});
+    JitterBuffers buffers1(16, 200);
+    JitterBuffers buffers2(16, 200);
+    {
+        const std::shared_ptr<SharedMediaSocket> socket = SharedMediaSocket::create(SHARED_PORT);
+        const auto session1 = socket->openSession("127.0.0.1", DEFAULT_NETWORK_PORT + 31);
+        const auto session2 = socket->openSession("127.0.0.1", DEFAULT_NETWORK_PORT + 32);
+        TEST_ASSERT_EQUALS(2u, socket->getNumberOfSessions());
+        session1->startReceiving(buffers1, nullptr);
+        session2->startReceiving(buffers2, nullptr);
+
+        sendPackage(remote1, 0x1111);
+        sendPackage(remote2, 0x2222);
+        waitForPackages();
+    }
+    TEST_ASSERT(buffers1.findBuffer(0x1111) != nullptr);
+    TEST_ASSERT(buffers1.findBuffer(0x2222) == nullptr);
+    TEST_ASSERT(buffers2.findBuffer(0x2222) != nullptr);
+    TEST_ASSERT(buffers2.findBuffer(0x1111) == nullptr);
+}
+
+void TestSharedMediaSocket::testSameSSRC()
+{
+    ohmcomm::network::UDPWrapper remote1(NetworkConfiguration{DEFAULT_NETWORK_PORT + 31, "127.0.0.1", SHARED_PORT});
+    ohmcomm::network::UDPWrapper remote2(NetworkConfiguration{DEFAULT_NETWORK_PORT + 32, "127.0.0.1", SHARED_PORT});
+    JitterBuffers buffers1(16, 200);
+    JitterBuffers buffers2(16, 200);
+    {
+        const std::shared_ptr<SharedMediaSocket> socket = SharedMediaSocket::create(SHARED_PORT);
+        const auto session1 = socket->openSession("127.0.0.1", DEFAULT_NETWORK_PORT + 31);
+        const auto session2 = socket->openSession("127.0.0.1", DEFAULT_NETWORK_PORT + 32);
+        session1->startReceiving(buffers1, nullptr);
+        session2->startReceiving(buffers2, nullptr);
+
+        //the remotes are told apart by their address
+        sendPackage(remote1, 0x3333);
+        sendPackage(remote2, 0x3333);
+        waitForPackages();
+    }
+    TEST_ASSERT(buffers1.findBuffer(0x3333) != nullptr);
+    TEST_ASSERT(buffers2.findBuffer(0x3333) != nullptr);
+}
+
+void TestSharedMediaSocket::testUnknownRemote()
+{
+    ohmcomm::network::UDPWrapper remote1(NetworkConfiguration{DEFAULT_NETWORK_PORT + 31, "127.0.0.1", SHARED_PORT});
+    ohmcomm::network::UDPWrapper unknownRemote(NetworkConfiguration{DEFAULT_NETWORK_PORT + 33, "127.0.0.1", SHARED_PORT});
+    JitterBuffers buffers(16, 200);
+    {
+        const std::shared_ptr<SharedMediaSocket> socket = SharedMediaSocket::create(SHARED_PORT);
+        const auto session = socket->openSession("127.0.0.1", DEFAULT_NETWORK_PORT + 31);
+        session->startReceiving(buffers, nullptr);
+
+        sendPackage(unknownRemote, 0x4444);
+        waitForPackages();
+        TEST_ASSERT(buffers.findBuffer(0x4444) == nullptr);
+
+        //a closed session does not receive anymore
+        session->closeNetwork();
+        TEST_ASSERT_EQUALS(0u, socket->getNumberOfSessions());
+        sendPackage(remote1, 0x5555);
+        waitForPackages();
+    }
+    TEST_ASSERT(buffers.findBuffer(0x5555) == nullptr);
+}
+
+void TestSharedMediaSocket::testSendData()
+{
+    ohmcomm::network::UDPWrapper remote1(NetworkConfiguration{DEFAULT_NETWORK_PORT + 31, "127.0.0.1", SHARED_PORT});
+    const std::shared_ptr<SharedMediaSocket> socket = SharedMediaSocket::create(SHARED_PORT);
+    const auto session = socket->openSession("127.0.0.1", DEFAULT_NETWORK_PORT + 31);
+
+    const ohmcomm::network::NetworkWrapper::BufferSegment segments[2] = {{"Test-", 5}, {"Data", 4}};
+    TEST_ASSERT_EQUALS(9, session->sendData(segments, 2));
+    char buffer[16];
+    const auto package = remote1.receiveData(buffer, sizeof(buffer));
+    TEST_ASSERT_EQUALS(9u, package.getReceivedSize());
+    TEST_ASSERT_EQUALS(0, memcmp(buffer, "Test-Data", 9));
+    TEST_ASSERT_EQUALS(SHARED_PORT, package.address.toAddressAndPort().second);
+}
+
+void TestSharedMediaSocket::testWorkerPool()
+{
+    //the remote ports are owned by different workers
+    ohmcomm::network::UDPWrapper remote1(NetworkConfiguration{DEFAULT_NETWORK_PORT + 31, "127.0.0.1", SHARED_PORT});
+    ohmcomm::network::UDPWrapper remote2(NetworkConfiguration{DEFAULT_NETWORK_PORT + 32, "127.0.0.1", SHARED_PORT});
+    JitterBuffers buffers1(16, 200);
+    JitterBuffers buffers2(16, 200);
+    {
+        MediaWorkerPool pool(SHARED_PORT, 2);
+        TEST_ASSERT(pool.getNumberOfWorkers() >= 1);
+        const auto session1 = pool.openSession("127.0.0.1", DEFAULT_NETWORK_PORT + 31);
+        const auto session2 = pool.openSession("127.0.0.1", DEFAULT_NETWORK_PORT + 32);
+        TEST_ASSERT_EQUALS(2u, pool.getNumberOfSessions());
+        if(pool.getNumberOfWorkers() == 2)
+        {
+            TEST_ASSERT(pool.getWorkerIndex(DEFAULT_NETWORK_PORT + 31) != pool.getWorkerIndex(DEFAULT_NETWORK_PORT + 32));
+            TEST_ASSERT_EQUALS(1u, pool.getSocket(0)->getNumberOfSessions());
+            TEST_ASSERT_EQUALS(1u, pool.getSocket(1)->getNumberOfSessions());
+        }
+        session1->startReceiving(buffers1, nullptr);
+        session2->startReceiving(buffers2, nullptr);
+
+        //the kernel delivers every package to the socket of the worker owning the remote
+        sendPackage(remote1, 0x6666);
+        sendPackage(remote2, 0x7777);
+        waitForPackages();
+    }
+    TEST_ASSERT(buffers1.findBuffer(0x6666) != nullptr);
+    TEST_ASSERT(buffers2.findBuffer(0x7777) != nullptr);
+}
+
+void TestSharedMediaSocket::testCloseFromListener()
+{
+    ohmcomm::network::UDPWrapper remote1(NetworkConfiguration{DEFAULT_NETWORK_PORT + 31, "127.0.0.1", SHARED_PORT});
+    JitterBuffers buffers(16, 200);
+    const std::shared_ptr<SharedMediaSocket> socket = SharedMediaSocket::create(SHARED_PORT);
+    const auto session = socket->openSession("127.0.0.1", DEFAULT_NETWORK_PORT + 31);
+    session->startReceiving(buffers, nullptr);
+    ClosingListener listener(*session);
+    ParticipantDatabase::registerListener(listener);
+
+    //the listener is called by the receiving thread, which must not hold the sessions while closing one
+    sendPackage(remote1, 0x8888);
+    waitForPackages();
+    ParticipantDatabase::unregisterListener(listener);
+    TEST_ASSERT(buffers.findBuffer(0x8888) != nullptr);
+    TEST_ASSERT_EQUALS(0u, socket->getNumberOfSessions());
+}
+
+void TestSharedMediaSocket::testWaitFromListener()
+{
+    ohmcomm::network::UDPWrapper remote1(NetworkConfiguration{DEFAULT_NETWORK_PORT + 31, "127.0.0.1", SHARED_PORT});
+    JitterBuffers buffers(16, 200);
+    const std::shared_ptr<SharedMediaSocket> socket = SharedMediaSocket::create(SHARED_PORT);
+    const auto session = socket->openSession("127.0.0.1", DEFAULT_NETWORK_PORT + 31);
+    session->startReceiving(buffers, nullptr);
+    WaitingListener listener;
+    ParticipantDatabase::registerListener(listener);
+
+    //the listener is called without the participant-database locked
+    sendPackage(remote1, 0x9999);
+    for(int i = 0; i < 30 && !listener.isCalled; ++i)
+    {
+        waitForPackages();
+    }
+    ParticipantDatabase::unregisterListener(listener);
+    TEST_ASSERT(listener.isCalled);
+    if(listener.isCalled)
+    {
+        //a blocked thread finishes, once the listener returned
+        listener.otherThread.wait();
+        TEST_ASSERT(listener.otherThreadDone);
+    }
+    ParticipantDatabase::removeParticipant(0x9999);
+    ParticipantDatabase::removeParticipant(WaitingListener::OTHER_SSRC);
+}
+
+void TestSharedMediaSocket::testRemovedParticipant()
+{
+    ohmcomm::network::UDPWrapper remote1(NetworkConfiguration{DEFAULT_NETWORK_PORT + 31, "127.0.0.1", SHARED_PORT});
+    JitterBuffers buffers(16, 200);
+    JitterBuffers newBuffers(16, 200);
+    const std::shared_ptr<SharedMediaSocket> socket = SharedMediaSocket::create(SHARED_PORT);
+    const auto session = socket->openSession("127.0.0.1", DEFAULT_NETWORK_PORT + 31);
+    session->startReceiving(buffers, nullptr);
+    const long receivedBefore = Statistics::readCounter(Statistics::COUNTER_PACKAGES_RECEIVED);
+
+    sendPackage(remote1, 0xBBBB);
+    waitForPackages();
+    //the counters of the receiving thread are summed up on reading
+    TEST_ASSERT_EQUALS(receivedBefore + 1, Statistics::readCounter(Statistics::COUNTER_PACKAGES_RECEIVED));
+    TEST_ASSERT(ParticipantDatabase::find(0xBBBB) != nullptr);
+    TEST_ASSERT(ParticipantDatabase::removeParticipant(0xBBBB));
+
+    //the participant cached by the listener is not used after it was removed
+    //the package is written into new buffers, which have not yet seen its sequence number
+    session->closeNetwork();
+    const auto newSession = socket->openSession("127.0.0.1", DEFAULT_NETWORK_PORT + 31);
+    newSession->startReceiving(newBuffers, nullptr);
+    sendPackage(remote1, 0xBBBB);
+    waitForPackages();
+    const Participant* participant = ParticipantDatabase::find(0xBBBB);
+    TEST_ASSERT(participant != nullptr);
+    if(participant != nullptr)
+    {
+        TEST_ASSERT_EQUALS(1u, participant->totalPackages);
+    }
+    ParticipantDatabase::removeParticipant(0xBBBB);
+}
@@ -0,0 +1,27 @@
+/*
+ * File:   TestSharedMediaSocket.h
+ */
+
+#ifndef TESTSHAREDMEDIASOCKET_H
+#define	TESTSHAREDMEDIASOCKET_H
+
+#include "cpptest.h"
+#include "rtp/MediaWorkerPool.h"
+#include "rtp/SharedMediaSocket.h"
+
+class TestSharedMediaSocket: public Test::Suite
+{
+public:
+    TestSharedMediaSocket();
+
+    void testDemultiplexBySSRC();
+    void testSameSSRC();
+    void testUnknownRemote();
+    void testSendData();
+    void testWorkerPool();
+    void testCloseFromListener();
+    void testWaitFromListener();
+    void testRemovedParticipant();
+};
+
+#endif	/* TESTSHAREDMEDIASOCKET_H */
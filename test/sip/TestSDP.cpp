@@ -13,6 +13,7 @@ TestSDP::TestSDP()
 {
     TEST_ADD(TestSDP::testSessionDescription);
     TEST_ADD(TestSDP::testMediaDescription);
+    TEST_ADD(TestSDP::testRTCPMultiplexing);
 }
 
 void TestSDP::testSessionDescription()
@@ -40,3 +41,16 @@ void TestSDP::testMediaDescription()
         TEST_ASSERT(m.getFormat().payloadType >= 0);
     }
 }
+
+void TestSDP::testRTCPMultiplexing()
+{
+    const ohmcomm::NetworkConfiguration config{12345, "127.0.0.1", 12345};
+    //offered by default
+    const SessionDescription descr = SDPMessageHandler::readSessionDescription(SDPMessageHandler::createSessionDescription("user", config));
+    TEST_ASSERT(SDPMessageHandler::isRTCPMultiplexed(descr));
+    //the "rtcp-mux" attribute must not be read as "rtcp" attribute
+    TEST_ASSERT_EQUALS(0, SDPMessageHandler::readRTCPAttribute(descr).remotePort);
+
+    const SessionDescription noMux = SDPMessageHandler::readSessionDescription(SDPMessageHandler::createSessionDescription("user", config, {}, nullptr, false));
+    TEST_ASSERT(!SDPMessageHandler::isRTCPMultiplexed(noMux));
+}
@@ -19,6 +19,7 @@ public:
     
     void testSessionDescription();
     void testMediaDescription();
+    void testRTCPMultiplexing();
 };
 
 #endif /* TESTSDP_H */